@@ -0,0 +1,89 @@
+#include "CallbackProfile.hpp"
+#include <algorithm>
+using namespace haze;
+
+void CCallbackProfile::SetBudget( uint64_t budget )
+{
+    m_nBudget = budget;
+    m_nStrikes = 0;
+    m_nRecovered = 0;
+    if( !budget ) {
+        m_nInterval = 1;
+    }
+}
+
+bool CCallbackProfile::HasBudget( void ) const
+{
+    return m_nBudget != 0;
+}
+
+bool CCallbackProfile::IsDue( void )
+{
+    if( ++m_nWaited >= m_nInterval || !m_nCalls ) {
+        m_nWaited = 0;
+        return true;
+    }
+
+    ++m_nSkipped;
+    return false;
+}
+
+void CCallbackProfile::AddSample( uint64_t duration )
+{
+    m_Histogram.Add( duration );
+    m_nLast = duration;
+
+    // exponential average over roughly the last 8 calls
+    m_nAverage = m_nCalls++ ? m_nAverage - m_nAverage / 8 + duration / 8 : duration;
+    if( !m_nBudget ) {
+        return;
+    }
+
+    if( m_nAverage > m_nBudget ) {
+        m_nRecovered = 0;
+        if( ++m_nStrikes >= STRIKES ) {
+            m_nStrikes = 0;
+            m_nInterval = m_nInterval * 2 < MAX_INTERVAL ? m_nInterval * 2 : MAX_INTERVAL;
+        }
+    }
+    else if( m_nAverage < m_nBudget / 2 ) {
+        m_nStrikes = 0;
+        if( ++m_nRecovered >= STRIKES ) {
+            m_nRecovered = 0;
+            m_nInterval = max< uint64_t >( m_nInterval / 2, 1 );
+        }
+    }
+    else {
+        m_nStrikes = 0;
+        m_nRecovered = 0;
+    }
+}
+
+CallbackStatistics CCallbackProfile::GetStatistics( void ) const
+{
+    const auto timings = m_Histogram.GetStatistics();
+
+    CallbackStatistics statistics;
+    statistics.nCalls = m_nCalls;
+    statistics.nSkipped = m_nSkipped;
+    statistics.nLast = m_nLast;
+    statistics.nAverage = m_nAverage;
+    statistics.nWorst = timings.nMax;
+    statistics.nP95 = timings.nP95;
+    statistics.nBudget = m_nBudget;
+    statistics.nInterval = m_nInterval;
+    return statistics;
+}
+
+void CCallbackProfile::Reset( void )
+{
+    m_Histogram.Reset();
+    m_nCalls = 0;
+    m_nSkipped = 0;
+    m_nLast = 0;
+    m_nAverage = 0;
+    m_nInterval = 1;
+    m_nWaited = 0;
+    m_nStrikes = 0;
+    m_nRecovered = 0;
+}
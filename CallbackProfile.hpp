@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include "FramePacer.hpp"
+#include "FrameTimer.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Timings of a render callback, times in nanoseconds
+     */
+    struct CallbackStatistics
+    {
+        uint64_t nCalls    = 0;
+        uint64_t nSkipped  = 0;
+        uint64_t nLast     = 0;
+        uint64_t nAverage  = 0;
+        uint64_t nWorst    = 0;
+        uint64_t nP95      = 0;
+        uint64_t nBudget   = 0;
+        uint64_t nInterval = 1;
+    };
+
+    /**
+     * @brief      CCallbackProfile times a single render callback over the
+     *             last 256 calls and throttles it when it keeps exceeding its
+     *             budget. Each time the running average stays above the
+     *             budget for STRIKES calls the callback runs half as often, up
+     *             to every MAX_INTERVAL frames. Once it stays below half of
+     *             the budget it runs twice as often again. A skipped callback
+     *             is expected to replay what it recorded last.
+     */
+    class CCallbackProfile
+    {
+    public:
+        static constexpr uint64_t STRIKES = 8;
+        static constexpr uint64_t MAX_INTERVAL = 16;
+
+    public:
+        CCallbackProfile( void ) = default;
+
+        /**
+         * @brief      Set the time budget of a call
+         *
+         * @param[in]  budget  budget in nanoseconds, 0 disables the throttling
+         */
+        void               SetBudget( uint64_t budget );
+
+        /**
+         * @brief      Has the callback a budget and may it get throttled?
+         *
+         * @return     bool
+         */
+        bool               HasBudget( void ) const;
+
+        /**
+         * @brief      Has the callback to run this frame? Counts the frame as
+         *             skipped if not.
+         *
+         * @return     bool
+         */
+        bool               IsDue( void );
+
+        /**
+         * @brief      Add the duration of a call and adapt the throttling
+         *
+         * @param[in]  duration  duration in nanoseconds
+         */
+        void               AddSample( uint64_t duration );
+
+        /**
+         * @brief      Time a call of the callback on the steady clock
+         *
+         * @param[in]  fn    callback
+         */
+        template< typename TFunction >
+        void               Run( TFunction&& fn )
+        {
+            const auto start = m_Clock.Now();
+            fn();
+            AddSample( m_Clock.Now() - start );
+        }
+
+        /**
+         * @brief      Get the timings of the callback
+         *
+         * @return     CallbackStatistics
+         */
+        CallbackStatistics GetStatistics( void ) const;
+
+        /**
+         * @brief      Remove every sample and stop the throttling
+         */
+        void               Reset( void );
+
+    private:
+        CSteadyClock       m_Clock;
+        CTimingHistogram   m_Histogram;
+        uint64_t           m_nCalls = 0;
+        uint64_t           m_nSkipped = 0;
+        uint64_t           m_nLast = 0;
+        uint64_t           m_nAverage = 0;
+        uint64_t           m_nBudget = 0;
+        uint64_t           m_nInterval = 1;
+        uint64_t           m_nWaited = 0;
+        uint64_t           m_nStrikes = 0;
+        uint64_t           m_nRecovered = 0;
+    };
+}
@@ -0,0 +1,204 @@
+#include "CallbackRegistry.hpp"
+#include <algorithm>
+using namespace haze;
+
+CallbackHandle CCallbackRegistry::Add( RenderCallback fn, int32_t priority )
+{
+    if( !fn ) {
+        return 0;
+    }
+
+    // a free slot lost its entry in the last Compact, nothing refers to its
+    // profile or list anymore
+    uint32_t slot;
+    if( !m_cFreeSlots.empty() ) {
+        slot = m_cFreeSlots.back();
+        m_cFreeSlots.pop_back();
+        m_cProfiles[ slot ].Reset();
+        m_cLists[ slot ].Reset();
+    }
+    else {
+        slot = static_cast< uint32_t >( m_cSlots.size() );
+        m_cSlots.emplace_back();
+        if( m_cProfiles.size() <= slot ) {
+            m_cProfiles.emplace_back();
+            m_cLists.emplace_back();
+        }
+    }
+
+    // the entries may be running, they only change in Compact
+    Entry entry;
+    entry.fn = move( fn );
+    entry.nPriority = priority;
+    entry.nSlot = slot;
+    m_cPending.push_back( move( entry ) );
+
+    m_cSlots[ slot ].nPosition = static_cast< uint32_t >( m_cPending.size() - 1 );
+    m_cSlots[ slot ].bPending = true;
+    m_cSlots[ slot ].bUsed = true;
+    return static_cast< CallbackHandle >( m_cSlots[ slot ].nGeneration ) << 32 | slot;
+}
+
+bool CCallbackRegistry::Remove( CallbackHandle handle )
+{
+    const auto* pSlot = Find( handle );
+    if( !pSlot ) {
+        return false;
+    }
+
+    // the slot is only reused after Compact dropped the entry
+    auto& slot = m_cSlots[ static_cast< uint32_t >( handle ) ];
+    GetEntry( slot ).bRemoved = true;
+    slot.bUsed = false;
+    if( !++slot.nGeneration ) {
+        slot.nGeneration = 1;
+    }
+    ++m_nRemoved;
+    return true;
+}
+
+bool CCallbackRegistry::SetEnabled( CallbackHandle handle, bool enabled )
+{
+    const auto* pSlot = Find( handle );
+    if( !pSlot ) {
+        return false;
+    }
+
+    GetEntry( *pSlot ).bEnabled = enabled;
+    return true;
+}
+
+bool CCallbackRegistry::IsEnabled( CallbackHandle handle ) const
+{
+    const auto* pSlot = Find( handle );
+    return pSlot && GetEntry( *pSlot ).bEnabled;
+}
+
+bool CCallbackRegistry::Contains( CallbackHandle handle ) const
+{
+    return Find( handle ) != nullptr;
+}
+
+CCallbackProfile* CCallbackRegistry::GetProfile( CallbackHandle handle )
+{
+    return Find( handle ) ? &m_cProfiles[ static_cast< uint32_t >( handle ) ] : nullptr;
+}
+
+const CCallbackProfile* CCallbackRegistry::GetProfile( CallbackHandle handle ) const
+{
+    return Find( handle ) ? &m_cProfiles[ static_cast< uint32_t >( handle ) ] : nullptr;
+}
+
+void CCallbackRegistry::Reserve( size_t count )
+{
+    m_cEntries.reserve( count );
+    m_cPending.reserve( count );
+    m_cSlots.reserve( count );
+    m_cFreeSlots.reserve( count );
+    if( m_cProfiles.size() < count ) {
+        m_cProfiles.resize( count );
+        m_cLists.resize( count );
+    }
+}
+
+void CCallbackRegistry::Clear( void )
+{
+    for( auto* pEntries : { &m_cEntries, &m_cPending } ) {
+        for( auto& entry : *pEntries ) {
+            if( !entry.bRemoved ) {
+                Remove( static_cast< CallbackHandle >( m_cSlots[ entry.nSlot ].nGeneration ) << 32 | entry.nSlot );
+            }
+        }
+    }
+    Compact();
+}
+
+size_t CCallbackRegistry::Size( void ) const
+{
+    return m_cEntries.size() + m_cPending.size() - m_nRemoved;
+}
+
+void CCallbackRegistry::Compact( void )
+{
+    if( !m_nRemoved && m_cPending.empty() ) {
+        return;
+    }
+
+    size_t next = 0;
+    for( size_t i = 0; i < m_cEntries.size(); ++i ) {
+        if( m_cEntries[ i ].bRemoved ) {
+            m_cFreeSlots.push_back( m_cEntries[ i ].nSlot );
+            continue;
+        }
+        if( next != i ) {
+            m_cEntries[ next ] = move( m_cEntries[ i ] );
+        }
+        ++next;
+    }
+    m_cEntries.erase( m_cEntries.begin() + next, m_cEntries.end() );
+
+    // behind every entry of the same priority, in the order they were added
+    for( auto& entry : m_cPending ) {
+        m_cSlots[ entry.nSlot ].bPending = false;
+        if( entry.bRemoved ) {
+            m_cFreeSlots.push_back( entry.nSlot );
+            continue;
+        }
+
+        const auto it = upper_bound( m_cEntries.begin(), m_cEntries.end(), entry.nPriority, []( int32_t value, const Entry& other ) {
+            return value < other.nPriority;
+        } );
+        m_cEntries.insert( it, move( entry ) );
+    }
+    m_cPending.clear();
+
+    for( size_t i = 0; i < m_cEntries.size(); ++i ) {
+        m_cSlots[ m_cEntries[ i ].nSlot ].nPosition = static_cast< uint32_t >( i );
+    }
+    m_nRemoved = 0;
+}
+
+size_t CCallbackRegistry::GetEntryCount( void ) const
+{
+    return m_cEntries.size();
+}
+
+bool CCallbackRegistry::IsActive( size_t index ) const
+{
+    return m_cEntries[ index ].bEnabled && !m_cEntries[ index ].bRemoved;
+}
+
+void CCallbackRegistry::Invoke( size_t index, const CRenderSurface* surface ) const
+{
+    m_cEntries[ index ].fn( surface );
+}
+
+CCallbackProfile& CCallbackRegistry::GetEntryProfile( size_t index )
+{
+    return m_cProfiles[ m_cEntries[ index ].nSlot ];
+}
+
+CCommandList& CCallbackRegistry::GetEntryList( size_t index )
+{
+    return m_cLists[ m_cEntries[ index ].nSlot ];
+}
+
+const CCallbackRegistry::Slot* CCallbackRegistry::Find( CallbackHandle handle ) const
+{
+    const auto slot = static_cast< uint32_t >( handle );
+    const auto generation = static_cast< uint32_t >( handle >> 32 );
+    if( slot >= m_cSlots.size() || !m_cSlots[ slot ].bUsed || m_cSlots[ slot ].nGeneration != generation ) {
+        return nullptr;
+    }
+    return &m_cSlots[ slot ];
+}
+
+CCallbackRegistry::Entry& CCallbackRegistry::GetEntry( const Slot& slot )
+{
+    return slot.bPending ? m_cPending[ slot.nPosition ] : m_cEntries[ slot.nPosition ];
+}
+
+const CCallbackRegistry::Entry& CCallbackRegistry::GetEntry( const Slot& slot ) const
+{
+    return slot.bPending ? m_cPending[ slot.nPosition ] : m_cEntries[ slot.nPosition ];
+}
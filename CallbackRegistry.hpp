@@ -0,0 +1,200 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "CallbackProfile.hpp"
+#include "CommandList.hpp"
+#include "Delegate.hpp"
+#include "Surface.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Render callback with up to 48 bytes of captured context
+     */
+    using RenderCallback = CDelegate< void( const CRenderSurface* ) >;
+
+    /**
+     * @brief      Identifies a registered callback, 0 is never a valid handle
+     */
+    using CallbackHandle = uint64_t;
+
+    /**
+     * @brief      CCallbackRegistry keeps the render callbacks sorted by
+     *             priority in one contiguous array, equal priorities in
+     *             registration order. Removing a callback only marks its entry
+     *             and takes constant time, the entries are compacted once
+     *             before the next frame runs them. Added callbacks wait in a
+     *             pending array until the same Compact sorts them in. Every
+     *             callback owns a profile and a command list which stay at
+     *             its slot, so neither moves while other callbacks come and
+     *             go. Callbacks run serially may add, remove or disable
+     *             callbacks. Callbacks run by a parallel recorder must leave
+     *             the registry alone.
+     */
+    class CCallbackRegistry
+    {
+    public:
+        /**
+         * @brief      Add a callback, it runs from the next Compact on
+         *
+         * @param[in]  fn        callback
+         * @param[in]  priority  lower priorities run first and are drawn below
+         *
+         * @return     CallbackHandle <> 0 if fn was empty
+         */
+        CallbackHandle          Add( RenderCallback fn, int32_t priority = 0 );
+
+        /**
+         * @brief      Remove a callback, its handle becomes invalid
+         *
+         * @param[in]  handle  callback handle
+         *
+         * @return     bool <> false if the handle was invalid
+         */
+        bool                    Remove( CallbackHandle handle );
+
+        /**
+         * @brief      Enable or disable a callback, a disabled callback keeps
+         *             its place, profile and handle
+         *
+         * @param[in]  handle   callback handle
+         * @param[in]  enabled  run the callback
+         *
+         * @return     bool <> false if the handle was invalid
+         */
+        bool                    SetEnabled( CallbackHandle handle, bool enabled );
+
+        /**
+         * @brief      Is the callback registered and enabled?
+         *
+         * @param[in]  handle  callback handle
+         *
+         * @return     bool
+         */
+        bool                    IsEnabled( CallbackHandle handle ) const;
+
+        /**
+         * @brief      Is the handle registered?
+         *
+         * @param[in]  handle  callback handle
+         *
+         * @return     bool
+         */
+        bool                    Contains( CallbackHandle handle ) const;
+
+        /**
+         * @brief      Get the profile of a callback
+         *
+         * @param[in]  handle  callback handle
+         *
+         * @return     CCallbackProfile* <> nullptr if the handle was invalid
+         */
+        CCallbackProfile*       GetProfile( CallbackHandle handle );
+        const CCallbackProfile* GetProfile( CallbackHandle handle ) const;
+
+        /**
+         * @brief      Reserve memory, registering up to count callbacks then
+         *             never allocates
+         *
+         * @param[in]  count  amount of callbacks
+         */
+        void                    Reserve( size_t count );
+
+        /**
+         * @brief      Remove every callback
+         */
+        void                    Clear( void );
+
+        /**
+         * @brief      Get the amount of registered callbacks
+         *
+         * @return     size_t
+         */
+        size_t                  Size( void ) const;
+
+        /**
+         * @brief      Drop the removed entries and sort the added ones in,
+         *             has to be called before the callbacks run and never
+         *             while they do
+         */
+        void                    Compact( void );
+
+        /**
+         * @brief      Get the amount of entries in run order, removed entries
+         *             count and added ones don't until the next Compact
+         *
+         * @return     size_t
+         */
+        size_t                  GetEntryCount( void ) const;
+
+        /**
+         * @brief      Should an entry run, is it enabled and not removed?
+         *
+         * @param[in]  index  entry in run order
+         *
+         * @return     bool
+         */
+        bool                    IsActive( size_t index ) const;
+
+        /**
+         * @brief      Run the callback of an entry
+         *
+         * @param[in]  index    entry in run order
+         * @param[in]  surface  surface to draw on
+         */
+        void                    Invoke( size_t index, const CRenderSurface* surface ) const;
+
+        /**
+         * @brief      Get the profile of an entry
+         *
+         * @param[in]  index  entry in run order
+         *
+         * @return     CCallbackProfile&
+         */
+        CCallbackProfile&       GetEntryProfile( size_t index );
+
+        /**
+         * @brief      Get the command list an entry records into when it
+         *             has to be replayed later
+         *
+         * @param[in]  index  entry in run order
+         *
+         * @return     CCommandList&
+         */
+        CCommandList&           GetEntryList( size_t index );
+
+    private:
+        struct Entry
+        {
+            RenderCallback fn;
+            int32_t        nPriority = 0;
+            uint32_t       nSlot = 0;
+            bool           bEnabled = true;
+            bool           bRemoved = false;
+        };
+
+        struct Slot
+        {
+            uint32_t       nGeneration = 1;
+            uint32_t       nPosition = 0;
+            bool           bUsed = false;
+            bool           bPending = false;
+        };
+
+        const Slot*             Find( CallbackHandle handle ) const;
+        Entry&                  GetEntry( const Slot& slot );
+        const Entry&            GetEntry( const Slot& slot ) const;
+
+    private:
+        vector< Entry >            m_cEntries;
+        vector< Entry >            m_cPending;
+        vector< Slot >             m_cSlots;
+        vector< uint32_t >         m_cFreeSlots;
+        deque< CCallbackProfile >  m_cProfiles;
+        deque< CCommandList >      m_cLists;
+        size_t                     m_nRemoved = 0;
+    };
+}
@@ -1,54 +1,57 @@
 #include "Color.hpp"
+#include "Simd.hpp"
+#include <cstring>
 using namespace haze;
 
-Color::Color( void )
-{
-    m_cColor.fill( 255 );
-}
-
-Color::Color( const array< byte, 4 >& color ) :
-    m_cColor( color )
-{
-}
-
-Color::Color( uint32_t hex )
-{
-    Set( hex );
-}
+namespace {
+    /**
+     * @brief      Scale every byte by factor / 256
+     */
+    uint32_t Scale( uint32_t color, uint32_t factor )
+    {
+        const auto rb = ( ( color & 0x00FF00FF ) * factor >> 8 ) & 0x00FF00FF;
+        const auto ga = ( ( color >> 8 ) & 0x00FF00FF ) * factor & 0xFF00FF00;
+        return rb | ga;
+    }
 
-Color::Color( int32_t r, int32_t g, int32_t b, int32_t a )
-{
-    Set( r, g, b, a );
-}
+    /**
+     * @brief      a * b / 255, rounded
+     */
+    uint32_t Multiply( uint32_t a, uint32_t b )
+    {
+        const auto t = a * b + 128;
+        return ( t + ( t >> 8 ) ) >> 8;
+    }
 
-Color Color::operator - ( const Color& color ) const
-{
-    return Color( r() - color.r(), g() - color.g(), b() - color.b(), a() - color.a() );
-}
+    uint32_t Load( const Color* pColors, size_t index )
+    {
+        return pColors[ index ].packed();
+    }
 
-bool Color::operator == ( const Color& color ) const
-{
-    for( size_t i = 0; i < 4; ++i ) {
-        if( at( i ) != color( i ) ) {
-            return false;
-        }
+    void Store( Color* pColors, size_t index, uint32_t color )
+    {
+        memcpy( pColors[ index ].data(), &color, sizeof( color ) );
     }
-    return true;
-}
 
-bool Color::operator == ( uint32_t Hex ) const
-{
-    return hex() == Hex;
-}
+#if defined( HAZE_SSE2 )
+    __m128i Load4( const Color* pColors, size_t index )
+    {
+        return _mm_loadu_si128( reinterpret_cast< const __m128i* >( pColors + index ) );
+    }
 
-bool Color::operator != ( const Color& color ) const
-{
-    return !( *this == color );
-}
+    void Store4( Color* pColors, size_t index, __m128i colors )
+    {
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( pColors + index ), colors );
+    }
 
-bool Color::operator != ( uint32_t hex ) const
-{
-    return !( *this == hex );
+    /**
+     * @brief      Broadcast the alpha of each pixel in 16 bit lanes to its four channels
+     */
+    __m128i SpreadAlpha( __m128i pixels )
+    {
+        return _mm_shufflehi_epi16( _mm_shufflelo_epi16( pixels, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) );
+    }
+#endif
 }
 
 byte& Color::operator [] ( size_t iIndex )
@@ -71,19 +74,14 @@ const byte& Color::operator () ( size_t iIndex ) const
     return at( iIndex );
 }
 
-array< byte, 4 > Color::get( void ) const
-{
-    return m_cColor;
-}
-
 byte* Color::data( void )
 {
-    return m_cColor.data();
+    return reinterpret_cast< byte* >( &m_nColor );
 }
 
 const byte* Color::data( void ) const
 {
-    return m_cColor.data();
+    return reinterpret_cast< const byte* >( &m_nColor );
 }
 
 byte& Color::at( size_t iIndex )
@@ -91,7 +89,7 @@ byte& Color::at( size_t iIndex )
     if( iIndex > 3 ) {
         iIndex = 3;
     }
-    return m_cColor.at( iIndex );
+    return data()[ iIndex ];
 }
 
 const byte& Color::at( size_t iIndex ) const
@@ -99,80 +97,101 @@ const byte& Color::at( size_t iIndex ) const
     if( iIndex > 3 ) {
         iIndex = 3;
     }
-    return m_cColor.at( iIndex );
+    return data()[ iIndex ];
 }
 
-Color Color::operator + ( const Color& color )
+void Color::Add( const Color* pA, const Color* pB, Color* pResult, size_t count )
 {
-    array< byte, 4 > cColor;
-    for( size_t i = 0; i < 4; ++i ) {
-        cColor.at( i ) = Clamp( at( i ) + color( i ) );
+    size_t i = 0;
+#if defined( HAZE_SSE2 )
+    for( ; i + 4 <= count; i += 4 ) {
+        Store4( pResult, i, _mm_adds_epu8( Load4( pA, i ), Load4( pB, i ) ) );
     }
-    return Color( cColor );
-}
-
-Color& Color::operator += ( const Color& color )
-{
-    for( size_t i = 0; i < 4; ++i ) {
-        at( i ) = Clamp( at( i ) + color( i ) );
+#endif
+    for( ; i < count; ++i ) {
+        Store( pResult, i, AddSaturated( Load( pA, i ), Load( pB, i ) ) );
     }
-    return *this;
 }
 
-Color Color::operator - ( const Color& color )
+void Color::Subtract( const Color* pA, const Color* pB, Color* pResult, size_t count )
 {
-    array< byte, 4 > cColor;
-    for( size_t i = 0; i < 4; ++i ) {
-        cColor.at( i ) = Clamp( at( i ) - color( i ) );
+    size_t i = 0;
+#if defined( HAZE_SSE2 )
+    for( ; i + 4 <= count; i += 4 ) {
+        Store4( pResult, i, _mm_subs_epu8( Load4( pA, i ), Load4( pB, i ) ) );
     }
-    return Color( cColor );
-}
-
-Color& Color::operator -= ( const Color& color )
-{
-    for( size_t i = 0; i < 4; ++i ) {
-        at( i ) = Clamp( at( i ) - color( i ) );
+#endif
+    for( ; i < count; ++i ) {
+        Store( pResult, i, SubtractSaturated( Load( pA, i ), Load( pB, i ) ) );
     }
-    return *this;
-}
-
-int32_t Color::r( void ) const
-{
-    return static_cast< int32_t >( at( 0 ) );
-}
-
-int32_t Color::g( void ) const
-{
-    return static_cast< int32_t >( at( 1 ) );
 }
 
-int32_t Color::b( void ) const
-{
-    return static_cast< int32_t >( at( 2 ) );
-}
-
-int32_t Color::a( void ) const
-{
-    return static_cast< int32_t >( at( 3 ) );
+void Color::Lerp( const Color* pA, const Color* pB, float t, Color* pResult, size_t count )
+{
+    // a * ( 256 - w ) + b * w stays below 65536, so 16 bit lanes hold it
+    const auto weight = static_cast< uint32_t >( ( t > 0.f ? ( t < 1.f ? t : 1.f ) : 0.f ) * 256.f + 0.5f );
+    size_t i = 0;
+#if defined( HAZE_SSE2 )
+    const auto zero = _mm_setzero_si128();
+    const auto weightA = _mm_set1_epi16( static_cast< short >( 256 - weight ) );
+    const auto weightB = _mm_set1_epi16( static_cast< short >( weight ) );
+    for( ; i + 4 <= count; i += 4 ) {
+        const auto a = Load4( pA, i ), b = Load4( pB, i );
+        const auto lo = _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( a, zero ), weightA ), _mm_mullo_epi16( _mm_unpacklo_epi8( b, zero ), weightB ) );
+        const auto hi = _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( a, zero ), weightA ), _mm_mullo_epi16( _mm_unpackhi_epi8( b, zero ), weightB ) );
+        Store4( pResult, i, _mm_packus_epi16( _mm_srli_epi16( lo, 8 ), _mm_srli_epi16( hi, 8 ) ) );
+    }
+#endif
+    for( ; i < count; ++i ) {
+        const auto a = Load( pA, i ), b = Load( pB, i );
+        const auto rb = ( ( a & 0x00FF00FF ) * ( 256 - weight ) + ( b & 0x00FF00FF ) * weight ) >> 8;
+        const auto ga = ( ( a >> 8 ) & 0x00FF00FF ) * ( 256 - weight ) + ( ( b >> 8 ) & 0x00FF00FF ) * weight;
+        Store( pResult, i, ( rb & 0x00FF00FF ) | ( ga & 0xFF00FF00 ) );
+    }
 }
 
-uint32_t Color::hex( void ) const
+void Color::Blend( const Color* pSource, const Color* pDestination, Color* pResult, size_t count )
 {
-    return static_cast< uint32_t >( ( at( 3 ) << 24 ) | ( at( 0 ) << 16 ) | ( at( 1 ) << 8 ) | at( 2 ) );
+    size_t i = 0;
+#if defined( HAZE_SSE2 )
+    const auto zero = _mm_setzero_si128();
+    const auto limit = _mm_set1_epi16( 256 );
+    for( ; i + 4 <= count; i += 4 ) {
+        const auto source = Load4( pSource, i ), destination = Load4( pDestination, i );
+        const auto sourceLo = _mm_unpacklo_epi8( source, zero ), sourceHi = _mm_unpackhi_epi8( source, zero );
+        const auto lo = _mm_mullo_epi16( _mm_unpacklo_epi8( destination, zero ), _mm_sub_epi16( limit, SpreadAlpha( sourceLo ) ) );
+        const auto hi = _mm_mullo_epi16( _mm_unpackhi_epi8( destination, zero ), _mm_sub_epi16( limit, SpreadAlpha( sourceHi ) ) );
+        Store4( pResult, i, _mm_adds_epu8( source, _mm_packus_epi16( _mm_srli_epi16( lo, 8 ), _mm_srli_epi16( hi, 8 ) ) ) );
+    }
+#endif
+    for( ; i < count; ++i ) {
+        const auto source = Load( pSource, i );
+        Store( pResult, i, AddSaturated( source, Scale( Load( pDestination, i ), 256 - ( source >> 24 ) ) ) );
+    }
 }
 
-void Color::Set( int32_t r, int32_t g, int32_t b, int32_t a )
-{
-    at( 0 ) = Clamp( r );
-    at( 1 ) = Clamp( g );
-    at( 2 ) = Clamp( b );
-    at( 3 ) = Clamp( a );
+void Color::Premultiply( const Color* pColors, Color* pResult, size_t count )
+{
+    size_t i = 0;
+#if defined( HAZE_SSE2 )
+    // c * a / 255 rounded as in Multiply, alpha itself is kept
+    const auto zero = _mm_setzero_si128();
+    const auto bias = _mm_set1_epi16( 128 );
+    const auto alphaMask = _mm_set1_epi32( static_cast< int >( 0xFF000000 ) );
+    for( ; i + 4 <= count; i += 4 ) {
+        const auto colors = Load4( pColors, i );
+        auto lo = _mm_unpacklo_epi8( colors, zero ), hi = _mm_unpackhi_epi8( colors, zero );
+        lo = _mm_add_epi16( _mm_mullo_epi16( lo, SpreadAlpha( lo ) ), bias );
+        hi = _mm_add_epi16( _mm_mullo_epi16( hi, SpreadAlpha( hi ) ), bias );
+        lo = _mm_srli_epi16( _mm_add_epi16( lo, _mm_srli_epi16( lo, 8 ) ), 8 );
+        hi = _mm_srli_epi16( _mm_add_epi16( hi, _mm_srli_epi16( hi, 8 ) ), 8 );
+        const auto scaled = _mm_packus_epi16( lo, hi );
+        Store4( pResult, i, _mm_or_si128( _mm_andnot_si128( alphaMask, scaled ), _mm_and_si128( alphaMask, colors ) ) );
+    }
+#endif
+    for( ; i < count; ++i ) {
+        const auto color = Load( pColors, i );
+        const auto a = color >> 24;
+        Store( pResult, i, Multiply( color & 0xFF, a ) | ( Multiply( ( color >> 8 ) & 0xFF, a ) << 8 ) | ( Multiply( ( color >> 16 ) & 0xFF, a ) << 16 ) | ( a << 24 ) );
+    }
 }
-
-void Color::Set( uint32_t hex )
-{
-    at( 3 ) = static_cast< byte >( ( hex >> 24 ) & 0xFF );
-    at( 0 ) = static_cast< byte >( ( hex >> 16 ) & 0xFF );
-    at( 1 ) = static_cast< byte >( ( hex >> 8 ) & 0xFF );
-    at( 2 ) = static_cast< byte >( hex & 0xFF );
-}
\ No newline at end of file
@@ -1,26 +1,45 @@
 #pragma once
+#include <algorithm>
 #include <array>
+#include <cstdint>
 
 namespace haze {
     using namespace std;
     using byte = unsigned char;
 
+    /**
+     * @brief      Normalized color channels
+     */
+    struct ColorF
+    {
+        float r;
+        float g;
+        float b;
+        float a;
+    };
+
+    /**
+     * @brief      Color is a single packed 32 bit value with red in the lowest
+     *             byte, the layout of the software backend pixels. On the
+     *             little endian targets the bytes lie in memory as r, g, b, a.
+     *             Arithmetic saturates every channel to 0..255. Everything
+     *             but the byte references is constexpr.
+     */
     class Color
     {
     public:
-        Color( void );
-        Color( const array< byte, 4 >& color );
-        Color( uint32_t hex );
-        Color( int32_t r, int32_t g, int32_t b, int32_t a = 255 );
-        Color operator + ( const Color& color );
-        Color& operator += ( const Color& color );
-        Color operator - ( const Color& color );
-        Color& operator -= ( const Color& color );
-        Color operator - ( const Color& color ) const;
-        bool operator == ( const Color& color ) const;
-        bool operator == ( uint32_t hex ) const;
-        bool operator != ( const Color& color ) const;
-        bool operator != ( uint32_t hex ) const;
+        constexpr Color( void );
+        constexpr Color( const array< byte, 4 >& color );
+        constexpr Color( uint32_t hex );
+        constexpr Color( int32_t r, int32_t g, int32_t b, int32_t a = 255 );
+        constexpr Color operator + ( const Color& color ) const;
+        constexpr Color& operator += ( const Color& color );
+        constexpr Color operator - ( const Color& color ) const;
+        constexpr Color& operator -= ( const Color& color );
+        constexpr bool operator == ( const Color& color ) const;
+        constexpr bool operator == ( uint32_t hex ) const;
+        constexpr bool operator != ( const Color& color ) const;
+        constexpr bool operator != ( uint32_t hex ) const;
         byte& operator [] ( size_t iIndex );
         const byte& operator [] ( size_t iIndex ) const;
         byte& operator () ( size_t iIndex );        
@@ -31,7 +50,7 @@ namespace haze {
          *
          * @return     array< byte, 4 >
          */
-        array< byte, 4 > get( void ) const;
+        constexpr array< byte, 4 > get( void ) const;
 
         /**
          * @brief      Return the raw data pointer
@@ -70,35 +89,35 @@ namespace haze {
         *
         * @return     <> int
         */
-        int32_t r( void ) const;
+        constexpr int32_t r( void ) const;
 
         /**
         * @brief      Return the green color
         *
         * @return     <> int
         */
-        int32_t g( void ) const;
+        constexpr int32_t g( void ) const;
 
         /**
         * @brief      Return the blue color
         *
         * @return     <> int
         */
-        int32_t b( void ) const;
+        constexpr int32_t b( void ) const;
 
         /**
         * @brief      Return the alpha color
         *
         * @return     <> int
         */
-        int32_t a( void ) const;
+        constexpr int32_t a( void ) const;
 
         /**
         * @brief      Return the rgba color as hex
         *
         * @return     <> uint32_t <> hex
         */
-        uint32_t hex( void ) const;
+        constexpr uint32_t hex( void ) const;
 
         /**
         * @brief      Set rgba color
@@ -108,14 +127,14 @@ namespace haze {
         * @param[in]  b     <> int <> blue
         * @param[in]  a     <> int <> alpha (default: 255)
         */
-        void Set( int32_t r, int32_t g, int32_t b, int32_t a = 255 );
+        constexpr void Set( int32_t r, int32_t g, int32_t b, int32_t a = 255 );
 
         /**
         * @brief      Set rgba by hex color
         *
         * @param[in]  hex   <> uint32_t <> hex color
         */
-        void Set( uint32_t hex );
+        constexpr void Set( uint32_t hex );
 
         /**
         * @brief      Return the red color as a specific type cast
@@ -124,7 +143,7 @@ namespace haze {
         *
         * @return     Red color as custom type
         */
-        template< typename T > T R( void ) const;
+        template< typename T > constexpr T R( void ) const;
 
         /**
         * @brief      Return the green color as a specific type cast
@@ -133,7 +152,7 @@ namespace haze {
         *
         * @return     Green color as custom type
         */
-        template< typename T > T G( void ) const;
+        template< typename T > constexpr T G( void ) const;
 
         /**
         * @brief      Return the blue color as a specific type cast
@@ -142,7 +161,7 @@ namespace haze {
         *
         * @return     Blue color as custom type
         */
-        template< typename T > T B( void ) const;
+        template< typename T > constexpr T B( void ) const;
 
         /**
         * @brief      Return the alpha color as a specific type cast
@@ -151,40 +170,367 @@ namespace haze {
         *
         * @return     Alpha color as custom type
         */
-        template< typename T > T A( void ) const;
+        template< typename T > constexpr T A( void ) const;
+
+        /**
+        * @brief      Return the packed color, red in the lowest byte
+        *
+        * @return     <> uint32_t
+        */
+        constexpr uint32_t packed( void ) const;
+
+        /**
+        * @brief      Return the normalized channels
+        *
+        * @return     <> ColorF
+        */
+        constexpr ColorF ToFloat( void ) const;
+
+        /**
+        * @brief      Return the normalized channels multiplied by alpha
+        *
+        * @return     <> ColorF
+        */
+        constexpr ColorF ToPremultipliedFloat( void ) const;
+
+        /**
+        * @brief      Add two spans of colors, saturating every channel
+        *
+        * @param[in]  pA       <> const Color* <> first summands
+        * @param[in]  pB       <> const Color* <> second summands
+        * @param[out] pResult  <> Color* <> sums, may alias pA or pB
+        * @param[in]  count    <> size_t <> number of colors
+        */
+        static void Add( const Color* pA, const Color* pB, Color* pResult, size_t count );
+
+        /**
+        * @brief      Subtract two spans of colors, saturating every channel
+        *
+        * @param[in]  pA       <> const Color* <> minuends
+        * @param[in]  pB       <> const Color* <> subtrahends
+        * @param[out] pResult  <> Color* <> differences, may alias pA or pB
+        * @param[in]  count    <> size_t <> number of colors
+        */
+        static void Subtract( const Color* pA, const Color* pB, Color* pResult, size_t count );
+
+        /**
+        * @brief      Interpolate between two spans of colors
+        *
+        * @param[in]  pA       <> const Color* <> colors at t = 0
+        * @param[in]  pB       <> const Color* <> colors at t = 1
+        * @param[in]  t        <> float <> weight of pB, clamped to 0..1
+        * @param[out] pResult  <> Color* <> may alias pA or pB
+        * @param[in]  count    <> size_t <> number of colors
+        */
+        static void Lerp( const Color* pA, const Color* pB, float t, Color* pResult, size_t count );
+
+        /**
+        * @brief      Blend premultiplied colors over others (source over)
+        *
+        * @param[in]  pSource       <> const Color* <> premultiplied colors on top
+        * @param[in]  pDestination  <> const Color* <> premultiplied colors below
+        * @param[out] pResult       <> Color* <> may alias either input
+        * @param[in]  count         <> size_t <> number of colors
+        */
+        static void Blend( const Color* pSource, const Color* pDestination, Color* pResult, size_t count );
+
+        /**
+        * @brief      Multiply red, green and blue by alpha
+        *
+        * @param[in]  pColors  <> const Color* <> straight alpha colors
+        * @param[out] pResult  <> Color* <> premultiplied colors, may alias pColors
+        * @param[in]  count    <> size_t <> number of colors
+        */
+        static void Premultiply( const Color* pColors, Color* pResult, size_t count );
 
     private:
         template< typename T >
-        static byte Clamp( T value )
+        static constexpr uint32_t Clamp( T value )
         {
             auto i = static_cast< int32_t >( value );
-            i = min( i, 0x00 ); 
-            i = max( i, 0xFF );
-            return static_cast< byte >( i );
+            i = max( i, 0x00 );
+            i = min( i, 0xFF );
+            return static_cast< uint32_t >( i );
         }
 
+        static constexpr uint32_t Pack( int32_t r, int32_t g, int32_t b, int32_t a );
+        static constexpr uint32_t SwapRedBlue( uint32_t color );
+        static constexpr uint32_t Spread( uint32_t bits );
+        static constexpr uint32_t AddSaturated( uint32_t a, uint32_t b );
+        static constexpr uint32_t SubtractSaturated( uint32_t a, uint32_t b );
+
     private:
-        array< byte, 4 > m_cColor;
+        uint32_t m_nColor;
     };
 
-    
-    template< typename T > T Color::R( void ) const
+    /**
+     * @brief      CPalette holds a fixed set of colors together with their
+     *             premultiplied float form, both computed at compile time:
+     *
+     *             constexpr auto theme = MakePalette( 0x202020_rgb, 0xC0FF8000_argb );
+     */
+    template< size_t N >
+    class CPalette
+    {
+    public:
+        template< typename... TColors >
+        constexpr CPalette( const TColors&... colors );
+
+        constexpr const Color&  operator [] ( size_t index ) const;
+
+        /**
+         * @brief      Get the premultiplied normalized channels of a color
+         *
+         * @param[in]  index  <> size_t <> color
+         *
+         * @return     <> const ColorF&
+         */
+        constexpr const ColorF& GetPremultiplied( size_t index ) const;
+
+        constexpr size_t        size( void ) const;
+
+    private:
+        array< Color, N >  m_cColors;
+        array< ColorF, N > m_cPremultiplied;
+    };
+
+    /**
+     * @brief      Build a palette, the size follows from the arguments
+     *
+     * @param[in]  colors  <> Color or anything a Color is constructed from
+     *
+     * @return     <> CPalette
+     */
+    template< typename... TColors >
+    constexpr CPalette< sizeof...( TColors ) > MakePalette( const TColors&... colors );
+
+    inline namespace literals {
+        /**
+         * @brief      0xAARRGGBB_argb
+         */
+        constexpr Color operator "" _argb( unsigned long long hex );
+
+        /**
+         * @brief      0xRRGGBB_rgb, opaque
+         */
+        constexpr Color operator "" _rgb( unsigned long long hex );
+    }
+
+    constexpr Color::Color( void ) :
+        m_nColor( 0xFFFFFFFF )
     {
-        return static_cast< T >( m_cColor.at( 0 ) );
     }
 
-    template< typename T > T Color::G( void ) const
+    constexpr Color::Color( const array< byte, 4 >& color ) :
+        m_nColor( Pack( color[ 0 ], color[ 1 ], color[ 2 ], color[ 3 ] ) )
     {
-        return static_cast< T >( m_cColor.at( 1 ) );
     }
 
-    template< typename T > T Color::B( void ) const
+    constexpr Color::Color( uint32_t hex ) :
+        m_nColor( SwapRedBlue( hex ) )
     {
-        return static_cast< T >( m_cColor.at( 2 ) );
+    }
+
+    constexpr Color::Color( int32_t r, int32_t g, int32_t b, int32_t a ) :
+        m_nColor( Pack( r, g, b, a ) )
+    {
+    }
+
+    constexpr Color Color::operator + ( const Color& color ) const
+    {
+        auto result = *this;
+        return result += color;
+    }
+
+    constexpr Color& Color::operator += ( const Color& color )
+    {
+        m_nColor = AddSaturated( m_nColor, color.m_nColor );
+        return *this;
+    }
+
+    constexpr Color Color::operator - ( const Color& color ) const
+    {
+        auto result = *this;
+        return result -= color;
+    }
+
+    constexpr Color& Color::operator -= ( const Color& color )
+    {
+        m_nColor = SubtractSaturated( m_nColor, color.m_nColor );
+        return *this;
+    }
+
+    constexpr bool Color::operator == ( const Color& color ) const
+    {
+        return m_nColor == color.m_nColor;
+    }
+
+    constexpr bool Color::operator == ( uint32_t hex ) const
+    {
+        return this->hex() == hex;
+    }
+
+    constexpr bool Color::operator != ( const Color& color ) const
+    {
+        return !( *this == color );
+    }
+
+    constexpr bool Color::operator != ( uint32_t hex ) const
+    {
+        return !( *this == hex );
+    }
+
+    constexpr array< byte, 4 > Color::get( void ) const
+    {
+        return { { static_cast< byte >( r() ), static_cast< byte >( g() ), static_cast< byte >( b() ), static_cast< byte >( a() ) } };
+    }
+
+    constexpr int32_t Color::r( void ) const
+    {
+        return static_cast< int32_t >( m_nColor & 0xFF );
+    }
+
+    constexpr int32_t Color::g( void ) const
+    {
+        return static_cast< int32_t >( ( m_nColor >> 8 ) & 0xFF );
+    }
+
+    constexpr int32_t Color::b( void ) const
+    {
+        return static_cast< int32_t >( ( m_nColor >> 16 ) & 0xFF );
+    }
+
+    constexpr int32_t Color::a( void ) const
+    {
+        return static_cast< int32_t >( m_nColor >> 24 );
+    }
+
+    constexpr uint32_t Color::hex( void ) const
+    {
+        return SwapRedBlue( m_nColor );
+    }
+
+    constexpr uint32_t Color::packed( void ) const
+    {
+        return m_nColor;
+    }
+
+    constexpr ColorF Color::ToFloat( void ) const
+    {
+        return { static_cast< float >( r() ) / 255.f, static_cast< float >( g() ) / 255.f, static_cast< float >( b() ) / 255.f, static_cast< float >( a() ) / 255.f };
+    }
+
+    constexpr ColorF Color::ToPremultipliedFloat( void ) const
+    {
+        const auto alpha = static_cast< float >( a() ) / 255.f;
+        return { static_cast< float >( r() ) / 255.f * alpha, static_cast< float >( g() ) / 255.f * alpha, static_cast< float >( b() ) / 255.f * alpha, alpha };
+    }
+
+    constexpr void Color::Set( int32_t r, int32_t g, int32_t b, int32_t a )
+    {
+        m_nColor = Pack( r, g, b, a );
+    }
+
+    constexpr void Color::Set( uint32_t hex )
+    {
+        m_nColor = SwapRedBlue( hex );
+    }
+
+    constexpr uint32_t Color::Pack( int32_t r, int32_t g, int32_t b, int32_t a )
+    {
+        return Clamp( r ) | ( Clamp( g ) << 8 ) | ( Clamp( b ) << 16 ) | ( Clamp( a ) << 24 );
+    }
+
+    constexpr uint32_t Color::SwapRedBlue( uint32_t color )
+    {
+        return ( color & 0xFF00FF00 ) | ( ( color & 0xFF ) << 16 ) | ( ( color >> 16 ) & 0xFF );
+    }
+
+    constexpr uint32_t Color::Spread( uint32_t bits )
+    {
+        // widen the top bit of every byte to the whole byte
+        return ( bits << 1 ) - ( bits >> 7 );
+    }
+
+    constexpr uint32_t Color::AddSaturated( uint32_t a, uint32_t b )
+    {
+        // the low seven bits can't carry into the neighbour, the top bits are added without carry
+        const auto sum = ( ( a & 0x7F7F7F7F ) + ( b & 0x7F7F7F7F ) ) ^ ( ( a ^ b ) & 0x80808080 );
+        const auto carry = ( ( a & b ) | ( ( a | b ) & ~sum ) ) & 0x80808080;
+        return sum | Spread( carry );
+    }
+
+    constexpr uint32_t Color::SubtractSaturated( uint32_t a, uint32_t b )
+    {
+        const auto difference = ( ( a | 0x80808080 ) - ( b & 0x7F7F7F7F ) ) ^ ( ( a ^ ~b ) & 0x80808080 );
+        const auto borrow = ( ( ~a & b ) | ( ~( a ^ b ) & difference ) ) & 0x80808080;
+        return difference & ~Spread( borrow );
+    }
+
+    static_assert( sizeof( Color ) == sizeof( uint32_t ), "spans of Color are processed as packed pixels" );
+
+    template< typename T > constexpr T Color::R( void ) const
+    {
+        return static_cast< T >( r() );
+    }
+
+    template< typename T > constexpr T Color::G( void ) const
+    {
+        return static_cast< T >( g() );
+    }
+
+    template< typename T > constexpr T Color::B( void ) const
+    {
+        return static_cast< T >( b() );
     }
     
-    template< typename T > T Color::A( void ) const
+    template< typename T > constexpr T Color::A( void ) const
     {
-        return static_cast< T >( m_cColor.at( 3 ) );
+        return static_cast< T >( a() );
+    }
+
+    template< size_t N >
+    template< typename... TColors >
+    constexpr CPalette< N >::CPalette( const TColors&... colors ) :
+        m_cColors{ { Color( colors )... } },
+        m_cPremultiplied{ { Color( colors ).ToPremultipliedFloat()... } }
+    {
+        static_assert( sizeof...( TColors ) == N, "a palette is built from exactly N colors" );
+    }
+
+    template< size_t N >
+    constexpr const Color& CPalette< N >::operator [] ( size_t index ) const
+    {
+        return m_cColors[ index ];
+    }
+
+    template< size_t N >
+    constexpr const ColorF& CPalette< N >::GetPremultiplied( size_t index ) const
+    {
+        return m_cPremultiplied[ index ];
+    }
+
+    template< size_t N >
+    constexpr size_t CPalette< N >::size( void ) const
+    {
+        return N;
+    }
+
+    template< typename... TColors >
+    constexpr CPalette< sizeof...( TColors ) > MakePalette( const TColors&... colors )
+    {
+        return CPalette< sizeof...( TColors ) >( colors... );
+    }
+
+    inline namespace literals {
+        constexpr Color operator "" _argb( unsigned long long hex )
+        {
+            return Color( static_cast< uint32_t >( hex ) );
+        }
+
+        constexpr Color operator "" _rgb( unsigned long long hex )
+        {
+            return Color( static_cast< uint32_t >( hex ) | 0xFF000000 );
+        }
     }
 }
\ No newline at end of file
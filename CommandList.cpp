@@ -0,0 +1,462 @@
+#include "CommandList.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+using namespace haze;
+
+static_assert( sizeof( DrawCommand ) == offsetof( DrawCommand, pFont ) + sizeof( void* ), "DrawCommand must not contain padding" );
+
+bool ICommandSink::FillRects( const RectF* pRects, size_t count, uint32_t color )
+{
+    if( !pRects ) {
+        return false;
+    }
+
+    auto result = true;
+    for( size_t i = 0; i < count; ++i ) {
+        result &= FillRect( pRects[ i ].x, pRects[ i ].y, pRects[ i ].w, pRects[ i ].h, color );
+    }
+    return result;
+}
+
+bool ICommandSink::FillColoredRects( const ColoredRect* pRects, size_t count )
+{
+    if( !pRects ) {
+        return false;
+    }
+
+    auto result = true;
+    for( size_t i = 0; i < count; ++i ) {
+        result &= FillRect( pRects[ i ].x, pRects[ i ].y, pRects[ i ].w, pRects[ i ].h, pRects[ i ].color.hex() );
+    }
+    return result;
+}
+
+bool ICommandSink::FillBorderBoxes( const ColoredBorderBox* pBoxes, size_t count )
+{
+    if( !pBoxes ) {
+        return false;
+    }
+
+    auto result = true;
+    RectF rects[ 4 ];
+    for( size_t i = 0; i < count; ++i ) {
+        result &= FillRects( rects, SplitBorderBox( pBoxes[ i ], rects ), pBoxes[ i ].color.hex() );
+    }
+    return result;
+}
+
+bool ICommandSink::Lines( const ColoredLine* pLines, size_t count )
+{
+    if( !pLines ) {
+        return false;
+    }
+
+    auto result = true;
+    for( size_t i = 0; i < count; ++i ) {
+        result &= Line( pLines[ i ].x, pLines[ i ].y, pLines[ i ].xx, pLines[ i ].yy, pLines[ i ].thickness, pLines[ i ].color.hex() );
+    }
+    return result;
+}
+
+bool ICommandSink::Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color )
+{
+    if( !pPoints || count < 2 ) {
+        return false;
+    }
+
+    auto result = true;
+    for( size_t i = 1; i < count; ++i ) {
+        result &= Line( pPoints[ i - 1 ].x, pPoints[ i - 1 ].y, pPoints[ i ].x, pPoints[ i ].y, thickness, color );
+    }
+    return result;
+}
+
+size_t haze::SplitBorderBox( const ColoredBorderBox& box, RectF* pRects )
+{
+    const auto t = box.thickness;
+
+    // without an opening the box is one rectangle
+    if( box.w <= t || box.h <= t ) {
+        pRects[ 0 ] = { box.x, box.y, box.w + t, box.h + t };
+        return 1;
+    }
+
+    // full width rows and the columns in between, every pixel is drawn once
+    pRects[ 0 ] = { box.x, box.y, box.w + t, t };
+    pRects[ 1 ] = { box.x, box.y + box.h, box.w + t, t };
+    pRects[ 2 ] = { box.x, box.y + t, t, box.h - t };
+    pRects[ 3 ] = { box.x + box.w, box.y + t, t, box.h - t };
+    return 4;
+}
+
+bool CCommandList::FillRect( float x, float y, float w, float h, uint32_t color )
+{
+    DrawCommand command = {};
+    command.eType  = DrawCommandType::Rect;
+    command.nColor = color;
+    command.x      = x;
+    command.y      = y;
+    command.w      = w;
+    command.h      = h;
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color )
+{
+    DrawCommand command = {};
+    command.eType  = DrawCommandType::RoundedRect;
+    command.nColor = color;
+    command.x      = x;
+    command.y      = y;
+    command.w      = w;
+    command.h      = h;
+    command.x_rad  = x_rad;
+    command.y_rad  = y_rad;
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color )
+{
+    DrawCommand command = {};
+    command.eType       = DrawCommandType::RoundedFrame;
+    command.nColor      = color;
+    command.x           = x;
+    command.y           = y;
+    command.w           = w;
+    command.h           = h;
+    command.x_rad       = x_rad;
+    command.y_rad       = y_rad;
+    command.thickness   = thickness;
+    command.inner_x_rad = inner_x_rad;
+    command.inner_y_rad = inner_y_rad;
+    command.nInnerColor = inner_color;
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::Line( float x, float y, float xx, float yy, float thickness, uint32_t color )
+{
+    DrawCommand command = {};
+    command.eType     = DrawCommandType::Line;
+    command.nColor    = color;
+    command.x         = x;
+    command.y         = y;
+    command.w         = xx;
+    command.h         = yy;
+    command.thickness = thickness;
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::FillColoredRects( const ColoredRect* pRects, size_t count )
+{
+    if( !pRects ) {
+        return false;
+    }
+
+    Reserve( count );
+    for( size_t i = 0; i < count; ++i ) {
+        FillRect( pRects[ i ].x, pRects[ i ].y, pRects[ i ].w, pRects[ i ].h, pRects[ i ].color.hex() );
+    }
+    return true;
+}
+
+bool CCommandList::Lines( const ColoredLine* pLines, size_t count )
+{
+    if( !pLines ) {
+        return false;
+    }
+
+    Reserve( count );
+    for( size_t i = 0; i < count; ++i ) {
+        Line( pLines[ i ].x, pLines[ i ].y, pLines[ i ].xx, pLines[ i ].yy, pLines[ i ].thickness, pLines[ i ].color.hex() );
+    }
+    return true;
+}
+
+bool CCommandList::Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color )
+{
+    if( !pPoints || count < 2 ) {
+        return false;
+    }
+
+    auto x0 = pPoints[ 0 ].x, y0 = pPoints[ 0 ].y, x1 = x0, y1 = y0;
+    for( size_t i = 1; i < count; ++i ) {
+        x0 = min( x0, pPoints[ i ].x );
+        y0 = min( y0, pPoints[ i ].y );
+        x1 = max( x1, pPoints[ i ].x );
+        y1 = max( y1, pPoints[ i ].y );
+    }
+
+    DrawCommand command = {};
+    command.eType       = DrawCommandType::Polyline;
+    command.nColor      = color;
+    command.x           = x0;
+    command.y           = y0;
+    command.w           = x1 - x0;
+    command.h           = y1 - y0;
+    command.thickness   = thickness;
+    command.nTextOffset = static_cast< uint32_t >( m_cPoints.size() );
+    command.nTextLength = static_cast< uint32_t >( count );
+
+    m_cPoints.insert( m_cPoints.end(), pPoints, pPoints + count );
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color )
+{
+    if( !text || !pFont ) {
+        return false;
+    }
+
+    DrawCommand command = {};
+    command.eType       = DrawCommandType::Text;
+    command.nColor      = color;
+    command.x           = x;
+    command.y           = y;
+    command.w           = w;
+    command.h           = h;
+    command.nTextOffset = static_cast< uint32_t >( m_cText.size() );
+    command.nTextLength = static_cast< uint32_t >( length );
+    command.pFont       = pFont;
+
+    m_cText.insert( m_cText.end(), text, text + length );
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::SetTransform( const Transform& transform )
+{
+    DrawCommand command = {};
+    command.eType = DrawCommandType::Transform;
+    command.x     = transform.m11;
+    command.y     = transform.m12;
+    command.w     = transform.m21;
+    command.h     = transform.m22;
+    command.x_rad = transform.dx;
+    command.y_rad = transform.dy;
+    m_cCommands.push_back( command );
+    return true;
+}
+
+bool CCommandList::SetAntialiasMode( AntialiasMode mode )
+{
+    DrawCommand command = {};
+    command.eType  = DrawCommandType::AntialiasMode;
+    command.nColor = static_cast< uint32_t >( mode );
+    m_cCommands.push_back( command );
+    return true;
+}
+
+void CCommandList::Reset( void )
+{
+    m_cCommands.clear();
+    m_cText.clear();
+    m_cPoints.clear();
+}
+
+void CCommandList::Append( const CCommandList& list )
+{
+    const auto offset = static_cast< uint32_t >( m_cText.size() );
+    const auto pointOffset = static_cast< uint32_t >( m_cPoints.size() );
+    const auto first = m_cCommands.size();
+
+    m_cCommands.insert( m_cCommands.end(), list.m_cCommands.begin(), list.m_cCommands.end() );
+    m_cText.insert( m_cText.end(), list.m_cText.begin(), list.m_cText.end() );
+    m_cPoints.insert( m_cPoints.end(), list.m_cPoints.begin(), list.m_cPoints.end() );
+
+    // the text and points of the appended commands moved behind the existing ones
+    for( auto i = first; i < m_cCommands.size(); ++i ) {
+        if( m_cCommands[ i ].eType == DrawCommandType::Text ) {
+            m_cCommands[ i ].nTextOffset += offset;
+        }
+        else if( m_cCommands[ i ].eType == DrawCommandType::Polyline ) {
+            m_cCommands[ i ].nTextOffset += pointOffset;
+        }
+    }
+}
+
+void CCommandList::Reserve( size_t count )
+{
+    // keep growing geometrically, a reserve per batch would reallocate for every small batch
+    const auto size = m_cCommands.size() + count;
+    if( size > m_cCommands.capacity() ) {
+        m_cCommands.reserve( max( size, 2 * m_cCommands.capacity() ) );
+    }
+}
+
+bool CCommandList::Replay( ICommandSink& sink ) const
+{
+    auto result = true;
+    for( const auto& command : m_cCommands ) {
+        result &= Replay( command, sink );
+    }
+    return result;
+}
+
+bool CCommandList::Replay( const DrawCommand& command, ICommandSink& sink ) const
+{
+    switch( command.eType ) {
+    case DrawCommandType::Rect:
+        return sink.FillRect( command.x, command.y, command.w, command.h, command.nColor );
+    case DrawCommandType::RoundedRect:
+        return sink.FillRoundedRect( command.x, command.y, command.w, command.h, command.x_rad, command.y_rad, command.nColor );
+    case DrawCommandType::RoundedFrame:
+        return sink.FillRoundedFrame( command.x, command.y, command.w, command.h, command.x_rad, command.y_rad, command.thickness, command.inner_x_rad, command.inner_y_rad, command.nColor, command.nInnerColor );
+    case DrawCommandType::Line:
+        return sink.Line( command.x, command.y, command.w, command.h, command.thickness, command.nColor );
+    case DrawCommandType::Polyline:
+        return sink.Polyline( GetPoints( command ), command.nTextLength, command.thickness, command.nColor );
+    case DrawCommandType::Text:
+        return sink.Text( command.x, command.y, command.w, command.h, GetText( command ), command.nTextLength, command.pFont, command.nColor );
+    case DrawCommandType::Transform:
+        return sink.SetTransform( { command.x, command.y, command.w, command.h, command.x_rad, command.y_rad } );
+    case DrawCommandType::AntialiasMode:
+        return sink.SetAntialiasMode( static_cast< AntialiasMode >( command.nColor ) );
+    }
+    return false;
+}
+
+uint64_t CCommandList::Hash( void ) const
+{
+    // fonts are hashed by address, which is stable for the lifetime of a font
+    const auto hash = Hash64( m_cCommands.data(), m_cCommands.size() * sizeof( DrawCommand ), m_cCommands.size() );
+    const auto text = Hash64( m_cText.data(), m_cText.size() * sizeof( wchar_t ), hash );
+    return Hash64( m_cPoints.data(), m_cPoints.size() * sizeof( PointF ), text );
+}
+
+const vector< DrawCommand >& CCommandList::GetCommands( void ) const
+{
+    return m_cCommands;
+}
+
+const wchar_t* CCommandList::GetText( const DrawCommand& command ) const
+{
+    if( command.eType != DrawCommandType::Text || m_cText.empty() ) {
+        return L"";
+    }
+    return m_cText.data() + command.nTextOffset;
+}
+
+const PointF* CCommandList::GetPoints( const DrawCommand& command ) const
+{
+    if( command.eType != DrawCommandType::Polyline || m_cPoints.empty() ) {
+        return nullptr;
+    }
+    return m_cPoints.data() + command.nTextOffset;
+}
+
+size_t CCommandList::size( void ) const
+{
+    return m_cCommands.size();
+}
+
+bool CCommandList::empty( void ) const
+{
+    return m_cCommands.empty();
+}
+
+bool CCountingCommandSink::FillRect( float, float, float, float, uint32_t )
+{
+    ++m_Counters.nRects;
+    return true;
+}
+
+bool CCountingCommandSink::FillRects( const RectF* pRects, size_t count, uint32_t )
+{
+    if( !pRects ) {
+        return false;
+    }
+
+    ++m_Counters.nBatches;
+    m_Counters.nBatchedRects += count;
+    return true;
+}
+
+bool CCountingCommandSink::FillColoredRects( const ColoredRect* pRects, size_t count )
+{
+    if( !pRects ) {
+        return false;
+    }
+
+    ++m_Counters.nBatches;
+    m_Counters.nBatchedRects += count;
+    return true;
+}
+
+bool CCountingCommandSink::FillRoundedRect( float, float, float, float, float, float, uint32_t )
+{
+    ++m_Counters.nRoundedRects;
+    return true;
+}
+
+bool CCountingCommandSink::FillRoundedFrame( float, float, float, float, float, float, float, float, float, uint32_t, uint32_t )
+{
+    ++m_Counters.nRoundedFrames;
+    return true;
+}
+
+bool CCountingCommandSink::Line( float, float, float, float, float, uint32_t )
+{
+    ++m_Counters.nLines;
+    return true;
+}
+
+bool CCountingCommandSink::Lines( const ColoredLine* pLines, size_t count )
+{
+    if( !pLines ) {
+        return false;
+    }
+
+    ++m_Counters.nBatches;
+    m_Counters.nBatchedLines += count;
+    return true;
+}
+
+bool CCountingCommandSink::Polyline( const PointF* pPoints, size_t count, float, uint32_t )
+{
+    if( !pPoints || count < 2 ) {
+        return false;
+    }
+
+    ++m_Counters.nPolylines;
+    m_Counters.nPolylinePoints += count;
+    return true;
+}
+
+bool CCountingCommandSink::Text( float, float, float, float, const wchar_t*, size_t length, const void*, uint32_t )
+{
+    ++m_Counters.nTexts;
+    m_Counters.nCharacters += length;
+    return true;
+}
+
+bool CCountingCommandSink::SetTransform( const Transform& )
+{
+    ++m_Counters.nStateChanges;
+    return true;
+}
+
+bool CCountingCommandSink::SetAntialiasMode( AntialiasMode )
+{
+    ++m_Counters.nStateChanges;
+    return true;
+}
+
+const CCountingCommandSink::Counters& CCountingCommandSink::GetCounters( void ) const
+{
+    return m_Counters;
+}
+
+uint64_t CCountingCommandSink::GetDrawCalls( void ) const
+{
+    return m_Counters.nRects + m_Counters.nBatches + m_Counters.nRoundedRects + m_Counters.nRoundedFrames + m_Counters.nLines + m_Counters.nPolylines + m_Counters.nTexts;
+}
+
+void CCountingCommandSink::Reset( void )
+{
+    m_Counters = Counters();
+}
@@ -0,0 +1,458 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Color.hpp"
+#include "Geometry.hpp"
+#include "RenderState.hpp"
+
+namespace haze {
+    using namespace std;
+
+    enum class DrawCommandType : uint32_t
+    {
+        Rect,
+        RoundedRect,
+        Line,
+        Text,
+        Transform,
+        AntialiasMode,
+        RoundedFrame,
+        Polyline
+    };
+
+    /**
+     * @brief      Rectangle of a batch with a color of its own
+     */
+    struct ColoredRect
+    {
+        float x;
+        float y;
+        float w;
+        float h;
+        Color color;
+    };
+
+    /**
+     * @brief      Line of a batch with a color of its own
+     */
+    struct ColoredLine
+    {
+        float x;
+        float y;
+        float xx;
+        float yy;
+        float thickness;
+        Color color;
+    };
+
+    /**
+     * @brief      Bordered box of a batch with a color of its own, the border
+     *             runs from x to x + w + thickness like CRenderSurface::BorderBox
+     */
+    struct ColoredBorderBox
+    {
+        float x;
+        float y;
+        float w;
+        float h;
+        float thickness;
+        Color color;
+    };
+
+    /**
+     * @brief      Split a bordered box into rectangles which do not overlap
+     *
+     * @param[in]  box     bordered box
+     * @param[out] pRects  four rectangles
+     *
+     * @return     size_t <> amount of rectangles, one for a box without an
+     *             opening
+     */
+    size_t SplitBorderBox( const ColoredBorderBox& box, RectF* pRects );
+
+    /**
+     * @brief      Compact draw command as recorded by a CCommandList.
+     *             Lines store their final position inside w and h, transforms
+     *             store their matrix inside x to y_rad and the antialias mode
+     *             inside nColor. Only rounded frames use the inner radii and
+     *             the inner color. Text commands reference a range inside the
+     *             text arena of the list, polylines a range inside the point
+     *             arena through the same fields and keep the bounds of their
+     *             points in x to h. The command has no padding, so the
+     *             commands of a list can be hashed as one block of memory.
+     */
+    struct DrawCommand
+    {
+        DrawCommandType eType;
+        uint32_t        nColor;
+        float           x;
+        float           y;
+        float           w;
+        float           h;
+        float           x_rad;
+        float           y_rad;
+        float           thickness;
+        float           inner_x_rad;
+        float           inner_y_rad;
+        uint32_t        nTextOffset;
+        uint32_t        nTextLength;
+        uint32_t        nInnerColor;
+        const void*     pFont;
+    };
+
+    /**
+     * @brief      ICommandSink receives draw calls, either directly from the
+     *             surface or while a CCommandList gets replayed. Every function
+     *             returns false when the sink wasn't able to process the call.
+     */
+    class ICommandSink
+    {
+    public:
+        virtual ~ICommandSink( void ) = default;
+
+        /**
+         * @brief      Fill a rectangle
+         *
+         * @param[in]  x      x-position
+         * @param[in]  y      y-position
+         * @param[in]  w      width
+         * @param[in]  h      height
+         * @param[in]  color  argb color
+         *
+         * @return     bool
+         */
+        virtual bool FillRect( float x, float y, float w, float h, uint32_t color ) = 0;
+
+        /**
+         * @brief      Fill multiple rectangles of the same color at once. The
+         *             default implementation falls back to FillRect.
+         *
+         * @param[in]  pRects  rectangles
+         * @param[in]  count   amount of rectangles
+         * @param[in]  color   argb color
+         *
+         * @return     bool
+         */
+        virtual bool FillRects( const RectF* pRects, size_t count, uint32_t color );
+
+        /**
+         * @brief      Fill a batch of rectangles with a color each. The
+         *             default implementation falls back to FillRect.
+         *
+         * @param[in]  pRects  rectangles
+         * @param[in]  count   amount of rectangles
+         *
+         * @return     bool
+         */
+        virtual bool FillColoredRects( const ColoredRect* pRects, size_t count );
+
+        /**
+         * @brief      Fill a batch of bordered boxes with a color each. The
+         *             default implementation falls back to FillRects.
+         *
+         * @param[in]  pBoxes  bordered boxes
+         * @param[in]  count   amount of boxes
+         *
+         * @return     bool
+         */
+        virtual bool FillBorderBoxes( const ColoredBorderBox* pBoxes, size_t count );
+
+        /**
+         * @brief      Fill a rounded rectangle
+         *
+         * @param[in]  x      x-position
+         * @param[in]  y      y-position
+         * @param[in]  w      width
+         * @param[in]  h      height
+         * @param[in]  x_rad  x-radius
+         * @param[in]  y_rad  y-radius
+         * @param[in]  color  argb color
+         *
+         * @return     bool
+         */
+        virtual bool FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color ) = 0;
+
+        /**
+         * @brief      Fill the ring between a rounded rectangle and its inset
+         *             by thickness, and the inset with a second color. Both
+         *             share their edge, so no pixel is drawn twice as it is
+         *             when a fill is drawn over a larger shape. Without room
+         *             for the inset the whole rectangle gets the ring color.
+         *
+         * @param[in]  x            x-position
+         * @param[in]  y            y-position
+         * @param[in]  w            width
+         * @param[in]  h            height
+         * @param[in]  x_rad        outer x-radius
+         * @param[in]  y_rad        outer y-radius
+         * @param[in]  thickness    width of the ring
+         * @param[in]  inner_x_rad  inner x-radius
+         * @param[in]  inner_y_rad  inner y-radius
+         * @param[in]  color        argb color of the ring
+         * @param[in]  inner_color  argb color of the inset, fully transparent
+         *                          leaves it empty
+         *
+         * @return     bool
+         */
+        virtual bool FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color ) = 0;
+
+        /**
+         * @brief      Draw a line
+         *
+         * @param[in]  x          x-initial-position
+         * @param[in]  y          y-initial-position
+         * @param[in]  xx         x-final-position
+         * @param[in]  yy         y-final-position
+         * @param[in]  thickness  thickness
+         * @param[in]  color      argb color
+         *
+         * @return     bool
+         */
+        virtual bool Line( float x, float y, float xx, float yy, float thickness, uint32_t color ) = 0;
+
+        /**
+         * @brief      Draw a batch of lines with a color each. The default
+         *             implementation falls back to Line.
+         *
+         * @param[in]  pLines  lines
+         * @param[in]  count   amount of lines
+         *
+         * @return     bool
+         */
+        virtual bool Lines( const ColoredLine* pLines, size_t count );
+
+        /**
+         * @brief      Draw connected lines through a sequence of points as one
+         *             open path. The default implementation falls back to Line
+         *             per segment.
+         *
+         * @param[in]  pPoints    points
+         * @param[in]  count      amount of points, at least two
+         * @param[in]  thickness  thickness
+         * @param[in]  color      argb color
+         *
+         * @return     bool
+         */
+        virtual bool Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color );
+
+        /**
+         * @brief      Draw an utf-16 string inside a layout box
+         *
+         * @param[in]  x       x-position
+         * @param[in]  y       y-position
+         * @param[in]  w       layout width
+         * @param[in]  h       layout height
+         * @param[in]  text    utf-16 text (not null terminated)
+         * @param[in]  length  text length
+         * @param[in]  pFont   sink specific font object
+         * @param[in]  color   argb color
+         *
+         * @return     bool
+         */
+        virtual bool Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color ) = 0;
+
+        /**
+         * @brief      Set the transform for every following call
+         *
+         * @param[in]  transform  transform
+         *
+         * @return     bool
+         */
+        virtual bool SetTransform( const Transform& transform ) = 0;
+
+        /**
+         * @brief      Set the antialias mode for every following call
+         *
+         * @param[in]  mode  antialias mode
+         *
+         * @return     bool
+         */
+        virtual bool SetAntialiasMode( AntialiasMode mode ) = 0;
+    };
+
+    /**
+     * @brief      CCommandList records the draw calls of a frame as POD
+     *             commands, so they can be replayed in one pass afterwards.
+     *             Reset keeps the allocated memory, a warmed up list does not
+     *             allocate anymore.
+     */
+    class CCommandList : public ICommandSink
+    {
+    public:
+        CCommandList( void ) = default;
+
+        bool FillRect( float x, float y, float w, float h, uint32_t color ) override;
+        bool FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color ) override;
+        bool FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color ) override;
+        bool Line( float x, float y, float xx, float yy, float thickness, uint32_t color ) override;
+        bool Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color ) override;
+        bool SetTransform( const Transform& transform ) override;
+        bool SetAntialiasMode( AntialiasMode mode ) override;
+
+        /**
+         * @brief      Record a batch as single rectangles, the list grows
+         *             once for the whole batch
+         */
+        bool FillColoredRects( const ColoredRect* pRects, size_t count ) override;
+        bool Lines( const ColoredLine* pLines, size_t count ) override;
+
+        /**
+         * @brief      Record the points once into the point arena
+         */
+        bool Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color ) override;
+
+        /**
+         * @brief      Remove every recorded command but keep the memory
+         */
+        void Reset( void );
+
+        /**
+         * @brief      Append every command of another list, as if they had
+         *             been recorded into this list
+         *
+         * @param[in]  list  list to append
+         */
+        void Append( const CCommandList& list );
+
+        /**
+         * @brief      Replay every recorded command in order
+         *
+         * @param[in]  sink  target sink
+         *
+         * @return     bool <> false if the sink rejected a command
+         */
+        bool Replay( ICommandSink& sink ) const;
+
+        /**
+         * @brief      Replay a single command of this list
+         *
+         * @param[in]  command  recorded command
+         * @param[in]  sink     target sink
+         *
+         * @return     bool <> false if the sink rejected the command
+         */
+        bool Replay( const DrawCommand& command, ICommandSink& sink ) const;
+
+        /**
+         * @brief      Fingerprint the recorded commands, their text and
+         *             points. Lists with the same commands in the same order
+         *             have the same hash.
+         *
+         * @return     uint64_t
+         */
+        uint64_t Hash( void ) const;
+
+        /**
+         * @brief      Get the recorded commands
+         *
+         * @return     const vector< DrawCommand >&
+         */
+        const vector< DrawCommand >& GetCommands( void ) const;
+
+        /**
+         * @brief      Get the text of a recorded text command
+         *
+         * @param[in]  command  text command
+         *
+         * @return     const wchar_t*
+         */
+        const wchar_t* GetText( const DrawCommand& command ) const;
+
+        /**
+         * @brief      Get the points of a recorded polyline command
+         *
+         * @param[in]  command  polyline command
+         *
+         * @return     const PointF* <> nullptr for any other command
+         */
+        const PointF* GetPoints( const DrawCommand& command ) const;
+
+        /**
+         * @brief      Get the amount of recorded commands
+         *
+         * @return     size_t
+         */
+        size_t size( void ) const;
+
+        /**
+         * @brief      Has the list no recorded commands?
+         *
+         * @return     bool
+         */
+        bool empty( void ) const;
+
+    private:
+        /**
+         * @brief      Make room for more commands at once
+         *
+         * @param[in]  count  amount of commands to add
+         */
+        void Reserve( size_t count );
+
+    private:
+        vector< DrawCommand > m_cCommands;
+        vector< wchar_t >     m_cText;
+        vector< PointF >      m_cPoints;
+    };
+
+    /**
+     * @brief      CCountingCommandSink does not render anything, it only counts
+     *             the calls it has received. Useful to test and measure the
+     *             recorder without any render target.
+     */
+    class CCountingCommandSink : public ICommandSink
+    {
+    public:
+        struct Counters
+        {
+            uint64_t nRects          = 0;
+            uint64_t nRoundedRects   = 0;
+            uint64_t nRoundedFrames  = 0;
+            uint64_t nLines          = 0;
+            uint64_t nTexts          = 0;
+            uint64_t nCharacters     = 0;
+            uint64_t nStateChanges   = 0;
+            uint64_t nBatches        = 0;
+            uint64_t nBatchedRects   = 0;
+            uint64_t nBatchedLines   = 0;
+            uint64_t nPolylines      = 0;
+            uint64_t nPolylinePoints = 0;
+        };
+
+    public:
+        bool FillRect( float x, float y, float w, float h, uint32_t color ) override;
+        bool FillRects( const RectF* pRects, size_t count, uint32_t color ) override;
+        bool FillColoredRects( const ColoredRect* pRects, size_t count ) override;
+        bool FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color ) override;
+        bool FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color ) override;
+        bool Line( float x, float y, float xx, float yy, float thickness, uint32_t color ) override;
+        bool Lines( const ColoredLine* pLines, size_t count ) override;
+        bool Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color ) override;
+        bool Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color ) override;
+        bool SetTransform( const Transform& transform ) override;
+        bool SetAntialiasMode( AntialiasMode mode ) override;
+
+        /**
+         * @brief      Get the amount of calls per primitive
+         *
+         * @return     const Counters&
+         */
+        const Counters& GetCounters( void ) const;
+
+        /**
+         * @brief      Get the amount of all draw calls
+         *
+         * @return     uint64_t
+         */
+        uint64_t GetDrawCalls( void ) const;
+
+        /**
+         * @brief      Reset all counters
+         */
+        void Reset( void );
+
+    private:
+        Counters m_Counters;
+    };
+}
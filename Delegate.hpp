@@ -0,0 +1,191 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace haze {
+    using namespace std;
+
+    template< typename TSignature, size_t TCapacity = 48 >
+    class CDelegate;
+
+    /**
+     * @brief      CDelegate is a move-only callable wrapper which stores the
+     *             callable inside the delegate itself, so neither function
+     *             pointers nor capturing lambdas ever allocate. Callables which
+     *             do not fit into TCapacity bytes are rejected at compile time,
+     *             capture a pointer to larger state instead.
+     *
+     * @tparam     TResult    result type
+     * @tparam     Args       argument types
+     * @tparam     TCapacity  size of the inline storage in bytes
+     */
+    template< typename TResult, typename... Args, size_t TCapacity >
+    class CDelegate< TResult( Args... ), TCapacity >
+    {
+    public:
+        static constexpr size_t CAPACITY = TCapacity;
+
+    public:
+        CDelegate( void ) = default;
+        CDelegate( nullptr_t );
+
+        /**
+         * @brief      Store a function pointer, functor or lambda
+         *
+         * @param[in]  fn    callable, a null function pointer leaves the
+         *                   delegate empty
+         */
+        template< typename TFunction, typename = enable_if_t< !is_same< decay_t< TFunction >, CDelegate >::value > >
+        CDelegate( TFunction&& fn );
+
+        CDelegate( CDelegate&& other ) noexcept;
+        CDelegate& operator = ( CDelegate&& other ) noexcept;
+        CDelegate( const CDelegate& ) = delete;
+        CDelegate& operator = ( const CDelegate& ) = delete;
+        ~CDelegate( void );
+
+        /**
+         * @brief      Call the stored callable, the delegate must not be empty
+         */
+        TResult operator()( Args... args ) const;
+
+        /**
+         * @brief      Is a callable stored?
+         */
+        explicit operator bool( void ) const;
+
+        /**
+         * @brief      Destroy the stored callable
+         */
+        void Reset( void );
+
+    private:
+        using InvokeFn = TResult( * )( void*, Args&&... );
+        using MoveFn = void( * )( void* pDestination, void* pSource );
+
+        template< typename TFunction >
+        static TResult Invoke( void* pStorage, Args&&... args );
+
+        template< typename TFunction >
+        static void    Move( void* pDestination, void* pSource );
+
+        template< typename TFunction >
+        static bool    IsNull( const TFunction& );
+        template< typename TPointee >
+        static bool    IsNull( TPointee* fn );
+
+    private:
+        alignas( max_align_t ) mutable unsigned char m_cStorage[ TCapacity ];
+        InvokeFn                                     m_fnInvoke = nullptr;
+        MoveFn                                       m_fnMove = nullptr;
+    };
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    CDelegate< TResult( Args... ), TCapacity >::CDelegate( nullptr_t )
+    {
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    template< typename TFunction, typename >
+    CDelegate< TResult( Args... ), TCapacity >::CDelegate( TFunction&& fn )
+    {
+        using Function = decay_t< TFunction >;
+        static_assert( sizeof( Function ) <= TCapacity, "callable does not fit into the delegate, capture less or by pointer" );
+        static_assert( alignof( Function ) <= alignof( max_align_t ), "callable is over-aligned" );
+        static_assert( is_nothrow_move_constructible< Function >::value, "callable must be nothrow move constructible" );
+
+        if( IsNull( fn ) ) {
+            return;
+        }
+        new( m_cStorage ) Function( forward< TFunction >( fn ) );
+        m_fnInvoke = &Invoke< Function >;
+        m_fnMove = &Move< Function >;
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    CDelegate< TResult( Args... ), TCapacity >::CDelegate( CDelegate&& other ) noexcept
+    {
+        *this = move( other );
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    CDelegate< TResult( Args... ), TCapacity >& CDelegate< TResult( Args... ), TCapacity >::operator = ( CDelegate&& other ) noexcept
+    {
+        if( this == &other ) {
+            return *this;
+        }
+
+        Reset();
+        if( other.m_fnInvoke ) {
+            other.m_fnMove( m_cStorage, other.m_cStorage );
+            m_fnInvoke = other.m_fnInvoke;
+            m_fnMove = other.m_fnMove;
+            other.m_fnInvoke = nullptr;
+            other.m_fnMove = nullptr;
+        }
+        return *this;
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    CDelegate< TResult( Args... ), TCapacity >::~CDelegate( void )
+    {
+        Reset();
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    TResult CDelegate< TResult( Args... ), TCapacity >::operator()( Args... args ) const
+    {
+        return m_fnInvoke( m_cStorage, forward< Args >( args )... );
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    CDelegate< TResult( Args... ), TCapacity >::operator bool( void ) const
+    {
+        return m_fnInvoke != nullptr;
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    void CDelegate< TResult( Args... ), TCapacity >::Reset( void )
+    {
+        if( m_fnMove ) {
+            // moving into nothing only destroys the source
+            m_fnMove( nullptr, m_cStorage );
+        }
+        m_fnInvoke = nullptr;
+        m_fnMove = nullptr;
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    template< typename TFunction >
+    TResult CDelegate< TResult( Args... ), TCapacity >::Invoke( void* pStorage, Args&&... args )
+    {
+        return ( *static_cast< TFunction* >( pStorage ) )( forward< Args >( args )... );
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    template< typename TFunction >
+    void CDelegate< TResult( Args... ), TCapacity >::Move( void* pDestination, void* pSource )
+    {
+        auto* pFunction = static_cast< TFunction* >( pSource );
+        if( pDestination ) {
+            new( pDestination ) TFunction( move( *pFunction ) );
+        }
+        pFunction->~TFunction();
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    template< typename TFunction >
+    bool CDelegate< TResult( Args... ), TCapacity >::IsNull( const TFunction& )
+    {
+        return false;
+    }
+
+    template< typename TResult, typename... Args, size_t TCapacity >
+    template< typename TPointee >
+    bool CDelegate< TResult( Args... ), TCapacity >::IsNull( TPointee* fn )
+    {
+        return fn == nullptr;
+    }
+}
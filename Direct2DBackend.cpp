@@ -0,0 +1,814 @@
+#if defined( _WIN32 )
+#include "Direct2DBackend.hpp"
+#include "Graph.hpp"
+#include "Hash.hpp"
+#include "Overlay.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+namespace {
+    void ReleaseTextLayout( IDWriteTextLayout*& pDirectWriteTextLayout )
+    {
+        SafeRelease( &pDirectWriteTextLayout );
+    }
+
+    void ReleaseMesh( ID2D1Mesh*& pDirect2DMesh )
+    {
+        SafeRelease( &pDirect2DMesh );
+    }
+
+    void ReleaseRealization( ID2D1GeometryRealization*& pDirect2DGeometryRealization )
+    {
+        SafeRelease( &pDirect2DGeometryRealization );
+    }
+
+    void ReleaseGeometry( ID2D1PathGeometry*& pDirect2DPathGeometry )
+    {
+        SafeRelease( &pDirect2DPathGeometry );
+    }
+}
+
+CDirect2DBackend::CDirect2DBackend( void ) :
+    m_cTextLayouts( DEFAULT_TEXT_LAYOUT_BUDGET, &ReleaseTextLayout ),
+    m_cMeshes( DEFAULT_MESH_BUDGET, &ReleaseMesh ),
+    m_cRealizations( DEFAULT_REALIZATION_BUDGET, &ReleaseRealization ),
+    m_cGeometries( DEFAULT_GEOMETRY_BUDGET, &ReleaseGeometry ),
+    m_Tessellations( 0 )
+{
+}
+
+CDirect2DBackend::CDirect2DBackend( const CDirect2DOverlay* pDirect2DOverlay ) :
+    CDirect2DBackend()
+{
+    SetOverlayInstance( pDirect2DOverlay );
+}
+
+CDirect2DBackend::~CDirect2DBackend( void )
+{
+    m_cRealizations.Clear();
+    SafeRelease( &m_pDirect2DDeviceContext );
+}
+
+bool CDirect2DBackend::FillRect( float x, float y, float w, float h, uint32_t color )
+{
+    if( !ApplyColor( color ) ) {
+        return false;
+    }
+
+    auto rect = D2D1::RectF( x, y, x + w, y + h );
+    m_pDirect2DHwndRenderTarget->FillRectangle( &rect, m_pDirect2DColorBrush );
+
+    return true;
+}
+
+bool CDirect2DBackend::FillRects( const RectF* pRects, size_t count, uint32_t color )
+{
+    if( !pRects || !m_pDirect2DFactory || !ApplyColor( color ) ) {
+        return false;
+    }
+
+    ID2D1PathGeometry* pDirect2DPathGeometry = nullptr;
+    if( FAILED( m_pDirect2DFactory->CreatePathGeometry( &pDirect2DPathGeometry ) ) ) {
+        return false;
+    }
+
+    ID2D1GeometrySink* pDirect2DGeometrySink = nullptr;
+    if( FAILED( pDirect2DPathGeometry->Open( &pDirect2DGeometrySink ) ) ) {
+        SafeRelease( &pDirect2DPathGeometry );
+        return false;
+    }
+
+    // every figure has the same winding, overlaps are filled once
+    pDirect2DGeometrySink->SetFillMode( D2D1_FILL_MODE_WINDING );
+    for( size_t i = 0; i < count; ++i ) {
+        const auto& rect = pRects[ i ];
+        const D2D1_POINT_2F points[ 3 ] = {
+            { rect.x + rect.w, rect.y },
+            { rect.x + rect.w, rect.y + rect.h },
+            { rect.x, rect.y + rect.h }
+        };
+        pDirect2DGeometrySink->BeginFigure( { rect.x, rect.y }, D2D1_FIGURE_BEGIN_FILLED );
+        pDirect2DGeometrySink->AddLines( points, 3 );
+        pDirect2DGeometrySink->EndFigure( D2D1_FIGURE_END_CLOSED );
+    }
+
+    auto hr = pDirect2DGeometrySink->Close();
+    SafeRelease( &pDirect2DGeometrySink );
+    if( SUCCEEDED( hr ) ) {
+        m_pDirect2DHwndRenderTarget->FillGeometry( pDirect2DPathGeometry, m_pDirect2DColorBrush );
+    }
+    SafeRelease( &pDirect2DPathGeometry );
+
+    return SUCCEEDED( hr );
+}
+
+bool CDirect2DBackend::FillColoredRects( const ColoredRect* pRects, size_t count )
+{
+    if( !pRects || !m_pDirect2DHwndRenderTarget || !m_pDirect2DColorBrush ) {
+        return false;
+    }
+
+    for( size_t i = 0; i < count; ++i ) {
+        const auto& rect = pRects[ i ];
+        SetBrushColor( rect.color.hex() );
+        auto bounds = D2D1::RectF( rect.x, rect.y, rect.x + rect.w, rect.y + rect.h );
+        m_pDirect2DHwndRenderTarget->FillRectangle( &bounds, m_pDirect2DColorBrush );
+    }
+
+    return true;
+}
+
+bool CDirect2DBackend::FillBorderBoxes( const ColoredBorderBox* pBoxes, size_t count )
+{
+    if( !pBoxes || !m_pDirect2DHwndRenderTarget || !m_pDirect2DColorBrush ) {
+        return false;
+    }
+
+    RectF rects[ 4 ];
+    for( size_t i = 0; i < count; ++i ) {
+        SetBrushColor( pBoxes[ i ].color.hex() );
+        const auto parts = SplitBorderBox( pBoxes[ i ], rects );
+        for( size_t j = 0; j < parts; ++j ) {
+            auto bounds = D2D1::RectF( rects[ j ].x, rects[ j ].y, rects[ j ].x + rects[ j ].w, rects[ j ].y + rects[ j ].h );
+            m_pDirect2DHwndRenderTarget->FillRectangle( &bounds, m_pDirect2DColorBrush );
+        }
+    }
+
+    return true;
+}
+
+bool CDirect2DBackend::FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color )
+{
+    if( !ApplyColor( color ) ) {
+        return false;
+    }
+
+    const auto x0 = min( x, x + w ), x1 = max( x, x + w );
+    const auto y0 = min( y, y + h ), y1 = max( y, y + h );
+    const auto rx = min( max( x_rad, 0.f ), 0.5f * ( x1 - x0 ) );
+    const auto ry = min( max( y_rad, 0.f ), 0.5f * ( y1 - y0 ) );
+    if( rx > 0.f && ry > 0.f ) {
+        const auto& t = m_Transform;
+        const auto scale = sqrt( fabs( t.m11 * t.m22 - t.m12 * t.m21 ) );
+        const auto segments = CTessellationCache::GetArcSegments( max( rx, ry ) * scale );
+
+        // a realization is drawn in either antialias mode, a mesh only aliased
+        auto* pDirect2DGeometryRealization = GetRealization( { x1 - x0, y1 - y0, rx, ry, 0.f, 0.f, 0.f, segments, 0, ShapePart::Outer } );
+        if( pDirect2DGeometryRealization ) {
+            MoveOrigin( x0, y0 );
+            m_pDirect2DDeviceContext->DrawGeometryRealization( pDirect2DGeometryRealization, m_pDirect2DColorBrush );
+            MoveOrigin( 0.f, 0.f );
+            return true;
+        }
+
+        auto* pDirect2DMesh = m_eAntialiasMode == AntialiasMode::Aliased ? GetRoundedRectMesh( x1 - x0, y1 - y0, rx, ry, segments ) : nullptr;
+        if( pDirect2DMesh ) {
+            MoveOrigin( x0, y0 );
+            m_pDirect2DHwndRenderTarget->FillMesh( pDirect2DMesh, m_pDirect2DColorBrush );
+            MoveOrigin( 0.f, 0.f );
+            return true;
+        }
+    }
+
+    auto rect = D2D1::RoundedRect( D2D1::RectF( x, y, x + w, y + h ), x_rad, y_rad );
+    m_pDirect2DHwndRenderTarget->FillRoundedRectangle( &rect, m_pDirect2DColorBrush );
+
+    return true;
+}
+
+bool CDirect2DBackend::FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color )
+{
+    const auto x0 = min( x, x + w ), x1 = max( x, x + w );
+    const auto y0 = min( y, y + h ), y1 = max( y, y + h );
+    if( !( thickness > 0.f ) ) {
+        return FillRoundedRect( x0, y0, x1 - x0, y1 - y0, inner_x_rad, inner_y_rad, inner_color );
+    }
+    if( 2.f * thickness >= x1 - x0 || 2.f * thickness >= y1 - y0 ) {
+        return FillRoundedRect( x0, y0, x1 - x0, y1 - y0, x_rad, y_rad, color );
+    }
+
+    // an opaque inset hides the inner edge of the whole shape, both fills hit their caches
+    const auto t = thickness;
+    if( ( inner_color >> 24 ) == 0xFF ) {
+        return FillRoundedRect( x0, y0, x1 - x0, y1 - y0, x_rad, y_rad, color ) &&
+               FillRoundedRect( x0 + t, y0 + t, x1 - x0 - 2.f * t, y1 - y0 - 2.f * t, inner_x_rad, inner_y_rad, inner_color );
+    }
+
+    // limited like CSoftwareBackend limits them, for the outer shape and for the inset
+    const auto rx = min( max( x_rad, 0.f ), 0.5f * ( x1 - x0 ) );
+    const auto ry = min( max( y_rad, 0.f ), 0.5f * ( y1 - y0 ) );
+    const auto irx = min( max( inner_x_rad, 0.f ), 0.5f * ( x1 - x0 ) - t );
+    const auto iry = min( max( inner_y_rad, 0.f ), 0.5f * ( y1 - y0 ) - t );
+    const auto scale = sqrt( fabs( m_Transform.m11 * m_Transform.m22 - m_Transform.m12 * m_Transform.m21 ) );
+    const auto segments = rx > 0.f && ry > 0.f ? CTessellationCache::GetArcSegments( max( rx, ry ) * scale ) : 1;
+    const auto inner = irx > 0.f && iry > 0.f ? CTessellationCache::GetArcSegments( max( irx, iry ) * scale ) : 1;
+
+    // the inset and the ring share the inner contour, only their antialiased edges meet
+    ShapeKey key = { x1 - x0, y1 - y0, rx, ry, t, irx, iry, segments, inner, ShapePart::Inset };
+    if( inner_color >> 24 ) {
+        if( !ApplyColor( inner_color ) || !FillShape( key, x0, y0 ) ) {
+            return false;
+        }
+    }
+    key.ePart = ShapePart::Ring;
+    return ApplyColor( color ) && FillShape( key, x0, y0 );
+}
+
+void CDirect2DBackend::MoveOrigin( float x, float y )
+{
+    // the state cache keeps the tracked transform, only the target moves
+    const auto& t = m_Transform;
+    const D2D1_MATRIX_3X2_F matrix = { t.m11, t.m12, t.m21, t.m22, x * t.m11 + y * t.m21 + t.dx, x * t.m12 + y * t.m22 + t.dy };
+    m_pDirect2DHwndRenderTarget->SetTransform( matrix );
+}
+
+ID2D1PathGeometry* CDirect2DBackend::CreateFigures( const size_t* pFigures, size_t count )
+{
+    ID2D1PathGeometry* pDirect2DPathGeometry = nullptr;
+    if( FAILED( m_pDirect2DFactory->CreatePathGeometry( &pDirect2DPathGeometry ) ) ) {
+        return nullptr;
+    }
+
+    ID2D1GeometrySink* pDirect2DGeometrySink = nullptr;
+    if( FAILED( pDirect2DPathGeometry->Open( &pDirect2DGeometrySink ) ) ) {
+        SafeRelease( &pDirect2DPathGeometry );
+        return nullptr;
+    }
+
+    // nested figures are left out by the alternate fill mode
+    pDirect2DGeometrySink->SetFillMode( D2D1_FILL_MODE_ALTERNATE );
+    for( size_t i = 0; i < count; ++i ) {
+        if( pFigures[ i ] == pFigures[ i + 1 ] ) {
+            continue;
+        }
+        pDirect2DGeometrySink->BeginFigure( m_cPoints[ pFigures[ i ] ], D2D1_FIGURE_BEGIN_FILLED );
+        pDirect2DGeometrySink->AddLines( m_cPoints.data() + pFigures[ i ] + 1, static_cast< UINT32 >( pFigures[ i + 1 ] - pFigures[ i ] - 1 ) );
+        pDirect2DGeometrySink->EndFigure( D2D1_FIGURE_END_CLOSED );
+    }
+
+    const auto hr = pDirect2DGeometrySink->Close();
+    SafeRelease( &pDirect2DGeometrySink );
+    if( FAILED( hr ) ) {
+        SafeRelease( &pDirect2DPathGeometry );
+    }
+    return pDirect2DPathGeometry;
+}
+
+bool CDirect2DBackend::Line( float x, float y, float xx, float yy, float thickness, uint32_t color )
+{
+    if( !ApplyColor( color ) ) {
+        return false;
+    }
+
+    m_pDirect2DHwndRenderTarget->DrawLine( { x, y }, { xx, yy }, m_pDirect2DColorBrush, thickness );
+
+    return true;
+}
+
+bool CDirect2DBackend::Lines( const ColoredLine* pLines, size_t count )
+{
+    if( !pLines || !m_pDirect2DHwndRenderTarget || !m_pDirect2DColorBrush ) {
+        return false;
+    }
+
+    for( size_t i = 0; i < count; ++i ) {
+        const auto& line = pLines[ i ];
+        SetBrushColor( line.color.hex() );
+        m_pDirect2DHwndRenderTarget->DrawLine( { line.x, line.y }, { line.xx, line.yy }, m_pDirect2DColorBrush, line.thickness );
+    }
+
+    return true;
+}
+
+bool CDirect2DBackend::Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color )
+{
+    if( !pPoints || count < 2 ) {
+        return false;
+    }
+
+    StrokePolyline( pPoints, count, thickness, m_cStroke );
+    if( m_cStroke.empty() ) {
+        return true;
+    }
+    if( !m_pDirect2DFactory || !ApplyColor( color ) ) {
+        return false;
+    }
+
+    ID2D1PathGeometry* pDirect2DPathGeometry = nullptr;
+    if( FAILED( m_pDirect2DFactory->CreatePathGeometry( &pDirect2DPathGeometry ) ) ) {
+        return false;
+    }
+
+    ID2D1GeometrySink* pDirect2DGeometrySink = nullptr;
+    if( FAILED( pDirect2DPathGeometry->Open( &pDirect2DGeometrySink ) ) ) {
+        SafeRelease( &pDirect2DPathGeometry );
+        return false;
+    }
+
+    m_cPoints.clear();
+    for( const auto& point : m_cStroke ) {
+        m_cPoints.push_back( { point.x, point.y } );
+    }
+
+    // overlapping quads of the same winding are filled once
+    pDirect2DGeometrySink->SetFillMode( D2D1_FILL_MODE_WINDING );
+    for( size_t i = 0; i < m_cPoints.size(); i += 4 ) {
+        pDirect2DGeometrySink->BeginFigure( m_cPoints[ i ], D2D1_FIGURE_BEGIN_FILLED );
+        pDirect2DGeometrySink->AddLines( m_cPoints.data() + i + 1, 3 );
+        pDirect2DGeometrySink->EndFigure( D2D1_FIGURE_END_CLOSED );
+    }
+
+    const auto hr = pDirect2DGeometrySink->Close();
+    SafeRelease( &pDirect2DGeometrySink );
+    if( SUCCEEDED( hr ) ) {
+        m_pDirect2DHwndRenderTarget->FillGeometry( pDirect2DPathGeometry, m_pDirect2DColorBrush );
+    }
+    SafeRelease( &pDirect2DPathGeometry );
+    return SUCCEEDED( hr );
+}
+
+bool CDirect2DBackend::Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color )
+{
+    if( !text || !pFont || !ApplyColor( color ) ) {
+        return false;
+    }
+
+    auto* pDirectWriteTextFormat = static_cast< IDWriteTextFormat* >( const_cast< void* >( pFont ) );
+
+    // unchanged labels reuse their layout and skip the shaping
+    auto* pDirectWriteTextLayout = GetTextLayout( text, length, pDirectWriteTextFormat, w, h );
+    if( pDirectWriteTextLayout ) {
+        m_pDirect2DHwndRenderTarget->DrawTextLayout( { x, y }, pDirectWriteTextLayout, m_pDirect2DColorBrush );
+        return true;
+    }
+
+    auto rect = D2D1::RectF( x, y, x + w, y + h );
+    m_pDirect2DHwndRenderTarget->DrawText( text, static_cast< UINT32 >( length ), pDirectWriteTextFormat, &rect, m_pDirect2DColorBrush );
+
+    return true;
+}
+
+bool CDirect2DBackend::SetTransform( const Transform& transform )
+{
+    if( !m_pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+
+    m_Transform = transform;
+    if( m_RenderState.SetTransform( transform ) ) {
+        D2D1_MATRIX_3X2_F matrix = { transform.m11, transform.m12, transform.m21, transform.m22, transform.dx, transform.dy };
+        m_pDirect2DHwndRenderTarget->SetTransform( matrix );
+    }
+    return true;
+}
+
+bool CDirect2DBackend::SetAntialiasMode( AntialiasMode mode )
+{
+    if( !m_pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+
+    m_eAntialiasMode = mode;
+    if( m_RenderState.SetAntialiasMode( mode ) ) {
+        m_pDirect2DHwndRenderTarget->SetAntialiasMode( mode == AntialiasMode::Aliased ? D2D1_ANTIALIAS_MODE_ALIASED : D2D1_ANTIALIAS_MODE_PER_PRIMITIVE );
+    }
+    return true;
+}
+
+bool CDirect2DBackend::BeginFrame( void )
+{
+    return Begin( true );
+}
+
+bool CDirect2DBackend::BeginPartialFrame( void )
+{
+    return Begin( false );
+}
+
+bool CDirect2DBackend::PushClip( const RectF& rect )
+{
+    // the clip is transformed by the transform at the time it gets pushed
+    if( !SetTransform( Transform::Identity() ) ) {
+        return false;
+    }
+
+    auto clip = D2D1::RectF( rect.x, rect.y, rect.x + rect.w, rect.y + rect.h );
+    m_pDirect2DHwndRenderTarget->PushAxisAlignedClip( clip, D2D1_ANTIALIAS_MODE_ALIASED );
+    return true;
+}
+
+bool CDirect2DBackend::PopClip( void )
+{
+    if( !m_pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+
+    m_pDirect2DHwndRenderTarget->PopAxisAlignedClip();
+    return true;
+}
+
+bool CDirect2DBackend::Clear( void )
+{
+    if( !m_pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+
+    m_pDirect2DHwndRenderTarget->Clear();
+    return true;
+}
+
+bool CDirect2DBackend::MeasureText( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, RectF& bounds )
+{
+    if( !text || !pFont ) {
+        return false;
+    }
+
+    auto* pDirectWriteTextFormat = static_cast< IDWriteTextFormat* >( const_cast< void* >( pFont ) );
+    auto* pDirectWriteTextLayout = GetTextLayout( text, length, pDirectWriteTextFormat, w, h );
+    if( !pDirectWriteTextLayout ) {
+        return false;
+    }
+
+    DWRITE_TEXT_METRICS metrics;
+    DWRITE_OVERHANG_METRICS overhang;
+    if( FAILED( pDirectWriteTextLayout->GetMetrics( &metrics ) ) || FAILED( pDirectWriteTextLayout->GetOverhangMetrics( &overhang ) ) ) {
+        return false;
+    }
+
+    // the overhang is the distance the ink reaches beyond the layout box
+    const auto x0 = min( x + metrics.left, x - overhang.left );
+    const auto y0 = min( y + metrics.top, y - overhang.top );
+    const auto x1 = max( x + metrics.left + metrics.widthIncludingTrailingWhitespace, x + w + overhang.right );
+    const auto y1 = max( y + metrics.top + metrics.height, y + h + overhang.bottom );
+    bounds = { x0, y0, x1 - x0, y1 - y0 };
+    return true;
+}
+
+bool CDirect2DBackend::Begin( bool clear )
+{
+    m_pDirect2DFactory = nullptr;
+    m_pDirectWriteFactory = nullptr;
+    m_pDirect2DHwndRenderTarget = nullptr;
+    m_pDirect2DColorBrush = nullptr;
+    m_RenderState.NextFrame();
+
+    // budget changes of other threads
+    const auto budget = m_nTextLayoutBudget.exchange( NO_BUDGET_CHANGE );
+    if( budget != NO_BUDGET_CHANGE ) {
+        m_cTextLayouts.SetBudget( budget );
+    }
+
+    if( !m_pDirect2DOverlay ) {
+        return false;
+    }
+
+    // ReleaseDeviceResources forgets the interfaces when the overlay releases
+    // them, the addresses only catch interfaces swapped without a release
+    auto* pDirect2DHwndRenderTarget = m_pDirect2DOverlay->GetDirect2DHwndRenderTarget();
+    auto* pDirect2DColorBrush = m_pDirect2DOverlay->GetDirect2DColorBrush();
+    if( !pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+    if( pDirect2DHwndRenderTarget != m_pLastRenderTarget ) {
+        // meshes and realizations belong to the old render target, the
+        // render targets of windows 8.1 and later are device contexts
+        m_cMeshes.Clear();
+        m_cRealizations.Clear();
+        SafeRelease( &m_pDirect2DDeviceContext );
+        if( FAILED( pDirect2DHwndRenderTarget->QueryInterface( __uuidof( ID2D1DeviceContext1 ), reinterpret_cast< void** >( &m_pDirect2DDeviceContext ) ) ) ) {
+            m_pDirect2DDeviceContext = nullptr;
+        }
+    }
+    if( pDirect2DHwndRenderTarget != m_pLastRenderTarget || pDirect2DColorBrush != m_pLastColorBrush ) {
+        m_RenderState.Invalidate();
+        m_pLastRenderTarget = pDirect2DHwndRenderTarget;
+        m_pLastColorBrush = pDirect2DColorBrush;
+    }
+
+    m_pDirect2DFactory = m_pDirect2DOverlay->GetDirect2DFactory();
+    m_pDirectWriteFactory = m_pDirect2DOverlay->GetDirectWriteFactory();
+    m_pDirect2DHwndRenderTarget = pDirect2DHwndRenderTarget;
+    m_pDirect2DColorBrush = pDirect2DColorBrush;
+
+    m_pDirect2DHwndRenderTarget->BeginDraw();
+    if( clear ) {
+        m_pDirect2DHwndRenderTarget->Clear();
+    }
+
+    return SetTransform( Transform::Identity() ) &&
+           SetAntialiasMode( AntialiasMode::PerPrimitive );
+}
+
+bool CDirect2DBackend::EndFrame( void )
+{
+    if( !m_pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+
+    const auto result = SUCCEEDED( m_pDirect2DHwndRenderTarget->EndDraw() );
+    PublishStatistics();
+    return result;
+}
+
+const void* CDirect2DBackend::GetFont( const string& name ) const
+{
+    return m_pDirect2DOverlay ? m_pDirect2DOverlay->GetFont( name ) : nullptr;
+}
+
+FontHandle CDirect2DBackend::GetFontHandle( const string& name ) const
+{
+    return m_pDirect2DOverlay ? m_pDirect2DOverlay->GetFontHandle( name ) : 0;
+}
+
+const void* CDirect2DBackend::GetFont( FontHandle handle ) const
+{
+    return m_pDirect2DOverlay ? m_pDirect2DOverlay->GetFont( handle ) : nullptr;
+}
+
+array< int32_t, 2 > CDirect2DBackend::GetSize( void ) const
+{
+    if( !m_pDirect2DOverlay ) {
+        return { { 0, 0 } };
+    }
+    return m_pDirect2DOverlay->GetSize();
+}
+
+CRenderStateCache::Counters CDirect2DBackend::GetRenderStateCounters( void ) const
+{
+    return m_Statistics.Load().RenderState;
+}
+
+void CDirect2DBackend::SetTextLayoutBudget( size_t budget )
+{
+    // SIZE_MAX marks that nothing changed, one byte less is as unlimited
+    m_nTextLayoutBudget = min( budget, NO_BUDGET_CHANGE - 1 );
+}
+
+CacheStatistics CDirect2DBackend::GetTextLayoutStatistics( void ) const
+{
+    return m_Statistics.Load().TextLayouts;
+}
+
+void CDirect2DBackend::ClearTextLayouts( void )
+{
+    m_cTextLayouts.Clear();
+}
+
+bool CDirect2DBackend::ApplyColor( uint32_t color )
+{
+    if( !m_pDirect2DHwndRenderTarget || !m_pDirect2DColorBrush ) {
+        return false;
+    }
+
+    SetBrushColor( color );
+    return true;
+}
+
+void CDirect2DBackend::SetBrushColor( uint32_t color )
+{
+    if( m_RenderState.SetColor( color ) ) {
+        // D2D1::ColorF( uint32_t ) ignores the alpha byte
+        const auto value = Color( color ).ToFloat();
+        m_pDirect2DColorBrush->SetColor( D2D1::ColorF( value.r, value.g, value.b, value.a ) );
+    }
+}
+
+IDWriteTextLayout* CDirect2DBackend::GetTextLayout( const wchar_t* text, size_t length, IDWriteTextFormat* pDirectWriteTextFormat, float w, float h )
+{
+    // text may be measured before the frame has fetched the interfaces
+    auto* pDirectWriteFactory = m_pDirectWriteFactory;
+    if( !pDirectWriteFactory && m_pDirect2DOverlay ) {
+        pDirectWriteFactory = m_pDirect2DOverlay->GetDirectWriteFactory();
+    }
+    if( !pDirectWriteFactory || !m_cTextLayouts.IsEnabled() ) {
+        return nullptr;
+    }
+
+    const void* pFont = pDirectWriteTextFormat;
+    auto hash = Hash64( pFont );
+    hash = Hash64( w, hash );
+    hash = Hash64( h, hash );
+    hash = Hash64( text, length * sizeof( wchar_t ), hash );
+
+    auto* ppDirectWriteTextLayout = m_cTextLayouts.Find( hash, [ & ]( const TextLayoutKey& key ) {
+        return key.pFont == pFont && key.w == w && key.h == h && key.text.compare( 0, wstring::npos, text, length ) == 0;
+    } );
+    if( ppDirectWriteTextLayout ) {
+        return *ppDirectWriteTextLayout;
+    }
+
+    IDWriteTextLayout* pDirectWriteTextLayout = nullptr;
+    if( FAILED( pDirectWriteFactory->CreateTextLayout( text, static_cast< UINT32 >( length ), pDirectWriteTextFormat, w, h, &pDirectWriteTextLayout ) ) ) {
+        return nullptr;
+    }
+
+    // rough estimate of the memory DirectWrite keeps per layout
+    const auto cost = sizeof( TextLayoutKey ) + 256 + length * ( sizeof( wchar_t ) + 64 );
+    return m_cTextLayouts.Insert( hash, { pFont, wstring( text, length ), w, h }, pDirectWriteTextLayout, cost );
+}
+
+ID2D1Mesh* CDirect2DBackend::GetRoundedRectMesh( float w, float h, float rx, float ry, size_t segments )
+{
+    if( !m_cMeshes.IsEnabled() ) {
+        return nullptr;
+    }
+
+    auto hash = Hash64( w );
+    hash = Hash64( h, hash );
+    hash = Hash64( rx, hash );
+    hash = Hash64( ry, hash );
+    hash = Hash64( segments, hash );
+
+    auto* ppDirect2DMesh = m_cMeshes.Find( hash, [ & ]( const MeshKey& key ) {
+        return key.w == w && key.h == h && key.fRadiusX == rx && key.fRadiusY == ry && key.nSegments == segments;
+    } );
+    if( ppDirect2DMesh ) {
+        return *ppDirect2DMesh;
+    }
+
+    // the outline is convex, a fan around the center covers it
+    const auto& points = m_Tessellations.GetRoundedRect( w, h, rx, ry, segments )->cPoints;
+    const D2D1_POINT_2F center = { 0.5f * w, 0.5f * h };
+    m_cTriangles.clear();
+    for( size_t i = 0; i < points.size(); ++i ) {
+        const auto& p0 = points[ i ];
+        const auto& p1 = points[ ( i + 1 ) % points.size() ];
+        m_cTriangles.push_back( { center, { p0.x, p0.y }, { p1.x, p1.y } } );
+    }
+
+    ID2D1Mesh* pDirect2DMesh = nullptr;
+    ID2D1TessellationSink* pDirect2DTessellationSink = nullptr;
+    if( FAILED( m_pDirect2DHwndRenderTarget->CreateMesh( &pDirect2DMesh ) ) || FAILED( pDirect2DMesh->Open( &pDirect2DTessellationSink ) ) ) {
+        SafeRelease( &pDirect2DMesh );
+        return nullptr;
+    }
+
+    pDirect2DTessellationSink->AddTriangles( m_cTriangles.data(), static_cast< UINT32 >( m_cTriangles.size() ) );
+    const auto hr = pDirect2DTessellationSink->Close();
+    SafeRelease( &pDirect2DTessellationSink );
+    if( FAILED( hr ) ) {
+        SafeRelease( &pDirect2DMesh );
+        return nullptr;
+    }
+
+    const auto cost = sizeof( MeshKey ) + m_cTriangles.size() * sizeof( D2D1_TRIANGLE );
+    return m_cMeshes.Insert( hash, { w, h, rx, ry, segments }, pDirect2DMesh, cost );
+}
+
+ID2D1PathGeometry* CDirect2DBackend::GetGeometry( const ShapeKey& key )
+{
+    if( !m_pDirect2DFactory ) {
+        return nullptr;
+    }
+
+    const auto hash = key.Hash();
+    auto* ppDirect2DPathGeometry = m_cGeometries.Find( hash, [ & ]( const ShapeKey& other ) {
+        return other == key;
+    } );
+    if( ppDirect2DPathGeometry ) {
+        return *ppDirect2DPathGeometry;
+    }
+
+    const auto* pTessellation = key.fThickness > 0.f ?
+        m_Tessellations.GetRoundedFrame( key.w, key.h, key.fRadiusX, key.fRadiusY, key.fThickness, key.fInnerRadiusX, key.fInnerRadiusY, key.nSegments, key.nInnerSegments ) :
+        m_Tessellations.GetRoundedRect( key.w, key.h, key.fRadiusX, key.fRadiusY, key.nSegments );
+    m_cPoints.clear();
+    for( const auto& point : pTessellation->cPoints ) {
+        m_cPoints.push_back( { point.x, point.y } );
+    }
+
+    // the outer contour, the ring between both contours or the inner one
+    const size_t figures[ 3 ] = { 0, pTessellation->nOuter, m_cPoints.size() };
+    auto* pDirect2DPathGeometry = CreateFigures( key.ePart == ShapePart::Inset ? figures + 1 : figures, key.ePart == ShapePart::Ring ? 2 : 1 );
+    if( !pDirect2DPathGeometry ) {
+        return nullptr;
+    }
+
+    // without a budget the newest geometry stays, a frame still builds each part once
+    const auto cost = sizeof( ShapeKey ) + m_cPoints.size() * sizeof( D2D1_POINT_2F );
+    return m_cGeometries.Insert( hash, key, pDirect2DPathGeometry, cost );
+}
+
+ID2D1GeometryRealization* CDirect2DBackend::GetRealization( const ShapeKey& key )
+{
+    if( !m_pDirect2DDeviceContext || !m_cRealizations.IsEnabled() ) {
+        return nullptr;
+    }
+
+    const auto hash = key.Hash();
+    auto* ppDirect2DGeometryRealization = m_cRealizations.Find( hash, [ & ]( const ShapeKey& other ) {
+        return other == key;
+    } );
+    if( ppDirect2DGeometryRealization ) {
+        return *ppDirect2DGeometryRealization;
+    }
+
+    auto* pDirect2DPathGeometry = GetGeometry( key );
+    if( !pDirect2DPathGeometry ) {
+        return nullptr;
+    }
+
+    // the contours are flat already, the tolerance only matters for the antialiased edge
+    ID2D1GeometryRealization* pDirect2DGeometryRealization = nullptr;
+    if( FAILED( m_pDirect2DDeviceContext->CreateFilledGeometryRealization( pDirect2DPathGeometry, D2D1_DEFAULT_FLATTENING_TOLERANCE, &pDirect2DGeometryRealization ) ) ) {
+        return nullptr;
+    }
+
+    // rough estimate of the triangles of the fill and of its antialiased edge
+    const auto points = 4 * ( key.nSegments + 1 ) + ( key.fThickness > 0.f ? 4 * ( key.nInnerSegments + 1 ) : 0 );
+    const auto cost = sizeof( ShapeKey ) + 4 * points * sizeof( D2D1_TRIANGLE );
+    return m_cRealizations.Insert( hash, key, pDirect2DGeometryRealization, cost );
+}
+
+bool CDirect2DBackend::FillShape( const ShapeKey& key, float x, float y )
+{
+    auto* pDirect2DGeometryRealization = GetRealization( key );
+    if( pDirect2DGeometryRealization ) {
+        MoveOrigin( x, y );
+        m_pDirect2DDeviceContext->DrawGeometryRealization( pDirect2DGeometryRealization, m_pDirect2DColorBrush );
+        MoveOrigin( 0.f, 0.f );
+        return true;
+    }
+
+    auto* pDirect2DPathGeometry = GetGeometry( key );
+    if( !pDirect2DPathGeometry ) {
+        return false;
+    }
+
+    MoveOrigin( x, y );
+    m_pDirect2DHwndRenderTarget->FillGeometry( pDirect2DPathGeometry, m_pDirect2DColorBrush );
+    MoveOrigin( 0.f, 0.f );
+    return true;
+}
+
+CacheStatistics CDirect2DBackend::GetMeshStatistics( void ) const
+{
+    return m_Statistics.Load().Meshes;
+}
+
+CacheStatistics CDirect2DBackend::GetRealizationStatistics( void ) const
+{
+    return m_Statistics.Load().Realizations;
+}
+
+CacheStatistics CDirect2DBackend::GetGeometryStatistics( void ) const
+{
+    return m_Statistics.Load().Geometries;
+}
+
+void CDirect2DBackend::ClearMeshes( void )
+{
+    m_cMeshes.Clear();
+    m_cRealizations.Clear();
+    m_cGeometries.Clear();
+}
+
+void CDirect2DBackend::ReleaseDeviceResources( void )
+{
+    m_cTextLayouts.Clear();
+    m_cMeshes.Clear();
+    m_cRealizations.Clear();
+    SafeRelease( &m_pDirect2DDeviceContext );
+    m_pLastRenderTarget = nullptr;
+    m_pLastColorBrush = nullptr;
+    m_RenderState.Invalidate();
+}
+
+void CDirect2DBackend::PublishStatistics( void )
+{
+    Statistics statistics;
+    statistics.RenderState = m_RenderState.GetCounters();
+    statistics.TextLayouts = m_cTextLayouts.GetStatistics();
+    statistics.Meshes = m_cMeshes.GetStatistics();
+    statistics.Realizations = m_cRealizations.GetStatistics();
+    statistics.Geometries = m_cGeometries.GetStatistics();
+    m_Statistics.Store( statistics );
+}
+
+bool CDirect2DBackend::ShapeKey::operator == ( const ShapeKey& other ) const
+{
+    return w == other.w && h == other.h && fRadiusX == other.fRadiusX && fRadiusY == other.fRadiusY && fThickness == other.fThickness &&
+           fInnerRadiusX == other.fInnerRadiusX && fInnerRadiusY == other.fInnerRadiusY && nSegments == other.nSegments &&
+           nInnerSegments == other.nInnerSegments && ePart == other.ePart;
+}
+
+uint64_t CDirect2DBackend::ShapeKey::Hash( void ) const
+{
+    auto hash = Hash64( w );
+    hash = Hash64( h, hash );
+    hash = Hash64( fRadiusX, hash );
+    hash = Hash64( fRadiusY, hash );
+    hash = Hash64( fThickness, hash );
+    hash = Hash64( fInnerRadiusX, hash );
+    hash = Hash64( fInnerRadiusY, hash );
+    hash = Hash64( nSegments, hash );
+    hash = Hash64( nInnerSegments, hash );
+    return Hash64( ePart, hash );
+}
+
+void CDirect2DBackend::SetOverlayInstance( const CDirect2DOverlay* pDirect2DOverlay )
+{
+    m_pDirect2DOverlay = pDirect2DOverlay;
+}
+#endif
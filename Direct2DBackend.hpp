@@ -0,0 +1,439 @@
+#pragma once
+#include <Windows.h>
+#include <d2d1.h>
+#include <d2d1_2.h>
+#include <d2d1helper.h>
+#include <dwrite.h>
+#include <atomic>
+#include "LruCache.hpp"
+#include "RenderBackend.hpp"
+#include "SequenceLock.hpp"
+#include "TessellationCache.hpp"
+
+namespace haze {
+
+    template< class T >
+    void SafeRelease( T** ppInterface )
+    {
+        if( ppInterface && *ppInterface ) {
+            ( *ppInterface )->Release();
+            *ppInterface = nullptr;
+        }
+    }
+
+    class CDirect2DOverlay;
+
+    /**
+     * @brief      CDirect2DBackend forwards every draw call to the window
+     *             render target of the overlay instance
+     */
+    class CDirect2DBackend : public IRenderBackend
+    {
+    public:
+        CDirect2DBackend( void );
+        explicit CDirect2DBackend( const CDirect2DOverlay* pDirect2DOverlay );
+        ~CDirect2DBackend( void );
+
+        bool FillRect( float x, float y, float w, float h, uint32_t color ) override;
+        bool FillRects( const RectF* pRects, size_t count, uint32_t color ) override;
+        bool FillColoredRects( const ColoredRect* pRects, size_t count ) override;
+        bool FillBorderBoxes( const ColoredBorderBox* pBoxes, size_t count ) override;
+
+        /**
+         * @brief      Draw a cached geometry realization of the size when the
+         *             render target supports them, antialiased or not.
+         *             Otherwise aliased ones fill a cached mesh and
+         *             antialiased ones take the analytic path of Direct2D.
+         */
+        bool FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color ) override;
+
+        /**
+         * @brief      An opaque inset is filled over the whole shape, which
+         *             leaves no seam along the inner edge. Otherwise the inset
+         *             and then the ring are filled from cached realizations
+         *             or path geometries of the same tessellation.
+         */
+        bool FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color ) override;
+        bool Line( float x, float y, float xx, float yy, float thickness, uint32_t color ) override;
+        bool Lines( const ColoredLine* pLines, size_t count ) override;
+
+        /**
+         * @brief      Fill the outline of the path as one geometry, every
+         *             joint looks the same as in the software backend
+         */
+        bool Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color ) override;
+        bool Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color ) override;
+        bool SetTransform( const Transform& transform ) override;
+        bool SetAntialiasMode( AntialiasMode mode ) override;
+
+        /**
+         * @brief      Fetch the interfaces of the overlay, begin drawing, clear
+         *             the target and reset the transform and antialias mode
+         *
+         * @return     bool <> false if an interface wasn't initialized
+         */
+        bool BeginFrame( void ) override;
+
+        /**
+         * @brief      Fetch the interfaces of the overlay and begin drawing on
+         *             top of the last frame. Needs a render target which
+         *             retains its contents.
+         *
+         * @return     bool <> false if an interface wasn't initialized
+         */
+        bool BeginPartialFrame( void ) override;
+
+        /**
+         * @brief      Push an aliased axis aligned clip, the transform is reset
+         *             to identity first
+         *
+         * @param[in]  rect  clip rectangle in target pixels
+         *
+         * @return     bool
+         */
+        bool PushClip( const RectF& rect ) override;
+        bool PopClip( void ) override;
+        bool Clear( void ) override;
+
+        /**
+         * @brief      Measure the ink of a string through its cached text
+         *             layout, including the overhang of the glyphs
+         *
+         * @return     bool <> false if the text couldn't be laid out
+         */
+        bool MeasureText( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, RectF& bounds ) override;
+
+        /**
+         * @brief      End drawing and present the frame
+         *
+         * @return     bool
+         */
+        bool EndFrame( void ) override;
+
+        /**
+         * @brief      Get a registered IDWriteTextFormat of the overlay
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     const void*
+         */
+        const void* GetFont( const string& name ) const override;
+
+        /**
+         * @brief      Get the handle of a registered font of the overlay
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     FontHandle
+         */
+        FontHandle GetFontHandle( const string& name ) const override;
+
+        /**
+         * @brief      Get a registered IDWriteTextFormat of the overlay by
+         *             its handle
+         *
+         * @param[in]  handle  font handle
+         *
+         * @return     const void*
+         */
+        const void* GetFont( FontHandle handle ) const override;
+
+        /**
+         * @brief      Get the overlay resolution
+         *
+         * @return     array< int32_t, 2 >
+         */
+        array< int32_t, 2 > GetSize( void ) const override;
+
+        /**
+         * @brief      Get the state changes of the last finished frame, can be
+         *             called from any thread
+         *
+         * @return     CRenderStateCache::Counters
+         */
+        CRenderStateCache::Counters GetRenderStateCounters( void ) const;
+
+        /**
+         * @brief      Set the memory budget of the text layout cache, 0 disables
+         *             the cache and every string gets laid out again. Can be
+         *             called from any thread, the thread which draws applies
+         *             it when the next frame begins.
+         *
+         * @param[in]  budget  budget in bytes
+         */
+        void SetTextLayoutBudget( size_t budget );
+
+        /**
+         * @brief      Get the hit/miss statistics of the text layout cache as
+         *             of the last finished frame, can be called from any thread
+         *
+         * @return     CacheStatistics
+         */
+        CacheStatistics GetTextLayoutStatistics( void ) const;
+
+        /**
+         * @brief      Release every cached text layout, only while no other
+         *             thread draws
+         */
+        void ClearTextLayouts( void );
+
+        /**
+         * @brief      Get the hit/miss statistics of the rounded rectangle
+         *             meshes as of the last finished frame, can be called from
+         *             any thread
+         *
+         * @return     CacheStatistics
+         */
+        CacheStatistics GetMeshStatistics( void ) const;
+
+        /**
+         * @brief      Get the hit/miss statistics of the geometry
+         *             realizations as of the last finished frame, can be
+         *             called from any thread
+         *
+         * @return     CacheStatistics
+         */
+        CacheStatistics GetRealizationStatistics( void ) const;
+
+        /**
+         * @brief      Get the hit/miss statistics of the path geometries of
+         *             rounded frames as of the last finished frame, can be
+         *             called from any thread
+         *
+         * @return     CacheStatistics
+         */
+        CacheStatistics GetGeometryStatistics( void ) const;
+
+        /**
+         * @brief      Release every cached mesh, geometry realization and path
+         *             geometry, only while no other thread draws
+         */
+        void ClearMeshes( void );
+
+        /**
+         * @brief      Release the cached text layouts, meshes and realizations
+         *             and forget the last interfaces, before the overlay
+         *             releases them. A recreated render target or brush can
+         *             reuse their addresses, so the next frame must not
+         *             compare them. Only while no other thread draws.
+         */
+        void ReleaseDeviceResources( void );
+
+        /**
+         * @brief      Set the overlay instance.
+         *
+         * @param[in]  pDirect2DOverlay  The direct2d overlay
+         */
+        void SetOverlayInstance( const CDirect2DOverlay* pDirect2DOverlay );
+
+    private:
+        /**
+         * @brief      Fetch the interfaces, begin drawing and reset the state
+         *
+         * @param[in]  clear  clear the target
+         *
+         * @return     bool
+         */
+        bool Begin( bool clear );
+
+        /**
+         * @brief      Apply the brush color unless it is already set
+         *
+         * @param[in]  color  argb color
+         *
+         * @return     bool <> false if an interface wasn't initialized
+         */
+        bool ApplyColor( uint32_t color );
+
+        /**
+         * @brief      Set the brush color unless it is already set, batches
+         *             check the interfaces once and then only change colors
+         *
+         * @param[in]  color  argb color
+         */
+        void SetBrushColor( uint32_t color );
+
+        /**
+         * @brief      Move the origin of the render target to a point of the
+         *             tracked transform, (0, 0) puts the tracked transform back
+         *
+         * @param[in]  x     x-position
+         * @param[in]  y     y-position
+         */
+        void MoveOrigin( float x, float y );
+
+        /**
+         * @brief      Build figures of m_cPoints into one path geometry, a
+         *             figure inside another is a hole
+         *
+         * @param[in]  pFigures  first point of each figure and the end of the last
+         * @param[in]  count     amount of figures
+         *
+         * @return     ID2D1PathGeometry* <> nullptr if the geometry couldn't be created
+         */
+        ID2D1PathGeometry* CreateFigures( const size_t* pFigures, size_t count );
+
+        /**
+         * @brief      Get a cached text layout or create a new one
+         *
+         * @param[in]  text                    utf-16 text
+         * @param[in]  length                  text length
+         * @param[in]  pDirectWriteTextFormat  font
+         * @param[in]  w                       layout width
+         * @param[in]  h                       layout height
+         *
+         * @return     IDWriteTextLayout* <> nullptr if the layout couldn't be created
+         */
+        IDWriteTextLayout* GetTextLayout( const wchar_t* text, size_t length, IDWriteTextFormat* pDirectWriteTextFormat, float w, float h );
+
+        /**
+         * @brief      Get a cached mesh of a rounded rectangle at the origin or
+         *             tessellate a new one. Meshes belong to the render
+         *             target and can only be filled aliased.
+         *
+         * @param[in]  w         width
+         * @param[in]  h         height
+         * @param[in]  rx        x-radius, limited to half of the width
+         * @param[in]  ry        y-radius, limited to half of the height
+         * @param[in]  segments  segments per quarter ellipse
+         *
+         * @return     ID2D1Mesh* <> nullptr if the mesh couldn't be created
+         */
+        ID2D1Mesh* GetRoundedRectMesh( float w, float h, float rx, float ry, size_t segments );
+
+    private:
+        struct TextLayoutKey
+        {
+            const void* pFont;
+            wstring     text;
+            float       w;
+            float       h;
+        };
+
+        struct MeshKey
+        {
+            float  w;
+            float  h;
+            float  fRadiusX;
+            float  fRadiusY;
+            size_t nSegments;
+        };
+
+        /**
+         * @brief      Contours of a rounded frame, a rounded rectangle only has
+         *             the outer one
+         */
+        enum class ShapePart : uint32_t
+        {
+            Outer,
+            Ring,
+            Inset
+        };
+
+        struct ShapeKey
+        {
+            float     w;
+            float     h;
+            float     fRadiusX;
+            float     fRadiusY;
+            float     fThickness;
+            float     fInnerRadiusX;
+            float     fInnerRadiusY;
+            size_t    nSegments;
+            size_t    nInnerSegments;
+            ShapePart ePart;
+
+            bool     operator == ( const ShapeKey& other ) const;
+            uint64_t Hash( void ) const;
+        };
+
+        struct Statistics
+        {
+            CRenderStateCache::Counters RenderState;
+            CacheStatistics             TextLayouts;
+            CacheStatistics             Meshes;
+            CacheStatistics             Realizations;
+            CacheStatistics             Geometries;
+        };
+
+        /**
+         * @brief      Get a cached path geometry of a part of a rounded
+         *             rectangle or frame at the origin, or build it from the
+         *             tessellation of its key. Geometries belong to the
+         *             factory and outlive the render target.
+         *
+         * @param[in]  key   size, radii and segments limited like
+         *                   CTessellationCache limits them, no thickness for
+         *                   a rounded rectangle
+         *
+         * @return     ID2D1PathGeometry* <> nullptr if the geometry couldn't
+         *             be created
+         */
+        ID2D1PathGeometry* GetGeometry( const ShapeKey& key );
+
+        /**
+         * @brief      Get a cached geometry realization of a part of a rounded
+         *             rectangle or frame at the origin, or realize the
+         *             tessellation of its key. Realizations belong to the
+         *             render target and can be drawn aliased or antialiased.
+         *
+         * @param[in]  key   size, radii and segments limited like
+         *                   CTessellationCache limits them, no thickness for
+         *                   a rounded rectangle
+         *
+         * @return     ID2D1GeometryRealization* <> nullptr if the render
+         *             target has no device context or the realization
+         *             couldn't be created
+         */
+        ID2D1GeometryRealization* GetRealization( const ShapeKey& key );
+
+        /**
+         * @brief      Fill a part of a rounded rectangle or frame with the
+         *             current brush, from its realization if the render target
+         *             has a device context and from its path geometry otherwise
+         *
+         * @param[in]  key   shape at the origin
+         * @param[in]  x     x-position of the top left corner
+         * @param[in]  y     y-position of the top left corner
+         *
+         * @return     bool <> false if neither could be created
+         */
+        bool FillShape( const ShapeKey& key, float x, float y );
+
+        /**
+         * @brief      Publish the statistics of the drawing thread
+         */
+        void PublishStatistics( void );
+
+        static constexpr size_t DEFAULT_TEXT_LAYOUT_BUDGET = 1 << 20;
+        static constexpr size_t DEFAULT_MESH_BUDGET = 1 << 20;
+        static constexpr size_t DEFAULT_REALIZATION_BUDGET = 4 << 20;
+        static constexpr size_t DEFAULT_GEOMETRY_BUDGET = 1 << 20;
+        static constexpr size_t NO_BUDGET_CHANGE = SIZE_MAX;
+        const CDirect2DOverlay* m_pDirect2DOverlay = nullptr;
+        ID2D1Factory*           m_pDirect2DFactory = nullptr;
+        IDWriteFactory*         m_pDirectWriteFactory = nullptr;
+        ID2D1HwndRenderTarget*  m_pDirect2DHwndRenderTarget = nullptr;
+        ID2D1SolidColorBrush*   m_pDirect2DColorBrush = nullptr;
+        ID2D1HwndRenderTarget*  m_pLastRenderTarget = nullptr;
+        ID2D1SolidColorBrush*   m_pLastColorBrush = nullptr;
+        ID2D1DeviceContext1*    m_pDirect2DDeviceContext = nullptr;
+        CRenderStateCache       m_RenderState;
+        Transform               m_Transform = Transform::Identity();
+        AntialiasMode           m_eAntialiasMode = AntialiasMode::PerPrimitive;
+        CLruCache< TextLayoutKey,
+            IDWriteTextLayout* > m_cTextLayouts;
+        CLruCache< MeshKey,
+            ID2D1Mesh* >         m_cMeshes;
+        CLruCache< ShapeKey,
+            ID2D1GeometryRealization* > m_cRealizations;
+        CLruCache< ShapeKey,
+            ID2D1PathGeometry* > m_cGeometries;
+        CTessellationCache      m_Tessellations;
+        vector< D2D1_TRIANGLE > m_cTriangles;
+        vector< D2D1_POINT_2F > m_cPoints;
+        vector< PointF >        m_cStroke;
+        atomic< size_t >        m_nTextLayoutBudget{ NO_BUDGET_CHANGE };
+        CSequenceLock< Statistics > m_Statistics;
+    };
+}
@@ -0,0 +1,311 @@
+#include "DirtyRegion.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+namespace {
+    using Bounds = array< int32_t, 4 >;
+
+    int64_t GetArea( const Bounds& bounds )
+    {
+        return static_cast< int64_t >( bounds[ 2 ] - bounds[ 0 ] ) * ( bounds[ 3 ] - bounds[ 1 ] );
+    }
+
+    Bounds GetUnion( const Bounds& a, const Bounds& b )
+    {
+        return { { min( a[ 0 ], b[ 0 ] ), min( a[ 1 ], b[ 1 ] ), max( a[ 2 ], b[ 2 ] ), max( a[ 3 ], b[ 3 ] ) } };
+    }
+
+    bool Intersects( const Bounds& a, const Bounds& b )
+    {
+        return a[ 0 ] < b[ 2 ] && b[ 0 ] < a[ 2 ] && a[ 1 ] < b[ 3 ] && b[ 1 ] < a[ 3 ];
+    }
+
+    bool IsStateCommand( const DrawCommand& command )
+    {
+        return command.eType == DrawCommandType::Transform || command.eType == DrawCommandType::AntialiasMode;
+    }
+}
+
+bool CDirtyRegion::Update( const CCommandList& list, IRenderBackend& backend )
+{
+    Measure( list, backend );
+
+    const auto cSize = backend.GetSize();
+    auto full = !m_bValid || cSize != m_cSize;
+
+    m_cDirty.clear();
+    if( !full ) {
+        // equal commands at the front and at the back of both frames draw
+        // equal pixels, everything in between is dirty in both frames
+        const auto count = min( m_cEntries.size(), m_cLastEntries.size() );
+        size_t front = 0, back = 0;
+        while( front < count && m_cEntries[ front ].nHash == m_cLastEntries[ front ].nHash && m_cEntries[ front ].cBounds == m_cLastEntries[ front ].cBounds ) {
+            ++front;
+        }
+        while( back < count - front &&
+               m_cEntries[ m_cEntries.size() - 1 - back ].nHash == m_cLastEntries[ m_cLastEntries.size() - 1 - back ].nHash &&
+               m_cEntries[ m_cEntries.size() - 1 - back ].cBounds == m_cLastEntries[ m_cLastEntries.size() - 1 - back ].cBounds ) {
+            ++back;
+        }
+
+        full = m_cEntries.size() + m_cLastEntries.size() - 2 * ( front + back ) > MAX_DIRTY_ENTRIES;
+        for( auto i = front; !full && i < m_cLastEntries.size() - back; ++i ) {
+            AddDirty( m_cLastEntries[ i ].cBounds );
+        }
+        for( auto i = front; !full && i < m_cEntries.size() - back; ++i ) {
+            AddDirty( m_cEntries[ i ].cBounds );
+        }
+    }
+
+    int64_t area = 0;
+    if( !full ) {
+        MergeDirty();
+        for( const auto& bounds : m_cDirty ) {
+            area += GetArea( bounds );
+        }
+
+        // clipping pays off only while a fair part of the target is kept
+        full = 2 * area > static_cast< int64_t >( cSize[ 0 ] ) * cSize[ 1 ];
+    }
+
+    swap( m_cEntries, m_cLastEntries );
+    m_cSize = cSize;
+    m_bValid = true;
+
+    m_cRects.clear();
+    m_Statistics.nLastRedrawn = 0;
+    if( full ) {
+        m_Statistics.nLastRects = 0;
+        m_Statistics.nLastArea = static_cast< uint64_t >( cSize[ 0 ] ) * cSize[ 1 ];
+        ++m_Statistics.nFullFrames;
+        return false;
+    }
+
+    for( const auto& bounds : m_cDirty ) {
+        m_cRects.push_back( { static_cast< float >( bounds[ 0 ] ), static_cast< float >( bounds[ 1 ] ),
+                              static_cast< float >( bounds[ 2 ] - bounds[ 0 ] ), static_cast< float >( bounds[ 3 ] - bounds[ 1 ] ) } );
+    }
+    m_Statistics.nLastRects = m_cRects.size();
+    m_Statistics.nLastArea = static_cast< uint64_t >( area );
+    if( m_cRects.empty() ) {
+        ++m_Statistics.nUnchangedFrames;
+    }
+    return true;
+}
+
+bool CDirtyRegion::Redraw( const CCommandList& list, IRenderBackend& backend )
+{
+    if( m_cRects.empty() ) {
+        return true;
+    }
+
+    // the entries of the current frame were swapped into the last entries
+    if( !backend.BeginPartialFrame() ) {
+        ++m_Statistics.nFullFrames;
+        return false;
+    }
+
+    const auto& cCommands = list.GetCommands();
+    for( size_t i = 0; i < m_cRects.size(); ++i ) {
+        if( !backend.PushClip( m_cRects[ i ] ) ) {
+            backend.EndFrame();
+            ++m_Statistics.nFullFrames;
+            return false;
+        }
+
+        backend.Clear();
+        backend.SetTransform( Transform::Identity() );
+        backend.SetAntialiasMode( AntialiasMode::PerPrimitive );
+
+        size_t entry = 0;
+        for( const auto& command : cCommands ) {
+            if( IsStateCommand( command ) ) {
+                list.Replay( command, backend );
+            }
+            else if( Intersects( m_cLastEntries[ entry++ ].cBounds, m_cDirty[ i ] ) ) {
+                list.Replay( command, backend );
+                ++m_Statistics.nLastRedrawn;
+            }
+        }
+
+        backend.PopClip();
+    }
+
+    if( !backend.EndFrame() ) {
+        Invalidate();
+        ++m_Statistics.nFullFrames;
+        return false;
+    }
+
+    ++m_Statistics.nPartialFrames;
+    return true;
+}
+
+const vector< RectF >& CDirtyRegion::GetRects( void ) const
+{
+    return m_cRects;
+}
+
+void CDirtyRegion::Invalidate( void )
+{
+    m_bValid = false;
+}
+
+void CDirtyRegion::SetMaxRects( size_t count )
+{
+    m_nMaxRects = max< size_t >( count, 1 );
+}
+
+const DirtyRegionStatistics& CDirtyRegion::GetStatistics( void ) const
+{
+    return m_Statistics;
+}
+
+void CDirtyRegion::Measure( const CCommandList& list, IRenderBackend& backend )
+{
+    const auto cSize = backend.GetSize();
+    auto transform = Transform::Identity();
+    auto mode = AntialiasMode::PerPrimitive;
+    auto state = Hash64( mode, Hash64( transform ) );
+
+    m_cEntries.clear();
+    for( const auto& command : list.GetCommands() ) {
+        if( command.eType == DrawCommandType::Transform ) {
+            transform = { command.x, command.y, command.w, command.h, command.x_rad, command.y_rad };
+            state = Hash64( mode, Hash64( transform ) );
+            continue;
+        }
+        if( command.eType == DrawCommandType::AntialiasMode ) {
+            mode = static_cast< AntialiasMode >( command.nColor );
+            state = Hash64( mode, Hash64( transform ) );
+            continue;
+        }
+
+        // the text offset changes whenever an earlier text or polyline does
+        auto key = command;
+        key.nTextOffset = 0;
+        auto hash = Hash64( key, state );
+
+        auto x0 = min( command.x, command.x + command.w ), x1 = max( command.x, command.x + command.w );
+        auto y0 = min( command.y, command.y + command.h ), y1 = max( command.y, command.y + command.h );
+        if( command.eType == DrawCommandType::Line ) {
+            // lines store their final position inside w and h
+            const auto half = 0.5f * fabs( command.thickness );
+            x0 = min( command.x, command.w ) - half;
+            x1 = max( command.x, command.w ) + half;
+            y0 = min( command.y, command.h ) - half;
+            y1 = max( command.y, command.h ) + half;
+        }
+        else if( command.eType == DrawCommandType::Polyline ) {
+            // polylines store the bounds of their points, the outline reaches half the thickness beyond
+            hash = Hash64( list.GetPoints( command ), command.nTextLength * sizeof( PointF ), hash );
+            const auto half = 0.5f * fabs( command.thickness );
+            x0 -= half;
+            y0 -= half;
+            x1 += half;
+            y1 += half;
+        }
+        else if( command.eType == DrawCommandType::Text ) {
+            const auto* text = list.GetText( command );
+            hash = Hash64( text, command.nTextLength * sizeof( wchar_t ), hash );
+
+            RectF bounds;
+            if( backend.MeasureText( command.x, command.y, command.w, command.h, text, command.nTextLength, command.pFont, bounds ) ) {
+                x0 = bounds.x;
+                y0 = bounds.y;
+                x1 = bounds.x + bounds.w;
+                y1 = bounds.y + bounds.h;
+            }
+        }
+
+        // transformed corners, padded by a pixel for the antialiasing
+        const float corners[ 4 ][ 2 ] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+        auto left = HUGE_VALF, top = HUGE_VALF, right = -HUGE_VALF, bottom = -HUGE_VALF;
+        auto finite = true;
+        for( const auto& corner : corners ) {
+            const auto x = corner[ 0 ] * transform.m11 + corner[ 1 ] * transform.m21 + transform.dx;
+            const auto y = corner[ 0 ] * transform.m12 + corner[ 1 ] * transform.m22 + transform.dy;
+            finite = finite && isfinite( x ) && isfinite( y );
+            left = min( left, x );
+            top = min( top, y );
+            right = max( right, x );
+            bottom = max( bottom, y );
+        }
+
+        // both ends are clamped before the cast, it is undefined for floats
+        // beyond the integer range. Infinite or NaN bounds may draw anywhere.
+        const auto width = static_cast< float >( cSize[ 0 ] ), height = static_cast< float >( cSize[ 1 ] );
+        auto clamp = []( float value, float limit ) {
+            return static_cast< int32_t >( min( max( value, 0.f ), limit ) );
+        };
+
+        Entry entry;
+        entry.nHash = hash;
+        if( finite ) {
+            entry.cBounds[ 0 ] = clamp( floor( left ) - 1.f, width );
+            entry.cBounds[ 1 ] = clamp( floor( top ) - 1.f, height );
+            entry.cBounds[ 2 ] = clamp( ceil( right ) + 1.f, width );
+            entry.cBounds[ 3 ] = clamp( ceil( bottom ) + 1.f, height );
+        }
+        else {
+            entry.cBounds = { { 0, 0, cSize[ 0 ], cSize[ 1 ] } };
+        }
+        if( entry.cBounds[ 0 ] >= entry.cBounds[ 2 ] || entry.cBounds[ 1 ] >= entry.cBounds[ 3 ] ) {
+            entry.cBounds = { { 0, 0, 0, 0 } };
+        }
+        m_cEntries.push_back( entry );
+    }
+}
+
+void CDirtyRegion::AddDirty( const Bounds& bounds )
+{
+    if( GetArea( bounds ) > 0 ) {
+        m_cDirty.push_back( bounds );
+    }
+}
+
+void CDirtyRegion::MergeDirty( void )
+{
+    for( ;; ) {
+        // overlapping rectangles would be cleared and redrawn twice
+        auto merged = false;
+        for( size_t i = 0; i < m_cDirty.size(); ++i ) {
+            for( auto j = i + 1; j < m_cDirty.size(); ) {
+                if( Intersects( m_cDirty[ i ], m_cDirty[ j ] ) ) {
+                    m_cDirty[ i ] = GetUnion( m_cDirty[ i ], m_cDirty[ j ] );
+                    m_cDirty[ j ] = m_cDirty.back();
+                    m_cDirty.pop_back();
+                    merged = true;
+                }
+                else {
+                    ++j;
+                }
+            }
+        }
+        if( merged ) {
+            continue;
+        }
+        if( m_cDirty.size() <= m_nMaxRects ) {
+            return;
+        }
+
+        // merge the pair which adds the least area
+        size_t first = 0, second = 1;
+        auto best = INT64_MAX;
+        for( size_t i = 0; i < m_cDirty.size(); ++i ) {
+            for( auto j = i + 1; j < m_cDirty.size(); ++j ) {
+                const auto cost = GetArea( GetUnion( m_cDirty[ i ], m_cDirty[ j ] ) ) - GetArea( m_cDirty[ i ] ) - GetArea( m_cDirty[ j ] );
+                if( cost < best ) {
+                    best = cost;
+                    first = i;
+                    second = j;
+                }
+            }
+        }
+        m_cDirty[ first ] = GetUnion( m_cDirty[ first ], m_cDirty[ second ] );
+        m_cDirty[ second ] = m_cDirty.back();
+        m_cDirty.pop_back();
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "CommandList.hpp"
+#include "RenderBackend.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Statistics of the incremental redraw
+     */
+    struct DirtyRegionStatistics
+    {
+        uint64_t nFullFrames      = 0;
+        uint64_t nPartialFrames   = 0;
+        uint64_t nUnchangedFrames = 0;
+        uint64_t nLastRects       = 0;
+        uint64_t nLastArea        = 0;
+        uint64_t nLastRedrawn     = 0;
+    };
+
+    /**
+     * @brief      CDirtyRegion redraws only the parts of a frame that changed.
+     *             Every drawing command gets a fingerprint, which includes the
+     *             transform and antialias mode it is drawn with, and its
+     *             bounds in target pixels. The commands of two frames are
+     *             matched from the front and from the back, the bounds of the
+     *             unmatched commands of both frames form the dirty rectangles.
+     *             Each of them is cleared behind a clip and redrawn from the
+     *             commands that intersect it.
+     */
+    class CDirtyRegion
+    {
+    public:
+        CDirtyRegion( void ) = default;
+
+        /**
+         * @brief      Compare a recorded frame with the last one and compute
+         *             the dirty rectangles
+         *
+         * @param[in]  list     recorded frame
+         * @param[in]  backend  backend the frame gets drawn with, measures
+         *                      text and reports the target size
+         *
+         * @return     bool <> false if the whole frame has to be redrawn
+         */
+        bool Update( const CCommandList& list, IRenderBackend& backend );
+
+        /**
+         * @brief      Redraw the dirty rectangles of the last Update as a
+         *             partial frame
+         *
+         * @param[in]  list     recorded frame passed to Update
+         * @param[in]  backend  target backend
+         *
+         * @return     bool <> false if the backend can't draw a partial frame,
+         *             the whole frame has to be redrawn then
+         */
+        bool Redraw( const CCommandList& list, IRenderBackend& backend );
+
+        /**
+         * @brief      Get the dirty rectangles of the last Update, empty if
+         *             nothing has changed
+         *
+         * @return     const vector< RectF >&
+         */
+        const vector< RectF >& GetRects( void ) const;
+
+        /**
+         * @brief      Let the next Update request a full redraw, has to be
+         *             called whenever the target lost its content
+         */
+        void Invalidate( void );
+
+        /**
+         * @brief      Set the maximum amount of dirty rectangles, closer ones
+         *             get merged until the amount fits
+         *
+         * @param[in]  count  amount of rectangles
+         */
+        void SetMaxRects( size_t count );
+
+        /**
+         * @brief      Get the redraw statistics
+         *
+         * @return     const DirtyRegionStatistics&
+         */
+        const DirtyRegionStatistics& GetStatistics( void ) const;
+
+    private:
+        struct Entry
+        {
+            uint64_t             nHash;
+            array< int32_t, 4 >  cBounds;
+        };
+
+        /**
+         * @brief      Fingerprint and bound every drawing command of a frame
+         */
+        void Measure( const CCommandList& list, IRenderBackend& backend );
+
+        /**
+         * @brief      Add the bounds of an entry to the dirty rectangles
+         */
+        void AddDirty( const array< int32_t, 4 >& bounds );
+
+        /**
+         * @brief      Merge the dirty rectangles until none overlap and their
+         *             amount fits
+         */
+        void MergeDirty( void );
+
+    private:
+        static constexpr size_t DEFAULT_MAX_RECTS = 8;
+        static constexpr size_t MAX_DIRTY_ENTRIES = 256;
+
+        vector< Entry >               m_cEntries;
+        vector< Entry >               m_cLastEntries;
+        vector< array< int32_t, 4 > > m_cDirty;
+        vector< RectF >               m_cRects;
+        array< int32_t, 2 >           m_cSize = { { 0, 0 } };
+        size_t                        m_nMaxRects = DEFAULT_MAX_RECTS;
+        bool                          m_bValid = false;
+        DirtyRegionStatistics         m_Statistics;
+    };
+}
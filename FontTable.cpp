@@ -0,0 +1,50 @@
+#include "FontTable.hpp"
+using namespace haze;
+
+CFontTable::CFontTable( void )
+{
+    Clear();
+}
+
+FontHandle CFontTable::Insert( const string& name, const void* pFont )
+{
+    if( name.empty() ) {
+        return 0;
+    }
+
+    auto& handle = m_cHandles[ name ];
+    if( !handle ) {
+        handle = static_cast< FontHandle >( m_cFonts.size() );
+        m_cFonts.push_back( pFont );
+    }
+    m_cFonts[ handle ] = pFont;
+    return handle;
+}
+
+FontHandle CFontTable::Find( const string& name ) const
+{
+    const auto it = m_cHandles.find( name );
+    return it != m_cHandles.end() ? it->second : 0;
+}
+
+const void* CFontTable::Get( FontHandle handle ) const
+{
+    // the unused first entry makes the invalid handle resolve to nullptr
+    return handle < m_cFonts.size() ? m_cFonts[ handle ] : nullptr;
+}
+
+const void* CFontTable::Get( const string& name ) const
+{
+    return Get( Find( name ) );
+}
+
+size_t CFontTable::GetCount( void ) const
+{
+    return m_cFonts.size() - 1;
+}
+
+void CFontTable::Clear( void )
+{
+    m_cFonts.assign( 1, nullptr );
+    m_cHandles.clear();
+}
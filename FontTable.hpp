@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Dense index of a registered font, 0 is never a valid handle
+     */
+    using FontHandle = uint32_t;
+
+    /**
+     * @brief      CFontTable interns the buffer names of the fonts. Every name
+     *             gets a handle once, resolving a handle is a bounds checked
+     *             array index, so the labels drawn every frame never hash a
+     *             string. Handles stay valid until the table is cleared.
+     */
+    class CFontTable
+    {
+    public:
+        CFontTable( void );
+
+        /**
+         * @brief      Register a font or replace the object of a registered
+         *             one, the handle of a name never changes
+         *
+         * @param[in]  name   buffer name
+         * @param[in]  pFont  backend specific font object
+         *
+         * @return     FontHandle <> 0 if the name was empty
+         */
+        FontHandle  Insert( const string& name, const void* pFont );
+
+        /**
+         * @brief      Get the handle of a registered font
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     FontHandle <> 0 if there is no such font
+         */
+        FontHandle  Find( const string& name ) const;
+
+        /**
+         * @brief      Get a registered font
+         *
+         * @param[in]  handle  font handle
+         *
+         * @return     const void* <> nullptr if the handle is invalid
+         */
+        const void* Get( FontHandle handle ) const;
+
+        /**
+         * @brief      Get a registered font by name
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     const void* <> nullptr if there is no such font
+         */
+        const void* Get( const string& name ) const;
+
+        /**
+         * @brief      Get the amount of fonts, the handles are 1 to count
+         *
+         * @return     size_t
+         */
+        size_t      GetCount( void ) const;
+
+        /**
+         * @brief      Remove every font, the handles become invalid
+         */
+        void        Clear( void );
+
+    private:
+        vector< const void* >               m_cFonts;
+        unordered_map< string, FontHandle > m_cHandles;
+    };
+}
@@ -0,0 +1,242 @@
+#include "Format.hpp"
+#include "Utf.hpp"
+#include <cmath>
+#include <cwchar>
+using namespace haze;
+
+CUtf16Writer::CUtf16Writer( wstring& buffer ) :
+    m_Buffer( buffer )
+{
+}
+
+void CUtf16Writer::Write( wchar_t c )
+{
+    *Reserve( 1 ) = c;
+    ++m_nLength;
+}
+
+void CUtf16Writer::Write( const wchar_t* text, size_t length )
+{
+    if( !text || !length ) {
+        return;
+    }
+    wmemcpy( Reserve( length ), text, length );
+    m_nLength += length;
+}
+
+void CUtf16Writer::WriteUtf8( const char* text, size_t length )
+{
+    if( !text || !length ) {
+        return;
+    }
+    m_nLength += Utf8ToUtf16( text, length, Reserve( length ) );
+}
+
+void CUtf16Writer::WriteInteger( uint64_t value, bool negative )
+{
+    wchar_t digits[ 20 ];
+    size_t count = 0;
+    do {
+        digits[ count++ ] = static_cast< wchar_t >( L'0' + value % 10 );
+        value /= 10;
+    } while( value );
+
+    auto* dst = Reserve( count + 1 );
+    if( negative ) {
+        *dst++ = L'-';
+        ++m_nLength;
+    }
+    for( size_t i = 0; i < count; ++i ) {
+        dst[ i ] = digits[ count - 1 - i ];
+    }
+    m_nLength += count;
+}
+
+void CUtf16Writer::WriteFloat( double value, int32_t precision )
+{
+    static constexpr uint64_t POWERS[ 10 ] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+    if( precision < 0 || precision > 9 ) {
+        precision = 6;
+    }
+    if( std::isnan( value ) ) {
+        Write( L"nan", 3 );
+        return;
+    }
+    if( std::signbit( value ) ) {
+        Write( L'-' );
+        value = -value;
+    }
+    if( std::isinf( value ) ) {
+        Write( L"inf", 3 );
+        return;
+    }
+
+    const auto scale = POWERS[ precision ];
+    const auto scaled = value * static_cast< double >( scale ) + 0.5;
+    if( scaled < 18446744073709551615.0 ) {
+        const auto fixed = static_cast< uint64_t >( scaled );
+        WriteInteger( fixed / scale );
+        if( precision ) {
+            auto fraction = fixed % scale;
+            auto* dst = Reserve( precision + 1 );
+            dst[ 0 ] = L'.';
+            for( auto i = precision; i > 0; --i ) {
+                dst[ i ] = static_cast< wchar_t >( L'0' + fraction % 10 );
+                fraction /= 10;
+            }
+            m_nLength += precision + 1;
+        }
+        return;
+    }
+
+    // too large for the fixed point path, there are no decimals left anyway
+    // and the lowest digits are only as exact as the division by ten
+    wchar_t digits[ 320 ];
+    size_t count = 0;
+    for( auto integer = std::floor( value ); integer >= 1.0 && count < 320; integer = std::floor( integer / 10.0 ) ) {
+        digits[ count++ ] = static_cast< wchar_t >( L'0' + static_cast< int32_t >( std::fmod( integer, 10.0 ) ) );
+    }
+    auto* dst = Reserve( count + precision + 1 );
+    for( size_t i = 0; i < count; ++i ) {
+        dst[ i ] = digits[ count - 1 - i ];
+    }
+    m_nLength += count;
+    if( precision ) {
+        dst[ count ] = L'.';
+        wmemset( dst + count + 1, L'0', precision );
+        m_nLength += precision + 1;
+    }
+}
+
+void CUtf16Writer::WriteArgument( const FormatArgument& argument, int32_t precision )
+{
+    switch( argument.eType ) {
+    case FormatArgument::Type::Signed:
+        WriteInteger( argument.i < 0 ? 0 - static_cast< uint64_t >( argument.i ) : static_cast< uint64_t >( argument.i ), argument.i < 0 );
+        break;
+    case FormatArgument::Type::Unsigned:
+        WriteInteger( argument.u );
+        break;
+    case FormatArgument::Type::Floating:
+        WriteFloat( argument.f, precision );
+        break;
+    case FormatArgument::Type::Narrow:
+        WriteUtf8( argument.pNarrow, argument.nLength );
+        break;
+    case FormatArgument::Type::Wide:
+        Write( argument.pWide, argument.nLength );
+        break;
+    case FormatArgument::Type::Character:
+        Write( static_cast< wchar_t >( argument.u ) );
+        break;
+    case FormatArgument::Type::None:
+        break;
+    }
+}
+
+const wchar_t* CUtf16Writer::data( void ) const
+{
+    return m_Buffer.data();
+}
+
+size_t CUtf16Writer::size( void ) const
+{
+    return m_nLength;
+}
+
+wchar_t* CUtf16Writer::Reserve( size_t length )
+{
+    const auto required = m_nLength + length;
+    if( required > m_Buffer.size() ) {
+        m_Buffer.resize( max( required, m_Buffer.size() * 2 ) );
+    }
+    return &m_Buffer[ m_nLength ];
+}
+
+wstring& haze::GetFormatBuffer( void )
+{
+    static thread_local wstring buffer( 0x100, L'\0' );
+    return buffer;
+}
+
+void haze::FormatSegments( CUtf16Writer& writer, const char* format, const FormatSegment* segments, size_t count, const FormatArgument* arguments )
+{
+    for( size_t i = 0; i < count; ++i ) {
+        const auto& segment = segments[ i ];
+        writer.WriteUtf8( format + segment.nOffset, segment.nLength );
+        if( segment.nArgument >= 0 ) {
+            writer.WriteArgument( arguments[ segment.nArgument ], segment.nPrecision );
+        }
+    }
+}
+
+FormatArgument haze::MakeFormatArgument( bool value )
+{
+    return MakeFormatArgument( value ? "true" : "false" );
+}
+
+FormatArgument haze::MakeFormatArgument( char value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Character;
+    argument.u = static_cast< unsigned char >( value );
+    return argument;
+}
+
+FormatArgument haze::MakeFormatArgument( wchar_t value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Character;
+    argument.u = static_cast< uint64_t >( value );
+    return argument;
+}
+
+FormatArgument haze::MakeFormatArgument( float value )
+{
+    return MakeFormatArgument( static_cast< double >( value ) );
+}
+
+FormatArgument haze::MakeFormatArgument( double value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Floating;
+    argument.f = value;
+    return argument;
+}
+
+FormatArgument haze::MakeFormatArgument( const char* value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Narrow;
+    argument.pNarrow = value;
+    argument.nLength = value ? char_traits< char >::length( value ) : 0;
+    return argument;
+}
+
+FormatArgument haze::MakeFormatArgument( const wchar_t* value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Wide;
+    argument.pWide = value;
+    argument.nLength = value ? char_traits< wchar_t >::length( value ) : 0;
+    return argument;
+}
+
+FormatArgument haze::MakeFormatArgument( const string& value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Narrow;
+    argument.pNarrow = value.data();
+    argument.nLength = value.length();
+    return argument;
+}
+
+FormatArgument haze::MakeFormatArgument( const wstring& value )
+{
+    FormatArgument argument;
+    argument.eType = FormatArgument::Type::Wide;
+    argument.pWide = value.data();
+    argument.nLength = value.length();
+    return argument;
+}
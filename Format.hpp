@@ -0,0 +1,295 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/**
+ * @brief      Wrap a string literal into a format string type, so it can be
+ *             checked and parsed at compile time:
+ *             Surface().String( x, y, "font", color, HAZE_FORMAT( "{} fps ({:.1} ms)" ), fps, ms );
+ *
+ *             Placeholders are {} and {:.N} (N = 0-9 decimals, floating point
+ *             only), braces are escaped as {{ and }}.
+ */
+#define HAZE_FORMAT( str ) [] {                                              \
+        struct FormatString : haze::FormatStringTag {                        \
+            static constexpr const char* value( void ) { return str; }       \
+        };                                                                   \
+        return FormatString();                                               \
+    }()
+
+namespace haze {
+    using namespace std;
+
+    struct FormatStringTag {};
+
+    template< typename T >
+    using IsFormatString = is_base_of< FormatStringTag, T >;
+
+    /**
+     * @brief      A literal run of the format string, optionally followed by
+     *             an argument
+     */
+    struct FormatSegment
+    {
+        uint32_t nOffset;
+        uint32_t nLength;
+        int32_t  nArgument;
+        int32_t  nPrecision;
+    };
+
+    struct FormatInfo
+    {
+        bool   bValid;
+        size_t nSegments;
+        size_t nArguments;
+    };
+
+    /**
+     * @brief      A type erased format argument
+     */
+    struct FormatArgument
+    {
+        enum class Type : uint32_t
+        {
+            None,
+            Signed,
+            Unsigned,
+            Floating,
+            Narrow,
+            Wide,
+            Character
+        };
+
+        Type eType = Type::None;
+        union
+        {
+            int64_t        i;
+            uint64_t       u;
+            double         f;
+            const char*    pNarrow;
+            const wchar_t* pWide;
+        };
+        size_t nLength = 0;
+
+        FormatArgument( void ) : u( 0 ) {}
+    };
+
+    /**
+     * @brief      CUtf16Writer appends utf-16 text to a reusable buffer. The
+     *             buffer only grows, so a warmed up buffer does not allocate.
+     */
+    class CUtf16Writer
+    {
+    public:
+        explicit CUtf16Writer( wstring& buffer );
+
+        void Write( wchar_t c );
+        void Write( const wchar_t* text, size_t length );
+        void WriteUtf8( const char* text, size_t length );
+        void WriteInteger( uint64_t value, bool negative = false );
+
+        /**
+         * @brief      Write a floating point value in fixed notation
+         *
+         * @param[in]  value      value
+         * @param[in]  precision  decimals, -1 for the default of 6
+         */
+        void WriteFloat( double value, int32_t precision );
+
+        /**
+         * @brief      Write a type erased argument
+         *
+         * @param[in]  argument   argument
+         * @param[in]  precision  decimals of floating point values
+         */
+        void WriteArgument( const FormatArgument& argument, int32_t precision );
+
+        const wchar_t* data( void ) const;
+        size_t size( void ) const;
+
+    private:
+        /**
+         * @brief      Make room for more units
+         *
+         * @param[in]  length  amount of units
+         *
+         * @return     wchar_t* <> write position
+         */
+        wchar_t* Reserve( size_t length );
+
+    private:
+        wstring& m_Buffer;
+        size_t   m_nLength = 0;
+    };
+
+    /**
+     * @brief      Get the reusable format buffer of the calling thread
+     *
+     * @return     wstring&
+     */
+    wstring& GetFormatBuffer( void );
+
+    /**
+     * @brief      Write every segment of a parsed format string
+     *
+     * @param[in]  writer     target writer
+     * @param[in]  format     format string
+     * @param[in]  segments   parsed segments
+     * @param[in]  count      amount of segments
+     * @param[in]  arguments  type erased arguments
+     */
+    void FormatSegments( CUtf16Writer& writer, const char* format, const FormatSegment* segments, size_t count, const FormatArgument* arguments );
+
+    constexpr void EmitSegment( FormatInfo& info, FormatSegment* pSegments, size_t offset, size_t length, int32_t argument, int32_t precision )
+    {
+        if( pSegments ) {
+            pSegments[ info.nSegments ] = { static_cast< uint32_t >( offset ), static_cast< uint32_t >( length ), argument, precision };
+        }
+        ++info.nSegments;
+    }
+
+    /**
+     * @brief      Parse a format string, usable at compile time
+     *
+     * @param[in]  format     format string
+     * @param[out] pSegments  optional, receives the segments
+     *
+     * @return     FormatInfo
+     */
+    constexpr FormatInfo ParseFormat( const char* format, FormatSegment* pSegments = nullptr )
+    {
+        FormatInfo info = { true, 0, 0 };
+
+        size_t start = 0, i = 0;
+        while( format[ i ] ) {
+            const auto c = format[ i ];
+            if( ( c == '{' || c == '}' ) && format[ i + 1 ] == c ) {
+                EmitSegment( info, pSegments, start, i + 1 - start, -1, -1 );
+                i += 2;
+                start = i;
+                continue;
+            }
+            if( c == '}' ) {
+                info.bValid = false;
+                return info;
+            }
+            if( c == '{' ) {
+                int32_t precision = -1;
+                auto j = i + 1;
+                if( format[ j ] == ':' ) {
+                    if( format[ j + 1 ] != '.' || format[ j + 2 ] < '0' || format[ j + 2 ] > '9' ) {
+                        info.bValid = false;
+                        return info;
+                    }
+                    precision = format[ j + 2 ] - '0';
+                    j += 3;
+                }
+                if( format[ j ] != '}' ) {
+                    info.bValid = false;
+                    return info;
+                }
+                EmitSegment( info, pSegments, start, i - start, static_cast< int32_t >( info.nArguments++ ), precision );
+                i = j + 1;
+                start = i;
+                continue;
+            }
+            ++i;
+        }
+        if( i > start ) {
+            EmitSegment( info, pSegments, start, i - start, -1, -1 );
+        }
+        return info;
+    }
+
+    /**
+     * @brief      The compile time parsed form of a format string type
+     */
+    template< typename TFormat >
+    struct ParsedFormat
+    {
+        struct Table
+        {
+            FormatSegment data[ ParseFormat( TFormat::value() ).nSegments + 1 ];
+        };
+
+        static constexpr Table Build( void )
+        {
+            Table table = {};
+            ParseFormat( TFormat::value(), table.data );
+            return table;
+        }
+
+        static constexpr FormatInfo info = ParseFormat( TFormat::value() );
+        static constexpr Table      table = Build();
+    };
+
+    template< typename TFormat >
+    constexpr FormatInfo ParsedFormat< TFormat >::info;
+
+    template< typename TFormat >
+    constexpr typename ParsedFormat< TFormat >::Table ParsedFormat< TFormat >::table;
+
+    /**
+     * @brief      Are precisions only used for floating point arguments?
+     */
+    template< typename TFormat, typename... Args >
+    constexpr bool CheckFormatPrecision( void )
+    {
+        constexpr bool floating[] = { is_floating_point< Args >::value..., false };
+        for( size_t i = 0; i < ParsedFormat< TFormat >::info.nSegments; ++i ) {
+            const auto& segment = ParsedFormat< TFormat >::table.data[ i ];
+            if( segment.nArgument >= 0 && segment.nPrecision >= 0 &&
+                static_cast< size_t >( segment.nArgument ) < sizeof...( Args ) && !floating[ segment.nArgument ] ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template< typename T, typename = enable_if_t< is_integral< T >::value && !is_same< T, bool >::value && !is_same< T, char >::value && !is_same< T, wchar_t >::value > >
+    FormatArgument MakeFormatArgument( T value )
+    {
+        FormatArgument argument;
+        if( is_signed< T >::value ) {
+            argument.eType = FormatArgument::Type::Signed;
+            argument.i = static_cast< int64_t >( value );
+        }
+        else {
+            argument.eType = FormatArgument::Type::Unsigned;
+            argument.u = static_cast< uint64_t >( value );
+        }
+        return argument;
+    }
+
+    FormatArgument MakeFormatArgument( bool value );
+    FormatArgument MakeFormatArgument( char value );
+    FormatArgument MakeFormatArgument( wchar_t value );
+    FormatArgument MakeFormatArgument( float value );
+    FormatArgument MakeFormatArgument( double value );
+    FormatArgument MakeFormatArgument( const char* value );
+    FormatArgument MakeFormatArgument( const wchar_t* value );
+    FormatArgument MakeFormatArgument( const string& value );
+    FormatArgument MakeFormatArgument( const wstring& value );
+
+    /**
+     * @brief      Format the arguments into a writer. The format string is
+     *             validated against the arguments at compile time.
+     *
+     * @param[in]  writer  target writer
+     * @param[in]  <unnamed>  format string (HAZE_FORMAT)
+     * @param[in]  args    arguments
+     */
+    template< typename TFormat, typename... Args >
+    void Format( CUtf16Writer& writer, TFormat, const Args&... args )
+    {
+        using Parsed = ParsedFormat< TFormat >;
+        static_assert( Parsed::info.bValid, "invalid format string" );
+        static_assert( Parsed::info.nArguments == sizeof...( Args ), "the format string does not match the amount of arguments" );
+        static_assert( CheckFormatPrecision< TFormat, decay_t< Args >... >(), "a precision is only allowed for floating point arguments" );
+
+        const FormatArgument arguments[] = { MakeFormatArgument( args )..., FormatArgument() };
+        FormatSegments( writer, TFormat::value(), Parsed::table.data, Parsed::info.nSegments, arguments );
+    }
+}
@@ -0,0 +1,210 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#if defined( _WIN32 )
+#include <Windows.h>
+#include <timeapi.h>
+#pragma comment( lib, "winmm.lib" )
+
+#if !defined( CREATE_WAITABLE_TIMER_HIGH_RESOLUTION )
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+using namespace haze;
+
+#if defined( _WIN32 )
+namespace {
+    /**
+     * @brief      CWaitableTimer sleeps on a high resolution timer. The thread
+     *             sleep wakes up on a tick of the system timer, which is
+     *             15.6 ms apart by default.
+     */
+    class CWaitableTimer
+    {
+    public:
+        CWaitableTimer( void ) :
+            m_hTimer( CreateWaitableTimerExW( nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS ) )
+        {
+        }
+
+        ~CWaitableTimer( void )
+        {
+            if( m_hTimer ) {
+                CloseHandle( m_hTimer );
+            }
+        }
+
+        CWaitableTimer( const CWaitableTimer& ) = delete;
+        CWaitableTimer& operator = ( const CWaitableTimer& ) = delete;
+
+        /**
+         * @brief      Sleep for the duration
+         *
+         * @param[in]  duration  duration in nanoseconds
+         *
+         * @return     bool <> false if there is no high resolution timer
+         */
+        bool Sleep( uint64_t duration )
+        {
+            if( !m_hTimer ) {
+                return false;
+            }
+
+            // negative due times are relative, in units of 100 ns
+            LARGE_INTEGER dueTime;
+            dueTime.QuadPart = -static_cast< LONGLONG >( duration / 100 + 1 );
+            return SetWaitableTimer( m_hTimer, &dueTime, 0, nullptr, nullptr, FALSE ) &&
+                   WaitForSingleObject( m_hTimer, INFINITE ) == WAIT_OBJECT_0;
+        }
+
+    private:
+        HANDLE m_hTimer = nullptr;
+    };
+}
+#endif
+
+uint64_t CSteadyClock::Now( void ) const
+{
+    return static_cast< uint64_t >( chrono::duration_cast< chrono::nanoseconds >( chrono::steady_clock::now().time_since_epoch() ).count() );
+}
+
+void CSteadyClock::Sleep( uint64_t duration )
+{
+#if defined( _WIN32 )
+    // one timer per sleeping thread, windows before 10 1803 has none and
+    // raises the resolution of the system timer around the sleep instead
+    static thread_local CWaitableTimer timer;
+    if( timer.Sleep( duration ) ) {
+        return;
+    }
+
+    timeBeginPeriod( 1 );
+    this_thread::sleep_for( chrono::nanoseconds( duration ) );
+    timeEndPeriod( 1 );
+#else
+    this_thread::sleep_for( chrono::nanoseconds( duration ) );
+#endif
+}
+
+CFramePacer::CFramePacer( IClock* pClock ) :
+    m_pClock( pClock ? pClock : &m_SteadyClock )
+{
+}
+
+void CFramePacer::SetTargetFramesPerSecond( uint32_t fps )
+{
+    m_nTargetFramesPerSecond = fps;
+    m_nInterval = fps ? 1000000000ull / fps : 0;
+    m_bScheduled = false;
+}
+
+uint32_t CFramePacer::GetTargetFramesPerSecond( void ) const
+{
+    return m_nTargetFramesPerSecond;
+}
+
+void CFramePacer::SetSpinDuration( uint64_t duration )
+{
+    m_nSpinDuration = duration;
+}
+
+void CFramePacer::SetIdleInterval( uint64_t minimum, uint64_t maximum )
+{
+    m_nMinIdleInterval = minimum;
+    m_nMaxIdleInterval = max( minimum, maximum );
+}
+
+void CFramePacer::Wait( bool visible )
+{
+    auto interval = m_nInterval;
+    if( visible ) {
+        m_nIdleInterval = 0;
+    }
+    else {
+        m_nIdleInterval = m_nIdleInterval ? min( m_nIdleInterval * 2, m_nMaxIdleInterval ) : m_nMinIdleInterval;
+        interval = max( interval, m_nIdleInterval );
+        ++m_Statistics.nIdleFrames;
+    }
+
+    auto now = m_pClock->Now();
+    if( !m_bScheduled ) {
+        m_nDeadline = m_nLastFrame = now;
+        m_bScheduled = true;
+    }
+
+    // the deadlines advance by whole intervals so the rate does not drift
+    // with the wake up latency, a frame which missed its slot restarts the
+    // schedule instead of rushing the following ones
+    auto deadline = m_nDeadline + interval;
+    if( now > deadline + interval ) {
+        deadline = now;
+        ++m_Statistics.nMissed;
+    }
+    else if( interval ) {
+        now = WaitUntil( deadline );
+    }
+    else {
+        deadline = now;
+    }
+
+    const auto jitter = now - min( now, deadline );
+    m_nTotalJitter += jitter;
+    m_Statistics.nMaxJitter = max( m_Statistics.nMaxJitter, jitter );
+
+    m_Statistics.nLastInterval = now - m_nLastFrame;
+    m_nTotalInterval += m_Statistics.nLastInterval;
+    m_Statistics.nTargetInterval = interval;
+    ++m_Statistics.nFrames;
+
+    m_nDeadline = deadline;
+    m_nLastFrame = now;
+}
+
+PacingStatistics CFramePacer::GetStatistics( void ) const
+{
+    auto statistics = m_Statistics;
+    statistics.nSpinDuration = GetSpinDuration();
+    if( statistics.nFrames ) {
+        statistics.nAverageInterval = m_nTotalInterval / statistics.nFrames;
+        statistics.nAverageJitter = m_nTotalJitter / statistics.nFrames;
+    }
+    return statistics;
+}
+
+void CFramePacer::Reset( void )
+{
+    m_Statistics = PacingStatistics();
+    m_nTotalInterval = 0;
+    m_nTotalJitter = 0;
+    m_nIdleInterval = 0;
+    m_bScheduled = false;
+}
+
+uint64_t CFramePacer::GetSpinDuration( void ) const
+{
+    return max( m_nSpinDuration, m_nSleepOvershoot );
+}
+
+uint64_t CFramePacer::WaitUntil( uint64_t deadline )
+{
+    auto now = m_pClock->Now();
+    const auto spin = GetSpinDuration();
+    if( now + spin < deadline ) {
+        const auto duration = deadline - now - spin;
+        m_pClock->Sleep( duration );
+        const auto woken = m_pClock->Now();
+
+        // the margin follows the largest recent overshoot and only shrinks
+        // slowly, a single short sleep must not make the next one miss
+        const auto overshoot = woken - min( woken, now + duration );
+        m_nSleepOvershoot = max( overshoot, m_nSleepOvershoot - m_nSleepOvershoot / 16 );
+        now = woken;
+    }
+    while( now < deadline ) {
+        now = m_pClock->Now();
+    }
+    return now;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include <cstdint>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Time source of the frame pacer, times in nanoseconds
+     */
+    class IClock
+    {
+    public:
+        virtual ~IClock( void ) = default;
+
+        /**
+         * @brief      Get the current time of a monotonic clock
+         *
+         * @return     uint64_t
+         */
+        virtual uint64_t Now( void ) const = 0;
+
+        /**
+         * @brief      Give up the cpu for roughly the passed duration, may
+         *             oversleep by the scheduler granularity
+         *
+         * @param[in]  duration  duration
+         */
+        virtual void     Sleep( uint64_t duration ) = 0;
+    };
+
+    /**
+     * @brief      IClock on top of the steady clock and the thread sleep
+     */
+    class CSteadyClock : public IClock
+    {
+    public:
+        uint64_t Now( void ) const override;
+        void     Sleep( uint64_t duration ) override;
+    };
+
+    /**
+     * @brief      Pacing statistics, times in nanoseconds
+     */
+    struct PacingStatistics
+    {
+        uint64_t nFrames          = 0;
+        uint64_t nIdleFrames      = 0;
+        uint64_t nMissed          = 0;
+        uint64_t nTargetInterval  = 0;
+        uint64_t nLastInterval    = 0;
+        uint64_t nAverageInterval = 0;
+        uint64_t nAverageJitter   = 0;
+        uint64_t nMaxJitter       = 0;
+        uint64_t nSpinDuration    = 0;
+    };
+
+    /**
+     * @brief      CFramePacer spaces the frames of a render loop to a target
+     *             rate. It sleeps through the bulk of the wait and spins the
+     *             rest, since a sleep can overshoot by the scheduler
+     *             granularity. The spun part grows to the overshoot the
+     *             sleeps actually showed. While nothing is visible the interval doubles
+     *             up to the idle limit, so a hidden overlay barely uses the cpu.
+     *             The jitter is the distance between the scheduled and the
+     *             actual start of a frame.
+     */
+    class CFramePacer
+    {
+    public:
+        /**
+         * @brief      Create the pacer
+         *
+         * @param[in]  pClock  time source, nullptr for the steady clock. Has to
+         *                     outlive the pacer.
+         */
+        explicit CFramePacer( IClock* pClock = nullptr );
+
+        /**
+         * @brief      Set the target frame rate
+         *
+         * @param[in]  fps   frames per second, 0 for no limit
+         */
+        void             SetTargetFramesPerSecond( uint32_t fps );
+
+        /**
+         * @brief      Get the target frame rate
+         *
+         * @return     uint32_t <> 0 if there is no limit
+         */
+        uint32_t         GetTargetFramesPerSecond( void ) const;
+
+        /**
+         * @brief      Set the least part of a wait which is spun instead of
+         *             slept, the pacer spins longer while the sleeps overshoot
+         *             by more
+         *
+         * @param[in]  duration  duration in nanoseconds
+         */
+        void             SetSpinDuration( uint64_t duration );
+
+        /**
+         * @brief      Set the interval bounds of the idle backoff. The first
+         *             idle frame waits at least the minimum, every further one
+         *             twice as long up to the maximum.
+         *
+         * @param[in]  minimum  interval in nanoseconds
+         * @param[in]  maximum  interval in nanoseconds
+         */
+        void             SetIdleInterval( uint64_t minimum, uint64_t maximum );
+
+        /**
+         * @brief      Wait until the next frame is due
+         *
+         * @param[in]  visible  did the finished frame show anything? Hidden
+         *                      frames back off.
+         */
+        void             Wait( bool visible );
+
+        /**
+         * @brief      Get the pacing statistics
+         *
+         * @return     PacingStatistics
+         */
+        PacingStatistics GetStatistics( void ) const;
+
+        /**
+         * @brief      Reset the pacing statistics and the schedule
+         */
+        void             Reset( void );
+
+    private:
+        /**
+         * @brief      Get the part of a wait which is spun
+         *
+         * @return     uint64_t
+         */
+        uint64_t         GetSpinDuration( void ) const;
+
+        /**
+         * @brief      Sleep and spin until the deadline
+         *
+         * @param[in]  deadline  deadline
+         *
+         * @return     uint64_t <> time after the wait
+         */
+        uint64_t         WaitUntil( uint64_t deadline );
+
+    private:
+        CSteadyClock     m_SteadyClock;
+        IClock*          m_pClock = nullptr;
+        uint32_t         m_nTargetFramesPerSecond = 0;
+        uint64_t         m_nInterval = 0;
+        uint64_t         m_nSpinDuration = 2000000;
+        uint64_t         m_nSleepOvershoot = 0;
+        uint64_t         m_nMinIdleInterval = 16666667;
+        uint64_t         m_nMaxIdleInterval = 250000000;
+        uint64_t         m_nIdleInterval = 0;
+        uint64_t         m_nDeadline = 0;
+        uint64_t         m_nLastFrame = 0;
+        uint64_t         m_nTotalInterval = 0;
+        uint64_t         m_nTotalJitter = 0;
+        bool             m_bScheduled = false;
+        PacingStatistics m_Statistics;
+    };
+}
@@ -0,0 +1,173 @@
+#include "FrameTimer.hpp"
+#include <algorithm>
+using namespace haze;
+
+CTimingHistogram::CTimingHistogram( void )
+{
+    Reset();
+}
+
+void CTimingHistogram::Add( uint64_t sample )
+{
+    if( m_nCount == WINDOW ) {
+        const auto oldest = m_cSamples[ m_nNext ];
+        --m_cBuckets[ GetBucket( oldest ) ];
+        m_nTotal -= oldest;
+    }
+    else {
+        ++m_nCount;
+    }
+
+    m_cSamples[ m_nNext ] = sample;
+    m_nNext = ( m_nNext + 1 ) % WINDOW;
+    ++m_cBuckets[ GetBucket( sample ) ];
+    m_nTotal += sample;
+}
+
+TimingStatistics CTimingHistogram::GetStatistics( void ) const
+{
+    TimingStatistics statistics;
+    if( !m_nCount ) {
+        return statistics;
+    }
+
+    // the extremes are exact, a single bucket could hide them
+    statistics.nSamples = m_nCount;
+    statistics.nMin = UINT64_MAX;
+    for( size_t i = 0; i < m_nCount; ++i ) {
+        statistics.nMin = min( statistics.nMin, m_cSamples[ i ] );
+        statistics.nMax = max( statistics.nMax, m_cSamples[ i ] );
+    }
+    statistics.nAverage = m_nTotal / m_nCount;
+
+    const size_t ranks[] = { ( m_nCount * 50 + 99 ) / 100, ( m_nCount * 95 + 99 ) / 100, ( m_nCount * 99 + 99 ) / 100 };
+    uint64_t* percentiles[] = { &statistics.nP50, &statistics.nP95, &statistics.nP99 };
+
+    size_t seen = 0, rank = 0;
+    for( size_t bucket = 0; bucket < BUCKETS && rank < 3; ++bucket ) {
+        seen += m_cBuckets[ bucket ];
+        while( rank < 3 && seen >= ranks[ rank ] ) {
+            *percentiles[ rank++ ] = min( max( GetBucketLimit( bucket ), statistics.nMin ), statistics.nMax );
+        }
+    }
+    return statistics;
+}
+
+uint64_t CTimingHistogram::GetTotal( void ) const
+{
+    return m_nTotal;
+}
+
+void CTimingHistogram::Reset( void )
+{
+    m_cBuckets.fill( 0 );
+    m_nNext = 0;
+    m_nCount = 0;
+    m_nTotal = 0;
+}
+
+size_t CTimingHistogram::GetBucket( uint64_t sample )
+{
+    if( sample < 16 ) {
+        return static_cast< size_t >( sample );
+    }
+
+    // position of the leading bit, followed by the next three bits
+    size_t exponent = 4;
+    while( exponent < 63 && ( sample >> ( exponent + 1 ) ) ) {
+        ++exponent;
+    }
+    const auto mantissa = static_cast< size_t >( sample >> ( exponent - 3 ) ) & 7;
+    return 16 + ( exponent - 4 ) * 8 + mantissa;
+}
+
+uint64_t CTimingHistogram::GetBucketLimit( size_t bucket )
+{
+    if( bucket < 16 ) {
+        return bucket;
+    }
+
+    const auto exponent = ( bucket - 16 ) / 8 + 4;
+    const auto mantissa = static_cast< uint64_t >( ( bucket - 16 ) % 8 );
+    return ( ( 9 + mantissa ) << ( exponent - 3 ) ) - 1;
+}
+
+CFrameTimer::CFrameTimer( IClock* pClock ) :
+    m_pClock( pClock ? pClock : &m_SteadyClock )
+{
+}
+
+void CFrameTimer::BeginFrame( void )
+{
+    const auto now = m_pClock->Now();
+    if( m_bRunning ) {
+        m_FrameTime.Add( now - m_nFrameStart );
+    }
+    m_nFrameStart = now;
+    m_bRunning = true;
+}
+
+void CFrameTimer::EndFrame( void )
+{
+    ++m_nFrames;
+    Publish();
+}
+
+void CFrameTimer::Pause( void )
+{
+    m_bRunning = false;
+}
+
+void CFrameTimer::BeginCallbacks( void )
+{
+    m_nCallbackStart = m_pClock->Now();
+}
+
+void CFrameTimer::EndCallbacks( void )
+{
+    m_CallbackTime.Add( m_pClock->Now() - m_nCallbackStart );
+}
+
+void CFrameTimer::BeginPresent( void )
+{
+    m_nPresentStart = m_pClock->Now();
+}
+
+void CFrameTimer::EndPresent( void )
+{
+    m_PresentTime.Add( m_pClock->Now() - m_nPresentStart );
+}
+
+uint64_t CFrameTimer::GetFramesPerSecond( void ) const
+{
+    return GetTimings().nFramesPerSecond;
+}
+
+FrameTimings CFrameTimer::GetTimings( void ) const
+{
+    return m_Snapshot.Load();
+}
+
+void CFrameTimer::Reset( void )
+{
+    m_FrameTime.Reset();
+    m_CallbackTime.Reset();
+    m_PresentTime.Reset();
+    m_nFrames = 0;
+    m_bRunning = false;
+    Publish();
+}
+
+void CFrameTimer::Publish( void )
+{
+    FrameTimings timings;
+    timings.nFrames = m_nFrames;
+    timings.FrameTime = m_FrameTime.GetStatistics();
+    timings.CallbackTime = m_CallbackTime.GetStatistics();
+    timings.PresentTime = m_PresentTime.GetStatistics();
+    if( m_FrameTime.GetTotal() ) {
+        timings.nFramesPerSecond = ( timings.FrameTime.nSamples * 1000000000ull + m_FrameTime.GetTotal() / 2 ) / m_FrameTime.GetTotal();
+    }
+
+    m_Snapshot.Store( timings );
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "FramePacer.hpp"
+#include "SequenceLock.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Distribution of a timed phase over the rolling window, times
+     *             in nanoseconds. The percentiles are accurate to 1/8 of
+     *             their power of two.
+     */
+    struct TimingStatistics
+    {
+        uint64_t nSamples = 0;
+        uint64_t nMin     = 0;
+        uint64_t nP50     = 0;
+        uint64_t nP95     = 0;
+        uint64_t nP99     = 0;
+        uint64_t nMax     = 0;
+        uint64_t nAverage = 0;
+    };
+
+    /**
+     * @brief      Snapshot of the frame timer
+     */
+    struct FrameTimings
+    {
+        uint64_t         nFrames          = 0;
+        uint64_t         nFramesPerSecond = 0;
+        TimingStatistics FrameTime;
+        TimingStatistics CallbackTime;
+        TimingStatistics PresentTime;
+    };
+
+    /**
+     * @brief      CTimingHistogram keeps the last WINDOW samples of a phase
+     *             and a log-linear histogram of them. Every power of two is
+     *             split into 8 buckets, so adding a sample and reading the
+     *             percentiles take constant time.
+     */
+    class CTimingHistogram
+    {
+    public:
+        static constexpr size_t WINDOW = 256;
+
+    public:
+        CTimingHistogram( void );
+
+        /**
+         * @brief      Add a sample, the oldest one leaves the window
+         *
+         * @param[in]  sample  duration in nanoseconds
+         */
+        void             Add( uint64_t sample );
+
+        /**
+         * @brief      Get the distribution of the window
+         *
+         * @return     TimingStatistics
+         */
+        TimingStatistics GetStatistics( void ) const;
+
+        /**
+         * @brief      Get the sum of the samples inside the window
+         *
+         * @return     uint64_t
+         */
+        uint64_t         GetTotal( void ) const;
+
+        /**
+         * @brief      Remove every sample
+         */
+        void             Reset( void );
+
+    private:
+        static constexpr size_t BUCKETS = 16 + 60 * 8;
+
+        static size_t    GetBucket( uint64_t sample );
+        static uint64_t  GetBucketLimit( size_t bucket );
+
+    private:
+        array< uint64_t, WINDOW >  m_cSamples;
+        array< uint16_t, BUCKETS > m_cBuckets;
+        size_t                     m_nNext = 0;
+        size_t                     m_nCount = 0;
+        uint64_t                   m_nTotal = 0;
+    };
+
+    /**
+     * @brief      CFrameTimer measures the frames of one render loop on a
+     *             monotonic clock: the time between two frame starts, the
+     *             time the callbacks took and the time to present. Only the
+     *             render loop may call the Begin and End functions, the
+     *             snapshot is published through a sequence lock and can be
+     *             read from any thread without blocking the render loop.
+     */
+    class CFrameTimer
+    {
+    public:
+        /**
+         * @brief      Create the timer
+         *
+         * @param[in]  pClock  time source, nullptr for the steady clock. Has to
+         *                     outlive the timer.
+         */
+        explicit CFrameTimer( IClock* pClock = nullptr );
+
+        CFrameTimer( const CFrameTimer& ) = delete;
+        CFrameTimer& operator = ( const CFrameTimer& ) = delete;
+
+        /**
+         * @brief      Start a frame, the frame time is measured between two
+         *             consecutive starts
+         */
+        void         BeginFrame( void );
+
+        /**
+         * @brief      Finish the frame and publish a new snapshot
+         */
+        void         EndFrame( void );
+
+        /**
+         * @brief      Interrupt the measurement, the next frame does not
+         *             count the time in between. Used while nothing is drawn.
+         */
+        void         Pause( void );
+
+        void         BeginCallbacks( void );
+        void         EndCallbacks( void );
+        void         BeginPresent( void );
+        void         EndPresent( void );
+
+        /**
+         * @brief      Get the frames per second of the rolling window, can be
+         *             called from any thread
+         *
+         * @return     uint64_t
+         */
+        uint64_t     GetFramesPerSecond( void ) const;
+
+        /**
+         * @brief      Get the latest snapshot, can be called from any thread
+         *
+         * @return     FrameTimings
+         */
+        FrameTimings GetTimings( void ) const;
+
+        /**
+         * @brief      Remove every sample, only from the render loop
+         */
+        void         Reset( void );
+
+    private:
+        void         Publish( void );
+
+    private:
+        CSteadyClock                       m_SteadyClock;
+        IClock*                            m_pClock = nullptr;
+        CTimingHistogram                   m_FrameTime;
+        CTimingHistogram                   m_CallbackTime;
+        CTimingHistogram                   m_PresentTime;
+        uint64_t                           m_nFrameStart = 0;
+        uint64_t                           m_nCallbackStart = 0;
+        uint64_t                           m_nPresentStart = 0;
+        uint64_t                           m_nFrames = 0;
+        bool                               m_bRunning = false;
+        CSequenceLock< FrameTimings >      m_Snapshot;
+    };
+}
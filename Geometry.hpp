@@ -0,0 +1,23 @@
+#pragma once
+
+namespace haze {
+    /**
+     * @brief      Point in pixels
+     */
+    struct PointF
+    {
+        float x;
+        float y;
+    };
+
+    /**
+     * @brief      Axis aligned rectangle
+     */
+    struct RectF
+    {
+        float x;
+        float y;
+        float w;
+        float h;
+    };
+}
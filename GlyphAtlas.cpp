@@ -0,0 +1,174 @@
+#include "GlyphAtlas.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+using namespace haze;
+
+const GlyphQuad* CGlyphAtlas::Get( const CTrueTypeFont& face, float size, uint32_t glyph )
+{
+    // sizes are told apart in steps of 1/64 pixel
+    const Key key = { &face, static_cast< uint32_t >( max( size, 0.f ) * 64.f + 0.5f ), glyph };
+    auto it = m_cGlyphs.find( key );
+    if( it != m_cGlyphs.end() ) {
+        ++m_Statistics.nHits;
+        return it->second.bEmpty ? nullptr : &it->second.Quad;
+    }
+    ++m_Statistics.nMisses;
+
+    Entry entry = {};
+    entry.bEmpty = true;
+
+    const auto scale = static_cast< float >( key.nSize ) / 64.f / static_cast< float >( max( face.GetUnitsPerEm(), 1 ) );
+    array< int32_t, 4 > bounds;
+    if( key.nSize && face.GetBounds( glyph, bounds ) && face.GetOutline( glyph, m_cPoints, m_cContours ) ) {
+        // font units point up, pixels point down
+        const auto left = static_cast< int32_t >( floor( static_cast< float >( bounds[ 0 ] ) * scale ) );
+        const auto top = static_cast< int32_t >( floor( static_cast< float >( -bounds[ 3 ] ) * scale ) );
+        const auto w = static_cast< int32_t >( ceil( static_cast< float >( bounds[ 2 ] ) * scale ) ) - left;
+        const auto h = static_cast< int32_t >( ceil( static_cast< float >( -bounds[ 1 ] ) * scale ) ) - top;
+
+        int32_t x = 0, y = 0;
+        auto allocated = w > 0 && h > 0 && Allocate( w, h, x, y );
+        if( !allocated && w > 0 && h > 0 ) {
+            Reset();
+            allocated = Allocate( w, h, x, y );
+        }
+
+        if( allocated ) {
+            m_Rasterizer.Reset( left, top, w, h );
+            CTrueTypeFont::ForEachSegment( m_cPoints, m_cContours, [ & ]( const OutlinePoint& p0, const OutlinePoint& p1 ) {
+                m_Rasterizer.AddLine( { p0.x * scale, -p0.y * scale }, { p1.x * scale, -p1.y * scale } );
+            }, [ & ]( const OutlinePoint& p0, const OutlinePoint& p1, const OutlinePoint& p2 ) {
+                m_Rasterizer.AddQuadratic( { p0.x * scale, -p0.y * scale }, { p1.x * scale, -p1.y * scale }, { p2.x * scale, -p2.y * scale } );
+            } );
+            m_Rasterizer.Resolve();
+
+            for( int32_t row = 0; row < h; ++row ) {
+                int32_t begin, end;
+                const auto* pCoverage = m_Rasterizer.GetRow( row, begin, end );
+                auto* pRow = m_cPixels.data() + static_cast< size_t >( y + row ) * WIDTH + x;
+                memset( pRow, 0, static_cast< size_t >( w ) );
+                if( begin < end ) {
+                    memcpy( pRow + begin, pCoverage + begin, static_cast< size_t >( end - begin ) );
+                }
+            }
+
+            entry.Quad = { static_cast< uint16_t >( x ), static_cast< uint16_t >( y ), static_cast< uint16_t >( w ), static_cast< uint16_t >( h ),
+                           static_cast< int16_t >( left ), static_cast< int16_t >( top ) };
+            entry.bEmpty = false;
+        }
+    }
+
+    auto& stored = m_cGlyphs.emplace( key, entry ).first->second;
+    m_Statistics.nGlyphs = m_cGlyphs.size();
+    return stored.bEmpty ? nullptr : &stored.Quad;
+}
+
+const uint8_t* CGlyphAtlas::GetRow( int32_t y ) const
+{
+    return m_cPixels.data() + static_cast< size_t >( y ) * WIDTH;
+}
+
+int32_t CGlyphAtlas::GetWidth( void ) const
+{
+    return WIDTH;
+}
+
+int32_t CGlyphAtlas::GetHeight( void ) const
+{
+    return m_nHeight;
+}
+
+const GlyphAtlasStatistics& CGlyphAtlas::GetStatistics( void ) const
+{
+    return m_Statistics;
+}
+
+void CGlyphAtlas::Remove( const CTrueTypeFont& face )
+{
+    // the space of the glyphs is only reclaimed once the atlas starts over
+    for( auto it = m_cGlyphs.begin(); it != m_cGlyphs.end(); ) {
+        if( it->first.pFace == &face ) {
+            it = m_cGlyphs.erase( it );
+        }
+        else {
+            ++it;
+        }
+    }
+    m_Statistics.nGlyphs = m_cGlyphs.size();
+}
+
+void CGlyphAtlas::Clear( void )
+{
+    m_cGlyphs.clear();
+    m_cShelves.clear();
+    m_cPixels.clear();
+    m_cPixels.shrink_to_fit();
+    m_nHeight = 0;
+    m_Statistics.nGlyphs = 0;
+    m_Statistics.nBytes = 0;
+}
+
+bool CGlyphAtlas::Allocate( int32_t w, int32_t h, int32_t& x, int32_t& y )
+{
+    // a pixel of padding keeps the glyphs apart
+    const auto paddedW = w + 1, paddedH = h + 1;
+    if( paddedW > WIDTH || paddedH > MAX_HEIGHT ) {
+        return false;
+    }
+
+    // the lowest shelf which is not much higher than the glyph
+    Shelf* pBest = nullptr;
+    for( auto& shelf : m_cShelves ) {
+        if( shelf.nHeight >= paddedH && shelf.nHeight <= paddedH + paddedH / 4 + 1 && shelf.nX + paddedW <= WIDTH &&
+            ( !pBest || shelf.nHeight < pBest->nHeight ) ) {
+            pBest = &shelf;
+        }
+    }
+
+    if( !pBest ) {
+        const auto top = m_cShelves.empty() ? 0 : m_cShelves.back().nY + m_cShelves.back().nHeight;
+        if( top + paddedH > MAX_HEIGHT ) {
+            return false;
+        }
+        if( top + paddedH > m_nHeight ) {
+            // the width is fixed, so growing keeps every row in place
+            auto height = max( m_nHeight, 64 );
+            while( height < top + paddedH ) {
+                height *= 2;
+            }
+            m_nHeight = height < MAX_HEIGHT ? height : MAX_HEIGHT;
+            if( m_cPixels.size() < static_cast< size_t >( WIDTH ) * m_nHeight ) {
+                m_cPixels.resize( static_cast< size_t >( WIDTH ) * m_nHeight );
+            }
+            m_Statistics.nBytes = m_cPixels.size();
+        }
+        m_cShelves.push_back( { top, paddedH, 0 } );
+        pBest = &m_cShelves.back();
+    }
+
+    x = pBest->nX;
+    y = pBest->nY;
+    pBest->nX += paddedW;
+    return true;
+}
+
+void CGlyphAtlas::Reset( void )
+{
+    // the texture memory is kept, every glyph gets rasterized again
+    m_cGlyphs.clear();
+    m_cShelves.clear();
+    m_Statistics.nGlyphs = 0;
+    ++m_Statistics.nResets;
+}
+
+bool CGlyphAtlas::Key::operator == ( const Key& other ) const
+{
+    return pFace == other.pFace && nSize == other.nSize && nGlyph == other.nGlyph;
+}
+
+size_t CGlyphAtlas::KeyHash::operator()( const Key& key ) const
+{
+    return static_cast< size_t >( Hash64( key.nGlyph, Hash64( key.nSize, Hash64( key.pFace ) ) ) );
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Rasterizer.hpp"
+#include "TrueType.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Rasterized glyph inside the atlas. The offsets place the
+     *             top left pixel relative to the pen on the baseline.
+     */
+    struct GlyphQuad
+    {
+        uint16_t x;
+        uint16_t y;
+        uint16_t w;
+        uint16_t h;
+        int16_t  nLeft;
+        int16_t  nTop;
+    };
+
+    struct GlyphAtlasStatistics
+    {
+        uint64_t nHits    = 0;
+        uint64_t nMisses  = 0;
+        uint64_t nResets  = 0;
+        size_t   nGlyphs  = 0;
+        size_t   nBytes   = 0;
+    };
+
+    /**
+     * @brief      CGlyphAtlas rasterizes every glyph once per font and size
+     *             into a single 8 bit coverage texture. Glyphs are packed
+     *             into shelves of similar height, the texture grows in height
+     *             up to MAX_HEIGHT and starts over once it is full.
+     */
+    class CGlyphAtlas
+    {
+    public:
+        static constexpr int32_t WIDTH = 1024;
+        static constexpr int32_t MAX_HEIGHT = 4096;
+
+    public:
+        CGlyphAtlas( void ) = default;
+
+        /**
+         * @brief      Get a glyph, rasterizes it on the first use. The quad
+         *             stays valid until the next call.
+         *
+         * @param[in]  face   font
+         * @param[in]  size   em size in pixels
+         * @param[in]  glyph  glyph index
+         *
+         * @return     const GlyphQuad* <> nullptr if the glyph has no pixels
+         */
+        const GlyphQuad*            Get( const CTrueTypeFont& face, float size, uint32_t glyph );
+
+        /**
+         * @brief      Get a row of the coverage texture
+         *
+         * @param[in]  y     row
+         *
+         * @return     const uint8_t*
+         */
+        const uint8_t*              GetRow( int32_t y ) const;
+
+        int32_t                     GetWidth( void ) const;
+        int32_t                     GetHeight( void ) const;
+
+        /**
+         * @brief      Get the hits and misses of the glyph lookups
+         *
+         * @return     const GlyphAtlasStatistics&
+         */
+        const GlyphAtlasStatistics& GetStatistics( void ) const;
+
+        /**
+         * @brief      Remove every glyph of a font, has to be called before
+         *             the font gets destroyed
+         *
+         * @param[in]  face  font
+         */
+        void                        Remove( const CTrueTypeFont& face );
+
+        /**
+         * @brief      Remove every glyph and release the texture
+         */
+        void                        Clear( void );
+
+    private:
+        struct Key
+        {
+            const CTrueTypeFont* pFace;
+            uint32_t             nSize;
+            uint32_t             nGlyph;
+
+            bool operator == ( const Key& other ) const;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()( const Key& key ) const;
+        };
+
+        struct Entry
+        {
+            GlyphQuad Quad;
+            bool      bEmpty;
+        };
+
+        struct Shelf
+        {
+            int32_t nY;
+            int32_t nHeight;
+            int32_t nX;
+        };
+
+        bool                        Allocate( int32_t w, int32_t h, int32_t& x, int32_t& y );
+        void                        Reset( void );
+
+    private:
+        unordered_map< Key, Entry, KeyHash > m_cGlyphs;
+        vector< uint8_t >                    m_cPixels;
+        vector< Shelf >                      m_cShelves;
+        int32_t                              m_nHeight = 0;
+        CRasterizer                          m_Rasterizer;
+        vector< OutlinePoint >               m_cPoints;
+        vector< size_t >                     m_cContours;
+        GlyphAtlasStatistics                 m_Statistics;
+    };
+}
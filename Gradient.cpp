@@ -0,0 +1,233 @@
+#include "Gradient.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Hue in turns, saturation, value and alpha in 0..1
+     */
+    struct Hsv
+    {
+        float h;
+        float s;
+        float v;
+        float a;
+    };
+
+    Hsv ToHsv( const ColorF& color )
+    {
+        const auto maximum = max( color.r, max( color.g, color.b ) );
+        const auto minimum = min( color.r, min( color.g, color.b ) );
+        const auto delta = maximum - minimum;
+
+        Hsv hsv = { 0.f, maximum > 0.f ? delta / maximum : 0.f, maximum, color.a };
+        if( delta > 0.f ) {
+            if( maximum == color.r ) {
+                hsv.h = ( color.g - color.b ) / delta;
+            }
+            else if( maximum == color.g ) {
+                hsv.h = 2.f + ( color.b - color.r ) / delta;
+            }
+            else {
+                hsv.h = 4.f + ( color.r - color.g ) / delta;
+            }
+            hsv.h /= 6.f;
+            if( hsv.h < 0.f ) {
+                hsv.h += 1.f;
+            }
+        }
+        return hsv;
+    }
+
+    ColorF FromHsv( const Hsv& hsv )
+    {
+        const auto h = ( hsv.h - floor( hsv.h ) ) * 6.f;
+        const auto sector = static_cast< int32_t >( h ) % 6;
+        const auto f = h - floor( h );
+        const auto p = hsv.v * ( 1.f - hsv.s );
+        const auto q = hsv.v * ( 1.f - hsv.s * f );
+        const auto t = hsv.v * ( 1.f - hsv.s * ( 1.f - f ) );
+        switch( sector ) {
+        case 0:
+            return { hsv.v, t, p, hsv.a };
+        case 1:
+            return { q, hsv.v, p, hsv.a };
+        case 2:
+            return { p, hsv.v, t, hsv.a };
+        case 3:
+            return { p, q, hsv.v, hsv.a };
+        case 4:
+            return { t, p, hsv.v, hsv.a };
+        default:
+            return { hsv.v, p, q, hsv.a };
+        }
+    }
+
+    float Mix( float a, float b, float t )
+    {
+        return a + ( b - a ) * t;
+    }
+
+    ColorF Interpolate( const Color& from, const Color& to, float t, GradientSpace space )
+    {
+        const auto a = from.ToFloat(), b = to.ToFloat();
+        if( space == GradientSpace::RGB ) {
+            return { Mix( a.r, b.r, t ), Mix( a.g, b.g, t ), Mix( a.b, b.b, t ), Mix( a.a, b.a, t ) };
+        }
+
+        auto hsvA = ToHsv( a ), hsvB = ToHsv( b );
+        // a grey has no hue of its own, it takes the one of the other end
+        if( hsvA.s <= 0.f ) {
+            hsvA.h = hsvB.h;
+        }
+        if( hsvB.s <= 0.f ) {
+            hsvB.h = hsvA.h;
+        }
+
+        auto delta = hsvB.h - hsvA.h;
+        if( delta > 0.5f ) {
+            delta -= 1.f;
+        }
+        else if( delta < -0.5f ) {
+            delta += 1.f;
+        }
+        return FromHsv( { hsvA.h + delta * t, Mix( hsvA.s, hsvB.s, t ), Mix( hsvA.v, hsvB.v, t ), Mix( hsvA.a, hsvB.a, t ) } );
+    }
+
+    int32_t ToByte( float value )
+    {
+        return static_cast< int32_t >( value * 255.f + 0.5f );
+    }
+}
+
+CGradient::CGradient( void ) :
+    m_cTable( SMALL_TABLE )
+{
+    UpdateScale();
+}
+
+bool CGradient::Build( const GradientStop* pStops, size_t count, GradientSpace space, size_t size )
+{
+    if( !pStops || !count || ( size != SMALL_TABLE && size != LARGE_TABLE ) ) {
+        return false;
+    }
+
+    vector< GradientStop > cStops( pStops, pStops + count );
+    stable_sort( cStops.begin(), cStops.end(), []( const GradientStop& a, const GradientStop& b ) {
+        return a.fPosition < b.fPosition;
+    } );
+
+    m_cTable.resize( size );
+    size_t stop = 0;
+    for( size_t i = 0; i < size; ++i ) {
+        const auto t = static_cast< float >( i ) / static_cast< float >( size - 1 );
+        while( stop + 1 < cStops.size() && cStops[ stop + 1 ].fPosition <= t ) {
+            ++stop;
+        }
+
+        if( t <= cStops.front().fPosition ) {
+            m_cTable[ i ] = cStops.front().color;
+        }
+        else if( stop + 1 >= cStops.size() ) {
+            m_cTable[ i ] = cStops.back().color;
+        }
+        else {
+            const auto& from = cStops[ stop ];
+            const auto& to = cStops[ stop + 1 ];
+            const auto color = Interpolate( from.color, to.color, ( t - from.fPosition ) / ( to.fPosition - from.fPosition ), space );
+            m_cTable[ i ] = Color( ToByte( color.r ), ToByte( color.g ), ToByte( color.b ), ToByte( color.a ) );
+        }
+    }
+
+    UpdateScale();
+    return true;
+}
+
+bool CGradient::SetRange( float minimum, float maximum )
+{
+    if( !isfinite( minimum ) || !isfinite( maximum ) || !isfinite( maximum - minimum ) || !( maximum > minimum ) ) {
+        return false;
+    }
+
+    m_fMinimum = minimum;
+    m_fMaximum = maximum;
+    UpdateScale();
+    return true;
+}
+
+Color CGradient::Map( float value ) const
+{
+    return m_cTable[ GetIndex( value ) ];
+}
+
+void CGradient::Map( const float* pValues, size_t count, Color* pResult ) const
+{
+    // every path rounds the same way as GetIndex, the results are identical
+    size_t i = 0;
+#if defined( HAZE_AVX2 )
+    {
+        const auto minimum = _mm256_set1_ps( m_fMinimum );
+        const auto scale = _mm256_set1_ps( m_fScale );
+        const auto last = _mm256_set1_ps( m_fLast );
+        const auto half = _mm256_set1_ps( 0.5f );
+        const auto zero = _mm256_setzero_ps();
+        const auto* pTable = reinterpret_cast< const int* >( m_cTable.data() );
+        for( ; i + 8 <= count; i += 8 ) {
+            auto t = _mm256_mul_ps( _mm256_sub_ps( _mm256_loadu_ps( pValues + i ), minimum ), scale );
+            // max returns the second operand for NaN
+            t = _mm256_min_ps( _mm256_max_ps( t, zero ), last );
+            const auto indices = _mm256_cvttps_epi32( _mm256_add_ps( t, half ) );
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( pResult + i ), _mm256_i32gather_epi32( pTable, indices, 4 ) );
+        }
+    }
+#endif
+#if defined( HAZE_SSE2 )
+    {
+        const auto minimum = _mm_set1_ps( m_fMinimum );
+        const auto scale = _mm_set1_ps( m_fScale );
+        const auto last = _mm_set1_ps( m_fLast );
+        const auto half = _mm_set1_ps( 0.5f );
+        const auto zero = _mm_setzero_ps();
+        alignas( 16 ) int32_t indices[ 4 ];
+        for( ; i + 4 <= count; i += 4 ) {
+            auto t = _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( pValues + i ), minimum ), scale );
+            t = _mm_min_ps( _mm_max_ps( t, zero ), last );
+            _mm_store_si128( reinterpret_cast< __m128i* >( indices ), _mm_cvttps_epi32( _mm_add_ps( t, half ) ) );
+            pResult[ i ] = m_cTable[ indices[ 0 ] ];
+            pResult[ i + 1 ] = m_cTable[ indices[ 1 ] ];
+            pResult[ i + 2 ] = m_cTable[ indices[ 2 ] ];
+            pResult[ i + 3 ] = m_cTable[ indices[ 3 ] ];
+        }
+    }
+#endif
+    for( ; i < count; ++i ) {
+        pResult[ i ] = m_cTable[ GetIndex( pValues[ i ] ) ];
+    }
+}
+
+const Color* CGradient::GetTable( void ) const
+{
+    return m_cTable.data();
+}
+
+size_t CGradient::GetSize( void ) const
+{
+    return m_cTable.size();
+}
+
+uint32_t CGradient::GetIndex( float value ) const
+{
+    // written as in the vector paths, NaN ends up at the first entry
+    auto t = ( value - m_fMinimum ) * m_fScale;
+    t = t > 0.f ? t : 0.f;
+    t = t < m_fLast ? t : m_fLast;
+    return static_cast< uint32_t >( t + 0.5f );
+}
+
+void CGradient::UpdateScale( void )
+{
+    m_fLast = static_cast< float >( m_cTable.size() - 1 );
+    m_fScale = m_fLast / ( m_fMaximum - m_fMinimum );
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Color.hpp"
+
+namespace haze {
+    using namespace std;
+
+    enum class GradientSpace
+    {
+        RGB,
+        HSV
+    };
+
+    struct GradientStop
+    {
+        float fPosition;
+        Color color;
+    };
+
+    /**
+     * @brief      CGradient bakes a multi-stop gradient into a lookup table
+     *             once, so coloring elements by a metric is a single table
+     *             load per value. Values are mapped from a range onto the
+     *             table and clamped to its ends, NaN maps to the start.
+     */
+    class CGradient
+    {
+    public:
+        static constexpr size_t SMALL_TABLE = 256;
+        static constexpr size_t LARGE_TABLE = 4096;
+
+    public:
+        CGradient( void );
+
+        /**
+         * @brief      Bake the gradient. Stops may come in any order, the
+         *             colors before the first and after the last stop repeat
+         *             the end colors. HSV interpolates the hue along the
+         *             shorter way around the circle.
+         *
+         * @param[in]  pStops  stops
+         * @param[in]  count   number of stops
+         * @param[in]  space   color space to interpolate in
+         * @param[in]  size    table entries, SMALL_TABLE or LARGE_TABLE
+         *
+         * @return     bool <> false if there is no stop or the size is neither
+         */
+        bool         Build( const GradientStop* pStops, size_t count, GradientSpace space = GradientSpace::RGB, size_t size = SMALL_TABLE );
+
+        /**
+         * @brief      Set the values mapped to the first and the last entry
+         *
+         * @param[in]  minimum  value of the first entry
+         * @param[in]  maximum  value of the last entry
+         *
+         * @return     bool <> false if the range is empty or not finite
+         */
+        bool         SetRange( float minimum, float maximum );
+
+        /**
+         * @brief      Map a value to its color
+         *
+         * @param[in]  value  metric
+         *
+         * @return     Color
+         */
+        Color        Map( float value ) const;
+
+        /**
+         * @brief      Map a span of values to colors, eight at once with AVX2
+         *
+         * @param[in]  pValues  metrics
+         * @param[in]  count    number of values
+         * @param[out] pResult  colors
+         */
+        void         Map( const float* pValues, size_t count, Color* pResult ) const;
+
+        const Color* GetTable( void ) const;
+        size_t       GetSize( void ) const;
+
+    private:
+        uint32_t     GetIndex( float value ) const;
+        void         UpdateScale( void );
+
+    private:
+        vector< Color > m_cTable;
+        float           m_fMinimum = 0.f;
+        float           m_fMaximum = 1.f;
+        float           m_fScale = 0.f;
+        float           m_fLast = 0.f;
+    };
+}
@@ -0,0 +1,147 @@
+#include "Graph.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Call fn( pSamples, index, count ) for the contiguous runs of
+     *             the samples [ begin, end ), at most two around the wrap
+     */
+    template< typename Fn >
+    void ForEachRun( const SampleBuffer& samples, size_t begin, size_t end, Fn&& fn )
+    {
+        auto first = samples.nStart + begin;
+        if( first >= samples.nCapacity ) {
+            first -= samples.nCapacity;
+        }
+
+        const auto count = end - begin;
+        const auto head = min( count, samples.nCapacity - first );
+        fn( samples.pSamples + first, begin, head );
+        if( head < count ) {
+            fn( samples.pSamples, begin + head, count - head );
+        }
+    }
+
+    float Cross( float ax, float ay, float bx, float by )
+    {
+        return ax * by - ay * bx;
+    }
+}
+
+size_t haze::BuildGraph( const SampleBuffer& samples, const RectF& bounds, float minimum, float maximum, vector< PointF >& cPoints )
+{
+    cPoints.clear();
+    if( !samples.pSamples || !samples.nCapacity || samples.nStart >= samples.nCapacity || samples.nCount > samples.nCapacity || !samples.nCount ) {
+        return 0;
+    }
+    if( !isfinite( minimum ) || !isfinite( maximum ) || !isfinite( maximum - minimum ) || !( maximum > minimum ) || !( bounds.w > 0.f ) ) {
+        return 0;
+    }
+
+    const auto count = samples.nCount;
+    const auto step = count > 1 ? bounds.w / static_cast< float >( count - 1 ) : 0.f;
+    const auto scale = bounds.h / ( maximum - minimum );
+    const auto bottom = bounds.y + bounds.h;
+    auto addPoint = [ & ]( size_t index, float value ) {
+        cPoints.push_back( { bounds.x + static_cast< float >( index ) * step, bottom - ( min( max( value, minimum ), maximum ) - minimum ) * scale } );
+    };
+
+    const auto columns = max< size_t >( static_cast< size_t >( ceil( bounds.w ) ), 1 );
+    if( count <= columns ) {
+        cPoints.reserve( count );
+        ForEachRun( samples, 0, count, [ & ]( const float* pSamples, size_t index, size_t n ) {
+            for( size_t i = 0; i < n; ++i ) {
+                if( !isnan( pSamples[ i ] ) ) {
+                    addPoint( index + i, pSamples[ i ] );
+                }
+            }
+        } );
+        return cPoints.size();
+    }
+
+    // every column keeps its extremes at the x-position they were sampled at
+    cPoints.reserve( 2 * columns );
+    for( size_t column = 0; column < columns; ++column ) {
+        const auto begin = column * count / columns, end = ( column + 1 ) * count / columns;
+
+        auto low = HUGE_VALF, high = -HUGE_VALF;
+        auto lowIndex = count, highIndex = count;
+        ForEachRun( samples, begin, end, [ & ]( const float* pSamples, size_t index, size_t n ) {
+            // comparisons with NaN are false, those samples never win
+            for( size_t i = 0; i < n; ++i ) {
+                if( pSamples[ i ] < low ) {
+                    low = pSamples[ i ];
+                    lowIndex = index + i;
+                }
+                if( pSamples[ i ] > high ) {
+                    high = pSamples[ i ];
+                    highIndex = index + i;
+                }
+            }
+        } );
+
+        if( lowIndex == count ) {
+            // only NaN or only +inf inside the column
+            if( highIndex != count ) {
+                addPoint( highIndex, high );
+            }
+        }
+        else if( highIndex == count || lowIndex == highIndex ) {
+            addPoint( lowIndex, low );
+        }
+        else if( lowIndex < highIndex ) {
+            addPoint( lowIndex, low );
+            addPoint( highIndex, high );
+        }
+        else {
+            addPoint( highIndex, high );
+            addPoint( lowIndex, low );
+        }
+    }
+    return cPoints.size();
+}
+
+void haze::StrokePolyline( const PointF* pPoints, size_t count, float thickness, vector< PointF >& cQuads )
+{
+    cQuads.clear();
+    const auto half = 0.5f * fabs( thickness );
+    if( !pPoints || count < 2 || !( half > 0.f ) ) {
+        return;
+    }
+
+    cQuads.reserve( 8 * ( count - 1 ) );
+    auto from = pPoints[ 0 ];
+    auto lastDx = 0.f, lastDy = 0.f, lastNx = 0.f, lastNy = 0.f;
+    auto joint = false;
+    for( size_t i = 1; i < count; ++i ) {
+        const auto to = pPoints[ i ];
+        const auto dx = to.x - from.x, dy = to.y - from.y;
+        const auto length = sqrt( dx * dx + dy * dy );
+        if( !( length > 0.f ) ) {
+            // repeated points do not have a direction
+            continue;
+        }
+
+        const auto nx = -dy / length * half, ny = dx / length * half;
+        if( joint ) {
+            // the gap of a joint opens on the side the line turns away from
+            const auto side = Cross( lastDx, lastDy, dx, dy ) > 0.f ? -1.f : 1.f;
+            PointF a = { from.x + side * lastNx, from.y + side * lastNy };
+            PointF b = { from.x + side * nx, from.y + side * ny };
+            if( Cross( a.x - from.x, a.y - from.y, b.x - from.x, b.y - from.y ) > 0.f ) {
+                swap( a, b );
+            }
+            cQuads.insert( cQuads.end(), { from, a, b, b } );
+        }
+        cQuads.insert( cQuads.end(), { { from.x + nx, from.y + ny }, { to.x + nx, to.y + ny }, { to.x - nx, to.y - ny }, { from.x - nx, from.y - ny } } );
+
+        from = to;
+        lastDx = dx;
+        lastDy = dy;
+        lastNx = nx;
+        lastNy = ny;
+        joint = true;
+    }
+}
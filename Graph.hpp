@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Geometry.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      View of the samples of a graph inside a ring buffer, nothing
+     *             is copied. The oldest sample lies at nStart and the samples
+     *             wrap around at nCapacity, a plain array is a ring which
+     *             starts at zero.
+     */
+    struct SampleBuffer
+    {
+        const float* pSamples;
+        size_t       nCapacity;
+        size_t       nStart;
+        size_t       nCount;
+    };
+
+    /**
+     * @brief      Map samples onto the points of a graph inside a box. The
+     *             oldest sample lies on the left edge and the newest on the
+     *             right one, values are clamped to the range and NaN samples
+     *             are left out. With more samples than pixel columns only the
+     *             minimum and the maximum of every column are kept, in the
+     *             order they were sampled, so no peak gets lost.
+     *
+     * @param[in]  samples  samples
+     * @param[in]  bounds   box of the graph, larger values are drawn higher
+     * @param[in]  minimum  value at the bottom edge
+     * @param[in]  maximum  value at the top edge
+     * @param[out] cPoints  points of the graph
+     *
+     * @return     size_t <> amount of points, zero if the buffer, the box or
+     *             the range is invalid
+     */
+    size_t BuildGraph( const SampleBuffer& samples, const RectF& bounds, float minimum, float maximum, vector< PointF >& cPoints );
+
+    /**
+     * @brief      Outline connected lines as quads which are filled with the
+     *             nonzero rule. Every segment gets flat ends and the outer
+     *             side of every joint a bevel, a triangle repeats its last
+     *             point. All quads run the same way, so overlaps do not cancel.
+     *
+     * @param[in]  pPoints    points
+     * @param[in]  count      amount of points
+     * @param[in]  thickness  thickness
+     * @param[out] cQuads     four points per quad
+     */
+    void   StrokePolyline( const PointF* pPoints, size_t count, float thickness, vector< PointF >& cQuads );
+}
@@ -0,0 +1,41 @@
+#include "Hash.hpp"
+#include <cstring>
+using namespace haze;
+
+uint64_t haze::Hash64( const void* data, size_t length, uint64_t seed )
+{
+    constexpr uint64_t m = 0xC6A4A7935BD1E995ull;
+    constexpr int32_t  r = 47;
+
+    auto h = seed ^ ( length * m );
+    auto* pData = static_cast< const uint8_t* >( data );
+    auto* pEnd = pData + ( length & ~static_cast< size_t >( 7 ) );
+
+    for( ; pData != pEnd; pData += 8 ) {
+        uint64_t k;
+        memcpy( &k, pData, sizeof( k ) );
+
+        k *= m;
+        k ^= k >> r;
+        k *= m;
+
+        h ^= k;
+        h *= m;
+    }
+
+    // the tail is read as a little endian word
+    const auto tail = length & 7;
+    if( tail ) {
+        uint64_t k = 0;
+        memcpy( &k, pData, tail );
+
+        h ^= k;
+        h *= m;
+    }
+
+    h ^= h >> r;
+    h *= m;
+    h ^= h >> r;
+
+    return h;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Hash a block of memory (MurmurHash64A)
+     *
+     * @param[in]  data    pointer to the data
+     * @param[in]  length  size in bytes
+     * @param[in]  seed    seed, may be the hash of a previous block
+     *
+     * @return     uint64_t
+     */
+    uint64_t Hash64( const void* data, size_t length, uint64_t seed = 0 );
+
+    /**
+     * @brief      Hash a trivially copyable value
+     *
+     * @param[in]  value  value
+     * @param[in]  seed   seed, may be the hash of a previous block
+     *
+     * @return     uint64_t
+     */
+    template< typename T >
+    uint64_t Hash64( const T& value, uint64_t seed = 0 )
+    {
+        return Hash64( &value, sizeof( T ), seed );
+    }
+}
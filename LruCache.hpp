@@ -0,0 +1,250 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace haze {
+    using namespace std;
+
+    struct CacheStatistics
+    {
+        uint64_t nHits      = 0;
+        uint64_t nMisses    = 0;
+        uint64_t nEvictions = 0;
+        size_t   nEntries   = 0;
+        size_t   nBytes     = 0;
+    };
+
+    /**
+     * @brief      CLruCache keeps values up to a memory budget and evicts the
+     *             least recently used ones first. Entries are looked up by a
+     *             64 bit hash plus a predicate which compares the stored key,
+     *             so a lookup never has to build a key. Entries with the same
+     *             hash replace each other.
+     *
+     * @tparam     TKey    key type
+     * @tparam     TValue  value type
+     */
+    template< typename TKey, typename TValue >
+    class CLruCache
+    {
+    public:
+        using ReleaseFn = void( *)( TValue& );
+        using Statistics = CacheStatistics;
+
+    public:
+        /**
+         * @brief      Create a cache
+         *
+         * @param[in]  budget     memory budget in bytes (0 disables the cache)
+         * @param[in]  fnRelease  called for every value which leaves the cache
+         */
+        explicit CLruCache( size_t budget = 0, ReleaseFn fnRelease = nullptr );
+        CLruCache( const CLruCache& ) = delete;
+        CLruCache& operator = ( const CLruCache& ) = delete;
+        ~CLruCache( void );
+
+        /**
+         * @brief      Find a value and mark it as most recently used
+         *
+         * @param[in]  hash        hash of the key
+         * @param[in]  fnMatches   bool( const TKey& ), compares the stored key
+         *
+         * @return     TValue* <> nullptr on a miss
+         */
+        template< typename F >
+        TValue* Find( uint64_t hash, const F& fnMatches );
+
+        /**
+         * @brief      Insert a value as most recently used and evict old
+         *             entries until the cache fits into its budget again
+         *
+         * @param[in]  hash   hash of the key
+         * @param[in]  key    key
+         * @param[in]  value  value
+         * @param[in]  cost   estimated size of the entry in bytes
+         *
+         * @return     TValue&
+         */
+        TValue& Insert( uint64_t hash, TKey key, TValue value, size_t cost );
+
+        /**
+         * @brief      Release every entry
+         */
+        void Clear( void );
+
+        /**
+         * @brief      Set the memory budget, 0 disables the cache
+         *
+         * @param[in]  budget  budget in bytes
+         */
+        void SetBudget( size_t budget );
+
+        /**
+         * @brief      Get the memory budget
+         *
+         * @return     size_t
+         */
+        size_t GetBudget( void ) const;
+
+        /**
+         * @brief      Is the budget above zero?
+         *
+         * @return     bool
+         */
+        bool IsEnabled( void ) const;
+
+        /**
+         * @brief      Get the hit/miss statistics
+         *
+         * @return     const Statistics&
+         */
+        const Statistics& GetStatistics( void ) const;
+
+        /**
+         * @brief      Reset the hit, miss and eviction counters
+         */
+        void ResetStatistics( void );
+
+    private:
+        struct Entry
+        {
+            uint64_t nHash;
+            TKey     key;
+            TValue   value;
+            size_t   nCost;
+        };
+
+        using EntryList = list< Entry >;
+        using LookupMap = unordered_map< uint64_t, typename EntryList::iterator >;
+
+        /**
+         * @brief      Evict entries until the budget is kept
+         *
+         * @param[in]  keep  minimum amount of entries to keep
+         */
+        void Trim( size_t keep );
+
+        /**
+         * @brief      Remove an entry
+         *
+         * @param[in]  it    entry
+         */
+        void Erase( typename EntryList::iterator it );
+
+    private:
+        EntryList  m_cEntries;
+        LookupMap  m_cLookup;
+        ReleaseFn  m_fnRelease = nullptr;
+        size_t     m_nBudget = 0;
+        Statistics m_Statistics;
+    };
+
+    template< typename TKey, typename TValue >
+    CLruCache< TKey, TValue >::CLruCache( size_t budget, ReleaseFn fnRelease ) :
+        m_fnRelease( fnRelease ),
+        m_nBudget( budget )
+    {
+    }
+
+    template< typename TKey, typename TValue >
+    CLruCache< TKey, TValue >::~CLruCache( void )
+    {
+        Clear();
+    }
+
+    template< typename TKey, typename TValue >
+    template< typename F >
+    TValue* CLruCache< TKey, TValue >::Find( uint64_t hash, const F& fnMatches )
+    {
+        auto it = m_cLookup.find( hash );
+        if( it == m_cLookup.end() || !fnMatches( it->second->key ) ) {
+            ++m_Statistics.nMisses;
+            return nullptr;
+        }
+
+        ++m_Statistics.nHits;
+        m_cEntries.splice( m_cEntries.begin(), m_cEntries, it->second );
+        return &it->second->value;
+    }
+
+    template< typename TKey, typename TValue >
+    TValue& CLruCache< TKey, TValue >::Insert( uint64_t hash, TKey key, TValue value, size_t cost )
+    {
+        auto it = m_cLookup.find( hash );
+        if( it != m_cLookup.end() ) {
+            Erase( it->second );
+        }
+
+        m_cEntries.push_front( { hash, move( key ), move( value ), cost } );
+        m_cLookup[ hash ] = m_cEntries.begin();
+        m_Statistics.nBytes += cost;
+        m_Statistics.nEntries = m_cEntries.size();
+
+        Trim( 1 );
+        return m_cEntries.front().value;
+    }
+
+    template< typename TKey, typename TValue >
+    void CLruCache< TKey, TValue >::Clear( void )
+    {
+        while( !m_cEntries.empty() ) {
+            Erase( prev( m_cEntries.end() ) );
+        }
+    }
+
+    template< typename TKey, typename TValue >
+    void CLruCache< TKey, TValue >::SetBudget( size_t budget )
+    {
+        m_nBudget = budget;
+        Trim( 0 );
+    }
+
+    template< typename TKey, typename TValue >
+    size_t CLruCache< TKey, TValue >::GetBudget( void ) const
+    {
+        return m_nBudget;
+    }
+
+    template< typename TKey, typename TValue >
+    bool CLruCache< TKey, TValue >::IsEnabled( void ) const
+    {
+        return m_nBudget > 0;
+    }
+
+    template< typename TKey, typename TValue >
+    const typename CLruCache< TKey, TValue >::Statistics& CLruCache< TKey, TValue >::GetStatistics( void ) const
+    {
+        return m_Statistics;
+    }
+
+    template< typename TKey, typename TValue >
+    void CLruCache< TKey, TValue >::ResetStatistics( void )
+    {
+        m_Statistics.nHits = 0;
+        m_Statistics.nMisses = 0;
+        m_Statistics.nEvictions = 0;
+    }
+
+    template< typename TKey, typename TValue >
+    void CLruCache< TKey, TValue >::Trim( size_t keep )
+    {
+        while( m_cEntries.size() > keep && m_Statistics.nBytes > m_nBudget ) {
+            Erase( prev( m_cEntries.end() ) );
+            ++m_Statistics.nEvictions;
+        }
+    }
+
+    template< typename TKey, typename TValue >
+    void CLruCache< TKey, TValue >::Erase( typename EntryList::iterator it )
+    {
+        if( m_fnRelease ) {
+            m_fnRelease( it->value );
+        }
+
+        m_Statistics.nBytes -= it->nCost;
+        m_cLookup.erase( it->nHash );
+        m_cEntries.erase( it );
+        m_Statistics.nEntries = m_cEntries.size();
+    }
+}
@@ -1,182 +1,23 @@
+#if defined( _WIN32 )
 #include "Overlay.hpp"
-#include <codecvt>
+#include "Utf.hpp"
 using namespace haze;
 
-template< class T >
-void SafeRelease( T** ppInterface )
-{
-    if( ppInterface && *ppInterface ) {
-        ( *ppInterface )->Release();
-        *ppInterface = nullptr;
-    }
-}
-
 wstring string_to_wstring( const string& narrow )
 {
-    wstring_convert< codecvt_utf8_utf16< wchar_t > > converter;
-    return converter.from_bytes( narrow );
-}
-
-CDirect2DOverlay::CDirect2DSurface::CDirect2DSurface( const CDirect2DOverlay* pDirect2DOverlay )
-{
-    SetOverlayInstance( pDirect2DOverlay );
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::BorderBox( float x, float y, float w, float h, float thickness, const Color& color ) const
-{
-    if( !m_pDirect2DOverlay ) {
-        return false;
-    }
-
-    return Rect( x, y, w, thickness, color )     &&
-           Rect( x, y, thickness, h, color )     &&
-           Rect( x + w, y, thickness, h, color ) &&
-           Rect( x, y + h, w + thickness, thickness, color );
+    wstring wide;
+    Utf8ToUtf16( narrow.data(), narrow.length(), wide );
+    return wide;
 }
 
-bool CDirect2DOverlay::CDirect2DSurface::BorderBox( float x, float y, float w, float h, float thickness, float outlined_thickness, const Color& color, const Color& outlined_color ) const
-{
-    return BorderBox( x, y, w, h, thickness, color ) &&
-           BorderBox( x - outlined_thickness, y - outlined_thickness, w + outlined_thickness + thickness, h + outlined_thickness + thickness, outlined_thickness, outlined_color ) &&
-           BorderBox( x + thickness, y + thickness, w - outlined_thickness - thickness, h - outlined_thickness - thickness, outlined_thickness, outlined_color );
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::Line( float x, float y, float xx, float yy, float thickness, const Color& color ) const
-{
-    if( !m_pDirect2DOverlay ) {
-        return false;
-    }
-
-    auto* pDirect2DColorBrush = m_pDirect2DOverlay->GetDirect2DColorBrush();
-    if( !pDirect2DColorBrush ) {
-        return false;
-    }
-
-    auto* pDirect2DHwndRenderTarget = m_pDirect2DOverlay->GetDirect2DHwndRenderTarget();
-    if( !pDirect2DHwndRenderTarget ) {
-        return false;
-    }
-
-    pDirect2DColorBrush->SetColor( D2D1::ColorF( color.hex() ) );
-    pDirect2DHwndRenderTarget->DrawLine( { x, y }, { xx, yy }, pDirect2DColorBrush, thickness );
-
-    return true;
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, const Color& color ) const
-{
-    if( !m_pDirect2DOverlay ) {
-        return false;
-    }
-
-    auto* pDirect2DColorBrush = m_pDirect2DOverlay->GetDirect2DColorBrush();
-    if( !pDirect2DColorBrush ) {
-        return false;
-    }
-
-    auto* pDirect2DHwndRenderTarget = m_pDirect2DOverlay->GetDirect2DHwndRenderTarget();
-    if( !pDirect2DHwndRenderTarget ) {
-        return false;
-    }
-
-    auto rect = D2D1::RoundedRect( D2D1::RectF( x, y, x + w, y + h ), x_rad, y_rad );
-    pDirect2DColorBrush->SetColor( D2D1::ColorF( color.hex() ) );
-    pDirect2DHwndRenderTarget->FillRoundedRectangle( &rect, pDirect2DColorBrush );
-
-    return true;
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float x_rad_outlined, float y_rad_outlined, const Color& color, const Color& outlined ) const
-{
-    return RoundedRect( x - thickness, y - thickness, w + thickness * 2.f, h + thickness * 2.f, x_rad_outlined, y_rad_outlined, outlined ) &&
-           RoundedRect( x, y, w, h, x_rad, y_rad, color );
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::Rect( float x, float y, float w, float h, const Color& color ) const
-{
-    if( !m_pDirect2DOverlay ) {
-        return false;
-    }
-
-    auto* pDirect2DColorBrush = m_pDirect2DOverlay->GetDirect2DColorBrush();
-    if( !pDirect2DColorBrush ) {
-        return false;
-    }
-
-    auto* pDirect2DHwndRenderTarget = m_pDirect2DOverlay->GetDirect2DHwndRenderTarget();
-    if( !pDirect2DHwndRenderTarget ) {
-        return false;
-    }
-
-    auto rect = D2D1::RectF( x, y, x + w, y + h );    
-    pDirect2DColorBrush->SetColor( D2D1::ColorF( color.hex() ) );
-    pDirect2DHwndRenderTarget->FillRectangle( &rect, pDirect2DColorBrush );
-
-    return true;
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::Rect( float x, float y, float w, float h, float thickness, const Color& color, const Color& outlined ) const
-{
-    return Rect( x, y, w, h, color ) &&
-           BorderBox( x - thickness, y - thickness, w + thickness, h + thickness, thickness, outlined );
-}
-
-uint64_t CDirect2DOverlay::CDirect2DSurface::GetFramesPerSecond( void ) const
-{
-    return m_pDirect2DOverlay ? m_pDirect2DOverlay->GetFramesPerSecond() : 0;
-}
-
-bool CDirect2DOverlay::CDirect2DSurface::String( float x, float y, const string& font, const Color& color, const char* msg, ... ) const
-{
-    if( !m_pDirect2DOverlay ) {
-        return false;
-    }
-
-    auto* pDirect2DColorBrush = m_pDirect2DOverlay->GetDirect2DColorBrush();
-    if( !pDirect2DColorBrush ) {
-        return false;
-    }
-
-    auto* pDirect2DHwndRenderTarget = m_pDirect2DOverlay->GetDirect2DHwndRenderTarget();
-    if( !pDirect2DHwndRenderTarget ) {
-        return false;
-    }
-
-    auto* pDirectWriteTextFormat = m_pDirect2DOverlay->GetFont( font );
-    if( !pDirectWriteTextFormat ) {
-        return false;
-    }
-
-    const auto cSize = m_pDirect2DOverlay->GetSize();
-
-    va_list args;
-    va_start( args, msg );
-    char buffer[ 0x400 ];
-    vsprintf_s( buffer, msg, args );
-    va_end( args );
-
-    auto w = string_to_wstring( buffer );
-    auto rect = D2D1::RectF( x, y, x + static_cast< float >( cSize[ 0 ] ), y + static_cast< float >( cSize[ 1 ] ) );
-
-    pDirect2DColorBrush->SetColor( D2D1::ColorF( color.hex() ) );
-    pDirect2DHwndRenderTarget->DrawText( w.c_str(), w.length(), pDirectWriteTextFormat, &rect, pDirect2DColorBrush );
-
-    return true;
-}
-
-void CDirect2DOverlay::CDirect2DSurface::SetOverlayInstance( const CDirect2DOverlay* pDirect2DOverlay )
-{
-    m_pDirect2DOverlay = pDirect2DOverlay;
-}
-
-
 CDirect2DOverlay::CDirect2DOverlay( void ) :
     m_cPosition( { CW_USEDEFAULT, CW_USEDEFAULT } ),
     m_cSize( { 800, 600 } )
 {
     SetWindowClass( "Overlay" );
     SetWindowTitle( "D2DOverlay" );
-    m_Direct2DSurface.SetOverlayInstance( this );
+    m_Direct2DBackend.SetOverlayInstance( this );
+    m_Direct2DSurface.SetRenderBackend( &m_Direct2DBackend );
 }
 
 CDirect2DOverlay::~CDirect2DOverlay( void )
@@ -289,30 +130,178 @@ ID2D1SolidColorBrush* CDirect2DOverlay::GetDirect2DColorBrush( void ) const
     return m_pDiect2DColorBrush;
 }
 
-IDWriteTextFormat* CDirect2DOverlay::GetFont( const string& name ) const
+ICommandSink* CDirect2DOverlay::GetCommandSink( void ) const
+{
+    if( m_bRecording ) {
+        return &m_cCommandList;
+    }
+    return &m_Direct2DBackend;
+}
+
+IRenderBackend* CDirect2DOverlay::GetRenderBackend( void ) const
+{
+    return &m_Direct2DBackend;
+}
+
+const CCommandList& CDirect2DOverlay::GetCommandList( void ) const
+{
+    return m_cCommandList;
+}
+
+bool CDirect2DOverlay::IsRecording( void ) const
+{
+    return m_bRecording;
+}
+
+void CDirect2DOverlay::SetRecording( bool recording )
+{
+    m_bRecording = recording;
+    m_cCommandList.Reset();
+    m_Direct2DSurface.SetCommandSink( recording ? &m_cCommandList : nullptr );
+}
+
+bool CDirect2DOverlay::IsBatching( void ) const
 {
-    if( name.empty() || !m_cCustomFonts.count( name ) ) {
-        return nullptr;
+    return m_bBatching;
+}
+
+void CDirect2DOverlay::SetBatching( bool batching )
+{
+    m_bBatching = batching;
+    if( m_pRenderThread ) {
+        m_pRenderThread->SetBatching( batching );
     }
-    return m_cCustomFonts.at( name );
+}
+
+bool CDirect2DOverlay::StartRenderThread( void )
+{
+    if( m_pRenderThread || !m_pDirect2DHwndRenderTarget ) {
+        return false;
+    }
+
+    m_pRenderThread.reset( new CRenderThread( &m_Direct2DBackend ) );
+    m_pRenderThread->SetBatching( m_bBatching );
+    if( !m_pRenderThread->Start() ) {
+        m_pRenderThread.reset();
+        return false;
+    }
+    return true;
+}
+
+void CDirect2DOverlay::StopRenderThread( void )
+{
+    m_pRenderThread.reset();
+}
+
+bool CDirect2DOverlay::IsRenderThreadRunning( void ) const
+{
+    return !!m_pRenderThread;
+}
+
+RenderThreadStatistics CDirect2DOverlay::GetRenderThreadStatistics( void ) const
+{
+    return m_pRenderThread ? m_pRenderThread->GetStatistics() : RenderThreadStatistics();
+}
+
+bool CDirect2DOverlay::IsParallelRecording( void ) const
+{
+    return !!m_pParallelRecorder;
+}
+
+bool CDirect2DOverlay::IsFrameElision( void ) const
+{
+    return m_bFrameElision;
+}
+
+void CDirect2DOverlay::SetFrameElision( bool elision )
+{
+    m_bFrameElision = elision;
+    m_bFrameHash = false;
+}
+
+uint64_t CDirect2DOverlay::GetElidedFrames( void ) const
+{
+    return m_nElidedFrames;
+}
+
+bool CDirect2DOverlay::IsDirtyRects( void ) const
+{
+    return m_bDirtyRects;
+}
+
+void CDirect2DOverlay::SetDirtyRects( bool dirtyRects )
+{
+    m_bDirtyRects = dirtyRects;
+    m_DirtyRegion.Invalidate();
+}
+
+const DirtyRegionStatistics& CDirect2DOverlay::GetDirtyRegionStatistics( void ) const
+{
+    return m_DirtyRegion.GetStatistics();
+}
+
+void CDirect2DOverlay::SetParallelRecording( bool parallel, int32_t workers )
+{
+    m_pParallelRecorder.reset( parallel ? new CParallelRecorder( workers ) : nullptr );
+}
+
+const CRectBatcher::Counters& CDirect2DOverlay::GetBatchCounters( void ) const
+{
+    return m_RectBatcher.GetCounters();
+}
+
+CRenderStateCache::Counters CDirect2DOverlay::GetRenderStateCounters( void ) const
+{
+    return m_Direct2DBackend.GetRenderStateCounters();
+}
+
+void CDirect2DOverlay::SetTextLayoutBudget( size_t budget )
+{
+    m_Direct2DBackend.SetTextLayoutBudget( budget );
+}
+
+CacheStatistics CDirect2DOverlay::GetTextLayoutStatistics( void ) const
+{
+    return m_Direct2DBackend.GetTextLayoutStatistics();
+}
+
+IDWriteTextFormat* CDirect2DOverlay::GetFont( const string& name ) const
+{
+    return GetFont( m_Fonts.Find( name ) );
+}
+
+IDWriteTextFormat* CDirect2DOverlay::GetFont( FontHandle handle ) const
+{
+    return static_cast< IDWriteTextFormat* >( const_cast< void* >( m_Fonts.Get( handle ) ) );
+}
+
+FontHandle CDirect2DOverlay::GetFontHandle( const string& name ) const
+{
+    return m_Fonts.Find( name );
 }
 
 IDWriteTextFormat* CDirect2DOverlay::GetFont( const string& name, const string& fontName, const float size, const string& locale, DWRITE_FONT_WEIGHT weight, DWRITE_FONT_STYLE style, DWRITE_FONT_STRETCH stretch )
+{
+    return GetFont( RegisterFont( name, fontName, size, locale, weight, style, stretch ) );
+}
+
+FontHandle CDirect2DOverlay::RegisterFont( const string& name, const string& fontName, const float size, const string& locale, DWRITE_FONT_WEIGHT weight, DWRITE_FONT_STYLE style, DWRITE_FONT_STRETCH stretch )
 {
     if( !m_pDirectWriteFactory || name.empty() || fontName.empty() || locale.empty() ) {
-        return nullptr;
+        return 0;
     }
-    if( !!m_cCustomFonts.count( name ) ) {
-        return m_cCustomFonts[ name ];
+
+    const auto handle = m_Fonts.Find( name );
+    if( handle ) {
+        return handle;
     }
 
     IDWriteTextFormat* pDirectWriteTextFormat = nullptr;
     if( FAILED( m_pDirectWriteFactory->CreateTextFormat( string_to_wstring( fontName ).c_str(), nullptr, weight, style, stretch, size, string_to_wstring( locale ).c_str(), &pDirectWriteTextFormat ) ) ) {
-        return nullptr;
+        return 0;
     }
 
-    m_cCustomFonts.insert( make_pair( name, pDirectWriteTextFormat ) );
-    return m_cCustomFonts[ name ];
+    return m_Fonts.Insert( name, pDirectWriteTextFormat );
 }
 
 CDirect2DOverlay::CDirect2DSurface CDirect2DOverlay::Surface( void ) const
@@ -332,35 +321,256 @@ bool CDirect2DOverlay::Render( void )
         DispatchMessage( &msg );
     }
 
-    m_pDirect2DHwndRenderTarget->BeginDraw();
-    m_pDirect2DHwndRenderTarget->SetTransform( D2D1::Matrix3x2F::Identity() );
-    m_pDirect2DHwndRenderTarget->Clear();
+    const auto visible = m_hTargetHwnd == GetForegroundWindow();
+    if( m_pRenderThread ) {
+        const auto published = RenderScene( visible );
+        m_FramePacer.Wait( visible );
+        return published;
+    }
+
+    // a hidden overlay only has to be cleared once, after that the frames
+    // are skipped and the pacer backs off
+    if( !visible && !m_bVisible ) {
+        m_FramePacer.Wait( false );
+        return true;
+    }
+    m_bVisible = visible;
+
+    const auto fps = m_FrameTimer.GetFramesPerSecond();
+    if( visible ) {
+        m_FrameTimer.BeginFrame();
+        m_Direct2DSurface.SetFramesPerSecond( fps );
+    }
+    else {
+        m_FrameTimer.Pause();
+    }
+
+    // a recorded frame is complete before anything gets drawn, so a frame
+    // equal to the presented one can be skipped entirely
+    if( visible && m_bRecording ) {
+        m_FrameTimer.BeginCallbacks();
+        RunCallbacks( &m_cCommandList, fps );
+        m_FrameTimer.EndCallbacks();
+
+        // only the changed regions get cleared and redrawn, the backend
+        // falls back to a full frame if it can't keep its content
+        m_FrameTimer.BeginPresent();
+        auto redrawn = IsFrameUnchanged( m_cCommandList );
+        if( !redrawn && m_bDirtyRects && m_DirtyRegion.Update( m_cCommandList, m_Direct2DBackend ) ) {
+            redrawn = m_DirtyRegion.Redraw( m_cCommandList, m_Direct2DBackend );
+        }
+        if( redrawn ) {
+            m_FrameTimer.EndPresent();
+            m_FrameTimer.EndFrame();
+            m_FramePacer.Wait( true );
+            return true;
+        }
+    }
+    else {
+        m_bFrameHash = false;
+        m_DirtyRegion.Invalidate();
+    }
 
-    if( m_hTargetHwnd == GetForegroundWindow() ) {
-        CalculateFramesPerSecond( false );
+    if( !m_Direct2DBackend.BeginFrame() ) {
+        m_bFrameHash = false;
+        m_DirtyRegion.Invalidate();
+        return false;
+    }
 
-        for( auto& fn : m_cRenderCallbacks ) {
-            fn( &m_Direct2DSurface );
+    if( visible ) {
+        if( m_bRecording ) {
+            // replay the recorded frame in one pass
+            if( m_bBatching ) {
+                m_RectBatcher.Submit( m_cCommandList, m_Direct2DBackend );
+            }
+            else {
+                m_cCommandList.Replay( m_Direct2DBackend );
+            }
+        }
+        else {
+            // the callbacks draw directly, their time includes the drawing
+            m_FrameTimer.BeginCallbacks();
+            RunCallbacks( nullptr, fps );
+            m_FrameTimer.EndCallbacks();
+            m_FrameTimer.BeginPresent();
         }
+    }
+
+    m_Direct2DBackend.EndFrame();
+    if( visible ) {
+        m_FrameTimer.EndPresent();
+        m_FrameTimer.EndFrame();
+    }
+    m_FramePacer.Wait( visible );
 
-        CalculateFramesPerSecond( true );
+    return true;
+}
+
+bool CDirect2DOverlay::RenderScene( bool visible )
+{
+    // a hidden overlay needs a single empty scene to get cleared
+    if( !visible && !m_bVisible ) {
+        return true;
+    }
+    m_bVisible = visible;
+
+    auto& cList = m_pRenderThread->BeginScene();
+    m_bFrameHash &= visible;
+    if( !visible ) {
+        m_FrameTimer.Pause();
+    }
+    else {
+        // the render thread presents, only the frame and callback times
+        // are measured here
+        const auto fps = m_FrameTimer.GetFramesPerSecond();
+        m_FrameTimer.BeginFrame();
+        m_Direct2DSurface.SetFramesPerSecond( fps );
+        m_FrameTimer.BeginCallbacks();
+        RunCallbacks( &cList, fps );
+        m_FrameTimer.EndCallbacks();
+        m_FrameTimer.EndFrame();
+
+        // the unpublished scene is simply recorded over next frame
+        if( IsFrameUnchanged( cList ) ) {
+            return true;
+        }
     }
 
-    m_pDirect2DHwndRenderTarget->EndDraw();
-    
+    m_pRenderThread->PublishScene();
     return true;
 }
 
+void CDirect2DOverlay::RunCallbacks( CCommandList* pList, uint64_t fps )
+{
+    m_RenderCallbacks.Compact();
+
+    if( pList && m_pParallelRecorder ) {
+        // every callback records on its own, merged in run order
+        m_pParallelRecorder->Record( m_RenderCallbacks, &m_Direct2DBackend, fps, *pList );
+        return;
+    }
+
+    if( pList ) {
+        pList->Reset();
+    }
+
+    for( size_t i = 0; i < m_RenderCallbacks.GetEntryCount(); ++i ) {
+        if( !m_RenderCallbacks.IsActive( i ) ) {
+            continue;
+        }
+
+        // a callback without budget can't be throttled and draws straight
+        // into the frame
+        auto& profile = m_RenderCallbacks.GetEntryProfile( i );
+        if( !profile.HasBudget() ) {
+            m_Direct2DSurface.SetCommandSink( pList );
+            profile.Run( [ & ] { m_RenderCallbacks.Invoke( i, &m_Direct2DSurface ); } );
+            continue;
+        }
+
+        // a throttled callback replays what it has recorded last
+        auto& cList = m_RenderCallbacks.GetEntryList( i );
+        if( profile.IsDue() ) {
+            cList.Reset();
+            m_Direct2DSurface.SetCommandSink( &cList );
+            profile.Run( [ & ] { m_RenderCallbacks.Invoke( i, &m_Direct2DSurface ); } );
+        }
+        if( pList ) {
+            pList->Append( cList );
+        }
+        else {
+            cList.Replay( m_Direct2DBackend );
+        }
+    }
+
+    m_Direct2DSurface.SetCommandSink( m_bRecording ? &m_cCommandList : nullptr );
+}
+
+bool CDirect2DOverlay::IsFrameUnchanged( const CCommandList& list )
+{
+    if( !m_bFrameElision ) {
+        return false;
+    }
+
+    const auto hash = list.Hash();
+    if( m_bFrameHash && hash == m_nFrameHash ) {
+        ++m_nElidedFrames;
+        return true;
+    }
+
+    m_nFrameHash = hash;
+    m_bFrameHash = true;
+    return false;
+}
+
+void CDirect2DOverlay::SetTargetFramesPerSecond( uint32_t fps )
+{
+    m_FramePacer.SetTargetFramesPerSecond( fps );
+}
+
+uint32_t CDirect2DOverlay::GetTargetFramesPerSecond( void ) const
+{
+    return m_FramePacer.GetTargetFramesPerSecond();
+}
+
+PacingStatistics CDirect2DOverlay::GetPacingStatistics( void ) const
+{
+    return m_FramePacer.GetStatistics();
+}
+
+FrameTimings CDirect2DOverlay::GetFrameTimings( void ) const
+{
+    return m_FrameTimer.GetTimings();
+}
+
 uint64_t CDirect2DOverlay::GetFramesPerSecond( void ) const
 {
-    return m_nFramesPerSeconds;
+    return m_FrameTimer.GetFramesPerSecond();
+}
+
+CallbackHandle CDirect2DOverlay::AddToRenderFrame( RenderCallback fn, int32_t priority )
+{
+    return m_RenderCallbacks.Add( move( fn ), priority );
+}
+
+CallbackHandle CDirect2DOverlay::AddToRenderFrame( RenderContextCallbackFn fn, void* context, int32_t priority )
+{
+    if( !fn ) {
+        return 0;
+    }
+    return m_RenderCallbacks.Add( [ fn, context ]( const CDirect2DSurface* surface ) { fn( surface, context ); }, priority );
+}
+
+bool CDirect2DOverlay::RemoveFromRenderFrame( CallbackHandle handle )
+{
+    return m_RenderCallbacks.Remove( handle );
+}
+
+bool CDirect2DOverlay::SetCallbackEnabled( CallbackHandle handle, bool enabled )
+{
+    return m_RenderCallbacks.SetEnabled( handle, enabled );
 }
 
-void CDirect2DOverlay::AddToRenderFrame( RenderCallbackFn fn )
+bool CDirect2DOverlay::IsCallbackEnabled( CallbackHandle handle ) const
 {
-    if( fn ) {
-        m_cRenderCallbacks.push_back( fn );
+    return m_RenderCallbacks.IsEnabled( handle );
+}
+
+bool CDirect2DOverlay::SetCallbackBudget( CallbackHandle handle, uint64_t budget )
+{
+    auto* pProfile = m_RenderCallbacks.GetProfile( handle );
+    if( !pProfile ) {
+        return false;
     }
+
+    pProfile->SetBudget( budget );
+    return true;
+}
+
+CallbackStatistics CDirect2DOverlay::GetCallbackStatistics( CallbackHandle handle ) const
+{
+    const auto* pProfile = m_RenderCallbacks.GetProfile( handle );
+    return pProfile ? pProfile->GetStatistics() : CallbackStatistics();
 }
 
 void CDirect2DOverlay::Destroy( void )
@@ -369,21 +579,27 @@ void CDirect2DOverlay::Destroy( void )
         return;
     }
 
+    // The render thread must not present while the interfaces are released
+    StopRenderThread();
+
     // Unregister the overlay window class and destroy the window
     UnregisterClassA( m_cWindowData[ 0 ].c_str(), nullptr );
     DestroyWindow( m_hOvHwnd );
     m_hOvHwnd = nullptr;
 
-    // Release each interface pointer
+    // Release the cached text layouts and meshes and each interface pointer
+    m_Direct2DBackend.ReleaseDeviceResources();
     SafeRelease( &m_pDirect2DFactory );
     SafeRelease( &m_pDirect2DHwndRenderTarget );
     SafeRelease( &m_pDirectWriteFactory );
     SafeRelease( &m_pDiect2DColorBrush );
 
     // and also the font interface pointers
-    for( auto& _pair : m_cCustomFonts ) {
-        SafeRelease( &_pair.second );
+    for( FontHandle handle = 1; handle <= m_Fonts.GetCount(); ++handle ) {
+        auto* pDirectWriteTextFormat = GetFont( handle );
+        SafeRelease( &pDirectWriteTextFormat );
     }
+    m_Fonts.Clear();
 }
 
 void CDirect2DOverlay::Resize( HWND hWindow )
@@ -413,6 +629,10 @@ void CDirect2DOverlay::Resize( HWND hWindow )
     }
 
     MoveWindow( m_hOvHwnd, m_cPosition[ 0 ], m_cPosition[ 1 ], m_cSize[ 0 ], m_cSize[ 1 ], TRUE );
+
+    // the resized window has to be redrawn even if the frame did not change
+    m_bFrameHash = false;
+    m_DirtyRegion.Invalidate();
 }
 
 void CDirect2DOverlay::SetWindowClass( const string& windowClass )
@@ -436,7 +656,7 @@ bool CDirect2DOverlay::StartUp( HWND hWindow )
         GetClientRect( hWindow, &rect );
 
         auto size = D2D1::SizeU( rect.right - rect.left, rect.bottom - rect.top );
-        hr = m_pDirect2DFactory->CreateHwndRenderTarget( D2D1::RenderTargetProperties( D2D1_RENDER_TARGET_TYPE_HARDWARE, D2D1::PixelFormat( DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED ) ), D2D1::HwndRenderTargetProperties( hWindow, size, D2D1_PRESENT_OPTIONS_IMMEDIATELY ), &m_pDirect2DHwndRenderTarget );
+        hr = m_pDirect2DFactory->CreateHwndRenderTarget( D2D1::RenderTargetProperties( D2D1_RENDER_TARGET_TYPE_HARDWARE, D2D1::PixelFormat( DXGI_FORMAT_UNKNOWN, D2D1_ALPHA_MODE_PREMULTIPLIED ) ), D2D1::HwndRenderTargetProperties( hWindow, size, static_cast< D2D1_PRESENT_OPTIONS >( D2D1_PRESENT_OPTIONS_IMMEDIATELY | D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS ) ), &m_pDirect2DHwndRenderTarget );
     }
     if( SUCCEEDED( hr ) ) {
         hr = DWriteCreateFactory( DWRITE_FACTORY_TYPE_SHARED, __uuidof( IDWriteFactory ), reinterpret_cast< IUnknown** >( &m_pDirectWriteFactory ) );
@@ -447,17 +667,4 @@ bool CDirect2DOverlay::StartUp( HWND hWindow )
     return SUCCEEDED( hr );
 }
 
-void CDirect2DOverlay::CalculateFramesPerSecond( bool finished )
-{
-    static uint64_t last = 0, count = 0;
-    if( !finished ) {
-        if( GetTickCount64() - last > static_cast< uint32_t >( 333 ) ) {
-            m_nFramesPerSeconds = static_cast< uint64_t >( static_cast< float >( count ) * 3.333333333f - 3.f );
-            last = GetTickCount64();
-            count = 0;
-        }
-    }
-    else {
-        ++count;
-    }
-}
\ No newline at end of file
+#endif
@@ -3,175 +3,47 @@
 * @last update  05.01.2016
 */
 #pragma once
+#include "Color.hpp"
+#include "CommandList.hpp"
+#include "Format.hpp"
+#include "RenderBackend.hpp"
+#include "Surface.hpp"
+
+#if defined( _WIN32 )
 #include <Windows.h>
-#include <unordered_map>
+#include <memory>
 #include <dwmapi.h>
 #include <d2d1.h>
 #include <d2d1helper.h>
 #include <dwrite.h>
-#include <dwmapi.h>
-#include "Color.hpp"
+#include "CallbackRegistry.hpp"
+#include "Direct2DBackend.hpp"
+#include "DirtyRegion.hpp"
+#include "FramePacer.hpp"
+#include "FrameTimer.hpp"
+#include "LruCache.hpp"
+#include "ParallelRecorder.hpp"
+#include "RectBatcher.hpp"
+#include "RenderThread.hpp"
 
 #pragma comment( lib, "d2d1.lib" )
 #pragma comment( lib, "dwrite.lib" )
 #pragma comment( lib, "dwmapi.lib" )
 
 namespace haze {
-    
+
     class CDirect2DOverlay
     {
     public:
         
         /**
-         * @brief      CDirect2DSurface is a render class for Direct2D.
-         *             Every function does return a boolean which is only
-         *             false when an interface wasn't initialized
-         */
-        class CDirect2DSurface
-        {
-        public:
-            CDirect2DSurface( void ) = default;
-            explicit CDirect2DSurface( const CDirect2DOverlay* pDirect2DOverlay );
-            
-            /**
-             * @brief      Render a bordered box
-             *
-             * @param[in]  x          x-position
-             * @param[in]  y          y-position
-             * @param[in]  w          width
-             * @param[in]  h          height
-             * @param[in]  thickness  thickness
-             * @param[in]  color      color
-             *
-             * @return     bool
-             */
-            bool BorderBox( float x, float y, float w, float h, float thickness, const Color& color ) const;
-            
-            /**
-             * @brief      Render an outlined bordered box
-             *
-             * @param[in]  x                   x-position
-             * @param[in]  y                   y-position
-             * @param[in]  w                   width
-             * @param[in]  h                   height
-             * @param[in]  thickness           thickness
-             * @param[in]  outlined_thickness  outlined thickness
-             * @param[in]  color               color
-             * @param[in]  outlined_color      outlined color
-             *
-             * @return     bool
-             */
-            bool BorderBox( float x, float y, float w, float h, float thickness, float outlined_thickness, const Color& color, const Color& outlined_color ) const;
-            
-            /**
-             * @brief      Render a line
-             *
-             * @param[in]  x          x-initial-position
-             * @param[in]  y          y-initial-position
-             * @param[in]  xx         x-final-position
-             * @param[in]  yy         y-final-posiiton
-             * @param[in]  thickness  tickness
-             * @param[in]  color      color
-             *
-             * @return     biik
-             */
-            bool Line( float x, float y, float xx, float yy, float thickness, const Color& color ) const;
-            
-            /**
-             * @brief      Render a rounded rectangle
-             *
-             * @param[in]  x      x-position
-             * @param[in]  y      y-position
-             * @param[in]  w      width
-             * @param[in]  h      height
-             * @param[in]  x_rad  x-radius
-             * @param[in]  y_rad  y-radius
-             * @param[in]  color  color
-             *
-             * @return     bool
-             */
-            bool RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, const Color& color ) const;
-            
-            /**
-             * @brief      Render an outlined rounded rectangle
-             *
-             * @param[in]  x               x-position
-             * @param[in]  y               y-position
-             * @param[in]  w               width
-             * @param[in]  h               height
-             * @param[in]  x_rad           x-radius
-             * @param[in]  y_rad           y-radius
-             * @param[in]  thickness       thickness
-             * @param[in]  x_rad_outlined  outlined x-radius (whenever -1 was passed, the outlined radius will have the same value as the x_rad)
-             * @param[in]  y_rad_outlined  outlined y-radius (whenever -1 was passed, the outlined radius will have the same value as the y_rad)
-             * @param[in]  color           color
-             * @param[in]  outlined        outlined color
-             *
-             * @return     bool
-             */
-            bool RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float x_rad_outlined, float y_rad_outlined, const Color& color, const Color& outlined ) const;
-            
-            /**
-             * @brief      Render a rectangle
-             *
-             * @param[in]  x      x-position
-             * @param[in]  y      y-position
-             * @param[in]  w      width
-             * @param[in]  h      height
-             * @param[in]  color  color
-             *
-             * @return     bool
-             */
-            bool Rect( float x, float y, float w, float h, const Color& color ) const;
-            
-            /**
-             * @brief      Reder an outlined rectangle
-             *
-             * @param[in]  x          x-position
-             * @param[in]  y          y-position
-             * @param[in]  w          width
-             * @param[in]  h          height
-             * @param[in]  thickness  thickness
-             * @param[in]  color      color
-             * @param[in]  outlined   outlined color
-             *
-             * @return     bool
-             */
-            bool Rect( float x, float y, float w, float h, float thickness, const Color& color, const Color& outlined ) const;
-            
-            /**
-             * @brief      Get the frames per second.
-             *
-             * @return     uint64_t
-             */
-            uint64_t GetFramesPerSecond( void ) const;
-            
-            /**
-             * @brief      Render a string
-             *
-             * @param[in]  x          x-position
-             * @param[in]  y          y-position
-             * @param[in]  font       buffer name
-             * @param[in]  color      color
-             * @param[in]  msg        string
-             * @param[in]  <unnamed>  optional args
-             *
-             * @return     bool
-             */
-            bool String( float x, float y, const string& font, const Color& color, const char* msg, ... ) const;
-            
-            /**
-             * @brief      Set the overlay instance.
-             *
-             * @param[in]  pDirect2DOverlay  The direct2 d overlay
-             */
-            void SetOverlayInstance( const CDirect2DOverlay* pDirect2DOverlay );
-
-        private:
-            const CDirect2DOverlay* m_pDirect2DOverlay = nullptr;
-        };
+         * @brief      The surface used to be bound to Direct2D, it now draws
+         *             into any render backend
+         */
+        using CDirect2DSurface = CRenderSurface;
 
         using RenderCallbackFn = void( *)( const CDirect2DSurface* );
+        using RenderContextCallbackFn = void( *)( const CDirect2DSurface*, void* );
 
     public:
         CDirect2DOverlay( void );
@@ -245,6 +117,196 @@ namespace haze {
          */
         ID2D1SolidColorBrush*  GetDirect2DColorBrush( void ) const;
         
+        /**
+         * @brief      Get the sink the surface has to draw into. While recording
+         *             this is the command list of the current frame, otherwise
+         *             the window render target.
+         *
+         * @return     ICommandSink*
+         */
+        ICommandSink*          GetCommandSink( void ) const;
+
+        /**
+         * @brief      Get the Direct2D render backend of the overlay
+         *
+         * @return     IRenderBackend*
+         */
+        IRenderBackend*        GetRenderBackend( void ) const;
+
+        /**
+         * @brief      Get the commands recorded during the last frame
+         *
+         * @return     const CCommandList&
+         */
+        const CCommandList&    GetCommandList( void ) const;
+
+        /**
+         * @brief      Is the recording mode enabled?
+         *
+         * @return     bool
+         */
+        bool                   IsRecording( void ) const;
+
+        /**
+         * @brief      Enable or disable the recording mode. When enabled, the
+         *             surface records every draw call into a command list
+         *             which gets replayed in one pass at the end of the frame
+         *
+         * @param[in]  recording  enable recording
+         */
+        void                   SetRecording( bool recording );
+
+        /**
+         * @brief      Is the rectangle batching enabled?
+         *
+         * @return     bool
+         */
+        bool                   IsBatching( void ) const;
+
+        /**
+         * @brief      Enable or disable the rectangle batching. Only has an
+         *             effect in recording mode, the recorded rectangles of the
+         *             same color are then submitted as one combined geometry
+         *
+         * @param[in]  batching  enable batching
+         */
+        void                   SetBatching( bool batching );
+
+        /**
+         * @brief      Is the frame elision enabled?
+         *
+         * @return     bool
+         */
+        bool                   IsFrameElision( void ) const;
+
+        /**
+         * @brief      Enable or disable the frame elision. Only has an effect
+         *             in recording mode or on the render thread, a frame whose
+         *             commands hash equal to the presented frame is then
+         *             neither cleared, replayed nor presented.
+         *
+         * @param[in]  elision  enable frame elision
+         */
+        void                   SetFrameElision( bool elision );
+
+        /**
+         * @brief      Get the amount of frames which were skipped because
+         *             nothing had changed
+         *
+         * @return     uint64_t
+         */
+        uint64_t               GetElidedFrames( void ) const;
+
+        /**
+         * @brief      Is the dirty rectangle redraw enabled?
+         *
+         * @return     bool
+         */
+        bool                   IsDirtyRects( void ) const;
+
+        /**
+         * @brief      Enable or disable the dirty rectangle redraw. Only has an
+         *             effect in recording mode, the commands of a frame are
+         *             then compared with the last frame and only the changed
+         *             regions get cleared and redrawn. Frames without changes
+         *             are skipped.
+         *
+         * @param[in]  dirtyRects  enable the dirty rectangle redraw
+         */
+        void                   SetDirtyRects( bool dirtyRects );
+
+        /**
+         * @brief      Get the full, partial and unchanged frames of the dirty
+         *             rectangle redraw
+         *
+         * @return     const DirtyRegionStatistics&
+         */
+        const DirtyRegionStatistics& GetDirtyRegionStatistics( void ) const;
+
+        /**
+         * @brief      Is the parallel recording enabled?
+         *
+         * @return     bool
+         */
+        bool                   IsParallelRecording( void ) const;
+
+        /**
+         * @brief      Enable or disable the parallel recording. Only has an
+         *             effect in recording mode, the callbacks then record
+         *             concurrently on a work stealing pool and their lists are
+         *             merged in registration order. Callbacks must not create
+         *             fonts or share mutable state while recording.
+         *
+         * @param[in]  parallel  enable parallel recording
+         * @param[in]  workers   amount of worker threads, -1 for one less than
+         *                       the amount of hardware threads
+         */
+        void                   SetParallelRecording( bool parallel, int32_t workers = -1 );
+
+        /**
+         * @brief      Start presenting on a dedicated render thread. Render
+         *             then only runs the callbacks and publishes the recorded
+         *             scene, the render thread presents the latest scene
+         *             without ever blocking the caller. Needs a created overlay.
+         *
+         * @return     bool
+         */
+        bool                   StartRenderThread( void );
+
+        /**
+         * @brief      Stop the render thread, Render presents by itself again
+         */
+        void                   StopRenderThread( void );
+
+        /**
+         * @brief      Is a render thread presenting the scenes?
+         *
+         * @return     bool
+         */
+        bool                   IsRenderThreadRunning( void ) const;
+
+        /**
+         * @brief      Get the publish to present statistics of the render
+         *             thread
+         *
+         * @return     RenderThreadStatistics
+         */
+        RenderThreadStatistics GetRenderThreadStatistics( void ) const;
+
+        /**
+         * @brief      Get the amount of rectangles and batches of the last frame
+         *
+         * @return     const CRectBatcher::Counters&
+         */
+        const CRectBatcher::Counters& GetBatchCounters( void ) const;
+
+        /**
+         * @brief      Get the amount of issued and skipped render state
+         *             changes of the last frame, also while the render thread
+         *             runs
+         *
+         * @return     CRenderStateCache::Counters
+         */
+        CRenderStateCache::Counters GetRenderStateCounters( void ) const;
+
+        /**
+         * @brief      Set the memory budget of the text layout cache, 0 disables
+         *             the cache. The thread which draws applies it when its
+         *             next frame begins, so it may also be set while the
+         *             render thread runs.
+         *
+         * @param[in]  budget  budget in bytes
+         */
+        void                   SetTextLayoutBudget( size_t budget );
+
+        /**
+         * @brief      Get the hit/miss statistics of the text layout cache as
+         *             of the last frame, also while the render thread runs
+         *
+         * @return     CacheStatistics
+         */
+        CacheStatistics        GetTextLayoutStatistics( void ) const;
+
         /**
          * @brief      Get a pointer to a registered font interface
          *
@@ -268,21 +330,155 @@ namespace haze {
          * @return     Font.
          */
         IDWriteTextFormat*     GetFont( const string& name, const string& fontName, const float size = 12.f, const string& locale = "en-US",DWRITE_FONT_WEIGHT weight = DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE style = DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH stretch = DWRITE_FONT_STRETCH_NORMAL );
+
+        /**
+         * @brief      Create a font and get its handle, the String overloads
+         *             taking the handle skip the lookup of the name. A name
+         *             which is already registered keeps its font.
+         *
+         * @param[in]  name      buffer name
+         * @param[in]  fontName  font name
+         * @param[in]  size      font size
+         * @param[in]  locale    locale
+         * @param[in]  weight    font weight
+         * @param[in]  style     font style
+         * @param[in]  stretch   font stretch
+         *
+         * @return     FontHandle <> 0 if the font couldn't be created
+         */
+        FontHandle             RegisterFont( const string& name, const string& fontName, const float size = 12.f, const string& locale = "en-US", DWRITE_FONT_WEIGHT weight = DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE style = DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH stretch = DWRITE_FONT_STRETCH_NORMAL );
+
+        /**
+         * @brief      Get a pointer to a registered font interface by its
+         *             handle
+         *
+         * @param[in]  handle  font handle
+         *
+         * @return     IDWriteTextFormat* <> nullptr if the handle is invalid
+         */
+        IDWriteTextFormat*     GetFont( FontHandle handle ) const;
+
+        /**
+         * @brief      Get the handle of a registered font
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     FontHandle <> 0 if there is no such font
+         */
+        FontHandle             GetFontHandle( const string& name ) const;
         
         /**
-         * @brief      Get the frames per second.
+         * @brief      Get the frames per second of the last 256 visible frames
          *
          * @return     uint64_t
          */
         uint64_t               GetFramesPerSecond( void ) const;
+
+        /**
+         * @brief      Get the distribution of the frame, callback and present
+         *             times of the last 256 visible frames. Can be called from
+         *             any thread.
+         *
+         * @return     FrameTimings
+         */
+        FrameTimings           GetFrameTimings( void ) const;
         
+        /**
+         * @brief      Set the frame rate Render paces itself to. While the
+         *             target window is in the background nothing gets drawn
+         *             and Render backs off to a few frames per second.
+         *
+         * @param[in]  fps   frames per second, 0 for no limit
+         */
+        void                   SetTargetFramesPerSecond( uint32_t fps );
+
+        /**
+         * @brief      Get the target frame rate
+         *
+         * @return     uint32_t <> 0 if there is no limit
+         */
+        uint32_t               GetTargetFramesPerSecond( void ) const;
+
+        /**
+         * @brief      Get the frame intervals and the pacing jitter
+         *
+         * @return     PacingStatistics
+         */
+        PacingStatistics       GetPacingStatistics( void ) const;
+
         /**
          * @brief      Add a render function which get executed inside the Render frame
          *
-         * @param[in]  fn    function or function as lambda
+         * @param[in]  fn        function, functor or lambda with up to 48
+         *                       bytes of captures
+         * @param[in]  priority  lower priorities run first and are drawn below
+         *
+         * @return     CallbackHandle <> 0 if fn was empty
          */
-        void                   AddToRenderFrame( RenderCallbackFn fn );
-        
+        CallbackHandle         AddToRenderFrame( RenderCallback fn, int32_t priority = 0 );
+
+        /**
+         * @brief      Add a render function which gets a user context passed
+         *
+         * @param[in]  fn        function
+         * @param[in]  context   passed to every call of fn
+         * @param[in]  priority  lower priorities run first and are drawn below
+         *
+         * @return     CallbackHandle <> 0 if fn was nullptr
+         */
+        CallbackHandle         AddToRenderFrame( RenderContextCallbackFn fn, void* context, int32_t priority = 0 );
+
+        /**
+         * @brief      Remove a render function, may be called from inside a
+         *             render function unless the recording is parallel
+         *
+         * @param[in]  handle  handle returned by AddToRenderFrame
+         *
+         * @return     bool <> false if the handle was invalid
+         */
+        bool                   RemoveFromRenderFrame( CallbackHandle handle );
+
+        /**
+         * @brief      Enable or disable a render function, it keeps its place
+         *
+         * @param[in]  handle   handle returned by AddToRenderFrame
+         * @param[in]  enabled  run the function
+         *
+         * @return     bool <> false if the handle was invalid
+         */
+        bool                   SetCallbackEnabled( CallbackHandle handle, bool enabled );
+
+        /**
+         * @brief      Is the render function registered and enabled?
+         *
+         * @param[in]  handle  handle returned by AddToRenderFrame
+         *
+         * @return     bool
+         */
+        bool                   IsCallbackEnabled( CallbackHandle handle ) const;
+
+        /**
+         * @brief      Set the time budget of a render callback. A callback
+         *             which keeps exceeding its budget only runs every Nth
+         *             frame, in between its last recorded commands are drawn.
+         *
+         * @param[in]  handle  handle returned by AddToRenderFrame
+         * @param[in]  budget  budget in nanoseconds, 0 to never throttle it
+         *
+         * @return     bool <> false if the handle was invalid
+         */
+        bool                   SetCallbackBudget( CallbackHandle handle, uint64_t budget );
+
+        /**
+         * @brief      Get the average, worst and throttling of a render
+         *             callback
+         *
+         * @param[in]  handle  handle returned by AddToRenderFrame
+         *
+         * @return     CallbackStatistics
+         */
+        CallbackStatistics     GetCallbackStatistics( CallbackHandle handle ) const;
+
         /**
          * @brief      Destroy the aero overlay
          */
@@ -321,27 +517,67 @@ namespace haze {
         bool                   StartUp( HWND hWindow );
         
         /**
-         * @brief      Calculate the frames per second.
+         * @brief      Run the callbacks into a scene and publish it to the
+         *             render thread
+         *
+         * @param[in]  visible  is the target window in the foreground?
          *
-         * @param[in]  finished  has finished the render frame?
+         * @return     bool
          */
-        void                   CalculateFramesPerSecond( bool finished );
+        bool                   RenderScene( bool visible );
+
+        /**
+         * @brief      Run every due callback with profiling
+         *
+         * @param[in]  pList  list to record into, nullptr to draw into the
+         *                    backend
+         * @param[in]  fps    frames per second reported to the callbacks
+         */
+        void                   RunCallbacks( CCommandList* pList, uint64_t fps );
+
+        /**
+         * @brief      Compare the hash of a recorded frame with the presented
+         *             one and remember it
+         *
+         * @param[in]  list  recorded frame
+         *
+         * @return     bool <> true if the frame can be skipped
+         */
+        bool                   IsFrameUnchanged( const CCommandList& list );
+
 
     private:
-        static constexpr MARGINS   DWM_MARGINS = { -1, -1, -1, -1 };
-        CDirect2DSurface           m_Direct2DSurface;
-        array< int32_t, 2 >        m_cPosition;
-        array< int32_t, 2 >        m_cSize;
-        array< string, 2 >         m_cWindowData;
-        unordered_map< string,
-            IDWriteTextFormat* >   m_cCustomFonts;
-        vector< RenderCallbackFn > m_cRenderCallbacks;
-        HWND                       m_hOvHwnd = nullptr;
-        HWND                       m_hTargetHwnd = nullptr;
-        uint64_t                   m_nFramesPerSeconds = 0;
-        ID2D1Factory*              m_pDirect2DFactory = nullptr;
-        ID2D1HwndRenderTarget*     m_pDirect2DHwndRenderTarget = nullptr;
-        IDWriteFactory*            m_pDirectWriteFactory = nullptr;
-        ID2D1SolidColorBrush*      m_pDiect2DColorBrush = nullptr;
+        static constexpr MARGINS     DWM_MARGINS = { -1, -1, -1, -1 };
+        CDirect2DSurface             m_Direct2DSurface;
+        mutable CDirect2DBackend     m_Direct2DBackend;
+        mutable CCommandList         m_cCommandList;
+        CRectBatcher                 m_RectBatcher;
+        unique_ptr<
+            CParallelRecorder >      m_pParallelRecorder;
+        unique_ptr< CRenderThread >  m_pRenderThread;
+        CFramePacer                  m_FramePacer;
+        CFrameTimer                  m_FrameTimer;
+        bool                         m_bVisible = true;
+        bool                         m_bRecording = false;
+        bool                         m_bBatching = false;
+        bool                         m_bFrameElision = false;
+        bool                         m_bDirtyRects = false;
+        CDirtyRegion                 m_DirtyRegion;
+        bool                         m_bFrameHash = false;
+        uint64_t                     m_nFrameHash = 0;
+        uint64_t                     m_nElidedFrames = 0;
+        array< int32_t, 2 >          m_cPosition;
+        array< int32_t, 2 >          m_cSize;
+        array< string, 2 >           m_cWindowData;
+        CFontTable                   m_Fonts;
+        CCallbackRegistry            m_RenderCallbacks;
+        HWND                         m_hOvHwnd = nullptr;
+        HWND                         m_hTargetHwnd = nullptr;
+        ID2D1Factory*                m_pDirect2DFactory = nullptr;
+        ID2D1HwndRenderTarget*       m_pDirect2DHwndRenderTarget = nullptr;
+        IDWriteFactory*              m_pDirectWriteFactory = nullptr;
+        ID2D1SolidColorBrush*        m_pDiect2DColorBrush = nullptr;
     };
-}
\ No newline at end of file
+
+}
+#endif
@@ -0,0 +1,50 @@
+#include "ParallelRecorder.hpp"
+using namespace haze;
+
+CParallelRecorder::CParallelRecorder( int32_t workers ) :
+    m_Pool( workers )
+{
+}
+
+bool CParallelRecorder::Record( CCallbackRegistry& registry, IRenderBackend* pRenderBackend, uint64_t fps, CCommandList& list )
+{
+    list.Reset();
+    if( !pRenderBackend ) {
+        return false;
+    }
+
+    // the lists of the registry keep their memory from the last frames
+    const auto count = registry.GetEntryCount();
+    if( m_cSurfaces.size() < count ) {
+        m_cSurfaces.resize( count );
+    }
+
+    // every profile and list is only touched by the worker of its callback
+    m_Pool.ParallelFor( count, [ & ]( size_t i ) {
+        auto& cList = registry.GetEntryList( i );
+        auto& profile = registry.GetEntryProfile( i );
+        if( !registry.IsActive( i ) ) {
+            cList.Reset();
+            return;
+        }
+        if( !profile.IsDue() ) {
+            return;
+        }
+
+        cList.Reset();
+        m_cSurfaces[ i ].SetRenderBackend( pRenderBackend );
+        m_cSurfaces[ i ].SetCommandSink( &cList );
+        m_cSurfaces[ i ].SetFramesPerSecond( fps );
+        profile.Run( [ & ] { registry.Invoke( i, &m_cSurfaces[ i ] ); } );
+    } );
+
+    for( size_t i = 0; i < count; ++i ) {
+        list.Append( registry.GetEntryList( i ) );
+    }
+    return true;
+}
+
+const CWorkStealingPool& CParallelRecorder::GetPool( void ) const
+{
+    return m_Pool;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "CallbackRegistry.hpp"
+#include "CommandList.hpp"
+#include "Surface.hpp"
+#include "ThreadPool.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      CParallelRecorder runs render callbacks concurrently. Every
+     *             callback records into its own command list, the lists are
+     *             merged in run order afterwards, so the result is
+     *             identical to running the callbacks one after another.
+     *             Callbacks must only share read-only state, fonts have to be
+     *             created before recording starts.
+     */
+    class CParallelRecorder
+    {
+    public:
+        /**
+         * @brief      Start the worker pool
+         *
+         * @param[in]  workers  amount of workers, -1 for one less than the
+         *                      amount of hardware threads
+         */
+        explicit CParallelRecorder( int32_t workers = -1 );
+
+        /**
+         * @brief      Record every callback and merge the lists
+         *
+         * @param[in]  registry        compacted callbacks, a callback that is
+         *                             not due merges its last list
+         * @param[in]  pRenderBackend  backend which provides the fonts and size
+         * @param[in]  fps             frames per second reported to the callbacks
+         * @param[out] list            receives the merged commands
+         *
+         * @return     bool <> false if no backend was passed
+         */
+        bool Record( CCallbackRegistry& registry, IRenderBackend* pRenderBackend, uint64_t fps, CCommandList& list );
+
+        /**
+         * @brief      Get the worker pool
+         *
+         * @return     const CWorkStealingPool&
+         */
+        const CWorkStealingPool& GetPool( void ) const;
+
+    private:
+        CWorkStealingPool        m_Pool;
+        vector< CRenderSurface > m_cSurfaces;
+    };
+}
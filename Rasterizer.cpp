@@ -0,0 +1,205 @@
+#include "Rasterizer.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+void CRasterizer::Reset( int32_t x, int32_t y, int32_t w, int32_t h )
+{
+    // drop the area of a shape that never got resolved
+    if( m_bPending ) {
+        for( int32_t row = 0; row < m_nHeight; ++row ) {
+            auto* pArea = m_cArea.data() + static_cast< size_t >( row ) * m_nStride;
+            for( auto column = m_cSpans[ row ].nBegin; column < m_cSpans[ row ].nEnd; ++column ) {
+                pArea[ column ] = 0.f;
+            }
+        }
+        m_bPending = false;
+    }
+
+    m_nX = x;
+    m_nY = y;
+    m_nWidth = max( w, 0 );
+    m_nHeight = max( h, 0 );
+
+    // two columns of padding per row, edges on the right border spill into
+    // them. The area buffer is zero outside of Add/Resolve, Resolve only
+    // clears the touched spans again.
+    m_nStride = m_nWidth + 2;
+    const auto size = static_cast< size_t >( m_nStride ) * m_nHeight;
+    if( m_cArea.size() < size ) {
+        m_cArea.resize( size, 0.f );
+    }
+    if( m_cCoverage.size() < static_cast< size_t >( m_nWidth ) * m_nHeight ) {
+        m_cCoverage.resize( static_cast< size_t >( m_nWidth ) * m_nHeight );
+    }
+    m_cSpans.assign( m_nHeight, { m_nStride, 0 } );
+}
+
+void CRasterizer::AddLine( PointF p0, PointF p1 )
+{
+    // into region space, x is clamped so the area of clipped parts stays on the border
+    const auto w = static_cast< float >( m_nWidth );
+    p0 = { min( max( p0.x - m_nX, 0.f ), w ), p0.y - m_nY };
+    p1 = { min( max( p1.x - m_nX, 0.f ), w ), p1.y - m_nY };
+
+    if( p0.y == p1.y ) {
+        return;
+    }
+    m_bPending = true;
+
+    auto direction = 1.f;
+    if( p0.y > p1.y ) {
+        swap( p0, p1 );
+        direction = -1.f;
+    }
+
+    const auto dxdy = ( p1.x - p0.x ) / ( p1.y - p0.y );
+    auto x = p0.x;
+    if( p0.y < 0.f ) {
+        x -= p0.y * dxdy;
+    }
+
+    const auto yStart = max( static_cast< int32_t >( p0.y ), 0 );
+    const auto yEnd = min( static_cast< int32_t >( ceil( p1.y ) ), m_nHeight );
+    for( auto y = yStart; y < yEnd; ++y ) {
+        auto* pRow = m_cArea.data() + static_cast< size_t >( y ) * m_nStride;
+        auto& span = m_cSpans[ y ];
+
+        const auto dy = min( static_cast< float >( y + 1 ), p1.y ) - max( static_cast< float >( y ), p0.y );
+        const auto xNext = x + dxdy * dy;
+        const auto d = dy * direction;
+
+        // x is never negative inside the region, truncation is floor
+        const auto x0 = min( x, xNext );
+        const auto x1 = max( x, xNext );
+        const auto x0i = static_cast< int32_t >( x0 );
+        const auto x0Floor = static_cast< float >( x0i );
+        auto x1i = static_cast< int32_t >( x1 );
+        if( static_cast< float >( x1i ) < x1 ) {
+            ++x1i;
+        }
+        const auto x1Ceil = static_cast< float >( x1i );
+
+        if( x1i <= x0i + 1 ) {
+            // the edge stays inside a single pixel of this row
+            const auto xmf = 0.5f * ( x + xNext ) - x0Floor;
+            pRow[ x0i ] += d - d * xmf;
+            pRow[ x0i + 1 ] += d * xmf;
+            span.nBegin = min( span.nBegin, x0i );
+            span.nEnd = max( span.nEnd, x0i + 2 );
+        }
+        else {
+            const auto s = 1.f / ( x1 - x0 );
+            const auto x0f = x0 - x0Floor;
+            const auto a0 = 0.5f * s * ( 1.f - x0f ) * ( 1.f - x0f );
+            const auto x1f = x1 - x1Ceil + 1.f;
+            const auto am = 0.5f * s * x1f * x1f;
+
+            pRow[ x0i ] += d * a0;
+            if( x1i == x0i + 2 ) {
+                pRow[ x0i + 1 ] += d * ( 1.f - a0 - am );
+            }
+            else {
+                const auto a1 = s * ( 1.5f - x0f );
+                pRow[ x0i + 1 ] += d * ( a1 - a0 );
+                for( auto xi = x0i + 2; xi < x1i - 1; ++xi ) {
+                    pRow[ xi ] += d * s;
+                }
+                const auto a2 = a1 + static_cast< float >( x1i - x0i - 3 ) * s;
+                pRow[ x1i - 1 ] += d * ( 1.f - a2 - am );
+            }
+            pRow[ x1i ] += d * am;
+            span.nBegin = min( span.nBegin, x0i );
+            span.nEnd = max( span.nEnd, x1i + 1 );
+        }
+
+        x = xNext;
+    }
+}
+
+void CRasterizer::AddPolygon( const PointF* pPoints, size_t count )
+{
+    if( !pPoints || count < 3 ) {
+        return;
+    }
+    for( size_t i = 0; i < count; ++i ) {
+        AddLine( pPoints[ i ], pPoints[ ( i + 1 ) % count ] );
+    }
+}
+
+void CRasterizer::AddQuadratic( PointF p0, PointF p1, PointF p2 )
+{
+    // subdivide until the deviation stays below a quarter pixel
+    const auto dx = p0.x - 2.f * p1.x + p2.x;
+    const auto dy = p0.y - 2.f * p1.y + p2.y;
+    const auto deviation = sqrt( dx * dx + dy * dy );
+    const auto count = max( 1, static_cast< int32_t >( ceil( sqrt( deviation * 2.f ) ) ) );
+
+    auto previous = p0;
+    for( auto i = 1; i <= count; ++i ) {
+        const auto t = static_cast< float >( i ) / static_cast< float >( count );
+        const auto u = 1.f - t;
+        const PointF point = {
+            u * u * p0.x + 2.f * u * t * p1.x + t * t * p2.x,
+            u * u * p0.y + 2.f * u * t * p1.y + t * t * p2.y
+        };
+        AddLine( previous, point );
+        previous = point;
+    }
+}
+
+void CRasterizer::Resolve( bool aliased )
+{
+    m_bPending = false;
+    for( int32_t y = 0; y < m_nHeight; ++y ) {
+        auto* pArea = m_cArea.data() + static_cast< size_t >( y ) * m_nStride;
+        auto* pCoverage = m_cCoverage.data() + static_cast< size_t >( y ) * m_nWidth;
+        auto& span = m_cSpans[ y ];
+
+        // left of the span nothing got accumulated, right of it every
+        // closed outline has summed up to zero again
+        auto accumulated = 0.f;
+        for( auto x = span.nBegin; x < span.nEnd; ++x ) {
+            accumulated += pArea[ x ];
+            pArea[ x ] = 0.f;
+            if( x >= m_nWidth ) {
+                continue;
+            }
+            const auto coverage = min( fabs( accumulated ), 1.f );
+            if( aliased ) {
+                pCoverage[ x ] = coverage >= 0.5f ? 255 : 0;
+            }
+            else {
+                pCoverage[ x ] = static_cast< uint8_t >( coverage * 255.f + 0.5f );
+            }
+        }
+        span.nEnd = min( span.nEnd, m_nWidth );
+    }
+}
+
+const uint8_t* CRasterizer::GetRow( int32_t row, int32_t& begin, int32_t& end ) const
+{
+    begin = m_cSpans[ row ].nBegin;
+    end = m_cSpans[ row ].nEnd;
+    return m_cCoverage.data() + static_cast< size_t >( row ) * m_nWidth;
+}
+
+int32_t CRasterizer::GetX( void ) const
+{
+    return m_nX;
+}
+
+int32_t CRasterizer::GetY( void ) const
+{
+    return m_nY;
+}
+
+int32_t CRasterizer::GetWidth( void ) const
+{
+    return m_nWidth;
+}
+
+int32_t CRasterizer::GetHeight( void ) const
+{
+    return m_nHeight;
+}
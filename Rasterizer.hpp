@@ -0,0 +1,100 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Geometry.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      CRasterizer computes the exact area coverage of polygons
+     *             inside a clip region. Every edge accumulates its signed
+     *             area into a float buffer, a prefix sum per row then yields
+     *             the coverage (nonzero winding, clamped to 1).
+     */
+    class CRasterizer
+    {
+    public:
+        CRasterizer( void ) = default;
+
+        /**
+         * @brief      Start a new shape inside a region, everything outside of
+         *             it gets clipped. Keeps the allocated memory.
+         *
+         * @param[in]  x     region x-position in pixels
+         * @param[in]  y     region y-position in pixels
+         * @param[in]  w     region width in pixels
+         * @param[in]  h     region height in pixels
+         */
+        void Reset( int32_t x, int32_t y, int32_t w, int32_t h );
+
+        /**
+         * @brief      Add an edge in absolute pixel coordinates
+         *
+         * @param[in]  p0    start point
+         * @param[in]  p1    end point
+         */
+        void AddLine( PointF p0, PointF p1 );
+
+        /**
+         * @brief      Add a closed polygon
+         *
+         * @param[in]  pPoints  points
+         * @param[in]  count    amount of points
+         */
+        void AddPolygon( const PointF* pPoints, size_t count );
+
+        /**
+         * @brief      Add a quadratic bezier curve, flattened into lines
+         *
+         * @param[in]  p0    start point
+         * @param[in]  p1    control point
+         * @param[in]  p2    end point
+         */
+        void AddQuadratic( PointF p0, PointF p1, PointF p2 );
+
+        /**
+         * @brief      Convert the accumulated area into 8 bit coverage. Has to
+         *             be called once after every edge was added.
+         *
+         * @param[in]  aliased  round the coverage to 0 or 255
+         */
+        void Resolve( bool aliased = false );
+
+        /**
+         * @brief      Get the coverage of a region row after Resolve. Only the
+         *             columns [begin, end) are valid, everything else is not
+         *             covered.
+         *
+         * @param[in]  row    row inside the region
+         * @param[out] begin  first covered column
+         * @param[out] end    column after the last covered one
+         *
+         * @return     const uint8_t* <> coverage of the whole row
+         */
+        const uint8_t* GetRow( int32_t row, int32_t& begin, int32_t& end ) const;
+
+        int32_t GetX( void ) const;
+        int32_t GetY( void ) const;
+        int32_t GetWidth( void ) const;
+        int32_t GetHeight( void ) const;
+
+    private:
+        struct Span
+        {
+            int32_t nBegin;
+            int32_t nEnd;
+        };
+
+    private:
+        int32_t           m_nX = 0;
+        int32_t           m_nY = 0;
+        int32_t           m_nWidth = 0;
+        int32_t           m_nHeight = 0;
+        int32_t           m_nStride = 0;
+        bool              m_bPending = false;
+        vector< float >   m_cArea;
+        vector< uint8_t > m_cCoverage;
+        vector< Span >    m_cSpans;
+    };
+}
@@ -0,0 +1,223 @@
+#include "RectBatcher.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+namespace {
+    bool Intersects( const RectF& a, const RectF& b )
+    {
+        return a.x < b.x + b.w && b.x < a.x + a.w &&
+               a.y < b.y + b.h && b.y < a.y + a.h;
+    }
+
+    RectF Normalize( float x, float y, float w, float h )
+    {
+        return { min( x, x + w ), min( y, y + h ), abs( w ), abs( h ) };
+    }
+
+    RectF Union( const RectF& a, const RectF& b )
+    {
+        auto left   = min( a.x, b.x );
+        auto top    = min( a.y, b.y );
+        auto right  = max( a.x + a.w, b.x + b.w );
+        auto bottom = max( a.y + a.h, b.y + b.h );
+        return { left, top, right - left, bottom - top };
+    }
+}
+
+bool CRectBatcher::Submit( const CCommandList& list, ICommandSink& sink )
+{
+    m_Counters = Counters();
+    m_nBatches = 0;
+
+    auto result = true;
+    for( const auto& command : list.GetCommands() ) {
+        if( command.eType == DrawCommandType::Rect ) {
+            // bound the overlap tests of a single run
+            if( m_nBatches == MAX_BATCHES ) {
+                result &= Flush( sink );
+            }
+            Add( Normalize( command.x, command.y, command.w, command.h ), command.nColor );
+            ++m_Counters.nRects;
+            continue;
+        }
+
+        // anything else may overlap the pending rectangles
+        result &= Flush( sink );
+        result &= list.Replay( command, sink );
+    }
+    result &= Flush( sink );
+
+    return result;
+}
+
+const CRectBatcher::Counters& CRectBatcher::GetCounters( void ) const
+{
+    return m_Counters;
+}
+
+void CRectBatcher::Add( const RectF& rect, uint32_t color )
+{
+    const auto translucent = ( color >> 24 ) != 0xFF;
+
+    // batches newer than the overlapped one are not overlapped, the search stops at it
+    size_t newest = 0;
+    const auto overlapping = FindOverlap( rect, newest );
+
+    // find the latest batch of this color which the rectangle may join
+    size_t target = m_nBatches;
+    for( size_t i = m_nBatches; i-- > 0; ) {
+        const auto overlaps = overlapping && i == newest;
+        if( m_cBatches[ i ].nColor == color ) {
+            if( !translucent || !overlaps ) {
+                target = i;
+            }
+            break;
+        }
+        // joining an older batch would draw the rectangle below this one
+        if( overlaps ) {
+            break;
+        }
+    }
+
+    if( target < m_nBatches ) {
+        auto& batch = m_cBatches[ target ];
+        Index( rect, target );
+        batch.cRects.push_back( rect );
+        batch.bounds = Union( batch.bounds, rect );
+        return;
+    }
+
+    if( m_nBatches == m_cBatches.size() ) {
+        m_cBatches.emplace_back();
+    }
+
+    // keep the capacity of recycled batches
+    Index( rect, m_nBatches );
+    auto& batch = m_cBatches[ m_nBatches++ ];
+    batch.nColor = color;
+    batch.bounds = rect;
+    batch.cRects.clear();
+    batch.cRects.push_back( rect );
+}
+
+bool CRectBatcher::Flush( ICommandSink& sink )
+{
+    auto result = true;
+    for( size_t i = 0; i < m_nBatches; ++i ) {
+        const auto& batch = m_cBatches[ i ];
+        if( batch.cRects.size() == 1 ) {
+            const auto& rect = batch.cRects.front();
+            result &= sink.FillRect( rect.x, rect.y, rect.w, rect.h, batch.nColor );
+        }
+        else {
+            result &= sink.FillRects( batch.cRects.data(), batch.cRects.size(), batch.nColor );
+        }
+    }
+
+    m_Counters.nBatches += m_nBatches;
+    m_nBatches = 0;
+
+    // cells of an older run are emptied when they are used again
+    ++m_nRun;
+    m_cLarge.clear();
+    if( m_cGrid.size() > MAX_GRID_CELLS ) {
+        m_cGrid.clear();
+    }
+    return result;
+}
+
+bool CRectBatcher::Overlaps( const Batch& batch, const RectF& rect )
+{
+    if( !Intersects( batch.bounds, rect ) ) {
+        return false;
+    }
+    for( const auto& other : batch.cRects ) {
+        if( Intersects( other, rect ) ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool CRectBatcher::FindOverlap( const RectF& rect, size_t& newest ) const
+{
+    int32_t cells[ 4 ];
+    if( !GetCells( rect, cells ) ) {
+        // too large for the grid, every batch is tested from the newest
+        for( size_t i = m_nBatches; i-- > 0; ) {
+            if( Overlaps( m_cBatches[ i ], rect ) ) {
+                newest = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto found = false;
+    const auto test = [ & ]( const Entry& entry ) {
+        if( ( !found || entry.nBatch > newest ) && Intersects( entry.rect, rect ) ) {
+            newest = entry.nBatch;
+            found = true;
+        }
+    };
+    for( const auto& entry : m_cLarge ) {
+        test( entry );
+    }
+    for( auto y = cells[ 1 ]; y <= cells[ 3 ]; ++y ) {
+        for( auto x = cells[ 0 ]; x <= cells[ 2 ]; ++x ) {
+            const auto it = m_cGrid.find( GetKey( x, y ) );
+            if( it == m_cGrid.end() || it->second.nRun != m_nRun ) {
+                continue;
+            }
+            for( const auto& entry : it->second.cEntries ) {
+                test( entry );
+            }
+            // nothing is newer than the last batch
+            if( found && newest + 1 == m_nBatches ) {
+                return true;
+            }
+        }
+    }
+    return found;
+}
+
+void CRectBatcher::Index( const RectF& rect, size_t batch )
+{
+    const Entry entry = { rect, static_cast< uint32_t >( batch ) };
+    int32_t cells[ 4 ];
+    if( !GetCells( rect, cells ) ) {
+        m_cLarge.push_back( entry );
+        return;
+    }
+
+    for( auto y = cells[ 1 ]; y <= cells[ 3 ]; ++y ) {
+        for( auto x = cells[ 0 ]; x <= cells[ 2 ]; ++x ) {
+            auto& cell = m_cGrid[ GetKey( x, y ) ];
+            if( cell.nRun != m_nRun ) {
+                cell.nRun = m_nRun;
+                cell.cEntries.clear();
+            }
+            cell.cEntries.push_back( entry );
+        }
+    }
+}
+
+bool CRectBatcher::GetCells( const RectF& rect, int32_t ( &cells )[ 4 ] )
+{
+    // the comparisons also keep NaN out of the casts
+    const auto limit = static_cast< float >( 1 << 20 );
+    const float bounds[ 4 ] = { floor( rect.x / CELL_SIZE ), floor( rect.y / CELL_SIZE ), floor( ( rect.x + rect.w ) / CELL_SIZE ), floor( ( rect.y + rect.h ) / CELL_SIZE ) };
+    for( size_t i = 0; i < 4; ++i ) {
+        if( !( bounds[ i ] >= -limit && bounds[ i ] <= limit ) ) {
+            return false;
+        }
+        cells[ i ] = static_cast< int32_t >( bounds[ i ] );
+    }
+    return ( cells[ 2 ] - cells[ 0 ] + 1 ) * ( cells[ 3 ] - cells[ 1 ] + 1 ) <= MAX_CELLS;
+}
+
+uint64_t CRectBatcher::GetKey( int32_t x, int32_t y )
+{
+    return static_cast< uint64_t >( static_cast< uint32_t >( x ) ) << 32 | static_cast< uint32_t >( y );
+}
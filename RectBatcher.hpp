@@ -0,0 +1,147 @@
+#pragma once
+#include "CommandList.hpp"
+#include <unordered_map>
+
+namespace haze {
+
+    /**
+     * @brief      CRectBatcher replays a command list and merges runs of
+     *             axis aligned rectangles into one FillRects call per color.
+     *             A rectangle only joins an earlier batch of its color when it
+     *             does not overlap anything drawn in between, so the output
+     *             stays identical to a plain replay. Translucent rectangles
+     *             additionally must not overlap their own batch, because a
+     *             merged geometry would blend the overlap only once.
+     *             The overlap tests look up the rectangles of the run in a
+     *             grid, so a run costs linear time in its rectangles.
+     */
+    class CRectBatcher
+    {
+    public:
+        struct Counters
+        {
+            uint64_t nRects   = 0;
+            uint64_t nBatches = 0;
+        };
+
+    public:
+        CRectBatcher( void ) = default;
+
+        /**
+         * @brief      Replay a command list with merged rectangles
+         *
+         * @param[in]  list  recorded command list
+         * @param[in]  sink  target sink
+         *
+         * @return     bool <> false if the sink rejected a command
+         */
+        bool Submit( const CCommandList& list, ICommandSink& sink );
+
+        /**
+         * @brief      Get the amount of rectangles and the amount of batches
+         *             they were submitted in during the last Submit
+         *
+         * @return     const Counters&
+         */
+        const Counters& GetCounters( void ) const;
+
+    private:
+        struct Batch
+        {
+            uint32_t        nColor;
+            RectF           bounds;
+            vector< RectF > cRects;
+        };
+
+        struct Entry
+        {
+            RectF    rect;
+            uint32_t nBatch;
+        };
+
+        struct Cell
+        {
+            uint64_t        nRun = 0;
+            vector< Entry > cEntries;
+        };
+
+        /**
+         * @brief      Add a rectangle to the current run
+         *
+         * @param[in]  rect   normalized rectangle
+         * @param[in]  color  argb color
+         */
+        void Add( const RectF& rect, uint32_t color );
+
+        /**
+         * @brief      Submit every batch of the current run in order
+         *
+         * @param[in]  sink  target sink
+         *
+         * @return     bool
+         */
+        bool Flush( ICommandSink& sink );
+
+        /**
+         * @brief      Does a rectangle overlap any rectangle of a batch?
+         *
+         * @param[in]  batch  batch
+         * @param[in]  rect   normalized rectangle
+         *
+         * @return     bool
+         */
+        static bool Overlaps( const Batch& batch, const RectF& rect );
+
+        /**
+         * @brief      Find the newest batch of the run a rectangle overlaps
+         *
+         * @param[in]  rect    normalized rectangle
+         * @param[out] newest  index of the batch
+         *
+         * @return     bool <> false if it overlaps no batch
+         */
+        bool FindOverlap( const RectF& rect, size_t& newest ) const;
+
+        /**
+         * @brief      Add a rectangle of a batch to the grid
+         *
+         * @param[in]  rect   normalized rectangle
+         * @param[in]  batch  index of the batch
+         */
+        void Index( const RectF& rect, size_t batch );
+
+        /**
+         * @brief      Get the grid cells a rectangle covers
+         *
+         * @param[in]  rect   normalized rectangle
+         * @param[out] cells  first and last cell in x and y
+         *
+         * @return     bool <> false if it covers too many cells or any
+         *             coordinate is out of the grid
+         */
+        static bool GetCells( const RectF& rect, int32_t ( &cells )[ 4 ] );
+
+        /**
+         * @brief      Get the key of a grid cell
+         *
+         * @param[in]  x     x-cell
+         * @param[in]  y     y-cell
+         *
+         * @return     uint64_t
+         */
+        static uint64_t GetKey( int32_t x, int32_t y );
+
+    private:
+        static constexpr size_t  MAX_BATCHES = 32;
+        static constexpr float   CELL_SIZE = 32.f;
+        static constexpr int32_t MAX_CELLS = 64;
+        static constexpr size_t  MAX_GRID_CELLS = 1 << 14;
+        vector< Batch >          m_cBatches;
+        size_t                   m_nBatches = 0;
+        Counters                 m_Counters;
+        unordered_map< uint64_t,
+            Cell >               m_cGrid;
+        vector< Entry >          m_cLarge;
+        uint64_t                 m_nRun = 1;
+    };
+}
@@ -0,0 +1,165 @@
+#include "RenderBackend.hpp"
+using namespace haze;
+
+bool IRenderBackend::BeginPartialFrame( void )
+{
+    return false;
+}
+
+bool IRenderBackend::PushClip( const RectF& )
+{
+    return false;
+}
+
+bool IRenderBackend::PopClip( void )
+{
+    return false;
+}
+
+bool IRenderBackend::Clear( void )
+{
+    return false;
+}
+
+bool IRenderBackend::MeasureText( float, float, float, float, const wchar_t*, size_t, const void*, RectF& )
+{
+    return false;
+}
+
+FontHandle IRenderBackend::GetFontHandle( const string& ) const
+{
+    return 0;
+}
+
+const void* IRenderBackend::GetFont( FontHandle ) const
+{
+    return nullptr;
+}
+
+CCountingRenderBackend::CCountingRenderBackend( int32_t w, int32_t h )
+{
+    SetSize( w, h );
+}
+
+bool CCountingRenderBackend::FillRect( float x, float y, float w, float h, uint32_t color )
+{
+    return m_CountingSink.FillRect( x, y, w, h, color );
+}
+
+bool CCountingRenderBackend::FillRects( const RectF* pRects, size_t count, uint32_t color )
+{
+    return m_CountingSink.FillRects( pRects, count, color );
+}
+
+bool CCountingRenderBackend::FillColoredRects( const ColoredRect* pRects, size_t count )
+{
+    return m_CountingSink.FillColoredRects( pRects, count );
+}
+
+bool CCountingRenderBackend::FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color )
+{
+    return m_CountingSink.FillRoundedRect( x, y, w, h, x_rad, y_rad, color );
+}
+
+bool CCountingRenderBackend::FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color )
+{
+    return m_CountingSink.FillRoundedFrame( x, y, w, h, x_rad, y_rad, thickness, inner_x_rad, inner_y_rad, color, inner_color );
+}
+
+bool CCountingRenderBackend::Line( float x, float y, float xx, float yy, float thickness, uint32_t color )
+{
+    return m_CountingSink.Line( x, y, xx, yy, thickness, color );
+}
+
+bool CCountingRenderBackend::Lines( const ColoredLine* pLines, size_t count )
+{
+    return m_CountingSink.Lines( pLines, count );
+}
+
+bool CCountingRenderBackend::Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color )
+{
+    return m_CountingSink.Polyline( pPoints, count, thickness, color );
+}
+
+bool CCountingRenderBackend::Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color )
+{
+    if( !text || !pFont ) {
+        return false;
+    }
+    return m_CountingSink.Text( x, y, w, h, text, length, pFont, color );
+}
+
+bool CCountingRenderBackend::SetTransform( const Transform& transform )
+{
+    return m_CountingSink.SetTransform( transform );
+}
+
+bool CCountingRenderBackend::SetAntialiasMode( AntialiasMode mode )
+{
+    return m_CountingSink.SetAntialiasMode( mode );
+}
+
+bool CCountingRenderBackend::BeginFrame( void )
+{
+    return true;
+}
+
+bool CCountingRenderBackend::EndFrame( void )
+{
+    ++m_nFrames;
+    return true;
+}
+
+const void* CCountingRenderBackend::GetFont( const string& name ) const
+{
+    return m_FontTable.Get( name );
+}
+
+FontHandle CCountingRenderBackend::GetFontHandle( const string& name ) const
+{
+    return m_FontTable.Find( name );
+}
+
+const void* CCountingRenderBackend::GetFont( FontHandle handle ) const
+{
+    return m_FontTable.Get( handle );
+}
+
+array< int32_t, 2 > CCountingRenderBackend::GetSize( void ) const
+{
+    return m_cSize;
+}
+
+const void* CCountingRenderBackend::RegisterFont( const string& name )
+{
+    if( name.empty() ) {
+        return nullptr;
+    }
+    const void* pFont = &*m_cFonts.insert( name ).first;
+    m_FontTable.Insert( name, pFont );
+    return pFont;
+}
+
+void CCountingRenderBackend::SetSize( int32_t w, int32_t h )
+{
+    m_cSize = { { w, h } };
+}
+
+CCountingRenderBackend::Counters CCountingRenderBackend::GetCounters( void ) const
+{
+    Counters counters;
+    static_cast< CCountingCommandSink::Counters& >( counters ) = m_CountingSink.GetCounters();
+    counters.nFrames = m_nFrames;
+    return counters;
+}
+
+uint64_t CCountingRenderBackend::GetDrawCalls( void ) const
+{
+    return m_CountingSink.GetDrawCalls();
+}
+
+void CCountingRenderBackend::Reset( void )
+{
+    m_CountingSink.Reset();
+    m_nFrames = 0;
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include "CommandList.hpp"
+#include "FontTable.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      IRenderBackend is a render target the surface can draw into.
+     *             Next to the draw calls of a sink it owns the frame and the
+     *             fonts. Every function returns false when the backend wasn't
+     *             able to process the call.
+     */
+    class IRenderBackend : public ICommandSink
+    {
+    public:
+        /**
+         * @brief      Start a new frame, clears the target and resets the
+         *             transform and antialias mode
+         *
+         * @return     bool
+         */
+        virtual bool BeginFrame( void ) = 0;
+
+        /**
+         * @brief      Finish and present the current frame
+         *
+         * @return     bool
+         */
+        virtual bool EndFrame( void ) = 0;
+
+        /**
+         * @brief      Start a new frame which keeps the content of the last
+         *             one, only resets the transform and antialias mode. The
+         *             default implementation does not support it.
+         *
+         * @return     bool <> false if the content can't be kept
+         */
+        virtual bool BeginPartialFrame( void );
+
+        /**
+         * @brief      Restrict every following call to an axis aligned
+         *             rectangle in target pixels, the transform is not applied.
+         *             Clips nest. The default implementation does not support
+         *             clipping.
+         *
+         * @param[in]  rect  clip rectangle
+         *
+         * @return     bool
+         */
+        virtual bool PushClip( const RectF& rect );
+
+        /**
+         * @brief      Remove the last pushed clip rectangle
+         *
+         * @return     bool
+         */
+        virtual bool PopClip( void );
+
+        /**
+         * @brief      Clear the current clip rectangle, or the whole target
+         *             without a clip
+         *
+         * @return     bool
+         */
+        virtual bool Clear( void );
+
+        /**
+         * @brief      Measure the area a text command covers. The default
+         *             implementation can't measure and the layout box has to
+         *             be assumed.
+         *
+         * @param[in]  x       x-position
+         * @param[in]  y       y-position
+         * @param[in]  w       layout width
+         * @param[in]  h       layout height
+         * @param[in]  text    utf-16 text (not null terminated)
+         * @param[in]  length  text length
+         * @param[in]  pFont   backend specific font object
+         * @param[out] bounds  covered area, untransformed
+         *
+         * @return     bool <> false if the text couldn't be measured
+         */
+        virtual bool MeasureText( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, RectF& bounds );
+
+        /**
+         * @brief      Get a registered font
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     const void* <> backend specific font object, nullptr if
+         *             there is no such font
+         */
+        virtual const void* GetFont( const string& name ) const = 0;
+
+        /**
+         * @brief      Get the handle of a registered font. The default
+         *             implementation has no handles.
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     FontHandle <> 0 if there is no such font
+         */
+        virtual FontHandle GetFontHandle( const string& name ) const;
+
+        /**
+         * @brief      Get a registered font by its handle
+         *
+         * @param[in]  handle  font handle
+         *
+         * @return     const void* <> backend specific font object, nullptr if
+         *             the handle is invalid
+         */
+        virtual const void* GetFont( FontHandle handle ) const;
+
+        /**
+         * @brief      Get the resolution of the target
+         *
+         * @return     array< int32_t, 2 >
+         */
+        virtual array< int32_t, 2 > GetSize( void ) const = 0;
+    };
+
+    /**
+     * @brief      CCountingRenderBackend does not render anything, it only
+     *             counts the calls it has received. Builds everywhere, so the
+     *             overhead of the surface can be measured without a window or
+     *             driver involved.
+     */
+    class CCountingRenderBackend : public IRenderBackend
+    {
+    public:
+        struct Counters : CCountingCommandSink::Counters
+        {
+            uint64_t nFrames = 0;
+        };
+
+    public:
+        CCountingRenderBackend( void ) = default;
+        CCountingRenderBackend( int32_t w, int32_t h );
+
+        bool FillRect( float x, float y, float w, float h, uint32_t color ) override;
+        bool FillRects( const RectF* pRects, size_t count, uint32_t color ) override;
+        bool FillColoredRects( const ColoredRect* pRects, size_t count ) override;
+        bool FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color ) override;
+        bool FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color ) override;
+        bool Line( float x, float y, float xx, float yy, float thickness, uint32_t color ) override;
+        bool Lines( const ColoredLine* pLines, size_t count ) override;
+        bool Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color ) override;
+        bool Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color ) override;
+        bool SetTransform( const Transform& transform ) override;
+        bool SetAntialiasMode( AntialiasMode mode ) override;
+        bool BeginFrame( void ) override;
+        bool EndFrame( void ) override;
+        const void* GetFont( const string& name ) const override;
+        FontHandle GetFontHandle( const string& name ) const override;
+        const void* GetFont( FontHandle handle ) const override;
+        array< int32_t, 2 > GetSize( void ) const override;
+
+        /**
+         * @brief      Register a font, the returned object is only a unique
+         *             token that stays valid
+         *
+         * @param[in]  name  buffer name
+         *
+         * @return     const void*
+         */
+        const void* RegisterFont( const string& name );
+
+        /**
+         * @brief      Set the reported resolution
+         *
+         * @param[in]  w     width
+         * @param[in]  h     height
+         */
+        void SetSize( int32_t w, int32_t h );
+
+        /**
+         * @brief      Get the amount of calls per primitive and of frames
+         *
+         * @return     Counters
+         */
+        Counters GetCounters( void ) const;
+
+        /**
+         * @brief      Get the amount of all draw calls
+         *
+         * @return     uint64_t
+         */
+        uint64_t GetDrawCalls( void ) const;
+
+        /**
+         * @brief      Reset all counters
+         */
+        void Reset( void );
+
+    private:
+        CCountingCommandSink    m_CountingSink;
+        uint64_t                m_nFrames = 0;
+        array< int32_t, 2 >     m_cSize = { { 0, 0 } };
+        unordered_set< string > m_cFonts;
+        CFontTable              m_FontTable;
+    };
+}
@@ -0,0 +1,86 @@
+#include "RenderState.hpp"
+using namespace haze;
+
+Transform Transform::Identity( void )
+{
+    return { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f };
+}
+
+bool Transform::operator == ( const Transform& transform ) const
+{
+    return m11 == transform.m11 && m12 == transform.m12 &&
+           m21 == transform.m21 && m22 == transform.m22 &&
+           dx == transform.dx   && dy == transform.dy;
+}
+
+bool Transform::operator != ( const Transform& transform ) const
+{
+    return !( *this == transform );
+}
+
+bool CRenderStateCache::SetColor( uint32_t color )
+{
+    if( !Track( !m_bValidColor || m_nColor != color ) ) {
+        return false;
+    }
+
+    m_nColor = color;
+    m_bValidColor = true;
+    return true;
+}
+
+bool CRenderStateCache::SetTransform( const Transform& transform )
+{
+    if( !Track( !m_bValidTransform || m_Transform != transform ) ) {
+        return false;
+    }
+
+    m_Transform = transform;
+    m_bValidTransform = true;
+    return true;
+}
+
+bool CRenderStateCache::SetAntialiasMode( AntialiasMode mode )
+{
+    if( !Track( !m_bValidAntialiasMode || m_eAntialiasMode != mode ) ) {
+        return false;
+    }
+
+    m_eAntialiasMode = mode;
+    m_bValidAntialiasMode = true;
+    return true;
+}
+
+void CRenderStateCache::Invalidate( void )
+{
+    m_bValidColor = false;
+    m_bValidTransform = false;
+    m_bValidAntialiasMode = false;
+}
+
+void CRenderStateCache::NextFrame( void )
+{
+    m_LastFrameCounters = m_Counters;
+    m_Counters = Counters();
+}
+
+const CRenderStateCache::Counters& CRenderStateCache::GetCounters( void ) const
+{
+    return m_Counters;
+}
+
+const CRenderStateCache::Counters& CRenderStateCache::GetLastFrameCounters( void ) const
+{
+    return m_LastFrameCounters;
+}
+
+bool CRenderStateCache::Track( bool changed )
+{
+    if( changed ) {
+        ++m_Counters.nIssued;
+    }
+    else {
+        ++m_Counters.nSkipped;
+    }
+    return changed;
+}
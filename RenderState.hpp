@@ -0,0 +1,121 @@
+#pragma once
+#include <cstdint>
+
+namespace haze {
+    using namespace std;
+
+    enum class AntialiasMode : uint32_t
+    {
+        PerPrimitive,
+        Aliased
+    };
+
+    /**
+     * @brief      2D affine transform, laid out like a D2D1_MATRIX_3X2_F
+     */
+    struct Transform
+    {
+        float m11;
+        float m12;
+        float m21;
+        float m22;
+        float dx;
+        float dy;
+
+        /**
+         * @brief      Get the identity transform
+         *
+         * @return     Transform
+         */
+        static Transform Identity( void );
+
+        bool operator == ( const Transform& transform ) const;
+        bool operator != ( const Transform& transform ) const;
+    };
+
+    /**
+     * @brief      CRenderStateCache remembers the state which was last sent to
+     *             a render target, so redundant color, transform and antialias
+     *             changes can be skipped. Every Set function returns true when
+     *             the change has to be issued.
+     */
+    class CRenderStateCache
+    {
+    public:
+        struct Counters
+        {
+            uint64_t nIssued  = 0;
+            uint64_t nSkipped = 0;
+        };
+
+    public:
+        CRenderStateCache( void ) = default;
+
+        /**
+         * @brief      Track a brush color change
+         *
+         * @param[in]  color  argb color
+         *
+         * @return     bool <> true if the color has to be applied
+         */
+        bool SetColor( uint32_t color );
+
+        /**
+         * @brief      Track a transform change
+         *
+         * @param[in]  transform  transform
+         *
+         * @return     bool <> true if the transform has to be applied
+         */
+        bool SetTransform( const Transform& transform );
+
+        /**
+         * @brief      Track an antialias mode change
+         *
+         * @param[in]  mode  antialias mode
+         *
+         * @return     bool <> true if the mode has to be applied
+         */
+        bool SetAntialiasMode( AntialiasMode mode );
+
+        /**
+         * @brief      Forget the tracked state, the next change of every kind
+         *             will be issued. Has to be called whenever the render
+         *             target or brush got recreated.
+         */
+        void Invalidate( void );
+
+        /**
+         * @brief      Finish the current frame, its counters become the
+         *             counters of the last frame and start again at zero
+         */
+        void NextFrame( void );
+
+        /**
+         * @brief      Get the counters of the current frame
+         *
+         * @return     const Counters&
+         */
+        const Counters& GetCounters( void ) const;
+
+        /**
+         * @brief      Get the counters of the last finished frame
+         *
+         * @return     const Counters&
+         */
+        const Counters& GetLastFrameCounters( void ) const;
+
+    private:
+        bool Track( bool changed );
+
+    private:
+        uint32_t      m_nColor = 0;
+        Transform     m_Transform = Transform::Identity();
+        AntialiasMode m_eAntialiasMode = AntialiasMode::PerPrimitive;
+        bool          m_bValidColor = false;
+        bool          m_bValidTransform = false;
+        bool          m_bValidAntialiasMode = false;
+        Counters      m_Counters;
+        Counters      m_LastFrameCounters;
+    };
+}
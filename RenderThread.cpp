@@ -0,0 +1,179 @@
+#include "RenderThread.hpp"
+#include <algorithm>
+#include <chrono>
+using namespace haze;
+
+namespace {
+    uint64_t GetTimestamp( void )
+    {
+        return static_cast< uint64_t >( chrono::duration_cast< chrono::nanoseconds >( chrono::steady_clock::now().time_since_epoch() ).count() );
+    }
+}
+
+CRenderThread::CRenderThread( IRenderBackend* pRenderBackend ) :
+    m_pRenderBackend( pRenderBackend )
+{
+}
+
+CRenderThread::~CRenderThread( void )
+{
+    Stop();
+}
+
+bool CRenderThread::Start( void )
+{
+    if( !m_pRenderBackend || m_bRunning ) {
+        return false;
+    }
+
+    m_bStop = false;
+    m_bRunning = true;
+    m_Thread = thread( &CRenderThread::ThreadLoop, this );
+    return true;
+}
+
+void CRenderThread::Stop( void )
+{
+    if( !m_bRunning ) {
+        return;
+    }
+
+    {
+        lock_guard< mutex > lock( m_Mutex );
+        m_bStop = true;
+    }
+    m_Wake.notify_one();
+
+    m_Thread.join();
+    m_bRunning = false;
+}
+
+bool CRenderThread::IsRunning( void ) const
+{
+    return m_bRunning;
+}
+
+CCommandList& CRenderThread::BeginScene( void )
+{
+    auto& scene = m_cScenes.GetWriteBuffer();
+    scene.cList.Reset();
+    return scene.cList;
+}
+
+void CRenderThread::PublishScene( void )
+{
+    auto& scene = m_cScenes.GetWriteBuffer();
+    scene.nSequence = ++m_nSequence;
+    scene.nPublishTime = GetTimestamp();
+
+    // counted before the render thread can see the scene, so a snapshot
+    // never holds more presented scenes than published ones
+    m_nPublished.fetch_add( 1, memory_order_relaxed );
+    m_cScenes.Publish();
+
+    // the producer never takes the lock, a missed wake up only costs the
+    // render thread its next timeout
+    m_Wake.notify_one();
+}
+
+void CRenderThread::SetBatching( bool batching )
+{
+    m_bBatching = batching;
+}
+
+bool CRenderThread::IsBatching( void ) const
+{
+    return m_bBatching;
+}
+
+RenderThreadStatistics CRenderThread::GetStatistics( void ) const
+{
+    const auto snapshot = m_Snapshot.Load();
+    auto statistics = snapshot.Statistics;
+    statistics.nPublished = m_nPublished.load( memory_order_relaxed ) - snapshot.nPublishedBefore;
+    return statistics;
+}
+
+void CRenderThread::ResetStatistics( void )
+{
+    if( m_bRunning ) {
+        m_bReset = true;
+        return;
+    }
+    Reset();
+}
+
+void CRenderThread::ThreadLoop( void )
+{
+    while( !m_bStop ) {
+        if( m_bReset.exchange( false ) ) {
+            Reset();
+        }
+
+        if( !m_cScenes.Acquire() ) {
+            unique_lock< mutex > lock( m_Mutex );
+            m_Wake.wait_for( lock, chrono::milliseconds( 1 ), [ & ] {
+                return m_bStop || m_cScenes.HasPublished();
+            } );
+            continue;
+        }
+
+        Present( m_cScenes.GetReadBuffer() );
+    }
+}
+
+void CRenderThread::Present( Scene& scene )
+{
+    // scenes which got overwritten before they could be presented
+    if( scene.nSequence > m_nLastSequence + 1 ) {
+        m_nDropped += scene.nSequence - m_nLastSequence - 1;
+    }
+    m_nLastSequence = scene.nSequence;
+
+    if( m_pRenderBackend->BeginFrame() ) {
+        if( m_bBatching ) {
+            m_RectBatcher.Submit( scene.cList, *m_pRenderBackend );
+        }
+        else {
+            scene.cList.Replay( *m_pRenderBackend );
+        }
+    }
+    m_pRenderBackend->EndFrame();
+
+    const auto latency = GetTimestamp() - scene.nPublishTime;
+    m_nLastLatency = latency;
+    m_nTotalLatency += latency;
+    m_nMinLatency = min( m_nMinLatency, latency );
+    m_nMaxLatency = max( m_nMaxLatency, latency );
+    ++m_nPresented;
+    Publish();
+}
+
+void CRenderThread::Reset( void )
+{
+    // every scene after the last acquired one is still to be presented or
+    // dropped, it counts as published after the reset
+    m_nPublishedBefore = m_nLastSequence;
+    m_nPresented = 0;
+    m_nDropped = 0;
+    m_nLastLatency = 0;
+    m_nMinLatency = UINT64_MAX;
+    m_nMaxLatency = 0;
+    m_nTotalLatency = 0;
+    Publish();
+}
+
+void CRenderThread::Publish( void )
+{
+    Snapshot snapshot;
+    snapshot.nPublishedBefore = m_nPublishedBefore;
+    snapshot.Statistics.nPresented = m_nPresented;
+    snapshot.Statistics.nDropped = m_nDropped;
+    snapshot.Statistics.nLastLatency = m_nLastLatency;
+    snapshot.Statistics.nMaxLatency = m_nMaxLatency;
+    if( m_nPresented ) {
+        snapshot.Statistics.nMinLatency = m_nMinLatency;
+        snapshot.Statistics.nAverageLatency = m_nTotalLatency / m_nPresented;
+    }
+    m_Snapshot.Store( snapshot );
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "CommandList.hpp"
+#include "RectBatcher.hpp"
+#include "RenderBackend.hpp"
+#include "SequenceLock.hpp"
+#include "TripleBuffer.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Statistics of the scene handoff, times in nanoseconds
+     */
+    struct RenderThreadStatistics
+    {
+        uint64_t nPublished      = 0;
+        uint64_t nPresented      = 0;
+        uint64_t nDropped        = 0;
+        uint64_t nLastLatency    = 0;
+        uint64_t nMinLatency     = 0;
+        uint64_t nMaxLatency     = 0;
+        uint64_t nAverageLatency = 0;
+    };
+
+    /**
+     * @brief      CRenderThread presents scenes on a dedicated thread. A
+     *             producer records a complete scene and publishes it through
+     *             a triple buffer, the render thread always presents the
+     *             latest one. The producer never waits on a present and the
+     *             render thread never waits on a producer. Only one thread
+     *             at a time may produce scenes.
+     */
+    class CRenderThread
+    {
+    public:
+        explicit CRenderThread( IRenderBackend* pRenderBackend );
+        ~CRenderThread( void );
+
+        CRenderThread( const CRenderThread& ) = delete;
+        CRenderThread& operator = ( const CRenderThread& ) = delete;
+
+        /**
+         * @brief      Start the render thread
+         *
+         * @return     bool <> false if no backend was set or it already runs
+         */
+        bool Start( void );
+
+        /**
+         * @brief      Stop the render thread and wait for it
+         */
+        void Stop( void );
+
+        /**
+         * @brief      Is the render thread running?
+         *
+         * @return     bool
+         */
+        bool IsRunning( void ) const;
+
+        /**
+         * @brief      Start recording a new scene
+         *
+         * @return     CCommandList& <> empty list to record into
+         */
+        CCommandList& BeginScene( void );
+
+        /**
+         * @brief      Publish the recorded scene, replaces a published scene
+         *             which has not been presented yet
+         */
+        void PublishScene( void );
+
+        /**
+         * @brief      Submit the rectangles of a scene as batches
+         *
+         * @param[in]  batching  enable batching
+         */
+        void SetBatching( bool batching );
+
+        /**
+         * @brief      Is the rectangle batching enabled?
+         *
+         * @return     bool
+         */
+        bool IsBatching( void ) const;
+
+        /**
+         * @brief      Get the handoff statistics, can be called from any
+         *             thread. The render thread publishes them as one snapshot
+         *             after every present.
+         *
+         * @return     RenderThreadStatistics
+         */
+        RenderThreadStatistics GetStatistics( void ) const;
+
+        /**
+         * @brief      Reset the handoff statistics, can be called from any
+         *             thread. A running render thread resets them before it
+         *             presents the next scene.
+         */
+        void ResetStatistics( void );
+
+    private:
+        struct Scene
+        {
+            CCommandList cList;
+            uint64_t     nSequence = 0;
+            uint64_t     nPublishTime = 0;
+        };
+
+        struct Snapshot
+        {
+            RenderThreadStatistics Statistics;
+            uint64_t               nPublishedBefore = 0;
+        };
+
+        void ThreadLoop( void );
+
+        /**
+         * @brief      Present the acquired scene and account its latency
+         */
+        void Present( Scene& scene );
+
+        /**
+         * @brief      Restart the statistics, only from the render thread or
+         *             while it does not run
+         */
+        void Reset( void );
+
+        /**
+         * @brief      Publish the statistics of the render thread
+         */
+        void Publish( void );
+
+    private:
+        IRenderBackend*           m_pRenderBackend = nullptr;
+        CTripleBuffer< Scene >    m_cScenes;
+        CRectBatcher              m_RectBatcher;
+        thread                    m_Thread;
+        mutex                     m_Mutex;
+        condition_variable        m_Wake;
+        atomic< bool >            m_bRunning{ false };
+        atomic< bool >            m_bStop{ false };
+        atomic< bool >            m_bBatching{ false };
+        atomic< bool >            m_bReset{ false };
+        uint64_t                  m_nSequence = 0;
+        atomic< uint64_t >        m_nPublished{ 0 };
+        CSequenceLock< Snapshot > m_Snapshot;
+
+        // only touched by the render thread
+        uint64_t                  m_nLastSequence = 0;
+        uint64_t                  m_nPublishedBefore = 0;
+        uint64_t                  m_nPresented = 0;
+        uint64_t                  m_nDropped = 0;
+        uint64_t                  m_nLastLatency = 0;
+        uint64_t                  m_nMinLatency = UINT64_MAX;
+        uint64_t                  m_nMaxLatency = 0;
+        uint64_t                  m_nTotalLatency = 0;
+    };
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      CSequenceLock publishes a snapshot of one writer to any
+     *             amount of readers. The writer never waits, readers retry
+     *             while a store is in progress and always get a snapshot
+     *             which was stored as a whole.
+     */
+    template< typename T >
+    class CSequenceLock
+    {
+        static_assert( is_trivially_copyable< T >::value, "the snapshot is copied word by word" );
+
+    public:
+        CSequenceLock( void )
+        {
+            Store( T() );
+        }
+
+        CSequenceLock( const CSequenceLock& ) = delete;
+        CSequenceLock& operator = ( const CSequenceLock& ) = delete;
+
+        /**
+         * @brief      Publish a snapshot, only from the writing thread
+         *
+         * @param[in]  value  snapshot
+         */
+        void Store( const T& value )
+        {
+            array< uint64_t, WORDS > words = {};
+            memcpy( words.data(), &value, sizeof( T ) );
+
+            // odd while the words are written
+            const auto sequence = m_nSequence.load( memory_order_relaxed );
+            m_nSequence.store( sequence + 1, memory_order_relaxed );
+            atomic_thread_fence( memory_order_release );
+            for( size_t i = 0; i < WORDS; ++i ) {
+                m_cWords[ i ].store( words[ i ], memory_order_relaxed );
+            }
+            m_nSequence.store( sequence + 2, memory_order_release );
+        }
+
+        /**
+         * @brief      Get the latest snapshot, can be called from any thread
+         *
+         * @return     T
+         */
+        T Load( void ) const
+        {
+            array< uint64_t, WORDS > words;
+            for( ;; ) {
+                const auto sequence = m_nSequence.load( memory_order_acquire );
+                if( sequence & 1 ) {
+                    continue;
+                }
+                for( size_t i = 0; i < WORDS; ++i ) {
+                    words[ i ] = m_cWords[ i ].load( memory_order_relaxed );
+                }
+                atomic_thread_fence( memory_order_acquire );
+                if( m_nSequence.load( memory_order_relaxed ) == sequence ) {
+                    break;
+                }
+            }
+
+            T value;
+            memcpy( static_cast< void* >( &value ), words.data(), sizeof( T ) );
+            return value;
+        }
+
+    private:
+        static constexpr size_t WORDS = ( sizeof( T ) + sizeof( uint64_t ) - 1 ) / sizeof( uint64_t );
+
+        atomic< uint64_t >                 m_nSequence{ 0 };
+        array< atomic< uint64_t >, WORDS > m_cWords;
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Instruction sets are picked at compile time (/arch:AVX2 or -mavx2),
+// x64 always provides SSE2. HAZE_NO_SIMD keeps every function on its
+// scalar path, the tests build both to compare them.
+#if !defined( HAZE_NO_SIMD )
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define HAZE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined( __AVX2__ )
+#define HAZE_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
@@ -0,0 +1,1131 @@
+#include "SoftwareBackend.hpp"
+#include "Graph.hpp"
+#include "Simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      a * b / 255, rounded
+     */
+    uint32_t Multiply( uint32_t a, uint32_t b )
+    {
+        const auto t = a * b + 128;
+        return ( t + ( t >> 8 ) ) >> 8;
+    }
+
+    /**
+     * @brief      Convert an argb color into premultiplied RGBA
+     */
+    uint32_t Premultiply( uint32_t color )
+    {
+        const auto a = color >> 24;
+        const auto r = Multiply( ( color >> 16 ) & 0xFF, a );
+        const auto g = Multiply( ( color >> 8 ) & 0xFF, a );
+        const auto b = Multiply( color & 0xFF, a );
+        return r | ( g << 8 ) | ( b << 16 ) | ( a << 24 );
+    }
+
+    /**
+     * @brief      Scale every channel of a packed pixel by factor / 256
+     */
+    uint32_t Scale( uint32_t pixel, uint32_t factor )
+    {
+        const auto rb = ( ( pixel & 0x00FF00FF ) * factor >> 8 ) & 0x00FF00FF;
+        const auto ga = ( ( pixel >> 8 ) & 0x00FF00FF ) * factor & 0xFF00FF00;
+        return rb | ga;
+    }
+
+    /**
+     * @brief      Source-over of two premultiplied pixels
+     */
+    uint32_t BlendOver( uint32_t src, uint32_t dst )
+    {
+        return src + Scale( dst, 256 - ( src >> 24 ) );
+    }
+
+    uint32_t ToCoverage( float coverage )
+    {
+        return static_cast< uint32_t >( coverage * 255.f + 0.5f );
+    }
+
+    /**
+     * @brief      Blend a premultiplied color with a constant coverage over a span
+     */
+    void BlendSpan( uint32_t* pDst, size_t count, uint32_t color, uint32_t coverage )
+    {
+        if( !coverage ) {
+            return;
+        }
+
+        const auto src = coverage >= 255 ? color : Scale( color, coverage + ( coverage >> 7 ) );
+        if( ( src >> 24 ) == 0xFF ) {
+            fill( pDst, pDst + count, src );
+            return;
+        }
+
+        const auto inverse = 256 - ( src >> 24 );
+        size_t i = 0;
+#if defined( HAZE_SSE2 )
+        const auto zero = _mm_setzero_si128();
+        const auto factor = _mm_set1_epi16( static_cast< short >( inverse ) );
+        const auto source = _mm_set1_epi32( static_cast< int >( src ) );
+        for( ; i + 4 <= count; i += 4 ) {
+            auto v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pDst + i ) );
+            auto lo = _mm_srli_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( v, zero ), factor ), 8 );
+            auto hi = _mm_srli_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( v, zero ), factor ), 8 );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( pDst + i ), _mm_add_epi8( _mm_packus_epi16( lo, hi ), source ) );
+        }
+#endif
+        for( ; i < count; ++i ) {
+            pDst[ i ] = src + Scale( pDst[ i ], inverse );
+        }
+    }
+
+    /**
+     * @brief      Blend a premultiplied color with a coverage per pixel over a span
+     */
+    void BlendSpan( uint32_t* pDst, size_t count, uint32_t color, const uint8_t* pCoverage )
+    {
+        const auto opaque = ( color >> 24 ) == 0xFF;
+        size_t i = 0;
+#if defined( HAZE_SSE2 )
+        // same arithmetic as Scale and BlendOver, four pixels at once in 16 bit lanes
+        const auto zero = _mm_setzero_si128();
+        const auto source = _mm_unpacklo_epi8( _mm_set1_epi32( static_cast< int >( color ) ), zero );
+        const auto limit = _mm_set1_epi16( 256 );
+        for( ; i + 4 <= count; i += 4 ) {
+            uint32_t coverages;
+            memcpy( &coverages, pCoverage + i, sizeof( coverages ) );
+            if( !coverages ) {
+                continue;
+            }
+
+            auto factors = _mm_unpacklo_epi8( _mm_cvtsi32_si128( static_cast< int >( coverages ) ), zero );
+            factors = _mm_add_epi16( factors, _mm_srli_epi16( factors, 7 ) );
+            factors = _mm_unpacklo_epi16( factors, factors );
+            const auto factorsLo = _mm_unpacklo_epi32( factors, factors );
+            const auto factorsHi = _mm_unpackhi_epi32( factors, factors );
+
+            const auto srcLo = _mm_srli_epi16( _mm_mullo_epi16( source, factorsLo ), 8 );
+            const auto srcHi = _mm_srli_epi16( _mm_mullo_epi16( source, factorsHi ), 8 );
+            const auto inverseLo = _mm_sub_epi16( limit, _mm_shufflehi_epi16( _mm_shufflelo_epi16( srcLo, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) ) );
+            const auto inverseHi = _mm_sub_epi16( limit, _mm_shufflehi_epi16( _mm_shufflelo_epi16( srcHi, _MM_SHUFFLE( 3, 3, 3, 3 ) ), _MM_SHUFFLE( 3, 3, 3, 3 ) ) );
+
+            const auto v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( pDst + i ) );
+            const auto dstLo = _mm_srli_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( v, zero ), inverseLo ), 8 );
+            const auto dstHi = _mm_srli_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( v, zero ), inverseHi ), 8 );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( pDst + i ), _mm_packus_epi16( _mm_add_epi16( srcLo, dstLo ), _mm_add_epi16( srcHi, dstHi ) ) );
+        }
+#endif
+        for( ; i < count; ++i ) {
+            const uint32_t coverage = pCoverage[ i ];
+            if( !coverage ) {
+                continue;
+            }
+            if( coverage == 255 && opaque ) {
+                pDst[ i ] = color;
+                continue;
+            }
+            pDst[ i ] = BlendOver( coverage == 255 ? color : Scale( color, coverage + ( coverage >> 7 ) ), pDst[ i ] );
+        }
+    }
+
+    /**
+     * @brief      Blend a premultiplied color inside a shape and another one
+     *             inside a second shape it encloses over a span. Both get the
+     *             coverage they have in the pixel, the pixel is blended once.
+     */
+    void BlendSpan( uint32_t* pDst, size_t count, uint32_t color, const uint8_t* pCoverage, uint32_t inner, const uint8_t* pInner )
+    {
+        size_t i = 0;
+        while( i < count ) {
+            // runs covered by the inner shape alone take the plain span blend
+            auto run = i;
+            while( run < count && pCoverage[ run ] <= pInner[ run ] ) {
+                ++run;
+            }
+            if( run > i ) {
+                BlendSpan( pDst + i, run - i, inner, pInner + i );
+                i = run;
+                continue;
+            }
+
+            // and runs outside of it the plain span blend of the outer color
+            while( run < count && !pInner[ run ] ) {
+                ++run;
+            }
+            if( run > i ) {
+                BlendSpan( pDst + i, run - i, color, pCoverage + i );
+                i = run;
+                continue;
+            }
+
+            // the areas of both shapes and the uncovered rest weight each
+            // result of source-over, summed before the shift a fully covered
+            // pixel stays opaque and rounds like blending one over the other
+            const uint32_t b = pInner[ i ];
+            const uint32_t a = pCoverage[ i ] - b;
+            const auto wa = a + ( a >> 7 ), wb = b + ( b >> 7 ), wd = 256 - wa - wb;
+            const auto dst = pDst[ i ], over = BlendOver( color, dst ), innerOver = BlendOver( inner, dst );
+            const auto rb = ( ( over & 0x00FF00FF ) * wa + ( innerOver & 0x00FF00FF ) * wb + ( dst & 0x00FF00FF ) * wd ) >> 8;
+            const auto ga = ( ( over >> 8 ) & 0x00FF00FF ) * wa + ( ( innerOver >> 8 ) & 0x00FF00FF ) * wb + ( ( dst >> 8 ) & 0x00FF00FF ) * wd;
+            pDst[ i ] = ( rb & 0x00FF00FF ) | ( ga & 0xFF00FF00 );
+            ++i;
+        }
+    }
+
+    /**
+     * @brief      Lay out a string as boxes of a monospaced font, fn gets the
+     *             rectangle of every visible glyph
+     */
+    template< typename TFunction >
+    void ForEachGlyph( float x, float y, float w, float h, const wchar_t* text, size_t length, float size, TFunction&& fn )
+    {
+        const auto advance = 0.6f * size;
+        const auto lineHeight = 1.2f * size;
+
+        auto penX = x, penY = y;
+        for( size_t i = 0; i < length; ++i ) {
+            const auto c = text[ i ];
+            if( c == L'\n' || ( penX > x && penX + advance > x + w ) ) {
+                penX = x;
+                penY += lineHeight;
+                if( c == L'\n' ) {
+                    continue;
+                }
+            }
+            if( penY + lineHeight > y + h ) {
+                break;
+            }
+            if( c != L' ' && c != L'\t' && c != L'\r' ) {
+                fn( penX + 0.1f * size, penY + 0.45f * size, 0.4f * size, 0.5f * size );
+            }
+            penX += advance;
+        }
+    }
+
+    /**
+     * @brief      Lay out a string with the advances of a font, wraps like
+     *             ForEachGlyph. fn gets the glyph and the pen position on the
+     *             baseline of every visible glyph.
+     */
+    template< typename TFunction >
+    void ForEachFaceGlyph( float x, float y, float w, float h, const wchar_t* text, size_t length, const CTrueTypeFont& face, float size, TFunction&& fn )
+    {
+        const auto scale = size / static_cast< float >( face.GetUnitsPerEm() );
+        const auto ascender = static_cast< float >( face.GetAscender() ) * scale;
+        const auto lineHeight = static_cast< float >( face.GetAscender() - face.GetDescender() + face.GetLineGap() ) * scale;
+
+        auto penX = x, penY = y;
+        for( size_t i = 0; i < length; ++i ) {
+            // wchar_t is utf-16 on windows, combine the surrogate pairs
+            auto c = static_cast< uint32_t >( text[ i ] );
+            if( c >= 0xD800 && c < 0xDC00 && i + 1 < length ) {
+                const auto next = static_cast< uint32_t >( text[ i + 1 ] );
+                if( next >= 0xDC00 && next < 0xE000 ) {
+                    c = 0x10000 + ( ( c - 0xD800 ) << 10 ) + ( next - 0xDC00 );
+                    ++i;
+                }
+            }
+
+            const auto glyph = c == L'\n' ? 0 : face.GetGlyph( c );
+            const auto advance = static_cast< float >( face.GetAdvance( glyph ) ) * scale;
+            if( c == L'\n' || ( penX > x && penX + advance > x + w ) ) {
+                penX = x;
+                penY += lineHeight;
+                if( c == L'\n' ) {
+                    continue;
+                }
+            }
+            if( penY + lineHeight > y + h ) {
+                break;
+            }
+            if( c != L' ' && c != L'\t' && c != L'\r' ) {
+                fn( glyph, penX, penY + ascender );
+            }
+            penX += advance;
+        }
+    }
+
+    void WriteBigEndian( vector< uint8_t >& buffer, uint32_t value )
+    {
+        buffer.push_back( static_cast< uint8_t >( value >> 24 ) );
+        buffer.push_back( static_cast< uint8_t >( value >> 16 ) );
+        buffer.push_back( static_cast< uint8_t >( value >> 8 ) );
+        buffer.push_back( static_cast< uint8_t >( value ) );
+    }
+
+    uint32_t Crc32( const uint8_t* data, size_t length, uint32_t crc = 0 )
+    {
+        static const auto table = [] {
+            vector< uint32_t > result( 256 );
+            for( uint32_t i = 0; i < 256; ++i ) {
+                auto c = i;
+                for( auto k = 0; k < 8; ++k ) {
+                    c = ( c & 1 ) ? 0xEDB88320 ^ ( c >> 1 ) : c >> 1;
+                }
+                result[ i ] = c;
+            }
+            return result;
+        }();
+
+        crc = ~crc;
+        for( size_t i = 0; i < length; ++i ) {
+            crc = table[ ( crc ^ data[ i ] ) & 0xFF ] ^ ( crc >> 8 );
+        }
+        return ~crc;
+    }
+
+    uint32_t Adler32( const uint8_t* data, size_t length )
+    {
+        uint32_t a = 1, b = 0;
+        for( size_t i = 0; i < length; ++i ) {
+            a = ( a + data[ i ] ) % 65521;
+            b = ( b + a ) % 65521;
+        }
+        return ( b << 16 ) | a;
+    }
+
+    void WriteChunk( ofstream& file, const char* type, const vector< uint8_t >& data )
+    {
+        vector< uint8_t > chunk;
+        chunk.reserve( data.size() + 12 );
+        WriteBigEndian( chunk, static_cast< uint32_t >( data.size() ) );
+        chunk.insert( chunk.end(), type, type + 4 );
+        chunk.insert( chunk.end(), data.begin(), data.end() );
+        WriteBigEndian( chunk, Crc32( chunk.data() + 4, chunk.size() - 4 ) );
+        file.write( reinterpret_cast< const char* >( chunk.data() ), chunk.size() );
+    }
+}
+
+CSoftwareBackend::CSoftwareBackend( int32_t w, int32_t h )
+{
+    Resize( w, h );
+}
+
+bool CSoftwareBackend::FillRect( float x, float y, float w, float h, uint32_t color )
+{
+    const auto x0 = min( x, x + w ), x1 = max( x, x + w );
+    const auto y0 = min( y, y + h ), y1 = max( y, y + h );
+
+    if( IsAxisAligned() ) {
+        const auto a = Apply( x0, y0 ), b = Apply( x1, y1 );
+        FillPixelRect( min( a.x, b.x ), min( a.y, b.y ), max( a.x, b.x ), max( a.y, b.y ), Premultiply( color ) );
+        return true;
+    }
+
+    const PointF points[] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+    FillPolygon( points, 4, color );
+    return true;
+}
+
+bool CSoftwareBackend::FillColoredRects( const ColoredRect* pRects, size_t count )
+{
+    if( !pRects ) {
+        return false;
+    }
+    if( !IsAxisAligned() ) {
+        return IRenderBackend::FillColoredRects( pRects, count );
+    }
+
+    // the transform is checked once, every rectangle goes straight to the pixels
+    for( size_t i = 0; i < count; ++i ) {
+        const auto& rect = pRects[ i ];
+        const auto a = Apply( rect.x, rect.y ), b = Apply( rect.x + rect.w, rect.y + rect.h );
+        FillPixelRect( min( a.x, b.x ), min( a.y, b.y ), max( a.x, b.x ), max( a.y, b.y ), Premultiply( rect.color.hex() ) );
+    }
+    return true;
+}
+
+bool CSoftwareBackend::FillBorderBoxes( const ColoredBorderBox* pBoxes, size_t count )
+{
+    if( !pBoxes ) {
+        return false;
+    }
+    if( !IsAxisAligned() ) {
+        return IRenderBackend::FillBorderBoxes( pBoxes, count );
+    }
+
+    RectF rects[ 4 ];
+    for( size_t i = 0; i < count; ++i ) {
+        const auto color = Premultiply( pBoxes[ i ].color.hex() );
+        const auto parts = SplitBorderBox( pBoxes[ i ], rects );
+        for( size_t j = 0; j < parts; ++j ) {
+            const auto a = Apply( rects[ j ].x, rects[ j ].y ), b = Apply( rects[ j ].x + rects[ j ].w, rects[ j ].y + rects[ j ].h );
+            FillPixelRect( min( a.x, b.x ), min( a.y, b.y ), max( a.x, b.x ), max( a.y, b.y ), color );
+        }
+    }
+    return true;
+}
+
+bool CSoftwareBackend::FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color )
+{
+    const auto x0 = min( x, x + w ), x1 = max( x, x + w );
+    const auto y0 = min( y, y + h ), y1 = max( y, y + h );
+
+    // like Direct2D, the radii are limited to half of the rectangle
+    const auto rx = min( max( x_rad, 0.f ), 0.5f * ( x1 - x0 ) );
+    const auto ry = min( max( y_rad, 0.f ), 0.5f * ( y1 - y0 ) );
+    if( rx <= 0.f || ry <= 0.f ) {
+        return FillRect( x, y, w, h, color );
+    }
+
+    // the flattened outline only depends on the size, moved panels reuse it
+    const auto scale = sqrt( fabs( m_Transform.m11 * m_Transform.m22 - m_Transform.m12 * m_Transform.m21 ) );
+    const auto segments = CTessellationCache::GetArcSegments( max( rx, ry ) * scale );
+    FillTessellation( *m_Tessellations.GetRoundedRect( x1 - x0, y1 - y0, rx, ry, segments ), x0, y0, color );
+    return true;
+}
+
+bool CSoftwareBackend::FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color )
+{
+    const auto x0 = min( x, x + w ), x1 = max( x, x + w );
+    const auto y0 = min( y, y + h ), y1 = max( y, y + h );
+    if( !( thickness > 0.f ) ) {
+        return FillRoundedRect( x0, y0, x1 - x0, y1 - y0, inner_x_rad, inner_y_rad, inner_color );
+    }
+    if( 2.f * thickness >= x1 - x0 || 2.f * thickness >= y1 - y0 ) {
+        return FillRoundedRect( x0, y0, x1 - x0, y1 - y0, x_rad, y_rad, color );
+    }
+
+    // limited like FillRoundedRect limits them, for the outer shape and for the inset
+    const auto t = thickness;
+    const auto rx = min( max( x_rad, 0.f ), 0.5f * ( x1 - x0 ) );
+    const auto ry = min( max( y_rad, 0.f ), 0.5f * ( y1 - y0 ) );
+    const auto irx = min( max( inner_x_rad, 0.f ), 0.5f * ( x1 - x0 ) - t );
+    const auto iry = min( max( inner_y_rad, 0.f ), 0.5f * ( y1 - y0 ) - t );
+
+    // the inner contour gets as many segments as a fill of the inset would
+    const auto scale = sqrt( fabs( m_Transform.m11 * m_Transform.m22 - m_Transform.m12 * m_Transform.m21 ) );
+    const auto segments = rx > 0.f && ry > 0.f ? CTessellationCache::GetArcSegments( max( rx, ry ) * scale ) : 1;
+    const auto inner = irx > 0.f && iry > 0.f ? CTessellationCache::GetArcSegments( max( irx, iry ) * scale ) : 1;
+    const auto& tessellation = *m_Tessellations.GetRoundedFrame( x1 - x0, y1 - y0, rx, ry, t, irx, iry, segments, inner );
+    if( !( inner_color >> 24 ) ) {
+        FillTessellation( tessellation, x0, y0, color );
+        return true;
+    }
+
+    const auto count = tessellation.cPoints.size();
+    m_cPoints.resize( count );
+    auto minX = HUGE_VALF, minY = HUGE_VALF, maxX = -HUGE_VALF, maxY = -HUGE_VALF;
+    for( size_t i = 0; i < count; ++i ) {
+        const auto point = Apply( x0 + tessellation.cPoints[ i ].x, y0 + tessellation.cPoints[ i ].y );
+        m_cPoints[ i ] = point;
+        minX = min( minX, point.x );
+        minY = min( minY, point.y );
+        maxX = max( maxX, point.x );
+        maxY = max( maxY, point.y );
+    }
+    if( !BeginShape( minX, minY, maxX, maxY ) ) {
+        return true;
+    }
+
+    // the inset is rasterized first and kept, then the whole shape over the same region
+    const auto inset = m_cPoints.data() + tessellation.nOuter;
+    m_Rasterizer.AddPolygon( inset, count - tessellation.nOuter );
+    m_Rasterizer.Resolve( m_eAntialiasMode == AntialiasMode::Aliased );
+    const auto width = static_cast< size_t >( m_Rasterizer.GetWidth() ), height = static_cast< size_t >( m_Rasterizer.GetHeight() );
+    m_cCoverage.assign( width * height, 0 );
+    for( size_t row = 0; row < height; ++row ) {
+        int32_t begin, end;
+        const auto* pCoverage = m_Rasterizer.GetRow( static_cast< int32_t >( row ), begin, end );
+        if( begin < end ) {
+            memcpy( m_cCoverage.data() + row * width + begin, pCoverage + begin, static_cast< size_t >( end - begin ) );
+        }
+    }
+
+    m_Rasterizer.Reset( m_Rasterizer.GetX(), m_Rasterizer.GetY(), m_Rasterizer.GetWidth(), m_Rasterizer.GetHeight() );
+    m_Rasterizer.AddPolygon( m_cPoints.data(), tessellation.nOuter );
+    m_Rasterizer.Resolve( m_eAntialiasMode == AntialiasMode::Aliased );
+
+    // the ring is what the inset leaves of the shape, so their coverages add up to the one of the shape
+    const auto left = m_Rasterizer.GetX(), top = m_Rasterizer.GetY();
+    const auto bottom = top + m_Rasterizer.GetHeight();
+    const auto premultiplied = Premultiply( color ), innerPremultiplied = Premultiply( inner_color );
+    for( auto y = max( top, m_cClip[ 1 ] ); y < min( bottom, m_cClip[ 3 ] ); ++y ) {
+        int32_t begin, end;
+        const auto* pCoverage = m_Rasterizer.GetRow( y - top, begin, end );
+        const auto* pInner = m_cCoverage.data() + static_cast< size_t >( y - top ) * width;
+        begin = max( begin, m_cClip[ 0 ] - left );
+        end = min( end, m_cClip[ 2 ] - left );
+        if( begin < end ) {
+            auto* pDst = m_cPixels.data() + static_cast< size_t >( y ) * m_nWidth + left + begin;
+            if( m_bOverdrawCounter ) {
+                CountOverdraw( pDst, end - begin, pCoverage + begin, pInner + begin );
+            }
+            BlendSpan( pDst, end - begin, premultiplied, pCoverage + begin, innerPremultiplied, pInner + begin );
+        }
+    }
+    return true;
+}
+
+bool CSoftwareBackend::Line( float x, float y, float xx, float yy, float thickness, uint32_t color )
+{
+    const auto dx = xx - x, dy = yy - y;
+    const auto length = sqrt( dx * dx + dy * dy );
+    if( length <= 0.f || thickness <= 0.f ) {
+        return true;
+    }
+
+    // flat caps, the line is a rectangle along its direction
+    const auto half = 0.5f * thickness;
+    if( dx == 0.f || dy == 0.f ) {
+        return FillRect( min( x, xx ) - ( dx == 0.f ? half : 0.f ), min( y, yy ) - ( dy == 0.f ? half : 0.f ),
+                         dx == 0.f ? thickness : fabs( dx ), dy == 0.f ? thickness : fabs( dy ), color );
+    }
+
+    const auto nx = -dy / length * half, ny = dx / length * half;
+    const PointF points[] = { { x + nx, y + ny }, { xx + nx, yy + ny }, { xx - nx, yy - ny }, { x - nx, y - ny } };
+    FillPolygon( points, 4, color );
+    return true;
+}
+
+bool CSoftwareBackend::Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color )
+{
+    if( !pPoints || count < 2 ) {
+        return false;
+    }
+
+    StrokePolyline( pPoints, count, thickness, m_cStroke );
+    if( m_cStroke.empty() ) {
+        return true;
+    }
+
+    m_cPoints.resize( m_cStroke.size() );
+    auto minX = HUGE_VALF, minY = HUGE_VALF, maxX = -HUGE_VALF, maxY = -HUGE_VALF;
+    for( size_t i = 0; i < m_cStroke.size(); ++i ) {
+        const auto point = Apply( m_cStroke[ i ].x, m_cStroke[ i ].y );
+        m_cPoints[ i ] = point;
+        minX = min( minX, point.x );
+        minY = min( minY, point.y );
+        maxX = max( maxX, point.x );
+        maxY = max( maxY, point.y );
+    }
+
+    if( !BeginShape( minX, minY, maxX, maxY ) ) {
+        return true;
+    }
+    for( size_t i = 0; i < m_cPoints.size(); i += 4 ) {
+        m_Rasterizer.AddPolygon( m_cPoints.data() + i, 4 );
+    }
+    BlendShape( color );
+    return true;
+}
+
+bool CSoftwareBackend::Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color )
+{
+    const auto* pSoftwareFont = static_cast< const Font* >( pFont );
+    if( !text || !pSoftwareFont ) {
+        return false;
+    }
+
+    if( !pSoftwareFont->pFace ) {
+        // every glyph is approximated by a box of a monospaced font
+        ForEachGlyph( x, y, w, h, text, length, pSoftwareFont->fSize, [ & ]( float gx, float gy, float gw, float gh ) {
+            FillRect( gx, gy, gw, gh, color );
+        } );
+        return true;
+    }
+
+    const auto& face = *pSoftwareFont->pFace;
+    const auto size = pSoftwareFont->fSize;
+    if( !IsTranslation() ) {
+        // scaled, rotated or skewed text is filled from the outlines
+        ForEachFaceGlyph( x, y, w, h, text, length, face, size, [ & ]( uint32_t glyph, float penX, float penY ) {
+            FillGlyph( face, size, glyph, penX, penY, color );
+        } );
+        return true;
+    }
+
+    // the pen snaps to whole pixels, so every glyph comes straight from the atlas
+    const auto premultiplied = Premultiply( color );
+    ForEachFaceGlyph( x, y, w, h, text, length, face, size, [ & ]( uint32_t glyph, float penX, float penY ) {
+        const auto* pQuad = m_GlyphAtlas.Get( face, size, glyph );
+        if( pQuad ) {
+            BlendGlyph( *pQuad, static_cast< int32_t >( floor( penX + m_Transform.dx + 0.5f ) ), static_cast< int32_t >( floor( penY + m_Transform.dy + 0.5f ) ), premultiplied );
+        }
+    } );
+    return true;
+}
+
+bool CSoftwareBackend::MeasureText( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, RectF& bounds )
+{
+    const auto* pSoftwareFont = static_cast< const Font* >( pFont );
+    if( !text || !pSoftwareFont ) {
+        return false;
+    }
+
+    auto x0 = HUGE_VALF, y0 = HUGE_VALF, x1 = -HUGE_VALF, y1 = -HUGE_VALF;
+    if( !pSoftwareFont->pFace ) {
+        ForEachGlyph( x, y, w, h, text, length, pSoftwareFont->fSize, [ & ]( float gx, float gy, float gw, float gh ) {
+            x0 = min( x0, gx );
+            y0 = min( y0, gy );
+            x1 = max( x1, gx + gw );
+            y1 = max( y1, gy + gh );
+        } );
+    }
+    else {
+        // the outline boxes, widened by the half pixel the pen snaps by
+        const auto& face = *pSoftwareFont->pFace;
+        const auto scale = pSoftwareFont->fSize / static_cast< float >( face.GetUnitsPerEm() );
+        ForEachFaceGlyph( x, y, w, h, text, length, face, pSoftwareFont->fSize, [ & ]( uint32_t glyph, float penX, float penY ) {
+            array< int32_t, 4 > box;
+            if( face.GetBounds( glyph, box ) ) {
+                x0 = min( x0, penX + floor( static_cast< float >( box[ 0 ] ) * scale ) - 0.5f );
+                y0 = min( y0, penY + floor( static_cast< float >( -box[ 3 ] ) * scale ) - 0.5f );
+                x1 = max( x1, penX + ceil( static_cast< float >( box[ 2 ] ) * scale ) + 0.5f );
+                y1 = max( y1, penY + ceil( static_cast< float >( -box[ 1 ] ) * scale ) + 0.5f );
+            }
+        } );
+    }
+
+    bounds = x0 < x1 ? RectF{ x0, y0, x1 - x0, y1 - y0 } : RectF{ x, y, 0.f, 0.f };
+    return true;
+}
+
+bool CSoftwareBackend::SetTransform( const Transform& transform )
+{
+    m_Transform = transform;
+    return true;
+}
+
+bool CSoftwareBackend::SetAntialiasMode( AntialiasMode mode )
+{
+    m_eAntialiasMode = mode;
+    return true;
+}
+
+bool CSoftwareBackend::Resize( int32_t w, int32_t h )
+{
+    if( w < 0 || h < 0 ) {
+        return false;
+    }
+
+    m_nWidth = w;
+    m_nHeight = h;
+    m_cPixels.assign( static_cast< size_t >( w ) * h, 0 );
+    if( m_bOverdrawCounter ) {
+        m_cOverdraw.assign( m_cPixels.size(), 0 );
+    }
+    m_nPixelWrites = 0;
+    ResetState();
+    return true;
+}
+
+bool CSoftwareBackend::BeginFrame( void )
+{
+    ResetState();
+    ResetOverdraw();
+    Clear( m_nClearColor );
+    return true;
+}
+
+bool CSoftwareBackend::BeginPartialFrame( void )
+{
+    ResetState();
+    ResetOverdraw();
+    return true;
+}
+
+bool CSoftwareBackend::PushClip( const RectF& rect )
+{
+    m_cClipStack.push_back( m_cClip );
+
+    // pixels count as inside if their center is, like an aliased clip
+    m_cClip[ 0 ] = max( m_cClip[ 0 ], static_cast< int32_t >( floor( min( rect.x, rect.x + rect.w ) + 0.5f ) ) );
+    m_cClip[ 1 ] = max( m_cClip[ 1 ], static_cast< int32_t >( floor( min( rect.y, rect.y + rect.h ) + 0.5f ) ) );
+    m_cClip[ 2 ] = min( m_cClip[ 2 ], static_cast< int32_t >( floor( max( rect.x, rect.x + rect.w ) + 0.5f ) ) );
+    m_cClip[ 3 ] = min( m_cClip[ 3 ], static_cast< int32_t >( floor( max( rect.y, rect.y + rect.h ) + 0.5f ) ) );
+    return true;
+}
+
+bool CSoftwareBackend::PopClip( void )
+{
+    if( m_cClipStack.empty() ) {
+        return false;
+    }
+
+    m_cClip = m_cClipStack.back();
+    m_cClipStack.pop_back();
+    return true;
+}
+
+bool CSoftwareBackend::Clear( void )
+{
+    const auto color = Premultiply( m_nClearColor );
+    for( auto y = m_cClip[ 1 ]; y < m_cClip[ 3 ]; ++y ) {
+        auto* pRow = m_cPixels.data() + static_cast< size_t >( y ) * m_nWidth;
+        if( m_cClip[ 0 ] < m_cClip[ 2 ] ) {
+            fill( pRow + m_cClip[ 0 ], pRow + m_cClip[ 2 ], color );
+        }
+    }
+    return true;
+}
+
+bool CSoftwareBackend::EndFrame( void )
+{
+    return true;
+}
+
+array< int32_t, 2 > CSoftwareBackend::GetSize( void ) const
+{
+    return { { m_nWidth, m_nHeight } };
+}
+
+void CSoftwareBackend::SetClearColor( uint32_t color )
+{
+    m_nClearColor = color;
+}
+
+void CSoftwareBackend::Clear( uint32_t color )
+{
+    fill( m_cPixels.begin(), m_cPixels.end(), Premultiply( color ) );
+}
+
+const void* CSoftwareBackend::RegisterFont( const string& name, const string& family, float size )
+{
+    auto& pFont = m_cFonts[ name ];
+    if( !pFont ) {
+        pFont.reset( new Font() );
+    }
+    const auto face = m_cFaces.find( family );
+    pFont->strFamily = family;
+    pFont->fSize = size;
+    pFont->pFace = face != m_cFaces.end() ? face->second.get() : nullptr;
+    m_FontTable.Insert( name, pFont.get() );
+    return pFont.get();
+}
+
+bool CSoftwareBackend::LoadFontFile( const string& family, const string& path )
+{
+    unique_ptr< CTrueTypeFont > pFace( new CTrueTypeFont() );
+    if( !pFace->Load( path ) ) {
+        return false;
+    }
+
+    // the fonts of the family switch over, the glyphs of the old file go
+    auto& pCurrent = m_cFaces[ family ];
+    if( pCurrent ) {
+        m_GlyphAtlas.Remove( *pCurrent );
+    }
+    pCurrent = move( pFace );
+    for( auto& font : m_cFonts ) {
+        if( font.second->strFamily == family ) {
+            font.second->pFace = pCurrent.get();
+        }
+    }
+    return true;
+}
+
+const CGlyphAtlas& CSoftwareBackend::GetGlyphAtlas( void ) const
+{
+    return m_GlyphAtlas;
+}
+
+CTessellationCache& CSoftwareBackend::GetTessellationCache( void )
+{
+    return m_Tessellations;
+}
+
+const void* CSoftwareBackend::GetFont( const string& name ) const
+{
+    return m_FontTable.Get( name );
+}
+
+FontHandle CSoftwareBackend::GetFontHandle( const string& name ) const
+{
+    return m_FontTable.Find( name );
+}
+
+const void* CSoftwareBackend::GetFont( FontHandle handle ) const
+{
+    return m_FontTable.Get( handle );
+}
+
+void CSoftwareBackend::SetOverdrawCounter( bool enable )
+{
+    m_bOverdrawCounter = enable;
+    m_nPixelWrites = 0;
+    if( enable ) {
+        m_cOverdraw.assign( m_cPixels.size(), 0 );
+    }
+    else {
+        m_cOverdraw = vector< uint32_t >();
+    }
+}
+
+OverdrawStatistics CSoftwareBackend::GetOverdrawStatistics( void ) const
+{
+    OverdrawStatistics statistics;
+    statistics.nPixelWrites = m_nPixelWrites;
+    for( const auto count : m_cOverdraw ) {
+        statistics.nPixelsWritten += count ? 1 : 0;
+        statistics.nMaxOverdraw = max( statistics.nMaxOverdraw, count );
+    }
+    return statistics;
+}
+
+uint32_t CSoftwareBackend::GetOverdraw( int32_t x, int32_t y ) const
+{
+    if( m_cOverdraw.empty() || x < 0 || y < 0 || x >= m_nWidth || y >= m_nHeight ) {
+        return 0;
+    }
+    return m_cOverdraw[ static_cast< size_t >( y ) * m_nWidth + x ];
+}
+
+const uint32_t* CSoftwareBackend::GetPixels( void ) const
+{
+    return m_cPixels.data();
+}
+
+uint32_t CSoftwareBackend::GetPixel( int32_t x, int32_t y ) const
+{
+    if( x < 0 || y < 0 || x >= m_nWidth || y >= m_nHeight ) {
+        return 0;
+    }
+    return m_cPixels[ static_cast< size_t >( y ) * m_nWidth + x ];
+}
+
+int32_t CSoftwareBackend::GetWidth( void ) const
+{
+    return m_nWidth;
+}
+
+int32_t CSoftwareBackend::GetHeight( void ) const
+{
+    return m_nHeight;
+}
+
+bool CSoftwareBackend::SavePPM( const string& path ) const
+{
+    ofstream file( path, ios::binary );
+    if( !file ) {
+        return false;
+    }
+
+    file << "P6\n" << m_nWidth << " " << m_nHeight << "\n255\n";
+
+    // premultiplied color is the color composited over black
+    vector< uint8_t > row( static_cast< size_t >( m_nWidth ) * 3 );
+    for( int32_t y = 0; y < m_nHeight; ++y ) {
+        const auto* pRow = m_cPixels.data() + static_cast< size_t >( y ) * m_nWidth;
+        for( int32_t x = 0; x < m_nWidth; ++x ) {
+            row[ x * 3 + 0 ] = static_cast< uint8_t >( pRow[ x ] );
+            row[ x * 3 + 1 ] = static_cast< uint8_t >( pRow[ x ] >> 8 );
+            row[ x * 3 + 2 ] = static_cast< uint8_t >( pRow[ x ] >> 16 );
+        }
+        file.write( reinterpret_cast< const char* >( row.data() ), row.size() );
+    }
+    return static_cast< bool >( file );
+}
+
+bool CSoftwareBackend::SavePNG( const string& path ) const
+{
+    ofstream file( path, ios::binary );
+    if( !file ) {
+        return false;
+    }
+
+    // every row starts with filter type 0 (none)
+    const auto rowSize = static_cast< size_t >( m_nWidth ) * 4 + 1;
+    vector< uint8_t > raw( rowSize * m_nHeight );
+    for( int32_t y = 0; y < m_nHeight; ++y ) {
+        auto* pRow = raw.data() + y * rowSize;
+        *pRow++ = 0;
+        for( int32_t x = 0; x < m_nWidth; ++x ) {
+            const auto pixel = m_cPixels[ static_cast< size_t >( y ) * m_nWidth + x ];
+            const auto a = pixel >> 24;
+            for( auto c = 0; c < 3; ++c ) {
+                const auto value = ( pixel >> ( c * 8 ) ) & 0xFF;
+                *pRow++ = static_cast< uint8_t >( a ? min< uint32_t >( ( value * 255 + a / 2 ) / a, 255 ) : 0 );
+            }
+            *pRow++ = static_cast< uint8_t >( a );
+        }
+    }
+
+    // zlib stream of stored deflate blocks, the dump is about speed and not size
+    vector< uint8_t > data = { 0x78, 0x01 };
+    data.reserve( raw.size() + raw.size() / 65535 * 5 + 16 );
+    size_t offset = 0;
+    do {
+        const auto length = min< size_t >( raw.size() - offset, 65535 );
+        data.push_back( offset + length == raw.size() ? 1 : 0 );
+        data.push_back( static_cast< uint8_t >( length ) );
+        data.push_back( static_cast< uint8_t >( length >> 8 ) );
+        data.push_back( static_cast< uint8_t >( ~length ) );
+        data.push_back( static_cast< uint8_t >( ~length >> 8 ) );
+        data.insert( data.end(), raw.begin() + offset, raw.begin() + offset + length );
+        offset += length;
+    } while( offset < raw.size() );
+    WriteBigEndian( data, Adler32( raw.data(), raw.size() ) );
+
+    vector< uint8_t > header;
+    WriteBigEndian( header, static_cast< uint32_t >( m_nWidth ) );
+    WriteBigEndian( header, static_cast< uint32_t >( m_nHeight ) );
+    header.insert( header.end(), { 8, 6, 0, 0, 0 } );
+
+    const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write( reinterpret_cast< const char* >( signature ), sizeof( signature ) );
+    WriteChunk( file, "IHDR", header );
+    WriteChunk( file, "IDAT", data );
+    WriteChunk( file, "IEND", {} );
+    return static_cast< bool >( file );
+}
+
+void CSoftwareBackend::FillPixelRect( float x0, float y0, float x1, float y1, uint32_t color )
+{
+    if( m_eAntialiasMode == AntialiasMode::Aliased ) {
+        x0 = floor( x0 + 0.5f );
+        y0 = floor( y0 + 0.5f );
+        x1 = floor( x1 + 0.5f );
+        y1 = floor( y1 + 0.5f );
+    }
+
+    // the clip is in whole pixels, so clamping keeps the coverage exact
+    x0 = max( x0, static_cast< float >( m_cClip[ 0 ] ) );
+    y0 = max( y0, static_cast< float >( m_cClip[ 1 ] ) );
+    x1 = min( x1, static_cast< float >( m_cClip[ 2 ] ) );
+    y1 = min( y1, static_cast< float >( m_cClip[ 3 ] ) );
+    if( x0 >= x1 || y0 >= y1 ) {
+        return;
+    }
+
+    // a partially covered column on each side and fully covered columns in between
+    const auto left = static_cast< int32_t >( floor( x0 ) );
+    const auto right = static_cast< int32_t >( ceil( x1 ) );
+    const auto leftCoverage = right - left == 1 ? x1 - x0 : static_cast< float >( left + 1 ) - x0;
+    const auto rightCoverage = x1 - static_cast< float >( right - 1 );
+
+    const auto top = static_cast< int32_t >( floor( y0 ) );
+    const auto bottom = static_cast< int32_t >( ceil( y1 ) );
+    for( auto y = top; y < bottom; ++y ) {
+        const auto coverage = min( y1, static_cast< float >( y + 1 ) ) - max( y0, static_cast< float >( y ) );
+        auto* pRow = m_cPixels.data() + static_cast< size_t >( y ) * m_nWidth;
+
+        const auto leftColumn = ToCoverage( leftCoverage * coverage );
+        if( m_bOverdrawCounter ) {
+            CountOverdraw( pRow + left, 1, leftColumn );
+        }
+        BlendSpan( pRow + left, 1, color, leftColumn );
+        if( right - left > 1 ) {
+            const auto columns = ToCoverage( coverage ), rightColumn = ToCoverage( rightCoverage * coverage );
+            if( m_bOverdrawCounter ) {
+                CountOverdraw( pRow + left + 1, right - left - 2, columns );
+                CountOverdraw( pRow + right - 1, 1, rightColumn );
+            }
+            BlendSpan( pRow + left + 1, right - left - 2, color, columns );
+            BlendSpan( pRow + right - 1, 1, color, rightColumn );
+        }
+    }
+}
+
+void CSoftwareBackend::FillPolygon( const PointF* pPoints, size_t count, uint32_t color )
+{
+    if( !pPoints || count < 3 ) {
+        return;
+    }
+
+    m_cPoints.resize( count );
+    auto minX = HUGE_VALF, minY = HUGE_VALF, maxX = -HUGE_VALF, maxY = -HUGE_VALF;
+    for( size_t i = 0; i < count; ++i ) {
+        const auto point = Apply( pPoints[ i ].x, pPoints[ i ].y );
+        m_cPoints[ i ] = point;
+        minX = min( minX, point.x );
+        minY = min( minY, point.y );
+        maxX = max( maxX, point.x );
+        maxY = max( maxY, point.y );
+    }
+
+    if( !BeginShape( minX, minY, maxX, maxY ) ) {
+        return;
+    }
+    m_Rasterizer.AddPolygon( m_cPoints.data(), count );
+    BlendShape( color );
+}
+
+void CSoftwareBackend::FillTessellation( const Tessellation& tessellation, float x, float y, uint32_t color )
+{
+    const auto count = tessellation.cPoints.size();
+    if( tessellation.nOuter < 3 ) {
+        return;
+    }
+
+    m_cPoints.resize( count );
+    auto minX = HUGE_VALF, minY = HUGE_VALF, maxX = -HUGE_VALF, maxY = -HUGE_VALF;
+    for( size_t i = 0; i < count; ++i ) {
+        const auto point = Apply( x + tessellation.cPoints[ i ].x, y + tessellation.cPoints[ i ].y );
+        m_cPoints[ i ] = point;
+        minX = min( minX, point.x );
+        minY = min( minY, point.y );
+        maxX = max( maxX, point.x );
+        maxY = max( maxY, point.y );
+    }
+
+    if( !BeginShape( minX, minY, maxX, maxY ) ) {
+        return;
+    }
+    m_Rasterizer.AddPolygon( m_cPoints.data(), tessellation.nOuter );
+    if( count > tessellation.nOuter ) {
+        // the inner contour cuts the hole once it runs the other way
+        reverse( m_cPoints.begin() + static_cast< ptrdiff_t >( tessellation.nOuter ), m_cPoints.end() );
+        m_Rasterizer.AddPolygon( m_cPoints.data() + tessellation.nOuter, count - tessellation.nOuter );
+    }
+    BlendShape( color );
+}
+
+bool CSoftwareBackend::BeginShape( float minX, float minY, float maxX, float maxY )
+{
+    const auto left = max( static_cast< int32_t >( floor( minX ) ), 0 );
+    const auto top = max( static_cast< int32_t >( floor( minY ) ), 0 );
+    const auto right = min( static_cast< int32_t >( ceil( maxX ) ), m_nWidth );
+    const auto bottom = min( static_cast< int32_t >( ceil( maxY ) ), m_nHeight );
+    if( left >= right || top >= bottom ) {
+        return false;
+    }
+
+    m_Rasterizer.Reset( left, top, right - left, bottom - top );
+    return true;
+}
+
+void CSoftwareBackend::BlendShape( uint32_t color )
+{
+    m_Rasterizer.Resolve( m_eAntialiasMode == AntialiasMode::Aliased );
+
+    // the shape is rasterized unclipped and only blended inside the clip,
+    // so a clipped redraw produces the same pixels as a full one
+    const auto left = m_Rasterizer.GetX(), top = m_Rasterizer.GetY();
+    const auto bottom = top + m_Rasterizer.GetHeight();
+    const auto premultiplied = Premultiply( color );
+    for( auto y = max( top, m_cClip[ 1 ] ); y < min( bottom, m_cClip[ 3 ] ); ++y ) {
+        int32_t begin, end;
+        const auto* pCoverage = m_Rasterizer.GetRow( y - top, begin, end );
+        begin = max( begin, m_cClip[ 0 ] - left );
+        end = min( end, m_cClip[ 2 ] - left );
+        if( begin < end ) {
+            auto* pDst = m_cPixels.data() + static_cast< size_t >( y ) * m_nWidth + left + begin;
+            if( m_bOverdrawCounter ) {
+                CountOverdraw( pDst, end - begin, pCoverage + begin );
+            }
+            BlendSpan( pDst, end - begin, premultiplied, pCoverage + begin );
+        }
+    }
+}
+
+void CSoftwareBackend::BlendGlyph( const GlyphQuad& quad, int32_t x, int32_t y, uint32_t color )
+{
+    const auto x0 = x + quad.nLeft, y0 = y + quad.nTop;
+    const auto left = max( x0, m_cClip[ 0 ] ), right = min( x0 + quad.w, m_cClip[ 2 ] );
+    const auto top = max( y0, m_cClip[ 1 ] ), bottom = min( y0 + quad.h, m_cClip[ 3 ] );
+    if( left >= right ) {
+        return;
+    }
+
+    for( auto row = top; row < bottom; ++row ) {
+        const auto* pCoverage = m_GlyphAtlas.GetRow( quad.y + row - y0 ) + quad.x + ( left - x0 );
+        auto* pDst = m_cPixels.data() + static_cast< size_t >( row ) * m_nWidth + left;
+        if( m_bOverdrawCounter ) {
+            CountOverdraw( pDst, right - left, pCoverage );
+        }
+        BlendSpan( pDst, right - left, color, pCoverage );
+    }
+}
+
+void CSoftwareBackend::FillGlyph( const CTrueTypeFont& face, float size, uint32_t glyph, float x, float y, uint32_t color )
+{
+    if( !face.GetOutline( glyph, m_cGlyphPoints, m_cGlyphContours ) ) {
+        return;
+    }
+
+    // the control points enclose the curves
+    const auto scale = size / static_cast< float >( face.GetUnitsPerEm() );
+    auto minX = HUGE_VALF, minY = HUGE_VALF, maxX = -HUGE_VALF, maxY = -HUGE_VALF;
+    for( auto& point : m_cGlyphPoints ) {
+        const auto pixel = Apply( x + point.x * scale, y - point.y * scale );
+        point.x = pixel.x;
+        point.y = pixel.y;
+        minX = min( minX, pixel.x );
+        minY = min( minY, pixel.y );
+        maxX = max( maxX, pixel.x );
+        maxY = max( maxY, pixel.y );
+    }
+
+    if( !BeginShape( minX, minY, maxX, maxY ) ) {
+        return;
+    }
+    CTrueTypeFont::ForEachSegment( m_cGlyphPoints, m_cGlyphContours, [ & ]( const OutlinePoint& p0, const OutlinePoint& p1 ) {
+        m_Rasterizer.AddLine( { p0.x, p0.y }, { p1.x, p1.y } );
+    }, [ & ]( const OutlinePoint& p0, const OutlinePoint& p1, const OutlinePoint& p2 ) {
+        m_Rasterizer.AddQuadratic( { p0.x, p0.y }, { p1.x, p1.y }, { p2.x, p2.y } );
+    } );
+    BlendShape( color );
+}
+
+void CSoftwareBackend::CountOverdraw( const uint32_t* pDst, size_t count, uint32_t coverage )
+{
+    // the blend skips spans without coverage
+    if( !coverage ) {
+        return;
+    }
+
+    auto* pCount = m_cOverdraw.data() + ( pDst - m_cPixels.data() );
+    for( size_t i = 0; i < count; ++i ) {
+        ++pCount[ i ];
+    }
+    m_nPixelWrites += count;
+}
+
+void CSoftwareBackend::CountOverdraw( const uint32_t* pDst, size_t count, const uint8_t* pCoverage )
+{
+    auto* pCount = m_cOverdraw.data() + ( pDst - m_cPixels.data() );
+    for( size_t i = 0; i < count; ++i ) {
+        if( pCoverage[ i ] ) {
+            ++pCount[ i ];
+            ++m_nPixelWrites;
+        }
+    }
+}
+
+void CSoftwareBackend::CountOverdraw( const uint32_t* pDst, size_t count, const uint8_t* pCoverage, const uint8_t* pOther )
+{
+    auto* pCount = m_cOverdraw.data() + ( pDst - m_cPixels.data() );
+    for( size_t i = 0; i < count; ++i ) {
+        if( pCoverage[ i ] || pOther[ i ] ) {
+            ++pCount[ i ];
+            ++m_nPixelWrites;
+        }
+    }
+}
+
+void CSoftwareBackend::ResetOverdraw( void )
+{
+    fill( m_cOverdraw.begin(), m_cOverdraw.end(), 0 );
+    m_nPixelWrites = 0;
+}
+
+void CSoftwareBackend::ResetState( void )
+{
+    m_Transform = Transform::Identity();
+    m_eAntialiasMode = AntialiasMode::PerPrimitive;
+    m_cClip = { { 0, 0, m_nWidth, m_nHeight } };
+    m_cClipStack.clear();
+}
+
+PointF CSoftwareBackend::Apply( float x, float y ) const
+{
+    return { x * m_Transform.m11 + y * m_Transform.m21 + m_Transform.dx,
+             x * m_Transform.m12 + y * m_Transform.m22 + m_Transform.dy };
+}
+
+bool CSoftwareBackend::IsAxisAligned( void ) const
+{
+    return m_Transform.m12 == 0.f && m_Transform.m21 == 0.f;
+}
+
+bool CSoftwareBackend::IsTranslation( void ) const
+{
+    return IsAxisAligned() && m_Transform.m11 == 1.f && m_Transform.m22 == 1.f;
+}
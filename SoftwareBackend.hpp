@@ -0,0 +1,313 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GlyphAtlas.hpp"
+#include "Rasterizer.hpp"
+#include "RenderBackend.hpp"
+#include "TessellationCache.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Pixel writes since the start of the frame. A pixel blended
+     *             twice is written twice, clearing is no write.
+     */
+    struct OverdrawStatistics
+    {
+        uint64_t nPixelWrites   = 0;
+        uint64_t nPixelsWritten = 0;
+        uint32_t nMaxOverdraw   = 0;
+    };
+
+    /**
+     * @brief      CSoftwareBackend renders draw calls on the CPU into an
+     *             in-memory framebuffer, so frames can be rendered, compared
+     *             and profiled without any window or GPU. Pixels are stored
+     *             as premultiplied RGBA (r in the lowest byte), every shape
+     *             is antialiased by its exact area coverage and blended with
+     *             source-over. Unlike the Direct2D sink, the alpha of a color
+     *             is honored.
+     */
+    class CSoftwareBackend : public IRenderBackend
+    {
+    public:
+        /**
+         * @brief      Software font. Without a loaded font file for its family
+         *             the glyphs are drawn as boxes of a monospaced font.
+         */
+        struct Font
+        {
+            string               strFamily;
+            float                fSize;
+            const CTrueTypeFont* pFace;
+        };
+
+    public:
+        CSoftwareBackend( void ) = default;
+        CSoftwareBackend( int32_t w, int32_t h );
+
+        bool FillRect( float x, float y, float w, float h, uint32_t color ) override;
+        bool FillColoredRects( const ColoredRect* pRects, size_t count ) override;
+        bool FillBorderBoxes( const ColoredBorderBox* pBoxes, size_t count ) override;
+        bool FillRoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, uint32_t color ) override;
+        bool FillRoundedFrame( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, uint32_t color, uint32_t inner_color ) override;
+        bool Line( float x, float y, float xx, float yy, float thickness, uint32_t color ) override;
+
+        /**
+         * @brief      Rasterize every segment and joint of the path as one
+         *             shape, pixels below a joint are blended once
+         */
+        bool Polyline( const PointF* pPoints, size_t count, float thickness, uint32_t color ) override;
+        bool Text( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, uint32_t color ) override;
+        bool SetTransform( const Transform& transform ) override;
+        bool SetAntialiasMode( AntialiasMode mode ) override;
+
+        /**
+         * @brief      Start a new frame: clear the framebuffer with the clear
+         *             color and reset the transform and antialias mode
+         *
+         * @return     bool
+         */
+        bool BeginFrame( void ) override;
+
+        /**
+         * @brief      Start a new frame on top of the current framebuffer, only
+         *             resets the transform and antialias mode
+         *
+         * @return     bool
+         */
+        bool BeginPartialFrame( void ) override;
+        bool EndFrame( void ) override;
+        bool PushClip( const RectF& rect ) override;
+        bool PopClip( void ) override;
+
+        /**
+         * @brief      Fill the current clip rectangle with the clear color
+         *
+         * @return     bool
+         */
+        bool Clear( void ) override;
+        bool MeasureText( float x, float y, float w, float h, const wchar_t* text, size_t length, const void* pFont, RectF& bounds ) override;
+        const void* GetFont( const string& name ) const override;
+        FontHandle GetFontHandle( const string& name ) const override;
+        const void* GetFont( FontHandle handle ) const override;
+        array< int32_t, 2 > GetSize( void ) const override;
+
+        /**
+         * @brief      Resize the framebuffer, its content gets cleared
+         *
+         * @param[in]  w     width in pixels
+         * @param[in]  h     height in pixels
+         *
+         * @return     bool
+         */
+        bool Resize( int32_t w, int32_t h );
+
+        /**
+         * @brief      Set the color BeginFrame clears with
+         *
+         * @param[in]  color  argb color
+         */
+        void SetClearColor( uint32_t color );
+
+        /**
+         * @brief      Fill the whole framebuffer with a color, ignores the clip
+         *
+         * @param[in]  color  argb color
+         */
+        void Clear( uint32_t color );
+
+        /**
+         * @brief      Create or update a font
+         *
+         * @param[in]  name    name of the font
+         * @param[in]  family  font family, see LoadFontFile
+         * @param[in]  size    em size in pixels
+         *
+         * @return     const void* <> font object for Text
+         */
+        const void* RegisterFont( const string& name, const string& family, float size );
+
+        /**
+         * @brief      Load a TrueType file for a font family. The fonts of the
+         *             family then draw their glyphs from a glyph atlas,
+         *             Fonts/DejaVuSansMono.ttf is bundled for that.
+         *
+         * @param[in]  family  font family
+         * @param[in]  path    path of a .ttf file
+         *
+         * @return     bool <> false if the file is no TrueType font
+         */
+        bool LoadFontFile( const string& family, const string& path );
+
+        /**
+         * @brief      Get the glyph atlas the text is drawn from
+         *
+         * @return     const CGlyphAtlas&
+         */
+        const CGlyphAtlas& GetGlyphAtlas( void ) const;
+
+        /**
+         * @brief      Get the cache the rounded rectangles are flattened into
+         *
+         * @return     CTessellationCache&
+         */
+        CTessellationCache& GetTessellationCache( void );
+
+        /**
+         * @brief      Count how often every pixel gets blended, to find out
+         *             how much of a frame is drawn over again. Costs a counter
+         *             per pixel and is off by default, the counts start over
+         *             with every frame.
+         *
+         * @param[in]  enable  count the pixel writes
+         */
+        void SetOverdrawCounter( bool enable );
+
+        /**
+         * @brief      Get the pixel writes of the current frame, all zero
+         *             without the overdraw counter
+         *
+         * @return     OverdrawStatistics
+         */
+        OverdrawStatistics GetOverdrawStatistics( void ) const;
+
+        /**
+         * @brief      Get how often a single pixel was blended in the current
+         *             frame
+         *
+         * @param[in]  x     x-position
+         * @param[in]  y     y-position
+         *
+         * @return     uint32_t <> 0 outside of the framebuffer or without the
+         *             overdraw counter
+         */
+        uint32_t GetOverdraw( int32_t x, int32_t y ) const;
+
+        /**
+         * @brief      Get the framebuffer, row after row without padding
+         *
+         * @return     const uint32_t* <> premultiplied RGBA pixels
+         */
+        const uint32_t* GetPixels( void ) const;
+
+        /**
+         * @brief      Get a single pixel
+         *
+         * @param[in]  x     x-position
+         * @param[in]  y     y-position
+         *
+         * @return     uint32_t <> premultiplied RGBA, 0 outside of the framebuffer
+         */
+        uint32_t GetPixel( int32_t x, int32_t y ) const;
+
+        int32_t GetWidth( void ) const;
+        int32_t GetHeight( void ) const;
+
+        /**
+         * @brief      Write the framebuffer as binary PPM, composited over black
+         *
+         * @param[in]  path  file path
+         *
+         * @return     bool
+         */
+        bool SavePPM( const string& path ) const;
+
+        /**
+         * @brief      Write the framebuffer as straight alpha RGBA PNG
+         *
+         * @param[in]  path  file path
+         *
+         * @return     bool
+         */
+        bool SavePNG( const string& path ) const;
+
+    private:
+        /**
+         * @brief      Fill an axis aligned rectangle in pixel coordinates,
+         *             without going through the rasterizer
+         */
+        void FillPixelRect( float x0, float y0, float x1, float y1, uint32_t color );
+
+        /**
+         * @brief      Fill a polygon in user coordinates with the current
+         *             transform applied
+         */
+        void FillPolygon( const PointF* pPoints, size_t count, uint32_t color );
+
+        /**
+         * @brief      Fill a cached shape moved to a position in user
+         *             coordinates, with the current transform applied
+         */
+        void FillTessellation( const Tessellation& tessellation, float x, float y, uint32_t color );
+
+        /**
+         * @brief      Start a shape in pixel coordinates, returns false if it
+         *             lies outside of the framebuffer
+         */
+        bool BeginShape( float minX, float minY, float maxX, float maxY );
+
+        /**
+         * @brief      Blend the rasterized shape inside the clip
+         */
+        void BlendShape( uint32_t color );
+
+        /**
+         * @brief      Blend a glyph of the atlas at a pixel position
+         */
+        void BlendGlyph( const GlyphQuad& quad, int32_t x, int32_t y, uint32_t color );
+
+        /**
+         * @brief      Fill a glyph outline in user coordinates with the
+         *             current transform applied
+         */
+        void FillGlyph( const CTrueTypeFont& face, float size, uint32_t glyph, float x, float y, uint32_t color );
+
+        /**
+         * @brief      Count the pixels a span blend is going to write
+         */
+        void CountOverdraw( const uint32_t* pDst, size_t count, uint32_t coverage );
+        void CountOverdraw( const uint32_t* pDst, size_t count, const uint8_t* pCoverage );
+        void CountOverdraw( const uint32_t* pDst, size_t count, const uint8_t* pCoverage, const uint8_t* pOther );
+        void ResetOverdraw( void );
+
+        /**
+         * @brief      Reset the transform, the antialias mode and the clip
+         */
+        void ResetState( void );
+
+        PointF Apply( float x, float y ) const;
+        bool IsAxisAligned( void ) const;
+        bool IsTranslation( void ) const;
+
+    private:
+        int32_t                                     m_nWidth = 0;
+        int32_t                                     m_nHeight = 0;
+        vector< uint32_t >                          m_cPixels;
+        vector< uint32_t >                          m_cOverdraw;
+        uint64_t                                    m_nPixelWrites = 0;
+        bool                                        m_bOverdrawCounter = false;
+        Transform                                   m_Transform = Transform::Identity();
+        AntialiasMode                               m_eAntialiasMode = AntialiasMode::PerPrimitive;
+        uint32_t                                    m_nClearColor = 0;
+        array< int32_t, 4 >                         m_cClip = { { 0, 0, 0, 0 } };
+        vector< array< int32_t, 4 > >               m_cClipStack;
+        CRasterizer                                 m_Rasterizer;
+        CTessellationCache                          m_Tessellations;
+        vector< PointF >                            m_cPoints;
+        vector< PointF >                            m_cStroke;
+        vector< uint8_t >                           m_cCoverage;
+        unordered_map< string, unique_ptr< Font > > m_cFonts;
+        CFontTable                                  m_FontTable;
+        unordered_map< string,
+            unique_ptr< CTrueTypeFont > >           m_cFaces;
+        CGlyphAtlas                                 m_GlyphAtlas;
+        vector< OutlinePoint >                      m_cGlyphPoints;
+        vector< size_t >                            m_cGlyphContours;
+    };
+}
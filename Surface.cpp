@@ -0,0 +1,269 @@
+#include "Surface.hpp"
+#include "Utf.hpp"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Points of the graph currently drawn on this thread, the
+     *             buffer keeps its memory between graphs
+     */
+    vector< PointF >& GetGraphBuffer( void )
+    {
+        static thread_local vector< PointF > buffer;
+        return buffer;
+    }
+}
+
+CRenderSurface::CRenderSurface( IRenderBackend* pRenderBackend )
+{
+    SetRenderBackend( pRenderBackend );
+}
+
+bool CRenderSurface::BorderBox( float x, float y, float w, float h, float thickness, const Color& color ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    const ColoredBorderBox box = { x, y, w, h, thickness, color };
+    return pCommandSink->FillBorderBoxes( &box, 1 );
+}
+
+bool CRenderSurface::BorderBox( float x, float y, float w, float h, float thickness, float outlined_thickness, const Color& color, const Color& outlined_color ) const
+{
+    return BorderBox( x, y, w, h, thickness, color ) &&
+           BorderBox( x - outlined_thickness, y - outlined_thickness, w + outlined_thickness + thickness, h + outlined_thickness + thickness, outlined_thickness, outlined_color ) &&
+           BorderBox( x + thickness, y + thickness, w - outlined_thickness - thickness, h - outlined_thickness - thickness, outlined_thickness, outlined_color );
+}
+
+bool CRenderSurface::Line( float x, float y, float xx, float yy, float thickness, const Color& color ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    return pCommandSink->Line( x, y, xx, yy, thickness, color.hex() );
+}
+
+bool CRenderSurface::RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, const Color& color ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    return pCommandSink->FillRoundedRect( x, y, w, h, x_rad, y_rad, color.hex() );
+}
+
+bool CRenderSurface::RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float x_rad_outlined, float y_rad_outlined, const Color& color, const Color& outlined ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    // the ring ends where the fill starts, the inside is not drawn twice
+    thickness = max( thickness, 0.f );
+    return pCommandSink->FillRoundedFrame( x - thickness, y - thickness, w + thickness * 2.f, h + thickness * 2.f,
+                                           x_rad_outlined < 0.f ? x_rad : x_rad_outlined, y_rad_outlined < 0.f ? y_rad : y_rad_outlined,
+                                           thickness, x_rad, y_rad, outlined.hex(), color.hex() );
+}
+
+bool CRenderSurface::Rect( float x, float y, float w, float h, const Color& color ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    return pCommandSink->FillRect( x, y, w, h, color.hex() );
+}
+
+bool CRenderSurface::Rect( float x, float y, float w, float h, float thickness, const Color& color, const Color& outlined ) const
+{
+    return Rect( x, y, w, h, color ) &&
+           BorderBox( x - thickness, y - thickness, w + thickness, h + thickness, thickness, outlined );
+}
+
+bool CRenderSurface::Rects( const ColoredRect* pRects, size_t count ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink || !pRects ) {
+        return false;
+    }
+
+    return pCommandSink->FillColoredRects( pRects, count );
+}
+
+bool CRenderSurface::Lines( const ColoredLine* pLines, size_t count ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink || !pLines ) {
+        return false;
+    }
+
+    return pCommandSink->Lines( pLines, count );
+}
+
+bool CRenderSurface::BorderBoxes( const ColoredBorderBox* pBoxes, size_t count ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink || !pBoxes ) {
+        return false;
+    }
+
+    return pCommandSink->FillBorderBoxes( pBoxes, count );
+}
+
+bool CRenderSurface::Polyline( const PointF* pPoints, size_t count, float thickness, const Color& color ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink || !pPoints ) {
+        return false;
+    }
+
+    return pCommandSink->Polyline( pPoints, count, thickness, color.hex() );
+}
+
+bool CRenderSurface::Graph( float x, float y, float w, float h, const SampleBuffer& samples, float minimum, float maximum, float thickness, const Color& color ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    auto& cPoints = GetGraphBuffer();
+    if( BuildGraph( samples, { x, y, w, h }, minimum, maximum, cPoints ) < 2 ) {
+        return true;
+    }
+    return pCommandSink->Polyline( cPoints.data(), cPoints.size(), thickness, color.hex() );
+}
+
+bool CRenderSurface::SetTransform( const Transform& transform ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    return pCommandSink->SetTransform( transform );
+}
+
+bool CRenderSurface::SetAntialiasMode( AntialiasMode mode ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink ) {
+        return false;
+    }
+
+    return pCommandSink->SetAntialiasMode( mode );
+}
+
+uint64_t CRenderSurface::GetFramesPerSecond( void ) const
+{
+    return m_nFramesPerSecond;
+}
+
+bool CRenderSurface::String( float x, float y, const string& font, const Color& color, const char* msg, ... ) const
+{
+    if( !m_pRenderBackend ) {
+        return false;
+    }
+
+    va_list args;
+    va_start( args, msg );
+    const auto result = VString( x, y, m_pRenderBackend->GetFont( font ), color, msg, args );
+    va_end( args );
+    return result;
+}
+
+bool CRenderSurface::String( float x, float y, FontHandle font, const Color& color, const char* msg, ... ) const
+{
+    if( !m_pRenderBackend ) {
+        return false;
+    }
+
+    va_list args;
+    va_start( args, msg );
+    const auto result = VString( x, y, m_pRenderBackend->GetFont( font ), color, msg, args );
+    va_end( args );
+    return result;
+}
+
+FontHandle CRenderSurface::GetFontHandle( const string& font ) const
+{
+    return m_pRenderBackend ? m_pRenderBackend->GetFontHandle( font ) : 0;
+}
+
+bool CRenderSurface::VString( float x, float y, const void* pFont, const Color& color, const char* msg, va_list args ) const
+{
+    if( !pFont ) {
+        return false;
+    }
+
+    char buffer[ 0x400 ];
+    auto length = vsnprintf( buffer, sizeof( buffer ), msg, args );
+    if( length < 0 ) {
+        return false;
+    }
+    length = min( length, static_cast< int >( sizeof( buffer ) ) - 1 );
+
+    // reused by every label of this thread, no allocation once warmed up
+    static thread_local wstring w;
+    Utf8ToUtf16( buffer, static_cast< size_t >( length ), w );
+    return RenderText( x, y, pFont, color, w.c_str(), w.length() );
+}
+
+bool CRenderSurface::Text( float x, float y, const string& font, const Color& color, const wchar_t* text, size_t length ) const
+{
+    return m_pRenderBackend && RenderText( x, y, m_pRenderBackend->GetFont( font ), color, text, length );
+}
+
+bool CRenderSurface::Text( float x, float y, FontHandle font, const Color& color, const wchar_t* text, size_t length ) const
+{
+    return m_pRenderBackend && RenderText( x, y, m_pRenderBackend->GetFont( font ), color, text, length );
+}
+
+bool CRenderSurface::RenderText( float x, float y, const void* pFont, const Color& color, const wchar_t* text, size_t length ) const
+{
+    auto* pCommandSink = GetCommandSink();
+    if( !pCommandSink || !pFont ) {
+        return false;
+    }
+
+    const auto cSize = m_pRenderBackend->GetSize();
+    return pCommandSink->Text( x, y, static_cast< float >( cSize[ 0 ] ), static_cast< float >( cSize[ 1 ] ), text, length, pFont, color.hex() );
+}
+
+void CRenderSurface::SetRenderBackend( IRenderBackend* pRenderBackend )
+{
+    m_pRenderBackend = pRenderBackend;
+}
+
+IRenderBackend* CRenderSurface::GetRenderBackend( void ) const
+{
+    return m_pRenderBackend;
+}
+
+void CRenderSurface::SetCommandSink( ICommandSink* pCommandSink )
+{
+    m_pCommandSink = pCommandSink;
+}
+
+void CRenderSurface::SetFramesPerSecond( uint64_t fps )
+{
+    m_nFramesPerSecond = fps;
+}
+
+ICommandSink* CRenderSurface::GetCommandSink( void ) const
+{
+    if( !m_pRenderBackend ) {
+        return nullptr;
+    }
+    return m_pCommandSink ? m_pCommandSink : m_pRenderBackend;
+}
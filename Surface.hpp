@@ -0,0 +1,386 @@
+#pragma once
+#include <cstdarg>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include "Color.hpp"
+#include "Format.hpp"
+#include "Graph.hpp"
+#include "RenderBackend.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      CRenderSurface is the render class the callbacks draw with.
+     *             It forwards every primitive to a render backend (or to the
+     *             command sink that records for it). Every function does
+     *             return a boolean which is only false when no backend was
+     *             set or the backend rejected the call.
+     */
+    class CRenderSurface
+    {
+    public:
+        CRenderSurface( void ) = default;
+        explicit CRenderSurface( IRenderBackend* pRenderBackend );
+        
+        /**
+         * @brief      Render a bordered box
+         *
+         * @param[in]  x          x-position
+         * @param[in]  y          y-position
+         * @param[in]  w          width
+         * @param[in]  h          height
+         * @param[in]  thickness  thickness
+         * @param[in]  color      color
+         *
+         * @return     bool
+         */
+        bool BorderBox( float x, float y, float w, float h, float thickness, const Color& color ) const;
+        
+        /**
+         * @brief      Render an outlined bordered box
+         *
+         * @param[in]  x                   x-position
+         * @param[in]  y                   y-position
+         * @param[in]  w                   width
+         * @param[in]  h                   height
+         * @param[in]  thickness           thickness
+         * @param[in]  outlined_thickness  outlined thickness
+         * @param[in]  color               color
+         * @param[in]  outlined_color      outlined color
+         *
+         * @return     bool
+         */
+        bool BorderBox( float x, float y, float w, float h, float thickness, float outlined_thickness, const Color& color, const Color& outlined_color ) const;
+        
+        /**
+         * @brief      Render a line
+         *
+         * @param[in]  x          x-initial-position
+         * @param[in]  y          y-initial-position
+         * @param[in]  xx         x-final-position
+         * @param[in]  yy         y-final-posiiton
+         * @param[in]  thickness  tickness
+         * @param[in]  color      color
+         *
+         * @return     biik
+         */
+        bool Line( float x, float y, float xx, float yy, float thickness, const Color& color ) const;
+        
+        /**
+         * @brief      Render a rounded rectangle
+         *
+         * @param[in]  x      x-position
+         * @param[in]  y      y-position
+         * @param[in]  w      width
+         * @param[in]  h      height
+         * @param[in]  x_rad  x-radius
+         * @param[in]  y_rad  y-radius
+         * @param[in]  color  color
+         *
+         * @return     bool
+         */
+        bool RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, const Color& color ) const;
+        
+        /**
+         * @brief      Render an outlined rounded rectangle
+         *
+         * @param[in]  x               x-position
+         * @param[in]  y               y-position
+         * @param[in]  w               width
+         * @param[in]  h               height
+         * @param[in]  x_rad           x-radius
+         * @param[in]  y_rad           y-radius
+         * @param[in]  thickness       thickness
+         * @param[in]  x_rad_outlined  outlined x-radius (whenever -1 was passed, the outlined radius will have the same value as the x_rad)
+         * @param[in]  y_rad_outlined  outlined y-radius (whenever -1 was passed, the outlined radius will have the same value as the y_rad)
+         * @param[in]  color           color
+         * @param[in]  outlined        outlined color
+         *
+         * @return     bool
+         */
+        bool RoundedRect( float x, float y, float w, float h, float x_rad, float y_rad, float thickness, float x_rad_outlined, float y_rad_outlined, const Color& color, const Color& outlined ) const;
+        
+        /**
+         * @brief      Render a rectangle
+         *
+         * @param[in]  x      x-position
+         * @param[in]  y      y-position
+         * @param[in]  w      width
+         * @param[in]  h      height
+         * @param[in]  color  color
+         *
+         * @return     bool
+         */
+        bool Rect( float x, float y, float w, float h, const Color& color ) const;
+        
+        /**
+         * @brief      Reder an outlined rectangle
+         *
+         * @param[in]  x          x-position
+         * @param[in]  y          y-position
+         * @param[in]  w          width
+         * @param[in]  h          height
+         * @param[in]  thickness  thickness
+         * @param[in]  color      color
+         * @param[in]  outlined   outlined color
+         *
+         * @return     bool
+         */
+        bool Rect( float x, float y, float w, float h, float thickness, const Color& color, const Color& outlined ) const;
+        
+        /**
+         * @brief      Render a batch of rectangles. The backend is looked up
+         *             once and gets the whole batch in one call.
+         *
+         * @param[in]  pRects  rectangles with their colors
+         * @param[in]  count   amount of rectangles
+         *
+         * @return     bool
+         */
+        bool Rects( const ColoredRect* pRects, size_t count ) const;
+
+        /**
+         * @brief      Render a batch of lines in one call to the backend
+         *
+         * @param[in]  pLines  lines with their thickness and colors
+         * @param[in]  count   amount of lines
+         *
+         * @return     bool
+         */
+        bool Lines( const ColoredLine* pLines, size_t count ) const;
+
+        /**
+         * @brief      Render a batch of bordered boxes in one call to the
+         *             backend
+         *
+         * @param[in]  pBoxes  bordered boxes with their thickness and colors
+         * @param[in]  count   amount of boxes
+         *
+         * @return     bool
+         */
+        bool BorderBoxes( const ColoredBorderBox* pBoxes, size_t count ) const;
+
+        /**
+         * @brief      Render connected lines through a sequence of points as
+         *             one path in one call to the backend
+         *
+         * @param[in]  pPoints    points
+         * @param[in]  count      amount of points, at least two
+         * @param[in]  thickness  thickness
+         * @param[in]  color      color
+         *
+         * @return     bool
+         */
+        bool Polyline( const PointF* pPoints, size_t count, float thickness, const Color& color ) const;
+
+        /**
+         * @brief      Render a graph of samples as one polyline. With more
+         *             samples than pixel columns every column is reduced to
+         *             its minimum and maximum, see BuildGraph. The samples
+         *             are read in place, a streaming ring buffer is drawn
+         *             without being copied.
+         *
+         * @param[in]  x          x-position
+         * @param[in]  y          y-position
+         * @param[in]  w          width
+         * @param[in]  h          height
+         * @param[in]  samples    samples, oldest on the left
+         * @param[in]  minimum    value at the bottom edge
+         * @param[in]  maximum    value at the top edge
+         * @param[in]  thickness  thickness
+         * @param[in]  color      color
+         *
+         * @return     bool <> also true with less than two samples to draw
+         */
+        bool Graph( float x, float y, float w, float h, const SampleBuffer& samples, float minimum, float maximum, float thickness, const Color& color ) const;
+
+        /**
+         * @brief      Set the transform for every following primitive
+         *
+         * @param[in]  transform  transform
+         *
+         * @return     bool
+         */
+        bool SetTransform( const Transform& transform ) const;
+
+        /**
+         * @brief      Set the antialias mode for every following primitive
+         *
+         * @param[in]  mode  antialias mode
+         *
+         * @return     bool
+         */
+        bool SetAntialiasMode( AntialiasMode mode ) const;
+
+        /**
+         * @brief      Get the frames per second.
+         *
+         * @return     uint64_t
+         */
+        uint64_t GetFramesPerSecond( void ) const;
+        
+        /**
+         * @brief      Render a string
+         *
+         * @param[in]  x          x-position
+         * @param[in]  y          y-position
+         * @param[in]  font       buffer name
+         * @param[in]  color      color
+         * @param[in]  msg        string
+         * @param[in]  <unnamed>  optional args
+         *
+         * @return     bool
+         */
+        bool String( float x, float y, const string& font, const Color& color, const char* msg, ... ) const;
+
+        /**
+         * @brief      Render a formatted string. The format string is
+         *             checked against the arguments at compile time and
+         *             written as utf-16 without any length limit.
+         *
+         * @param[in]  x       x-position
+         * @param[in]  y       y-position
+         * @param[in]  font    buffer name
+         * @param[in]  color   color
+         * @param[in]  format  format string, see HAZE_FORMAT
+         * @param[in]  args    arguments
+         *
+         * @return     bool
+         */
+        template< typename TFormat, typename = enable_if_t< IsFormatString< TFormat >::value >, typename... Args >
+        bool String( float x, float y, const string& font, const Color& color, TFormat format, const Args&... args ) const;
+
+        /**
+         * @brief      Render a string with a font handle, which skips the
+         *             lookup of the font name
+         *
+         * @param[in]  x          x-position
+         * @param[in]  y          y-position
+         * @param[in]  font       font handle, see GetFontHandle
+         * @param[in]  color      color
+         * @param[in]  msg        string
+         * @param[in]  <unnamed>  optional args
+         *
+         * @return     bool
+         */
+        bool String( float x, float y, FontHandle font, const Color& color, const char* msg, ... ) const;
+
+        /**
+         * @brief      Render a formatted string with a font handle
+         *
+         * @param[in]  x       x-position
+         * @param[in]  y       y-position
+         * @param[in]  font    font handle, see GetFontHandle
+         * @param[in]  color   color
+         * @param[in]  format  format string, see HAZE_FORMAT
+         * @param[in]  args    arguments
+         *
+         * @return     bool
+         */
+        template< typename TFormat, typename = enable_if_t< IsFormatString< TFormat >::value >, typename... Args >
+        bool String( float x, float y, FontHandle font, const Color& color, TFormat format, const Args&... args ) const;
+
+        /**
+         * @brief      Get the handle of a registered font, best looked up
+         *             once and kept by the callback
+         *
+         * @param[in]  font  buffer name
+         *
+         * @return     FontHandle <> 0 if there is no such font
+         */
+        FontHandle GetFontHandle( const string& font ) const;
+        
+        /**
+         * @brief      Set the backend which provides the fonts and the size
+         *             and receives the draw calls
+         *
+         * @param[in]  pRenderBackend  render backend
+         */
+        void SetRenderBackend( IRenderBackend* pRenderBackend );
+
+        /**
+         * @brief      Get the render backend
+         *
+         * @return     IRenderBackend*
+         */
+        IRenderBackend* GetRenderBackend( void ) const;
+
+        /**
+         * @brief      Redirect the draw calls into another sink, e.g. a
+         *             command list which gets replayed on the backend later
+         *
+         * @param[in]  pCommandSink  sink, nullptr draws into the backend
+         */
+        void SetCommandSink( ICommandSink* pCommandSink );
+
+        /**
+         * @brief      Set the frames per second reported to the callbacks
+         *
+         * @param[in]  fps   frames per second
+         */
+        void SetFramesPerSecond( uint64_t fps );
+
+    private:
+        /**
+         * @brief      Render an utf-16 string
+         *
+         * @param[in]  x       x-position
+         * @param[in]  y       y-position
+         * @param[in]  font    buffer name
+         * @param[in]  color   color
+         * @param[in]  text    utf-16 text
+         * @param[in]  length  text length
+         *
+         * @return     bool
+         */
+        bool Text( float x, float y, const string& font, const Color& color, const wchar_t* text, size_t length ) const;
+        bool Text( float x, float y, FontHandle font, const Color& color, const wchar_t* text, size_t length ) const;
+        bool RenderText( float x, float y, const void* pFont, const Color& color, const wchar_t* text, size_t length ) const;
+
+        /**
+         * @brief      Format a printf style string and render it
+         *
+         * @param[in]  x       x-position
+         * @param[in]  y       y-position
+         * @param[in]  pFont   backend specific font object
+         * @param[in]  color   color
+         * @param[in]  msg     string
+         * @param[in]  args    optional args
+         *
+         * @return     bool
+         */
+        bool VString( float x, float y, const void* pFont, const Color& color, const char* msg, va_list args ) const;
+
+        /**
+         * @brief      Get the sink the primitives have to be drawn into
+         *
+         * @return     ICommandSink* <> nullptr if no backend was set
+         */
+        ICommandSink* GetCommandSink( void ) const;
+
+    private:
+        IRenderBackend* m_pRenderBackend = nullptr;
+        ICommandSink*   m_pCommandSink = nullptr;
+        uint64_t        m_nFramesPerSecond = 0;
+    };
+
+    using RenderCallbackFn = void( * )( const CRenderSurface* );
+
+    template< typename TFormat, typename, typename... Args >
+    bool CRenderSurface::String( float x, float y, const string& font, const Color& color, TFormat format, const Args&... args ) const
+    {
+        CUtf16Writer writer( GetFormatBuffer() );
+        Format( writer, format, args... );
+        return Text( x, y, font, color, writer.data(), writer.size() );
+    }
+
+    template< typename TFormat, typename, typename... Args >
+    bool CRenderSurface::String( float x, float y, FontHandle font, const Color& color, TFormat format, const Args&... args ) const
+    {
+        CUtf16Writer writer( GetFormatBuffer() );
+        Format( writer, format, args... );
+        return Text( x, y, font, color, writer.data(), writer.size() );
+    }
+}
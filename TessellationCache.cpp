@@ -0,0 +1,107 @@
+#include "TessellationCache.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <cmath>
+using namespace haze;
+
+namespace {
+    constexpr float PI = 3.14159265358979f;
+}
+
+CTessellationCache::CTessellationCache( size_t budget ) :
+    m_cShapes( budget )
+{
+}
+
+const Tessellation* CTessellationCache::GetRoundedRect( float w, float h, float x_rad, float y_rad, size_t segments )
+{
+    // a filled shape is a ring without thickness
+    return Get( { w, h, min( max( x_rad, 0.f ), 0.5f * w ), min( max( y_rad, 0.f ), 0.5f * h ), 0.f, 0.f, 0.f, max< size_t >( segments, 1 ), 0 } );
+}
+
+const Tessellation* CTessellationCache::GetRoundedFrame( float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, size_t segments, size_t inner_segments )
+{
+    const auto t = max( thickness, 0.f );
+    if( !( t > 0.f ) || w <= 2.f * t || h <= 2.f * t ) {
+        return GetRoundedRect( w, h, x_rad, y_rad, segments );
+    }
+
+    const auto iw = w - 2.f * t, ih = h - 2.f * t;
+    return Get( { w, h, min( max( x_rad, 0.f ), 0.5f * w ), min( max( y_rad, 0.f ), 0.5f * h ), t,
+                  min( max( inner_x_rad, 0.f ), 0.5f * iw ), min( max( inner_y_rad, 0.f ), 0.5f * ih ), max< size_t >( segments, 1 ), max< size_t >( inner_segments, 1 ) } );
+}
+
+size_t CTessellationCache::GetArcSegments( float radius )
+{
+    if( radius <= 0.1f ) {
+        return 1;
+    }
+    const auto step = 2.f * acos( 1.f - 0.1f / radius );
+    return min< size_t >( max< size_t >( static_cast< size_t >( ceil( 0.5f * PI / step ) ), 2 ), 64 );
+}
+
+void CTessellationCache::SetBudget( size_t budget )
+{
+    m_cShapes.SetBudget( budget );
+}
+
+const CacheStatistics& CTessellationCache::GetStatistics( void ) const
+{
+    return m_cShapes.GetStatistics();
+}
+
+void CTessellationCache::Clear( void )
+{
+    m_cShapes.Clear();
+}
+
+const Tessellation* CTessellationCache::Get( const Key& key )
+{
+    auto hash = Hash64( key.w );
+    hash = Hash64( key.h, hash );
+    hash = Hash64( key.fRadiusX, hash );
+    hash = Hash64( key.fRadiusY, hash );
+    hash = Hash64( key.fThickness, hash );
+    hash = Hash64( key.fInnerRadiusX, hash );
+    hash = Hash64( key.fInnerRadiusY, hash );
+    hash = Hash64( key.nSegments, hash );
+    hash = Hash64( key.nInnerSegments, hash );
+
+    auto* pTessellation = m_cShapes.Find( hash, [ & ]( const Key& other ) {
+        return other == key;
+    } );
+    if( pTessellation ) {
+        return pTessellation;
+    }
+
+    Tessellation tessellation;
+    AddRoundedRect( tessellation.cPoints, 0.f, 0.f, key.w, key.h, key.fRadiusX, key.fRadiusY, key.nSegments );
+    tessellation.nOuter = tessellation.cPoints.size();
+
+    const auto t = key.fThickness;
+    if( t > 0.f ) {
+        AddRoundedRect( tessellation.cPoints, t, t, key.w - 2.f * t, key.h - 2.f * t, key.fInnerRadiusX, key.fInnerRadiusY, key.nInnerSegments );
+    }
+
+    // the newest entry always stays, even without a budget
+    const auto cost = sizeof( Key ) + sizeof( Tessellation ) + tessellation.cPoints.size() * sizeof( PointF );
+    return &m_cShapes.Insert( hash, key, move( tessellation ), cost );
+}
+
+void CTessellationCache::AddRoundedRect( vector< PointF >& cPoints, float x, float y, float w, float h, float rx, float ry, size_t segments )
+{
+    // clockwise from the top right corner, a zero radius repeats the corner point
+    const PointF centers[] = { { x + w - rx, y + ry }, { x + w - rx, y + h - ry }, { x + rx, y + h - ry }, { x + rx, y + ry } };
+    for( size_t corner = 0; corner < 4; ++corner ) {
+        for( size_t i = 0; i <= segments; ++i ) {
+            const auto angle = ( static_cast< float >( corner ) - 1.f + static_cast< float >( i ) / static_cast< float >( segments ) ) * 0.5f * PI;
+            cPoints.push_back( { centers[ corner ].x + rx * cos( angle ), centers[ corner ].y + ry * sin( angle ) } );
+        }
+    }
+}
+
+bool CTessellationCache::Key::operator == ( const Key& other ) const
+{
+    return w == other.w && h == other.h && fRadiusX == other.fRadiusX && fRadiusY == other.fRadiusY && fThickness == other.fThickness &&
+           fInnerRadiusX == other.fInnerRadiusX && fInnerRadiusY == other.fInnerRadiusY && nSegments == other.nSegments && nInnerSegments == other.nInnerSegments;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "LruCache.hpp"
+#include "Rasterizer.hpp"
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Flattened shape with its top left corner at the origin. A
+     *             ring has an inner contour after the outer one, both run
+     *             clockwise.
+     */
+    struct Tessellation
+    {
+        vector< PointF > cPoints;
+        size_t           nOuter = 0;
+    };
+
+    /**
+     * @brief      CTessellationCache flattens shapes once per size and keeps
+     *             them up to a memory budget, least recently used first out.
+     *             Shapes which only moved are translated instead of being
+     *             flattened again.
+     */
+    class CTessellationCache
+    {
+    public:
+        static constexpr size_t DEFAULT_BUDGET = 256 << 10;
+
+    public:
+        explicit CTessellationCache( size_t budget = DEFAULT_BUDGET );
+
+        /**
+         * @brief      Get a rounded rectangle. The radii are limited to half
+         *             of the rectangle like Direct2D does. The pointer stays
+         *             valid until the next call.
+         *
+         * @param[in]  w         width, above zero
+         * @param[in]  h         height, above zero
+         * @param[in]  x_rad     x-radius
+         * @param[in]  y_rad     y-radius
+         * @param[in]  segments  segments per quarter ellipse
+         *
+         * @return     const Tessellation*
+         */
+        const Tessellation*    GetRoundedRect( float w, float h, float x_rad, float y_rad, size_t segments );
+
+        /**
+         * @brief      Get the ring between a rounded rectangle and its inset
+         *             by thickness. The inner contour is flattened exactly
+         *             like GetRoundedRect flattens the inset, so a ring and
+         *             the fill of its hole share their edge. Without room for
+         *             the inset only the outer contour is returned.
+         *
+         * @param[in]  w               width, above zero
+         * @param[in]  h               height, above zero
+         * @param[in]  x_rad           outer x-radius
+         * @param[in]  y_rad           outer y-radius
+         * @param[in]  thickness       width of the ring
+         * @param[in]  inner_x_rad     inner x-radius
+         * @param[in]  inner_y_rad     inner y-radius
+         * @param[in]  segments        segments per outer quarter ellipse
+         * @param[in]  inner_segments  segments per inner quarter ellipse
+         *
+         * @return     const Tessellation*
+         */
+        const Tessellation*    GetRoundedFrame( float w, float h, float x_rad, float y_rad, float thickness, float inner_x_rad, float inner_y_rad, size_t segments, size_t inner_segments );
+
+        /**
+         * @brief      Amount of segments a quarter ellipse needs to stay within
+         *             a tenth of a pixel
+         *
+         * @param[in]  radius  radius in pixels
+         *
+         * @return     size_t
+         */
+        static size_t          GetArcSegments( float radius );
+
+        void                   SetBudget( size_t budget );
+        const CacheStatistics& GetStatistics( void ) const;
+        void                   Clear( void );
+
+    private:
+        struct Key
+        {
+            float  w;
+            float  h;
+            float  fRadiusX;
+            float  fRadiusY;
+            float  fThickness;
+            float  fInnerRadiusX;
+            float  fInnerRadiusY;
+            size_t nSegments;
+            size_t nInnerSegments;
+
+            bool operator == ( const Key& other ) const;
+        };
+
+        const Tessellation* Get( const Key& key );
+
+        static void AddRoundedRect( vector< PointF >& cPoints, float x, float y, float w, float h, float rx, float ry, size_t segments );
+
+    private:
+        CLruCache< Key, Tessellation > m_cShapes;
+    };
+}
@@ -0,0 +1,135 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+using namespace haze;
+
+CWorkStealingPool::CWorkStealingPool( int32_t workers )
+{
+    if( workers < 0 ) {
+        workers = max( static_cast< int32_t >( thread::hardware_concurrency() ) - 1, 0 );
+    }
+
+    // queue 0 belongs to the calling thread
+    for( int32_t i = 0; i <= workers; ++i ) {
+        m_cQueues.emplace_back( new Queue() );
+    }
+    for( int32_t i = 1; i <= workers; ++i ) {
+        m_cWorkers.emplace_back( &CWorkStealingPool::WorkerLoop, this, static_cast< size_t >( i ) );
+    }
+}
+
+CWorkStealingPool::~CWorkStealingPool( void )
+{
+    {
+        lock_guard< mutex > lock( m_Mutex );
+        m_bStop = true;
+    }
+    m_Wake.notify_all();
+
+    for( auto& worker : m_cWorkers ) {
+        worker.join();
+    }
+}
+
+size_t CWorkStealingPool::GetWorkerCount( void ) const
+{
+    return m_cWorkers.size();
+}
+
+uint64_t CWorkStealingPool::GetStolenCount( void ) const
+{
+    return m_nStolen.load( memory_order_relaxed );
+}
+
+void CWorkStealingPool::Run( size_t count, TaskFn fn, void* pContext )
+{
+    if( !count ) {
+        return;
+    }
+
+    // nothing to share, skip the synchronization
+    if( m_cWorkers.empty() || count == 1 ) {
+        for( size_t i = 0; i < count; ++i ) {
+            fn( pContext, i );
+        }
+        return;
+    }
+
+    m_fnTask = fn;
+    m_pContext = pContext;
+    m_nPending.store( count, memory_order_relaxed );
+
+    // deal the iterations round robin, neighbouring iterations end up on
+    // different threads
+    for( size_t i = 0; i < m_cQueues.size(); ++i ) {
+        lock_guard< mutex > lock( m_cQueues[ i ]->Mutex );
+        for( auto index = i; index < count; index += m_cQueues.size() ) {
+            m_cQueues[ i ]->cTasks.push_front( index );
+        }
+    }
+
+    {
+        lock_guard< mutex > lock( m_Mutex );
+        ++m_nGeneration;
+    }
+    m_Wake.notify_all();
+
+    while( m_nPending.load( memory_order_acquire ) ) {
+        if( !Execute( 0 ) ) {
+            this_thread::yield();
+        }
+    }
+}
+
+void CWorkStealingPool::WorkerLoop( size_t queue )
+{
+    uint64_t generation = 0;
+    for( ;; ) {
+        {
+            unique_lock< mutex > lock( m_Mutex );
+            m_Wake.wait( lock, [ & ] { return m_bStop || m_nGeneration != generation; } );
+            if( m_bStop ) {
+                return;
+            }
+            generation = m_nGeneration;
+        }
+
+        while( Execute( queue ) ) {
+        }
+    }
+}
+
+bool CWorkStealingPool::Execute( size_t queue )
+{
+    size_t index = 0;
+    auto found = false;
+
+    {
+        auto& own = *m_cQueues[ queue ];
+        lock_guard< mutex > lock( own.Mutex );
+        if( !own.cTasks.empty() ) {
+            index = own.cTasks.back();
+            own.cTasks.pop_back();
+            found = true;
+        }
+    }
+
+    for( size_t i = 1; !found && i < m_cQueues.size(); ++i ) {
+        auto& victim = *m_cQueues[ ( queue + i ) % m_cQueues.size() ];
+        lock_guard< mutex > lock( victim.Mutex );
+        if( !victim.cTasks.empty() ) {
+            index = victim.cTasks.front();
+            victim.cTasks.pop_front();
+            found = true;
+            m_nStolen.fetch_add( 1, memory_order_relaxed );
+        }
+    }
+
+    if( !found ) {
+        return false;
+    }
+
+    // the task was published before its index got queued
+    m_fnTask( m_pContext, index );
+    m_nPending.fetch_sub( 1, memory_order_acq_rel );
+    return true;
+}
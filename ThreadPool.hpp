@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      CWorkStealingPool runs the iterations of a parallel loop on
+     *             a fixed set of worker threads. Every thread owns a queue and
+     *             takes work from its back, idle threads steal from the front
+     *             of the other queues. The calling thread takes part in the
+     *             loop, so a pool without workers runs everything serially.
+     */
+    class CWorkStealingPool
+    {
+    public:
+        /**
+         * @brief      Start the worker threads
+         *
+         * @param[in]  workers  amount of workers, -1 for one less than the
+         *                      amount of hardware threads
+         */
+        explicit CWorkStealingPool( int32_t workers = -1 );
+        ~CWorkStealingPool( void );
+
+        CWorkStealingPool( const CWorkStealingPool& ) = delete;
+        CWorkStealingPool& operator = ( const CWorkStealingPool& ) = delete;
+
+        /**
+         * @brief      Call fn( i ) for every i in [0, count) and return once
+         *             every call has finished. Must not be nested.
+         *
+         * @param[in]  count  amount of iterations
+         * @param[in]  fn     function
+         */
+        template< typename TFunction >
+        void ParallelFor( size_t count, TFunction&& fn )
+        {
+            using Function = remove_reference_t< TFunction >;
+            Run( count, []( void* pContext, size_t index ) {
+                ( *static_cast< Function* >( pContext ) )( index );
+            }, &fn );
+        }
+
+        /**
+         * @brief      Get the amount of worker threads, without the caller
+         *
+         * @return     size_t
+         */
+        size_t GetWorkerCount( void ) const;
+
+        /**
+         * @brief      Get the amount of iterations that were stolen from
+         *             another queue
+         *
+         * @return     uint64_t
+         */
+        uint64_t GetStolenCount( void ) const;
+
+    private:
+        using TaskFn = void( * )( void*, size_t );
+
+        struct Queue
+        {
+            mutex            Mutex;
+            deque< size_t >  cTasks;
+        };
+
+        void Run( size_t count, TaskFn fn, void* pContext );
+        void WorkerLoop( size_t queue );
+
+        /**
+         * @brief      Run a single task of the own queue or a stolen one
+         *
+         * @param[in]  queue  queue of the calling thread
+         *
+         * @return     bool <> false if every queue was empty
+         */
+        bool Execute( size_t queue );
+
+    private:
+        vector< unique_ptr< Queue > > m_cQueues;
+        vector< thread >              m_cWorkers;
+        mutex                         m_Mutex;
+        condition_variable            m_Wake;
+        TaskFn                        m_fnTask = nullptr;
+        void*                         m_pContext = nullptr;
+        atomic< size_t >              m_nPending{ 0 };
+        atomic< uint64_t >            m_nStolen{ 0 };
+        uint64_t                      m_nGeneration = 0;
+        bool                          m_bStop = false;
+    };
+}
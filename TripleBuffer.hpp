@@ -0,0 +1,87 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      CTripleBuffer hands values from one producer to one consumer
+     *             without locks. The producer fills the write buffer and
+     *             publishes it, the consumer acquires the latest published
+     *             buffer. Neither side ever waits, values the consumer did not
+     *             pick up in time are overwritten.
+     */
+    template< typename T >
+    class CTripleBuffer
+    {
+    public:
+        CTripleBuffer( void ) = default;
+
+        CTripleBuffer( const CTripleBuffer& ) = delete;
+        CTripleBuffer& operator = ( const CTripleBuffer& ) = delete;
+
+        /**
+         * @brief      Get the buffer the producer may fill
+         *
+         * @return     T&
+         */
+        T& GetWriteBuffer( void )
+        {
+            return m_cBuffers[ m_nWrite ];
+        }
+
+        /**
+         * @brief      Publish the write buffer, the producer gets a new one
+         */
+        void Publish( void )
+        {
+            m_nWrite = m_nMiddle.exchange( m_nWrite | FRESH, memory_order_acq_rel ) & INDEX;
+        }
+
+        /**
+         * @brief      Has the producer published a buffer which was not
+         *             acquired yet?
+         *
+         * @return     bool
+         */
+        bool HasPublished( void ) const
+        {
+            return !!( m_nMiddle.load( memory_order_acquire ) & FRESH );
+        }
+
+        /**
+         * @brief      Make the latest published buffer the read buffer
+         *
+         * @return     bool <> false if nothing new was published
+         */
+        bool Acquire( void )
+        {
+            if( !HasPublished() ) {
+                return false;
+            }
+            m_nRead = m_nMiddle.exchange( m_nRead, memory_order_acq_rel ) & INDEX;
+            return true;
+        }
+
+        /**
+         * @brief      Get the buffer the consumer acquired last
+         *
+         * @return     T&
+         */
+        T& GetReadBuffer( void )
+        {
+            return m_cBuffers[ m_nRead ];
+        }
+
+    private:
+        static constexpr uint32_t INDEX = 3;
+        static constexpr uint32_t FRESH = 4;
+
+        array< T, 3 >      m_cBuffers;
+        uint32_t           m_nWrite = 0;
+        atomic< uint32_t > m_nMiddle{ 1 };
+        uint32_t           m_nRead = 2;
+    };
+}
@@ -0,0 +1,443 @@
+#include "TrueType.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+using namespace haze;
+
+namespace {
+    // simple glyph flags
+    constexpr uint8_t ON_CURVE     = 0x01;
+    constexpr uint8_t X_SHORT      = 0x02;
+    constexpr uint8_t Y_SHORT      = 0x04;
+    constexpr uint8_t REPEAT       = 0x08;
+    constexpr uint8_t X_SAME       = 0x10;
+    constexpr uint8_t Y_SAME       = 0x20;
+
+    // composite glyph flags
+    constexpr uint16_t ARGS_ARE_WORDS   = 0x0001;
+    constexpr uint16_t ARGS_ARE_XY      = 0x0002;
+    constexpr uint16_t HAS_SCALE        = 0x0008;
+    constexpr uint16_t MORE_COMPONENTS  = 0x0020;
+    constexpr uint16_t HAS_XY_SCALE     = 0x0040;
+    constexpr uint16_t HAS_TWO_BY_TWO   = 0x0080;
+
+    constexpr int32_t MAX_COMPOSITE_DEPTH = 8;
+
+    float F2Dot14( int16_t value )
+    {
+        return static_cast< float >( value ) / 16384.f;
+    }
+}
+
+bool CTrueTypeFont::Load( const string& path )
+{
+    ifstream file( path, ios::binary );
+    if( !file ) {
+        return false;
+    }
+    return Load( vector< uint8_t >( istreambuf_iterator< char >( file ), istreambuf_iterator< char >() ) );
+}
+
+bool CTrueTypeFont::Load( vector< uint8_t > data )
+{
+    m_cData = move( data );
+    if( !Parse() ) {
+        m_cData.clear();
+        m_nUnitsPerEm = 0;
+        return false;
+    }
+    return true;
+}
+
+uint32_t CTrueTypeFont::GetGlyph( uint32_t codepoint ) const
+{
+    if( !m_nCmap ) {
+        return 0;
+    }
+
+    uint32_t glyph = 0;
+    if( m_nCmapFormat == 12 ) {
+        // sequential groups sorted by their first code point
+        uint32_t low = 0, high = U32( m_nCmap + 12 );
+        while( low < high ) {
+            const auto middle = ( low + high ) / 2;
+            const auto group = m_nCmap + 16 + middle * 12;
+            if( codepoint < U32( group ) ) {
+                high = middle;
+            }
+            else if( codepoint > U32( group + 4 ) ) {
+                low = middle + 1;
+            }
+            else {
+                glyph = U32( group + 8 ) + codepoint - U32( group );
+                break;
+            }
+        }
+    }
+    else if( codepoint <= 0xFFFF ) {
+        // segments sorted by their last code point
+        const uint32_t segments = U16( m_nCmap + 6 ) / 2u;
+        const auto endCodes = m_nCmap + 14;
+        const auto startCodes = endCodes + segments * 2 + 2;
+        const auto deltas = startCodes + segments * 2;
+        const auto rangeOffsets = deltas + segments * 2;
+
+        uint32_t low = 0, high = segments;
+        while( low < high ) {
+            const auto middle = ( low + high ) / 2;
+            if( codepoint > U16( endCodes + middle * 2 ) ) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        if( low < segments && codepoint >= U16( startCodes + low * 2 ) ) {
+            const auto delta = U16( deltas + low * 2 );
+            const auto rangeOffset = U16( rangeOffsets + low * 2 );
+            if( !rangeOffset ) {
+                glyph = ( codepoint + delta ) & 0xFFFF;
+            }
+            else {
+                // the offset is relative to its own position
+                glyph = U16( rangeOffsets + low * 2 + rangeOffset + ( codepoint - U16( startCodes + low * 2 ) ) * 2 );
+                if( glyph ) {
+                    glyph = ( glyph + delta ) & 0xFFFF;
+                }
+            }
+        }
+    }
+    return glyph < m_nGlyphs ? glyph : 0;
+}
+
+int32_t CTrueTypeFont::GetAdvance( uint32_t glyph ) const
+{
+    if( !m_nHorizontalMetrics ) {
+        return 0;
+    }
+
+    // the glyphs after the last metric share its advance
+    const auto index = min( glyph, m_nHorizontalMetrics - 1 );
+    return U16( m_Hmtx.nOffset + index * 4 );
+}
+
+bool CTrueTypeFont::GetBounds( uint32_t glyph, array< int32_t, 4 >& bounds ) const
+{
+    uint32_t offset, length;
+    if( !GetGlyphData( glyph, offset, length ) ) {
+        return false;
+    }
+
+    bounds = { { S16( offset + 2 ), S16( offset + 4 ), S16( offset + 6 ), S16( offset + 8 ) } };
+    return bounds[ 0 ] < bounds[ 2 ] && bounds[ 1 ] < bounds[ 3 ];
+}
+
+bool CTrueTypeFont::GetOutline( uint32_t glyph, vector< OutlinePoint >& cPoints, vector< size_t >& cContours ) const
+{
+    cPoints.clear();
+    cContours.clear();
+    const array< float, 6 > identity = { { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f } };
+    return AddOutline( glyph, identity, 0, cPoints, cContours ) && !cContours.empty();
+}
+
+bool CTrueTypeFont::IsLoaded( void ) const
+{
+    return m_nUnitsPerEm != 0;
+}
+
+int32_t CTrueTypeFont::GetUnitsPerEm( void ) const
+{
+    return m_nUnitsPerEm;
+}
+
+int32_t CTrueTypeFont::GetAscender( void ) const
+{
+    return m_nAscender;
+}
+
+int32_t CTrueTypeFont::GetDescender( void ) const
+{
+    return m_nDescender;
+}
+
+int32_t CTrueTypeFont::GetLineGap( void ) const
+{
+    return m_nLineGap;
+}
+
+bool CTrueTypeFont::Parse( void )
+{
+    // TrueType outlines (0x00010000 or 'true'), no CFF and no collections
+    const auto version = U32( 0 );
+    if( version != 0x00010000 && version != 0x74727565 ) {
+        return false;
+    }
+
+    const auto head = FindTable( "head" );
+    const auto maxp = FindTable( "maxp" );
+    const auto hhea = FindTable( "hhea" );
+    m_Hmtx = FindTable( "hmtx" );
+    m_Loca = FindTable( "loca" );
+    m_Glyf = FindTable( "glyf" );
+    if( head.nLength < 54 || maxp.nLength < 6 || hhea.nLength < 36 || !m_Hmtx.nLength || !m_Loca.nLength || !m_Glyf.nLength ) {
+        return false;
+    }
+
+    m_nUnitsPerEm = U16( head.nOffset + 18 );
+    m_bLongLoca = S16( head.nOffset + 50 ) != 0;
+    m_nGlyphs = U16( maxp.nOffset + 4 );
+    m_nAscender = S16( hhea.nOffset + 4 );
+    m_nDescender = S16( hhea.nOffset + 6 );
+    m_nLineGap = S16( hhea.nOffset + 8 );
+    m_nHorizontalMetrics = U16( hhea.nOffset + 34 );
+    if( !m_nUnitsPerEm || !m_nGlyphs || !m_nHorizontalMetrics || m_nHorizontalMetrics > m_nGlyphs ) {
+        return false;
+    }
+
+    // a truncated table would make the reads run into the following ones,
+    // every table has to be as long as its counts say
+    const uint64_t metrics = 4ull * m_nHorizontalMetrics + 2ull * ( m_nGlyphs - m_nHorizontalMetrics );
+    const uint64_t locations = ( m_nGlyphs + 1ull ) * ( m_bLongLoca ? 4 : 2 );
+    if( m_Hmtx.nLength < metrics || m_Loca.nLength < locations ) {
+        return false;
+    }
+    const auto glyfEnd = m_bLongLoca ? U32( m_Loca.nOffset + m_nGlyphs * 4 ) : U16( m_Loca.nOffset + m_nGlyphs * 2 ) * 2u;
+    if( glyfEnd > m_Glyf.nLength ) {
+        return false;
+    }
+
+    // prefer the full unicode map, then the basic multilingual plane
+    const auto cmap = FindTable( "cmap" );
+    const auto records = U16( cmap.nOffset + 2 );
+    if( cmap.nLength < 4 || cmap.nLength < 4ull + 8ull * records ) {
+        return false;
+    }
+
+    m_nCmap = 0;
+    m_nCmapFormat = 0;
+    for( uint32_t i = 0; i < records; ++i ) {
+        const auto record = cmap.nOffset + 4 + i * 8;
+        const auto platform = U16( record );
+        const auto encoding = U16( record + 2 );
+        const auto offset = U32( record + 4 );
+        const auto subtable = cmap.nOffset + offset;
+        const auto format = U16( subtable );
+
+        // the length field moved with the 32 bit formats
+        uint64_t length = 0;
+        if( format < 8 ) {
+            length = U16( subtable + 2 );
+        }
+        else {
+            length = format == 14 ? U32( subtable + 2 ) : U32( subtable + 4 );
+        }
+        if( offset > cmap.nLength || length < 4 || length > cmap.nLength - offset ) {
+            return false;
+        }
+        if( ( format == 4 && length < 16ull + 4ull * U16( subtable + 6 ) ) ||
+            ( format == 12 && length < 16ull + 12ull * U32( subtable + 12 ) ) ) {
+            return false;
+        }
+
+        const auto unicode = platform == 0 || ( platform == 3 && ( encoding == 1 || encoding == 10 ) );
+        if( !unicode || ( format != 4 && format != 12 ) || m_nCmapFormat == 12 ) {
+            continue;
+        }
+        m_nCmap = subtable;
+        m_nCmapFormat = format;
+    }
+    return true;
+}
+
+CTrueTypeFont::Table CTrueTypeFont::FindTable( const char* tag ) const
+{
+    Table table;
+    const auto count = U16( 4 );
+    for( uint32_t i = 0; i < count; ++i ) {
+        const auto record = 12 + i * 16;
+        if( record + 16 > m_cData.size() || memcmp( m_cData.data() + record, tag, 4 ) != 0 ) {
+            continue;
+        }
+
+        table.nOffset = U32( record + 8 );
+        table.nLength = U32( record + 12 );
+        if( table.nOffset > m_cData.size() || table.nLength > m_cData.size() - table.nOffset ) {
+            table = Table();
+        }
+        break;
+    }
+    return table;
+}
+
+bool CTrueTypeFont::GetGlyphData( uint32_t glyph, uint32_t& offset, uint32_t& length ) const
+{
+    if( glyph >= m_nGlyphs ) {
+        return false;
+    }
+
+    uint32_t begin, end;
+    if( m_bLongLoca ) {
+        begin = U32( m_Loca.nOffset + glyph * 4 );
+        end = U32( m_Loca.nOffset + glyph * 4 + 4 );
+    }
+    else {
+        begin = U16( m_Loca.nOffset + glyph * 2 ) * 2u;
+        end = U16( m_Loca.nOffset + glyph * 2 + 2 ) * 2u;
+    }
+
+    // glyphs without outline (e.g. the space) have no data
+    if( end <= begin || end - begin < 10 || end > m_Glyf.nLength ) {
+        return false;
+    }
+    offset = m_Glyf.nOffset + begin;
+    length = end - begin;
+    return true;
+}
+
+bool CTrueTypeFont::AddOutline( uint32_t glyph, const array< float, 6 >& matrix, int32_t depth, vector< OutlinePoint >& cPoints, vector< size_t >& cContours ) const
+{
+    uint32_t offset, length;
+    if( depth > MAX_COMPOSITE_DEPTH || !GetGlyphData( glyph, offset, length ) ) {
+        return false;
+    }
+
+    const auto contours = S16( offset );
+    if( contours < 0 ) {
+        // every component is another glyph placed by an affine transform
+        auto component = offset + 10;
+        uint16_t flags;
+        do {
+            flags = U16( component );
+            const auto child = U16( component + 2 );
+            component += 4;
+
+            float dx = 0.f, dy = 0.f;
+            if( flags & ARGS_ARE_WORDS ) {
+                dx = S16( component );
+                dy = S16( component + 2 );
+                component += 4;
+            }
+            else {
+                dx = static_cast< int8_t >( U8( component ) );
+                dy = static_cast< int8_t >( U8( component + 1 ) );
+                component += 2;
+            }
+            if( !( flags & ARGS_ARE_XY ) ) {
+                // anchor point matching is not supported
+                dx = dy = 0.f;
+            }
+
+            array< float, 6 > local = { { 1.f, 0.f, 0.f, 1.f, dx, dy } };
+            if( flags & HAS_SCALE ) {
+                local[ 0 ] = local[ 3 ] = F2Dot14( S16( component ) );
+                component += 2;
+            }
+            else if( flags & HAS_XY_SCALE ) {
+                local[ 0 ] = F2Dot14( S16( component ) );
+                local[ 3 ] = F2Dot14( S16( component + 2 ) );
+                component += 4;
+            }
+            else if( flags & HAS_TWO_BY_TWO ) {
+                local[ 0 ] = F2Dot14( S16( component ) );
+                local[ 1 ] = F2Dot14( S16( component + 2 ) );
+                local[ 2 ] = F2Dot14( S16( component + 4 ) );
+                local[ 3 ] = F2Dot14( S16( component + 6 ) );
+                component += 8;
+            }
+
+            // the component transform is applied before the parent one
+            const array< float, 6 > combined = { {
+                local[ 0 ] * matrix[ 0 ] + local[ 1 ] * matrix[ 2 ],
+                local[ 0 ] * matrix[ 1 ] + local[ 1 ] * matrix[ 3 ],
+                local[ 2 ] * matrix[ 0 ] + local[ 3 ] * matrix[ 2 ],
+                local[ 2 ] * matrix[ 1 ] + local[ 3 ] * matrix[ 3 ],
+                local[ 4 ] * matrix[ 0 ] + local[ 5 ] * matrix[ 2 ] + matrix[ 4 ],
+                local[ 4 ] * matrix[ 1 ] + local[ 5 ] * matrix[ 3 ] + matrix[ 5 ]
+            } };
+            AddOutline( child, combined, depth + 1, cPoints, cContours );
+        } while( ( flags & MORE_COMPONENTS ) && component < offset + length );
+        return true;
+    }
+
+    const auto ends = offset + 10;
+    const auto points = contours ? static_cast< uint32_t >( U16( ends + ( contours - 1 ) * 2 ) ) + 1 : 0;
+    auto cursor = ends + contours * 2;
+    cursor += 2 + U16( cursor );
+    if( cursor > offset + length ) {
+        return false;
+    }
+
+    // flags with their repeat counts, then the delta encoded coordinates
+    const auto first = cPoints.size();
+    cPoints.resize( first + points );
+    vector< uint8_t > cFlags( points );
+    for( uint32_t i = 0; i < points; ) {
+        const auto flag = U8( cursor++ );
+        auto repeat = ( flag & REPEAT ) ? U8( cursor++ ) + 1u : 1u;
+        while( repeat-- && i < points ) {
+            cFlags[ i++ ] = flag;
+        }
+    }
+
+    int32_t value = 0;
+    for( uint32_t i = 0; i < points; ++i ) {
+        if( cFlags[ i ] & X_SHORT ) {
+            const auto delta = U8( cursor++ );
+            value += ( cFlags[ i ] & X_SAME ) ? delta : -delta;
+        }
+        else if( !( cFlags[ i ] & X_SAME ) ) {
+            value += S16( cursor );
+            cursor += 2;
+        }
+        cPoints[ first + i ].x = static_cast< float >( value );
+    }
+
+    value = 0;
+    for( uint32_t i = 0; i < points; ++i ) {
+        if( cFlags[ i ] & Y_SHORT ) {
+            const auto delta = U8( cursor++ );
+            value += ( cFlags[ i ] & Y_SAME ) ? delta : -delta;
+        }
+        else if( !( cFlags[ i ] & Y_SAME ) ) {
+            value += S16( cursor );
+            cursor += 2;
+        }
+
+        auto& point = cPoints[ first + i ];
+        const auto x = point.x, y = static_cast< float >( value );
+        point.x = x * matrix[ 0 ] + y * matrix[ 2 ] + matrix[ 4 ];
+        point.y = x * matrix[ 1 ] + y * matrix[ 3 ] + matrix[ 5 ];
+        point.bOnCurve = ( cFlags[ i ] & ON_CURVE ) != 0;
+    }
+
+    size_t previous = 0;
+    for( int32_t i = 0; i < contours; ++i ) {
+        const auto end = min< size_t >( U16( ends + i * 2 ) + 1u, points );
+        if( end > previous ) {
+            cContours.push_back( first + end );
+            previous = end;
+        }
+    }
+    return true;
+}
+
+uint8_t CTrueTypeFont::U8( size_t offset ) const
+{
+    return offset < m_cData.size() ? m_cData[ offset ] : 0;
+}
+
+uint16_t CTrueTypeFont::U16( size_t offset ) const
+{
+    return static_cast< uint16_t >( U8( offset ) << 8 | U8( offset + 1 ) );
+}
+
+int16_t CTrueTypeFont::S16( size_t offset ) const
+{
+    return static_cast< int16_t >( U16( offset ) );
+}
+
+uint32_t CTrueTypeFont::U32( size_t offset ) const
+{
+    return static_cast< uint32_t >( U16( offset ) ) << 16 | U16( offset + 2 );
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Point of a glyph outline in font units, y points up
+     */
+    struct OutlinePoint
+    {
+        float x;
+        float y;
+        bool  bOnCurve;
+    };
+
+    /**
+     * @brief      CTrueTypeFont reads the glyph outlines and horizontal
+     *             metrics of a TrueType font (glyf outlines, cmap format 4
+     *             and 12). Hinting, kerning and CFF outlines are not
+     *             supported. A file whose tables are shorter than their
+     *             counts say is rejected, every other read is bounds checked
+     *             and a broken glyph is only empty.
+     */
+    class CTrueTypeFont
+    {
+    public:
+        CTrueTypeFont( void ) = default;
+
+        /**
+         * @brief      Load a font file
+         *
+         * @param[in]  path  path of a .ttf file
+         *
+         * @return     bool <> false if the file couldn't be read, is no
+         *             TrueType font or is truncated
+         */
+        bool     Load( const string& path );
+
+        /**
+         * @brief      Load a font from memory
+         *
+         * @param[in]  data  content of a .ttf file
+         *
+         * @return     bool <> false if the data is no TrueType font or is
+         *             truncated
+         */
+        bool     Load( vector< uint8_t > data );
+
+        /**
+         * @brief      Get the glyph of a unicode code point
+         *
+         * @param[in]  codepoint  code point
+         *
+         * @return     uint32_t <> 0 (the missing glyph) if the font has none
+         */
+        uint32_t GetGlyph( uint32_t codepoint ) const;
+
+        /**
+         * @brief      Get the horizontal advance of a glyph
+         *
+         * @param[in]  glyph  glyph index
+         *
+         * @return     int32_t <> advance in font units
+         */
+        int32_t  GetAdvance( uint32_t glyph ) const;
+
+        /**
+         * @brief      Get the bounding box of a glyph
+         *
+         * @param[in]  glyph   glyph index
+         * @param[out] bounds  xMin, yMin, xMax, yMax in font units
+         *
+         * @return     bool <> false if the glyph has no outline
+         */
+        bool     GetBounds( uint32_t glyph, array< int32_t, 4 >& bounds ) const;
+
+        /**
+         * @brief      Get the outline of a glyph, composite glyphs are resolved
+         *
+         * @param[in]  glyph      glyph index
+         * @param[out] cPoints    points of every contour
+         * @param[out] cContours  index after the last point of every contour
+         *
+         * @return     bool <> false if the glyph has no outline
+         */
+        bool     GetOutline( uint32_t glyph, vector< OutlinePoint >& cPoints, vector< size_t >& cContours ) const;
+
+        /**
+         * @brief      Walk the segments of an outline. Off-curve points
+         *             between two others imply an on-curve point in the
+         *             middle.
+         *
+         * @param[in]  cPoints    points of every contour
+         * @param[in]  cContours  index after the last point of every contour
+         * @param[in]  fnLine     void( const OutlinePoint& p0, const OutlinePoint& p1 )
+         * @param[in]  fnQuad     void( const OutlinePoint& p0, const OutlinePoint& p1, const OutlinePoint& p2 )
+         */
+        template< typename TLine, typename TQuad >
+        static void ForEachSegment( const vector< OutlinePoint >& cPoints, const vector< size_t >& cContours, TLine&& fnLine, TQuad&& fnQuad );
+
+        bool     IsLoaded( void ) const;
+        int32_t  GetUnitsPerEm( void ) const;
+        int32_t  GetAscender( void ) const;
+        int32_t  GetDescender( void ) const;
+        int32_t  GetLineGap( void ) const;
+
+    private:
+        struct Table
+        {
+            uint32_t nOffset = 0;
+            uint32_t nLength = 0;
+        };
+
+        bool     Parse( void );
+        Table    FindTable( const char* tag ) const;
+        bool     GetGlyphData( uint32_t glyph, uint32_t& offset, uint32_t& length ) const;
+        bool     AddOutline( uint32_t glyph, const array< float, 6 >& matrix, int32_t depth, vector< OutlinePoint >& cPoints, vector< size_t >& cContours ) const;
+
+        uint8_t  U8( size_t offset ) const;
+        uint16_t U16( size_t offset ) const;
+        int16_t  S16( size_t offset ) const;
+        uint32_t U32( size_t offset ) const;
+
+    private:
+        vector< uint8_t > m_cData;
+        Table             m_Glyf;
+        Table             m_Loca;
+        Table             m_Hmtx;
+        uint32_t          m_nCmap = 0;
+        uint16_t          m_nCmapFormat = 0;
+        uint32_t          m_nGlyphs = 0;
+        uint32_t          m_nHorizontalMetrics = 0;
+        int32_t           m_nUnitsPerEm = 0;
+        int32_t           m_nAscender = 0;
+        int32_t           m_nDescender = 0;
+        int32_t           m_nLineGap = 0;
+        bool              m_bLongLoca = false;
+    };
+
+    template< typename TLine, typename TQuad >
+    void CTrueTypeFont::ForEachSegment( const vector< OutlinePoint >& cPoints, const vector< size_t >& cContours, TLine&& fnLine, TQuad&& fnQuad )
+    {
+        const auto middle = []( const OutlinePoint& a, const OutlinePoint& b ) {
+            return OutlinePoint{ 0.5f * ( a.x + b.x ), 0.5f * ( a.y + b.y ), true };
+        };
+
+        size_t first = 0;
+        for( const auto end : cContours ) {
+            const auto count = end - first;
+            if( count < 2 ) {
+                first = end;
+                continue;
+            }
+
+            // start on an on-curve point, or between two off-curve ones
+            size_t on = 0;
+            while( on < count && !cPoints[ first + on ].bOnCurve ) {
+                ++on;
+            }
+            const auto found = on < count;
+            const auto origin = found ? cPoints[ first + on ] : middle( cPoints[ end - 1 ], cPoints[ first ] );
+            const auto start = found ? on + 1 : 0;
+            const auto visits = found ? count - 1 : count;
+
+            auto current = origin;
+            auto control = origin;
+            auto pending = false;
+            for( size_t i = 0; i <= visits; ++i ) {
+                const auto& point = i == visits ? origin : cPoints[ first + ( start + i ) % count ];
+                if( point.bOnCurve ) {
+                    if( pending ) {
+                        fnQuad( current, control, point );
+                    }
+                    else {
+                        fnLine( current, point );
+                    }
+                    current = point;
+                    pending = false;
+                }
+                else {
+                    if( pending ) {
+                        const auto implied = middle( control, point );
+                        fnQuad( current, control, implied );
+                        current = implied;
+                    }
+                    control = point;
+                    pending = true;
+                }
+            }
+            first = end;
+        }
+    }
+}
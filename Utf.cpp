@@ -0,0 +1,182 @@
+#include "Utf.hpp"
+#include "Simd.hpp"
+#include <cstdint>
+using namespace haze;
+
+namespace {
+    constexpr wchar_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+    /**
+     * @brief      Widen whole blocks of ASCII characters
+     *
+     * @return     size_t <> amount of converted bytes
+     */
+    size_t WidenAscii( const uint8_t* src, size_t length, wchar_t* dst )
+    {
+        size_t i = 0;
+#if !defined( HAZE_SSE2 )
+        // without vector paths every byte goes through the scalar loop
+        ( void )src;
+        ( void )length;
+        ( void )dst;
+#endif
+#if defined( HAZE_AVX2 )
+        for( ; i + 32 <= length; i += 32 ) {
+            auto v = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( src + i ) );
+            if( _mm256_movemask_epi8( v ) ) {
+                break;
+            }
+
+            auto lo = _mm256_castsi256_si128( v );
+            auto hi = _mm256_extracti128_si256( v, 1 );
+            if( sizeof( wchar_t ) == 2 ) {
+                _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i ), _mm256_cvtepu8_epi16( lo ) );
+                _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i + 16 ), _mm256_cvtepu8_epi16( hi ) );
+            }
+            else {
+                _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i ), _mm256_cvtepu8_epi32( lo ) );
+                _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i + 8 ), _mm256_cvtepu8_epi32( _mm_srli_si128( lo, 8 ) ) );
+                _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i + 16 ), _mm256_cvtepu8_epi32( hi ) );
+                _mm256_storeu_si256( reinterpret_cast< __m256i* >( dst + i + 24 ), _mm256_cvtepu8_epi32( _mm_srli_si128( hi, 8 ) ) );
+            }
+        }
+#endif
+#if defined( HAZE_SSE2 )
+        const auto zero = _mm_setzero_si128();
+        for( ; i + 16 <= length; i += 16 ) {
+            auto v = _mm_loadu_si128( reinterpret_cast< const __m128i* >( src + i ) );
+            if( _mm_movemask_epi8( v ) ) {
+                break;
+            }
+
+            auto lo = _mm_unpacklo_epi8( v, zero );
+            auto hi = _mm_unpackhi_epi8( v, zero );
+            if( sizeof( wchar_t ) == 2 ) {
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( dst + i ), lo );
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( dst + i + 8 ), hi );
+            }
+            else {
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( dst + i ), _mm_unpacklo_epi16( lo, zero ) );
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( dst + i + 4 ), _mm_unpackhi_epi16( lo, zero ) );
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( dst + i + 8 ), _mm_unpacklo_epi16( hi, zero ) );
+                _mm_storeu_si128( reinterpret_cast< __m128i* >( dst + i + 12 ), _mm_unpackhi_epi16( hi, zero ) );
+            }
+        }
+#endif
+        return i;
+    }
+
+    bool IsContinuation( uint8_t c )
+    {
+        return ( c & 0xC0 ) == 0x80;
+    }
+
+    /**
+     * @brief      Decode a single multi-byte sequence. On failure the lead
+     *             byte and every valid continuation byte are consumed
+     *             (maximal subpart), as recommended by the unicode standard.
+     *
+     * @return     bool <> false if the sequence is invalid
+     */
+    bool DecodeSequence( const uint8_t* src, size_t length, uint32_t& codepoint, size_t& consumed )
+    {
+        const auto lead = src[ 0 ];
+
+        size_t  count;
+        uint8_t lower = 0x80, upper = 0xBF;
+        if( lead >= 0xC2 && lead <= 0xDF ) {
+            count = 2;
+            codepoint = lead & 0x1F;
+        }
+        else if( lead >= 0xE0 && lead <= 0xEF ) {
+            count = 3;
+            codepoint = lead & 0x0F;
+            if( lead == 0xE0 ) {
+                lower = 0xA0;
+            }
+            else if( lead == 0xED ) {
+                upper = 0x9F;
+            }
+        }
+        else if( lead >= 0xF0 && lead <= 0xF4 ) {
+            count = 4;
+            codepoint = lead & 0x07;
+            if( lead == 0xF0 ) {
+                lower = 0x90;
+            }
+            else if( lead == 0xF4 ) {
+                upper = 0x8F;
+            }
+        }
+        else {
+            codepoint = REPLACEMENT_CHARACTER;
+            consumed = 1;
+            return false;
+        }
+
+        for( size_t i = 1; i < count; ++i ) {
+            const auto c = i < length ? src[ i ] : 0;
+            if( i == 1 ? ( c < lower || c > upper ) : !IsContinuation( c ) ) {
+                codepoint = REPLACEMENT_CHARACTER;
+                consumed = i;
+                return false;
+            }
+            codepoint = ( codepoint << 6 ) | ( c & 0x3F );
+        }
+
+        consumed = count;
+        return true;
+    }
+}
+
+size_t haze::Utf8ToUtf16( const char* src, size_t length, wchar_t* dst, bool* valid )
+{
+    auto* pSrc = reinterpret_cast< const uint8_t* >( src );
+    auto result = true;
+
+    size_t i = 0, o = 0;
+    while( i < length ) {
+        const auto ascii = WidenAscii( pSrc + i, length - i, dst + o );
+        i += ascii;
+        o += ascii;
+
+        // finish the block which stopped the fast path
+        for( const auto end = i + 16; i < length && i < end; ) {
+            if( pSrc[ i ] < 0x80 ) {
+                dst[ o++ ] = static_cast< wchar_t >( pSrc[ i++ ] );
+                continue;
+            }
+
+            uint32_t codepoint;
+            size_t   consumed;
+            result &= DecodeSequence( pSrc + i, length - i, codepoint, consumed );
+            i += consumed;
+
+            if( codepoint >= 0x10000 ) {
+                codepoint -= 0x10000;
+                dst[ o++ ] = static_cast< wchar_t >( 0xD800 + ( codepoint >> 10 ) );
+                dst[ o++ ] = static_cast< wchar_t >( 0xDC00 + ( codepoint & 0x3FF ) );
+            }
+            else {
+                dst[ o++ ] = static_cast< wchar_t >( codepoint );
+            }
+        }
+    }
+
+    if( valid ) {
+        *valid = result;
+    }
+    return o;
+}
+
+bool haze::Utf8ToUtf16( const char* src, size_t length, wstring& buffer )
+{
+    // utf-16 never needs more units than utf-8 needs bytes
+    if( buffer.size() < length ) {
+        buffer.resize( length );
+    }
+
+    bool valid;
+    buffer.resize( Utf8ToUtf16( src, length, &buffer[ 0 ], &valid ) );
+    return valid;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace haze {
+    using namespace std;
+
+    /**
+     * @brief      Convert utf-8 to utf-16. ASCII runs are widened with
+     *             SSE2/AVX2, everything else goes through a validating
+     *             scalar decoder. Invalid sequences become U+FFFD.
+     *
+     * @param[in]  src     utf-8 string
+     * @param[in]  length  length in bytes
+     * @param[out] dst     output buffer, has to hold at least length units
+     * @param[out] valid   optional, false if an invalid sequence was found
+     *
+     * @return     size_t <> amount of written utf-16 units
+     */
+    size_t Utf8ToUtf16( const char* src, size_t length, wchar_t* dst, bool* valid = nullptr );
+
+    /**
+     * @brief      Convert utf-8 to utf-16 into a reusable buffer. The buffer
+     *             keeps its capacity, so converting into a warmed up buffer
+     *             does not allocate.
+     *
+     * @param[in]  src     utf-8 string
+     * @param[in]  length  length in bytes
+     * @param[out] buffer  output buffer
+     *
+     * @return     bool <> false if an invalid sequence was found
+     */
+    bool Utf8ToUtf16( const char* src, size_t length, wstring& buffer );
+}
@@ -0,0 +1,120 @@
+#include "Benchmark.hpp"
+#include "CommandList.hpp"
+#include "RectBatcher.hpp"
+#include "RenderBackend.hpp"
+#include "SoftwareBackend.hpp"
+#include "Surface.hpp"
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr size_t PRIMITIVES = 100000;
+}
+
+int main( void )
+{
+    vector< ColoredRect > rects;
+    vector< ColoredLine > lines;
+    vector< ColoredBorderBox > boxes;
+    for( size_t i = 0; i < PRIMITIVES; ++i ) {
+        const auto x = static_cast< float >( i % 300 ) * 6.f;
+        const auto y = static_cast< float >( i / 300 % 150 ) * 7.f;
+        const auto color = i % 2 ? Color( 255, 64, 0, 255 ) : Color( 0, 128, 255, 255 );
+        rects.push_back( { x, y, 4.f, 5.f, color } );
+        lines.push_back( { x, y, x + 4.f, y + 5.f, 1.f, color } );
+        boxes.push_back( { x, y, 4.f, 5.f, 1.f, color } );
+    }
+
+    CCountingRenderBackend counting( 1920, 1080 );
+    CRenderSurface surface( &counting );
+    CCommandList list;
+
+    // times per primitive, the counting backend leaves only the call overhead
+    bench::Run( "counting: single rects", PRIMITIVES, [ & ] {
+        for( const auto& rect : rects ) {
+            surface.Rect( rect.x, rect.y, rect.w, rect.h, rect.color );
+        }
+        bench::Use( counting.GetDrawCalls() );
+    } );
+    bench::Run( "counting: Rects", PRIMITIVES, [ & ] {
+        surface.Rects( rects.data(), rects.size() );
+        bench::Use( counting.GetDrawCalls() );
+    } );
+    bench::Run( "counting: single lines", PRIMITIVES, [ & ] {
+        for( const auto& line : lines ) {
+            surface.Line( line.x, line.y, line.xx, line.yy, line.thickness, line.color );
+        }
+        bench::Use( counting.GetDrawCalls() );
+    } );
+    bench::Run( "counting: Lines", PRIMITIVES, [ & ] {
+        surface.Lines( lines.data(), lines.size() );
+        bench::Use( counting.GetDrawCalls() );
+    } );
+    bench::Run( "counting: single border boxes", PRIMITIVES, [ & ] {
+        for( const auto& box : boxes ) {
+            surface.BorderBox( box.x, box.y, box.w, box.h, box.thickness, box.color );
+        }
+        bench::Use( counting.GetDrawCalls() );
+    } );
+    bench::Run( "counting: BorderBoxes", PRIMITIVES, [ & ] {
+        surface.BorderBoxes( boxes.data(), boxes.size() );
+        bench::Use( counting.GetDrawCalls() );
+    } );
+
+    // recording into a command list
+    surface.SetCommandSink( &list );
+    bench::Run( "record: single rects", PRIMITIVES, [ & ] {
+        list.Reset();
+        for( const auto& rect : rects ) {
+            surface.Rect( rect.x, rect.y, rect.w, rect.h, rect.color );
+        }
+        bench::Use( list.size() );
+    } );
+    bench::Run( "record: Rects", PRIMITIVES, [ & ] {
+        list.Reset();
+        surface.Rects( rects.data(), rects.size() );
+        bench::Use( list.size() );
+    } );
+    bench::Run( "record: single border boxes", PRIMITIVES, [ & ] {
+        list.Reset();
+        for( const auto& box : boxes ) {
+            surface.BorderBox( box.x, box.y, box.w, box.h, box.thickness, box.color );
+        }
+        bench::Use( list.size() );
+    } );
+    bench::Run( "record: BorderBoxes", PRIMITIVES, [ & ] {
+        list.Reset();
+        surface.BorderBoxes( boxes.data(), boxes.size() );
+        bench::Use( list.size() );
+    } );
+
+    // replaying the recorded rectangles plainly and merged per color
+    list.Reset();
+    surface.Rects( rects.data(), rects.size() );
+    CRectBatcher batcher;
+    bench::Run( "replay: rects", PRIMITIVES, [ & ] {
+        list.Replay( counting );
+        bench::Use( counting.GetDrawCalls() );
+    } );
+    bench::Run( "replay: rects through CRectBatcher", PRIMITIVES, [ & ] {
+        batcher.Submit( list, counting );
+        bench::Use( counting.GetDrawCalls() );
+    } );
+
+    // the software backend is bound by the pixels either way
+    CSoftwareBackend software( 1920, 1080 );
+    CRenderSurface softwareSurface( &software );
+    software.BeginFrame();
+    bench::Run( "software: single rects", PRIMITIVES, [ & ] {
+        for( const auto& rect : rects ) {
+            softwareSurface.Rect( rect.x, rect.y, rect.w, rect.h, rect.color );
+        }
+        bench::Use( software.GetPixels()[ 0 ] );
+    } );
+    bench::Run( "software: Rects", PRIMITIVES, [ & ] {
+        softwareSurface.Rects( rects.data(), rects.size() );
+        bench::Use( software.GetPixels()[ 0 ] );
+    } );
+    software.EndFrame();
+    return 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+
+namespace haze {
+    namespace bench {
+        /**
+         * @brief      Keep the compiler from dropping a computed value
+         */
+        template< typename T >
+        void Use( const T& value )
+        {
+            static volatile T sink;
+            sink = value;
+            ( void )sink;
+        }
+
+        /**
+         * @brief      Time a function and print the best time per operation.
+         *             The first run warms up caches and lazily built state,
+         *             the best of the following runs was the least disturbed.
+         *
+         * @param[in]  name        name of the measurement
+         * @param[in]  operations  operations done by one call of fn
+         * @param[in]  fn          measured function
+         */
+        template< typename Fn >
+        void Run( const char* name, size_t operations, Fn&& fn )
+        {
+            fn();
+
+            auto best = HUGE_VAL;
+            for( int run = 0; run < 7; ++run ) {
+                const auto start = std::chrono::steady_clock::now();
+                fn();
+                const std::chrono::duration< double, std::nano > elapsed = std::chrono::steady_clock::now() - start;
+                best = std::min( best, elapsed.count() / static_cast< double >( operations ) );
+            }
+            printf( "%-48s %12.2f ns\n", name, best );
+        }
+    }
+}
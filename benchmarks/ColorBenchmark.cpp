@@ -0,0 +1,115 @@
+#include "Benchmark.hpp"
+#include "Color.hpp"
+#include <algorithm>
+#include <array>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr size_t COLORS = 4096;
+    constexpr size_t REPEATS = 200;
+
+    /**
+     * @brief      Color as it was before the packed layout, four bytes behind
+     *             bounds checked accessors and a clamp per channel. The clamp
+     *             bounds are the right way round, so it computes the same
+     *             saturated sum as Color.
+     */
+    class CByteColor
+    {
+    public:
+        CByteColor( void ) = default;
+
+        explicit CByteColor( const Color& color ) :
+            m_cColor( color.get() )
+        {
+        }
+
+        CByteColor operator + ( const CByteColor& color ) const
+        {
+            CByteColor result;
+            for( size_t i = 0; i < 4; ++i ) {
+                result.m_cColor.at( i ) = Clamp( m_cColor.at( i ) + color.m_cColor.at( i ) );
+            }
+            return result;
+        }
+
+        uint32_t packed( void ) const
+        {
+            return Color( m_cColor ).packed();
+        }
+
+    private:
+        template< typename T >
+        static byte Clamp( T value )
+        {
+            auto i = static_cast< int32_t >( value );
+            i = max( i, 0x00 );
+            i = min( i, 0xFF );
+            return static_cast< byte >( i );
+        }
+
+    private:
+        array< byte, 4 > m_cColor = {};
+    };
+}
+
+int main( void )
+{
+    vector< Color > a, b, result( COLORS );
+    uint32_t seed = 1;
+    for( size_t i = 0; i < COLORS; ++i ) {
+        seed = seed * 1664525u + 1013904223u;
+        a.push_back( Color( static_cast< int32_t >( seed & 0xFF ), static_cast< int32_t >( seed >> 8 & 0xFF ), static_cast< int32_t >( seed >> 16 & 0xFF ), static_cast< int32_t >( seed >> 24 ) ) );
+        b.push_back( Color( static_cast< int32_t >( seed >> 24 ), static_cast< int32_t >( seed >> 16 & 0xFF ), static_cast< int32_t >( seed >> 8 & 0xFF ), static_cast< int32_t >( seed & 0xFF ) ) );
+    }
+
+    vector< CByteColor > byte_a, byte_b, byte_result( COLORS );
+    for( size_t i = 0; i < COLORS; ++i ) {
+        byte_a.emplace_back( a[ i ] );
+        byte_b.emplace_back( b[ i ] );
+    }
+
+    // times per color
+    bench::Run( "array< byte, 4 > operator +", COLORS * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            for( size_t i = 0; i < COLORS; ++i ) {
+                byte_result[ i ] = byte_a[ i ] + byte_b[ i ];
+            }
+        }
+        bench::Use( byte_result[ 0 ].packed() );
+    } );
+    bench::Run( "operator +", COLORS * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            for( size_t i = 0; i < COLORS; ++i ) {
+                result[ i ] = a[ i ] + b[ i ];
+            }
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    bench::Run( "Color::Add", COLORS * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            Color::Add( a.data(), b.data(), result.data(), COLORS );
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    bench::Run( "Color::Lerp", COLORS * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            Color::Lerp( a.data(), b.data(), 0.3f, result.data(), COLORS );
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    bench::Run( "Color::Blend", COLORS * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            Color::Blend( a.data(), b.data(), result.data(), COLORS );
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    bench::Run( "Color::Premultiply", COLORS * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            Color::Premultiply( a.data(), result.data(), COLORS );
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    return 0;
+}
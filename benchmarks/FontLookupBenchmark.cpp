@@ -0,0 +1,48 @@
+#include "Benchmark.hpp"
+#include "RenderBackend.hpp"
+#include "Surface.hpp"
+#include <string>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr size_t LOOKUPS = 1000000;
+    constexpr size_t STRINGS = 100000;
+}
+
+int main( void )
+{
+    // a typical overlay registers a handful of fonts
+    CCountingRenderBackend backend( 1920, 1080 );
+    const vector< string > cNames = { "Consolas 12", "Consolas 14", "Consolas 16", "Consolas 20", "Verdana 12", "Verdana 14", "Verdana 18", "Title" };
+    vector< FontHandle > cHandles;
+    for( const auto& name : cNames ) {
+        backend.RegisterFont( name );
+        cHandles.push_back( backend.GetFontHandle( name ) );
+    }
+
+    bench::Run( "GetFont( name )", LOOKUPS, [ & ] {
+        for( size_t i = 0; i < LOOKUPS; ++i ) {
+            bench::Use( backend.GetFont( cNames[ i % cNames.size() ] ) );
+        }
+    } );
+    bench::Run( "GetFont( handle )", LOOKUPS, [ & ] {
+        for( size_t i = 0; i < LOOKUPS; ++i ) {
+            bench::Use( backend.GetFont( cHandles[ i % cHandles.size() ] ) );
+        }
+    } );
+
+    // the whole string call, the counting backend does not draw anything
+    CRenderSurface surface( &backend );
+    bench::Run( "String by name", STRINGS, [ & ] {
+        for( size_t i = 0; i < STRINGS; ++i ) {
+            surface.String( 10.f, 10.f, cNames[ i % cNames.size() ], Color( 255, 255, 255, 255 ), "fps: %d", 60 );
+        }
+    } );
+    bench::Run( "String by handle", STRINGS, [ & ] {
+        for( size_t i = 0; i < STRINGS; ++i ) {
+            surface.String( 10.f, 10.f, cHandles[ i % cHandles.size() ], Color( 255, 255, 255, 255 ), "fps: %d", 60 );
+        }
+    } );
+    return 0;
+}
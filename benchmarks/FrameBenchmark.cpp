@@ -0,0 +1,60 @@
+#include "Benchmark.hpp"
+#include "SoftwareBackend.hpp"
+#include <cstdio>
+using namespace haze;
+
+namespace {
+    constexpr int32_t WIDTH = 1920;
+    constexpr int32_t HEIGHT = 1080;
+    constexpr size_t PANELS = 12;
+
+    /**
+     * @brief      Outlined panels like a debug overlay draws them, each one
+     *             either as a frame or as the old fill and the inset over it
+     */
+    void DrawPanels( CSoftwareBackend& backend, bool frame, uint32_t inner_color )
+    {
+        for( size_t i = 0; i < PANELS; ++i ) {
+            const auto x = 20.25f + static_cast< float >( i % 4 ) * 470.f, y = 30.5f + static_cast< float >( i / 4 ) * 340.f;
+            if( frame ) {
+                backend.FillRoundedFrame( x, y, 450.f, 320.f, 14.f, 14.f, 2.f, 12.f, 12.f, 0xFFE0E0E0, inner_color );
+            }
+            else {
+                backend.FillRoundedRect( x, y, 450.f, 320.f, 14.f, 14.f, 0xFFE0E0E0 );
+                backend.FillRoundedRect( x + 2.f, y + 2.f, 446.f, 316.f, 12.f, 12.f, inner_color );
+            }
+        }
+    }
+}
+
+int main( void )
+{
+    CSoftwareBackend backend( WIDTH, HEIGHT );
+
+    // times per panel, the tessellations are cached after the first run
+    for( const auto inner_color : { 0xFF202830u, 0xC0202830u } ) {
+        const auto opaque = ( inner_color >> 24 ) == 0xFF;
+        backend.BeginFrame();
+        bench::Run( opaque ? "fill and inset, opaque" : "fill and inset, translucent", PANELS, [ & ] {
+            DrawPanels( backend, false, inner_color );
+            bench::Use( backend.GetPixels()[ 0 ] );
+        } );
+        bench::Run( opaque ? "FillRoundedFrame, opaque" : "FillRoundedFrame, translucent", PANELS, [ & ] {
+            DrawPanels( backend, true, inner_color );
+            bench::Use( backend.GetPixels()[ 0 ] );
+        } );
+        backend.EndFrame();
+    }
+
+    // the pixel writes of one frame of each
+    backend.SetOverdrawCounter( true );
+    for( const auto frame : { false, true } ) {
+        backend.BeginFrame();
+        DrawPanels( backend, frame, 0xFF202830 );
+        const auto statistics = backend.GetOverdrawStatistics();
+        printf( "%-48s %12llu writes, %llu pixels\n", frame ? "FillRoundedFrame" : "fill and inset", static_cast< unsigned long long >( statistics.nPixelWrites ),
+                static_cast< unsigned long long >( statistics.nPixelsWritten ) );
+        backend.EndFrame();
+    }
+    return 0;
+}
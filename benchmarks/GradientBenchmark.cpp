@@ -0,0 +1,52 @@
+#include "Benchmark.hpp"
+#include "Gradient.hpp"
+#include <algorithm>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr size_t VALUES = 4096;
+    constexpr size_t REPEATS = 200;
+}
+
+int main( void )
+{
+    const GradientStop stops[] = { { 0.f, Color( 0, 0, 255, 255 ) }, { 0.5f, Color( 0, 255, 0, 255 ) }, { 1.f, Color( 255, 0, 0, 255 ) } };
+    CGradient gradient;
+    gradient.Build( stops, 3, GradientSpace::HSV, CGradient::LARGE_TABLE );
+    gradient.SetRange( 0.f, 100.f );
+
+    vector< float > values;
+    vector< Color > result( VALUES );
+    uint32_t seed = 1;
+    for( size_t i = 0; i < VALUES; ++i ) {
+        seed = seed * 1664525u + 1013904223u;
+        values.push_back( -10.f + 120.f * static_cast< float >( seed >> 8 ) / 16777216.f );
+    }
+
+    // times per value
+    bench::Run( "Color per value", VALUES * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            for( size_t i = 0; i < VALUES; ++i ) {
+                const auto t = min( max( values[ i ] / 100.f, 0.f ), 1.f );
+                result[ i ] = Color( static_cast< int32_t >( t * 255.f ), static_cast< int32_t >( ( 1.f - t ) * 255.f ), 0, 255 );
+            }
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    bench::Run( "CGradient::Map single", VALUES * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            for( size_t i = 0; i < VALUES; ++i ) {
+                result[ i ] = gradient.Map( values[ i ] );
+            }
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    bench::Run( "CGradient::Map batch", VALUES * REPEATS, [ & ] {
+        for( size_t repeat = 0; repeat < REPEATS; ++repeat ) {
+            gradient.Map( values.data(), VALUES, result.data() );
+        }
+        bench::Use( result[ 0 ].packed() );
+    } );
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "Benchmark.hpp"
+#include "SoftwareBackend.hpp"
+#include <string>
+using namespace haze;
+
+namespace {
+    constexpr size_t STRINGS = 20000;
+}
+
+int main( void )
+{
+    CSoftwareBackend backend( 1024, 512 );
+    const auto* pBoxes = backend.RegisterFont( "boxes", "Boxes", 16.f );
+    if( !backend.LoadFontFile( "DejaVu", HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf" ) ) {
+        fprintf( stderr, "no font\n" );
+        return 1;
+    }
+    const auto* pFont = backend.RegisterFont( "text", "DejaVu", 16.f );
+    backend.BeginFrame();
+
+    // 22 characters, as many a typical overlay line has
+    const wstring text = L"fps: 144  frame: 6.9ms";
+    auto draw = [ & ]( size_t count, const void* pTextFont, uint32_t color ) {
+        for( size_t i = 0; i < count; ++i ) {
+            const auto x = static_cast< float >( i % 7 ) * 100.f, y = static_cast< float >( i % 23 ) * 20.f;
+            backend.Text( x, y, 300.f, 24.f, text.c_str(), text.size(), pTextFont, color );
+        }
+    };
+
+    bench::Run( "Text as boxes", STRINGS, [ & ] { draw( STRINGS, pBoxes, 0xFFFFFFFF ); } );
+    bench::Run( "Text from the atlas, opaque", STRINGS, [ & ] { draw( STRINGS, pFont, 0xFFFFFFFF ); } );
+    bench::Run( "Text from the atlas, translucent", STRINGS, [ & ] { draw( STRINGS, pFont, 0x80FFFFFF ); } );
+
+    const Transform rotation = { 0.9659258f, 0.2588190f, -0.2588190f, 0.9659258f, 0.f, 0.f };
+    backend.SetTransform( rotation );
+    bench::Run( "Text from the outlines, rotated", STRINGS / 20, [ & ] { draw( STRINGS / 20, pFont, 0xFFFFFFFF ); } );
+    backend.SetTransform( Transform::Identity() );
+
+    backend.EndFrame();
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "Benchmark.hpp"
+#include "Utf.hpp"
+#include <codecvt>
+#include <locale>
+#include <string>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr size_t CONVERSIONS = 100000;
+
+    /**
+     * @brief      Time every conversion of a set of labels
+     */
+    void RunLabels( const char* name, const vector< string >& cLabels )
+    {
+        const auto prefix = string( name ) + ": ";
+
+        // the conversion String used before
+        wstring_convert< codecvt_utf8_utf16< wchar_t > > converter;
+        bench::Run( ( prefix + "wstring_convert" ).c_str(), CONVERSIONS, [ & ] {
+            for( size_t i = 0; i < CONVERSIONS; ++i ) {
+                bench::Use( converter.from_bytes( cLabels[ i % cLabels.size() ] ).size() );
+            }
+        } );
+
+        vector< wchar_t > buffer( 256 );
+        bench::Run( ( prefix + "Utf8ToUtf16 into a buffer" ).c_str(), CONVERSIONS, [ & ] {
+            for( size_t i = 0; i < CONVERSIONS; ++i ) {
+                const auto& label = cLabels[ i % cLabels.size() ];
+                bench::Use( Utf8ToUtf16( label.data(), label.size(), buffer.data() ) );
+            }
+        } );
+
+        wstring text;
+        bench::Run( ( prefix + "Utf8ToUtf16 into a wstring" ).c_str(), CONVERSIONS, [ & ] {
+            for( size_t i = 0; i < CONVERSIONS; ++i ) {
+                const auto& label = cLabels[ i % cLabels.size() ];
+                Utf8ToUtf16( label.data(), label.size(), text );
+                bench::Use( text.size() );
+            }
+        } );
+    }
+}
+
+int main( void )
+{
+    // times per label, like the labels an overlay draws every frame
+    const vector< string > cAscii = { "fps: 144 frame time: 6.94 ms", "Player Name [100 hp] 23.5 m", "CPU 12% GPU 87% VRAM 5231 MB used of 8192 MB total",
+                                      "x: 1024.50 y: -77.25 z: 310.00" };
+    const vector< string > cMixed = { u8"Spieler Überlänge 23,5 m → Ziel", u8"プレイヤー 100 hp ★", u8"Игрок [100 hp] 23.5 m",
+                                      u8"fps: 144 \U0001F3AE frame time: 6.94 ms" };
+    RunLabels( "ascii", cAscii );
+    RunLabels( "mixed", cMixed );
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "Check.hpp"
+#include "CommandList.hpp"
+#include "RectBatcher.hpp"
+#include "RenderBackend.hpp"
+#include "SoftwareBackend.hpp"
+#include "Surface.hpp"
+#include <cstring>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr size_t COUNT = 1000;
+
+    /**
+     * @brief      Primitives on a grid which do not touch each other, in two
+     *             colors and with a translucent one every seventh
+     */
+    struct Primitives
+    {
+        vector< ColoredRect >      cRects;
+        vector< ColoredLine >      cLines;
+        vector< ColoredBorderBox > cBoxes;
+    };
+
+    Primitives MakePrimitives( void )
+    {
+        Primitives primitives;
+        for( size_t i = 0; i < COUNT; ++i ) {
+            const auto x = static_cast< float >( i % 40 ) * 8.f + 0.5f;
+            const auto y = static_cast< float >( i / 40 ) * 9.f + 0.25f;
+            const auto color = i % 7 ? ( i % 2 ? Color( 255, 64, 0, 255 ) : Color( 0, 128, 255, 255 ) ) : Color( 255, 255, 255, 96 );
+            primitives.cRects.push_back( { x, y, 5.5f, 6.f, color } );
+            primitives.cLines.push_back( { x, y, x + 5.f, y + 6.f, 1.5f, color } );
+            primitives.cBoxes.push_back( { x, y, 5.f, 5.5f, 1.f, color } );
+        }
+        return primitives;
+    }
+
+    void TestDrawCalls( void )
+    {
+        const auto primitives = MakePrimitives();
+        CCountingRenderBackend backend( 320, 240 );
+        CRenderSurface surface( &backend );
+
+        // every batch is one draw call, however many primitives it holds
+        HAZE_CHECK( surface.Rects( primitives.cRects.data(), COUNT ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 1 );
+        HAZE_CHECK( backend.GetCounters().nBatchedRects == COUNT && !backend.GetCounters().nRects );
+
+        backend.Reset();
+        HAZE_CHECK( surface.Lines( primitives.cLines.data(), COUNT ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 1 );
+        HAZE_CHECK( backend.GetCounters().nBatchedLines == COUNT && !backend.GetCounters().nLines );
+
+        // a sink without a border box batch fills each box as one batch of its sides
+        backend.Reset();
+        HAZE_CHECK( surface.BorderBoxes( primitives.cBoxes.data(), COUNT ) );
+        HAZE_CHECK( backend.GetDrawCalls() == COUNT );
+        HAZE_CHECK( backend.GetCounters().nBatchedRects == 4 * COUNT );
+
+        // single calls are one draw call each
+        backend.Reset();
+        for( const auto& rect : primitives.cRects ) {
+            surface.Rect( rect.x, rect.y, rect.w, rect.h, rect.color );
+        }
+        HAZE_CHECK( backend.GetDrawCalls() == COUNT );
+
+        HAZE_CHECK( !surface.Rects( nullptr, 1 ) && !surface.Lines( nullptr, 1 ) && !surface.BorderBoxes( nullptr, 1 ) );
+        HAZE_CHECK( surface.Rects( primitives.cRects.data(), 0 ) );
+    }
+
+    void TestReplay( void )
+    {
+        const auto primitives = MakePrimitives();
+        CCountingRenderBackend backend( 320, 240 );
+        CCommandList list;
+        CRenderSurface surface( &backend );
+        surface.SetCommandSink( &list );
+
+        // a recorded batch is plain commands
+        HAZE_CHECK( surface.Rects( primitives.cRects.data(), COUNT ) );
+        HAZE_CHECK( surface.BorderBoxes( primitives.cBoxes.data(), COUNT ) );
+        HAZE_CHECK( surface.Lines( primitives.cLines.data(), COUNT ) );
+        HAZE_CHECK( list.size() == 6 * COUNT );
+        HAZE_CHECK( !backend.GetDrawCalls() );
+
+        HAZE_CHECK( list.Replay( backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 6 * COUNT );
+
+        // the batcher merges the rectangles of both batches per color, the
+        // translucent ones overlap and stay apart, the lines end the run
+        backend.Reset();
+        CRectBatcher batcher;
+        HAZE_CHECK( batcher.Submit( list, backend ) );
+        HAZE_CHECK( backend.GetCounters().nLines == COUNT );
+        HAZE_CHECK( backend.GetCounters().nBatchedRects + backend.GetCounters().nRects == 5 * COUNT );
+        HAZE_CHECK( batcher.GetCounters().nRects == 5 * COUNT );
+        HAZE_CHECK( backend.GetDrawCalls() - COUNT == batcher.GetCounters().nBatches );
+        HAZE_CHECK( batcher.GetCounters().nBatches < COUNT / 10 );
+    }
+
+    /**
+     * @brief      Draw every primitive of a batch on its own
+     */
+    void DrawSingle( CRenderSurface& surface, const Primitives& primitives )
+    {
+        for( const auto& rect : primitives.cRects ) {
+            surface.Rect( rect.x, rect.y, rect.w, rect.h, rect.color );
+        }
+        for( const auto& box : primitives.cBoxes ) {
+            surface.BorderBox( box.x, box.y, box.w, box.h, box.thickness, box.color );
+        }
+        for( const auto& line : primitives.cLines ) {
+            surface.Line( line.x, line.y, line.xx, line.yy, line.thickness, line.color );
+        }
+    }
+
+    void DrawBatched( CRenderSurface& surface, const Primitives& primitives )
+    {
+        surface.Rects( primitives.cRects.data(), COUNT );
+        surface.BorderBoxes( primitives.cBoxes.data(), COUNT );
+        surface.Lines( primitives.cLines.data(), COUNT );
+    }
+
+    void TestPixels( void )
+    {
+        const auto primitives = MakePrimitives();
+        const Transform transforms[] = { Transform::Identity(), { 2.f, 0.f, 0.f, -1.5f, 10.f, 230.f }, { 0.9659258f, 0.2588190f, -0.2588190f, 0.9659258f, 40.f, 0.f } };
+        for( const auto& transform : transforms ) {
+            CSoftwareBackend single( 320, 240 ), batched( 320, 240 );
+            single.SetClearColor( 0xFF102030 );
+            batched.SetClearColor( 0xFF102030 );
+            HAZE_CHECK( single.BeginFrame() && batched.BeginFrame() );
+            single.SetTransform( transform );
+            batched.SetTransform( transform );
+
+            CRenderSurface singleSurface( &single ), batchedSurface( &batched );
+            DrawSingle( singleSurface, primitives );
+            DrawBatched( batchedSurface, primitives );
+            HAZE_CHECK( single.EndFrame() && batched.EndFrame() );
+            HAZE_CHECK( memcmp( single.GetPixels(), batched.GetPixels(), 320 * 240 * sizeof( uint32_t ) ) == 0 );
+        }
+    }
+}
+
+int main( void )
+{
+    TestDrawCalls();
+    TestReplay();
+    TestPixels();
+    return test::GetResult();
+}
@@ -0,0 +1,226 @@
+#include "Check.hpp"
+#include "CallbackRegistry.hpp"
+#include "Delegate.hpp"
+#include <vector>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Captured state which counts its live copies
+     */
+    struct Counted
+    {
+        explicit Counted( int* pLive ) :
+            pLive( pLive )
+        {
+            ++*pLive;
+        }
+
+        Counted( const Counted& other ) :
+            pLive( other.pLive )
+        {
+            ++*pLive;
+        }
+
+        Counted( Counted&& other ) noexcept :
+            pLive( other.pLive )
+        {
+            ++*pLive;
+        }
+
+        ~Counted( void )
+        {
+            --*pLive;
+        }
+
+        int* pLive;
+    };
+
+    /**
+     * @brief      Run the callbacks like the overlay does, the surface is never
+     *             drawn on
+     */
+    void Run( CCallbackRegistry& registry )
+    {
+        registry.Compact();
+        for( size_t i = 0; i < registry.GetEntryCount(); ++i ) {
+            if( registry.IsActive( i ) ) {
+                registry.Invoke( i, nullptr );
+            }
+        }
+    }
+
+    void TestOrder( void )
+    {
+        CCallbackRegistry registry;
+        vector< int > order;
+        for( const auto priority : { 5, -3, 5, 0, -3, 5, 100 } ) {
+            const auto id = static_cast< int >( registry.Size() );
+            HAZE_CHECK( registry.Add( [ &order, id ]( const CRenderSurface* ) { order.push_back( id ); }, priority ) );
+        }
+        HAZE_CHECK( registry.Size() == 7 );
+
+        // lower priorities first, equal ones in registration order
+        Run( registry );
+        HAZE_CHECK( ( order == vector< int >{ 1, 4, 3, 0, 2, 5, 6 } ) );
+
+        order.clear();
+        registry.Add( [ &order ]( const CRenderSurface* ) { order.push_back( 7 ); }, 0 );
+        Run( registry );
+        HAZE_CHECK( ( order == vector< int >{ 1, 4, 3, 7, 0, 2, 5, 6 } ) );
+    }
+
+    void TestHandles( void )
+    {
+        CCallbackRegistry registry;
+        HAZE_CHECK( !registry.Add( RenderCallback() ) && !registry.Add( static_cast< void( * )( const CRenderSurface* ) >( nullptr ) ) );
+        HAZE_CHECK( !registry.Contains( 0 ) && !registry.Remove( 0 ) && !registry.GetProfile( 0 ) );
+
+        int calls = 0;
+        const auto first = registry.Add( [ &calls ]( const CRenderSurface* ) { ++calls; } );
+        HAZE_CHECK( registry.Contains( first ) && registry.IsEnabled( first ) && registry.GetProfile( first ) );
+
+        // disabled callbacks keep their place and handle
+        HAZE_CHECK( registry.SetEnabled( first, false ) && !registry.IsEnabled( first ) );
+        Run( registry );
+        HAZE_CHECK( !calls && registry.Contains( first ) && registry.Size() == 1 );
+        HAZE_CHECK( registry.SetEnabled( first, true ) );
+        Run( registry );
+        HAZE_CHECK( calls == 1 );
+
+        // the slot is reused under a new generation, the old handle stays stale
+        HAZE_CHECK( registry.Remove( first ) && !registry.Remove( first ) );
+        Run( registry );
+        const auto second = registry.Add( [ &calls ]( const CRenderSurface* ) { calls += 10; } );
+        HAZE_CHECK( static_cast< uint32_t >( second ) == static_cast< uint32_t >( first ) && second != first );
+        HAZE_CHECK( !registry.Contains( first ) && !registry.IsEnabled( first ) && !registry.GetProfile( first ) );
+        HAZE_CHECK( !registry.SetEnabled( first, false ) && !registry.Remove( first ) );
+        Run( registry );
+        HAZE_CHECK( calls == 11 && registry.IsEnabled( second ) );
+    }
+
+    void TestChangesWhileRunning( void )
+    {
+        CCallbackRegistry registry;
+        vector< int > order;
+        CallbackHandle handles[ 4 ] = {};
+        handles[ 0 ] = registry.Add( [ &order ]( const CRenderSurface* ) { order.push_back( 0 ); } );
+
+        // removes itself and the callback behind it, adds one in front of both
+        handles[ 1 ] = registry.Add( [ & ]( const CRenderSurface* ) {
+            order.push_back( 1 );
+            HAZE_CHECK( registry.Remove( handles[ 1 ] ) && registry.Remove( handles[ 2 ] ) );
+            handles[ 3 ] = registry.Add( [ &order ]( const CRenderSurface* ) { order.push_back( 3 ); }, -1 );
+        } );
+        handles[ 2 ] = registry.Add( [ &order ]( const CRenderSurface* ) { order.push_back( 2 ); } );
+        registry.Compact();
+
+        // the profile of an entry stays where it is while callbacks are added
+        auto* pProfile = &registry.GetEntryProfile( 0 );
+        auto* pList = &registry.GetEntryList( 0 );
+        const auto count = registry.GetEntryCount();
+        for( size_t i = 0; i < count; ++i ) {
+            if( registry.IsActive( i ) ) {
+                registry.Invoke( i, nullptr );
+            }
+        }
+        HAZE_CHECK( ( order == vector< int >{ 0, 1 } ) );
+        HAZE_CHECK( registry.GetEntryCount() == 3 && registry.Size() == 2 );
+        HAZE_CHECK( &registry.GetEntryProfile( 0 ) == pProfile && &registry.GetEntryList( 0 ) == pList );
+        HAZE_CHECK( registry.Contains( handles[ 3 ] ) && !registry.Contains( handles[ 1 ] ) );
+
+        // the added callback only runs after the next Compact
+        order.clear();
+        Run( registry );
+        HAZE_CHECK( ( order == vector< int >{ 3, 0 } ) );
+        HAZE_CHECK( registry.GetEntryCount() == 2 );
+
+        // callbacks which are added and removed again never run
+        const auto removed = registry.Add( [ &order ]( const CRenderSurface* ) { order.push_back( 4 ); } );
+        HAZE_CHECK( registry.SetEnabled( removed, false ) && !registry.IsEnabled( removed ) );
+        HAZE_CHECK( registry.Remove( removed ) && registry.Size() == 2 );
+        order.clear();
+        Run( registry );
+        HAZE_CHECK( ( order == vector< int >{ 3, 0 } ) );
+    }
+
+    void TestClear( void )
+    {
+        int live = 0;
+        CCallbackRegistry registry;
+        registry.Reserve( 16 );
+        vector< CallbackHandle > handles;
+        for( int i = 0; i < 10; ++i ) {
+            handles.push_back( registry.Add( [ counted = Counted( &live ) ]( const CRenderSurface* ) {} ) );
+        }
+        registry.Compact();
+        registry.Remove( handles[ 3 ] );
+        handles.push_back( registry.Add( [ counted = Counted( &live ) ]( const CRenderSurface* ) {} ) );
+        HAZE_CHECK( live == 11 && registry.Size() == 10 );
+
+        // compacted, pending and removed entries alike
+        registry.Clear();
+        HAZE_CHECK( !live && !registry.Size() && !registry.GetEntryCount() );
+        for( const auto handle : handles ) {
+            HAZE_CHECK( !registry.Contains( handle ) );
+        }
+
+        registry.Add( [ counted = Counted( &live ) ]( const CRenderSurface* ) {} );
+        HAZE_CHECK( live == 1 && registry.Size() == 1 );
+    }
+
+    void TestDelegate( void )
+    {
+        int live = 0;
+        {
+            using Delegate = CDelegate< int( int ) >;
+            Delegate empty, null( nullptr );
+            HAZE_CHECK( !empty && !null );
+
+            // the captured state moves along, the source is left empty
+            Delegate first = [ counted = Counted( &live ), offset = 3 ]( int value ) { return value + offset; };
+            HAZE_CHECK( first && live == 1 && first( 4 ) == 7 );
+            Delegate second( move( first ) );
+            HAZE_CHECK( !first && second && live == 1 && second( 1 ) == 4 );
+
+            empty = move( second );
+            HAZE_CHECK( !second && empty( 0 ) == 3 && live == 1 );
+
+            // assigning over a delegate destroys what it held
+            empty = [ counted = Counted( &live ) ]( int value ) { return -value; };
+            HAZE_CHECK( live == 1 && empty( 5 ) == -5 );
+            empty = Delegate();
+            HAZE_CHECK( !empty && !live );
+
+            // up to the capacity fits inline
+            struct Large
+            {
+                double values[ 5 ];
+            };
+            const Large large = { { 1., 2., 3., 4., 5. } };
+            empty = [ large, counted = Counted( &live ) ]( int index ) { return static_cast< int >( large.values[ index ] ); };
+            HAZE_CHECK( live == 1 && empty( 4 ) == 5 );
+            static_assert( sizeof( Large ) + sizeof( Counted ) <= Delegate::CAPACITY, "too large for the delegate" );
+        }
+        HAZE_CHECK( !live );
+
+        // removed callbacks release their captures in Compact
+        CCallbackRegistry registry;
+        const auto handle = registry.Add( [ counted = Counted( &live ) ]( const CRenderSurface* ) {} );
+        HAZE_CHECK( live == 1 );
+        registry.Remove( handle );
+        HAZE_CHECK( live == 1 );
+        registry.Compact();
+        HAZE_CHECK( !live );
+    }
+}
+
+int main( void )
+{
+    TestOrder();
+    TestHandles();
+    TestChangesWhileRunning();
+    TestClear();
+    TestDelegate();
+    return test::GetResult();
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace haze {
+    namespace test {
+        /**
+         * @brief      Amount of failed checks of the running test
+         */
+        inline int& GetFailures( void )
+        {
+            static int failures = 0;
+            return failures;
+        }
+
+        inline bool Check( bool condition, const char* expression, const char* file, int line )
+        {
+            if( !condition ) {
+                fprintf( stderr, "%s:%d: check failed: %s\n", file, line, expression );
+                ++GetFailures();
+            }
+            return condition;
+        }
+
+        /**
+         * @brief      Compare data with the run of the vector build. The
+         *             vector build stores it in the working directory and the
+         *             scalar build reads it back, so the vector and the scalar
+         *             paths have to produce the same bytes.
+         *
+         * @param[in]  name  name of the snapshot
+         * @param[in]  data  data
+         * @param[in]  size  size in bytes
+         *
+         * @return     bool <> false if the snapshot couldn't be stored or
+         *             differs
+         */
+        inline bool MatchesVectorBuild( const std::string& name, const void* data, size_t size )
+        {
+            const auto path = name + ".snapshot";
+#if !defined( HAZE_NO_SIMD )
+            auto* file = fopen( path.c_str(), "wb" );
+            const auto stored = file && fwrite( data, 1, size, file ) == size;
+            return file && !fclose( file ) && stored;
+#else
+            auto* file = fopen( path.c_str(), "rb" );
+            if( !file ) {
+                fprintf( stderr, "%s: run the vector build first\n", path.c_str() );
+                return false;
+            }
+
+            std::vector< char > snapshot( size + 1 );
+            const auto length = fread( snapshot.data(), 1, snapshot.size(), file );
+            fclose( file );
+            return length == size && memcmp( snapshot.data(), data, size ) == 0;
+#endif
+        }
+
+        /**
+         * @brief      Exit code of a test, non zero if any check failed
+         */
+        inline int GetResult( void )
+        {
+            if( GetFailures() ) {
+                fprintf( stderr, "%d checks failed\n", GetFailures() );
+                return EXIT_FAILURE;
+            }
+            return EXIT_SUCCESS;
+        }
+    }
+}
+
+#define HAZE_CHECK( condition ) haze::test::Check( ( condition ), #condition, __FILE__, __LINE__ )
@@ -0,0 +1,141 @@
+#include "Check.hpp"
+#include "Color.hpp"
+#include <algorithm>
+#include <functional>
+#include <vector>
+using namespace haze;
+
+namespace {
+    using Colors = vector< Color >;
+    using Channel = function< uint32_t( uint32_t, uint32_t, uint32_t ) >;
+
+    /**
+     * @brief      Random colors, every fourth one has an extreme channel
+     */
+    Colors MakeColors( size_t count, uint32_t seed )
+    {
+        Colors colors;
+        for( size_t i = 0; i < count; ++i ) {
+            seed = seed * 1664525u + 1013904223u;
+            auto value = seed;
+            if( i % 4 == 1 ) {
+                value |= 0xFF000000;
+            }
+            else if( i % 4 == 2 ) {
+                value &= 0x00FFFF00;
+            }
+            colors.push_back( Color( static_cast< int32_t >( value & 0xFF ), static_cast< int32_t >( value >> 8 & 0xFF ), static_cast< int32_t >( value >> 16 & 0xFF ), static_cast< int32_t >( value >> 24 ) ) );
+        }
+        return colors;
+    }
+
+    /**
+     * @brief      Apply a reference to every channel, the alpha of b is passed
+     *             along for the blend
+     */
+    Color Reference( const Color& a, const Color& b, const Channel& fn )
+    {
+        const auto alpha = static_cast< uint32_t >( b.a() );
+        return Color( static_cast< int32_t >( fn( static_cast< uint32_t >( a.r() ), static_cast< uint32_t >( b.r() ), alpha ) ),
+                      static_cast< int32_t >( fn( static_cast< uint32_t >( a.g() ), static_cast< uint32_t >( b.g() ), alpha ) ),
+                      static_cast< int32_t >( fn( static_cast< uint32_t >( a.b() ), static_cast< uint32_t >( b.b() ), alpha ) ),
+                      static_cast< int32_t >( fn( static_cast< uint32_t >( a.a() ), static_cast< uint32_t >( b.a() ), alpha ) ) );
+    }
+
+    /**
+     * @brief      Run a span kernel at every length around the blocks of four
+     *             and compare it with the reference, also in place
+     */
+    template< typename Kernel >
+    void CheckKernel( Kernel&& kernel, const Channel& fn )
+    {
+        for( size_t count = 0; count <= 67; ++count ) {
+            const auto a = MakeColors( count, static_cast< uint32_t >( count ) );
+            const auto b = MakeColors( count, static_cast< uint32_t >( count ) + 1000 );
+            Colors result( count, Color( 1, 2, 3, 4 ) );
+            kernel( a.data(), b.data(), result.data(), count );
+
+            auto matches = true;
+            for( size_t i = 0; i < count; ++i ) {
+                matches = matches && result[ i ] == Reference( a[ i ], b[ i ], fn );
+            }
+            HAZE_CHECK( matches );
+
+            auto inPlace = a;
+            kernel( inPlace.data(), b.data(), inPlace.data(), count );
+            HAZE_CHECK( inPlace == result );
+        }
+    }
+
+    void TestOperators( void )
+    {
+        // every pair of channel values
+        auto matches = true;
+        for( int32_t x = 0; x < 256; ++x ) {
+            for( int32_t y = 0; y < 256; ++y ) {
+                const Color a( x, y, 255 - x, y ), b( y, x, x, 255 - y );
+                matches = matches && a + b == Reference( a, b, []( uint32_t p, uint32_t q, uint32_t ) { return min( p + q, 255u ); } );
+                matches = matches && a - b == Reference( a, b, []( uint32_t p, uint32_t q, uint32_t ) { return p > q ? p - q : 0u; } );
+            }
+        }
+        HAZE_CHECK( matches );
+
+        // the channels are clamped, not wrapped
+        HAZE_CHECK( Color( 300, -5, 128, 255 ) == Color( 255, 0, 128, 255 ) );
+    }
+
+    void TestSpans( void )
+    {
+        CheckKernel( []( const Color* a, const Color* b, Color* r, size_t n ) { Color::Add( a, b, r, n ); },
+                     []( uint32_t p, uint32_t q, uint32_t ) { return min( p + q, 255u ); } );
+        CheckKernel( []( const Color* a, const Color* b, Color* r, size_t n ) { Color::Subtract( a, b, r, n ); },
+                     []( uint32_t p, uint32_t q, uint32_t ) { return p > q ? p - q : 0u; } );
+
+        // the weight is rounded to 1/256 and clamped to 0..1
+        for( const auto t : { -1.f, 0.f, 0.3f, 0.5f, 0.999f, 1.f, 2.f } ) {
+            const auto w = static_cast< uint32_t >( min( max( t, 0.f ), 1.f ) * 256.f + 0.5f );
+            CheckKernel( [ t ]( const Color* a, const Color* b, Color* r, size_t n ) { Color::Lerp( a, b, t, r, n ); },
+                         [ w ]( uint32_t p, uint32_t q, uint32_t ) { return ( p * ( 256 - w ) + q * w ) >> 8; } );
+        }
+
+        // premultiplied source over, the source comes second here so its
+        // alpha is the one passed along
+        CheckKernel( []( const Color* a, const Color* b, Color* r, size_t n ) { Color::Blend( b, a, r, n ); },
+                     []( uint32_t d, uint32_t s, uint32_t alpha ) { return min( s + ( d * ( 256 - alpha ) >> 8 ), 255u ); } );
+    }
+
+    void TestPremultiply( void )
+    {
+        // every channel and alpha value, rounded to the nearest
+        Colors colors;
+        for( int32_t c = 0; c < 256; ++c ) {
+            for( int32_t a = 0; a < 256; ++a ) {
+                colors.push_back( Color( c, 255 - c, c / 2, a ) );
+            }
+        }
+
+        // at every start inside a block of four
+        for( size_t offset = 0; offset < 4; ++offset ) {
+            const auto count = colors.size() - offset;
+            Colors result( count );
+            Color::Premultiply( colors.data() + offset, result.data(), count );
+
+            auto matches = true;
+            for( size_t i = 0; i < count; ++i ) {
+                const auto& color = colors[ i + offset ];
+                const auto a = static_cast< uint32_t >( color.a() );
+                auto scale = [ a ]( int32_t c ) { return static_cast< int32_t >( ( 2 * static_cast< uint32_t >( c ) * a + 255 ) / 510 ); };
+                matches = matches && result[ i ] == Color( scale( color.r() ), scale( color.g() ), scale( color.b() ), color.a() );
+            }
+            HAZE_CHECK( matches );
+        }
+    }
+}
+
+int main( void )
+{
+    TestOperators();
+    TestSpans();
+    TestPremultiply();
+    return test::GetResult();
+}
@@ -0,0 +1,248 @@
+#include "Check.hpp"
+#include "CommandList.hpp"
+#include "Graph.hpp"
+#include "RenderBackend.hpp"
+#include "Surface.hpp"
+#include <cstring>
+#include <string>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Amount of every primitive a sink received, batched ones
+     *             included, a recorded batch replays as single calls
+     */
+    struct Primitives
+    {
+        uint64_t nRects;
+        uint64_t nRoundedRects;
+        uint64_t nRoundedFrames;
+        uint64_t nLines;
+        uint64_t nTexts;
+        uint64_t nCharacters;
+        uint64_t nStateChanges;
+        uint64_t nPolylines;
+        uint64_t nPolylinePoints;
+    };
+
+    Primitives GetPrimitives( const CCountingCommandSink::Counters& counters )
+    {
+        return { counters.nRects + counters.nBatchedRects, counters.nRoundedRects, counters.nRoundedFrames, counters.nLines + counters.nBatchedLines,
+                 counters.nTexts, counters.nCharacters, counters.nStateChanges, counters.nPolylines, counters.nPolylinePoints };
+    }
+
+    bool operator == ( const Primitives& a, const Primitives& b )
+    {
+        return memcmp( &a, &b, sizeof( Primitives ) ) == 0;
+    }
+
+    /**
+     * @brief      Draw every primitive of the surface once
+     */
+    void DrawAll( const CRenderSurface& surface )
+    {
+        const Color white( 255, 255, 255, 255 ), black( 0, 0, 0, 255 );
+        surface.Rect( 10.f, 10.f, 50.f, 20.f, white );
+        surface.Rect( 10.f, 40.f, 50.f, 20.f, 2.f, white, black );
+        surface.BorderBox( 70.f, 10.f, 40.f, 30.f, 2.f, white );
+        surface.BorderBox( 70.f, 50.f, 40.f, 30.f, 2.f, 1.f, white, black );
+        surface.RoundedRect( 120.f, 10.f, 60.f, 30.f, 6.f, 6.f, white );
+        surface.RoundedRect( 120.f, 50.f, 60.f, 30.f, 6.f, 6.f, 2.f, 4.f, 4.f, white, black );
+        surface.Line( 0.f, 100.f, 200.f, 120.f, 1.5f, white );
+        surface.SetTransform( { 1.f, 0.f, 0.f, 1.f, 5.f, 5.f } );
+        surface.SetAntialiasMode( AntialiasMode::Aliased );
+
+        const ColoredRect rects[] = { { 0.f, 130.f, 5.f, 5.f, white }, { 10.f, 130.f, 5.f, 5.f, black } };
+        const ColoredLine lines[] = { { 0.f, 140.f, 20.f, 140.f, 1.f, white }, { 0.f, 145.f, 20.f, 150.f, 2.f, black } };
+        const ColoredBorderBox boxes[] = { { 30.f, 130.f, 10.f, 10.f, 1.f, white }, { 50.f, 130.f, 10.f, 10.f, 1.f, black } };
+        surface.Rects( rects, 2 );
+        surface.Lines( lines, 2 );
+        surface.BorderBoxes( boxes, 2 );
+
+        const PointF points[] = { { 0.f, 160.f }, { 20.f, 170.f }, { 40.f, 160.f }, { 60.f, 175.f } };
+        surface.Polyline( points, 4, 2.f, white );
+        const float samples[] = { 1.f, 3.f, 2.f, 5.f, 4.f };
+        surface.Graph( 100.f, 150.f, 80.f, 30.f, { samples, 5, 2, 5 }, 0.f, 6.f, 1.f, white );
+
+        surface.String( 0.f, 190.f, "label", white, "fps %d", 60 );
+        surface.SetTransform( Transform::Identity() );
+        surface.SetAntialiasMode( AntialiasMode::PerPrimitive );
+    }
+
+    void TestReplayMatchesDirect( void )
+    {
+        CCountingRenderBackend backend( 256, 256 );
+        backend.RegisterFont( "label" );
+        CRenderSurface surface( &backend );
+        DrawAll( surface );
+        const auto direct = backend.GetCounters();
+
+        CCommandList list;
+        backend.Reset();
+        surface.SetCommandSink( &list );
+        DrawAll( surface );
+        surface.SetCommandSink( nullptr );
+        HAZE_CHECK( !backend.GetDrawCalls() && !list.empty() );
+
+        CCountingCommandSink sink;
+        HAZE_CHECK( list.Replay( sink ) );
+        HAZE_CHECK( GetPrimitives( sink.GetCounters() ) == GetPrimitives( direct ) );
+
+        // without batches a replay gives the same calls as drawing directly
+        HAZE_CHECK( sink.GetCounters().nPolylines == 2 && sink.GetCounters().nTexts == 1 );
+        HAZE_CHECK( sink.GetCounters().nRoundedRects == direct.nRoundedRects && sink.GetCounters().nRoundedFrames == direct.nRoundedFrames );
+        HAZE_CHECK( sink.GetCounters().nStateChanges == direct.nStateChanges );
+    }
+
+    void TestAppend( void )
+    {
+        const wchar_t* labels[] = { L"first", L"second one", L"third" };
+        const PointF points[] = { { 0.f, 0.f }, { 1.f, 2.f }, { 3.f, 1.f }, { 4.f, 4.f }, { 6.f, 0.f }, { 7.f, 3.f } };
+        const auto* pFont = reinterpret_cast< const void* >( &labels );
+
+        // every list starts its arenas at zero
+        CCommandList lists[ 3 ], merged, serial;
+        for( size_t i = 0; i < 3; ++i ) {
+            for( auto* pList : { &lists[ i ], &serial } ) {
+                pList->Text( 0.f, 0.f, 100.f, 20.f, labels[ i ], wcslen( labels[ i ] ), pFont, 0xFFFFFFFF );
+                pList->Polyline( points + i, 2 + i, 1.f, 0xFFFFFFFF );
+                pList->FillRect( 0.f, 0.f, 1.f, 1.f, 0xFF000000 );
+            }
+            merged.Append( lists[ i ] );
+        }
+        HAZE_CHECK( merged.size() == 9 );
+
+        for( size_t i = 0; i < 3; ++i ) {
+            const auto& text = merged.GetCommands()[ 3 * i ];
+            const auto& polyline = merged.GetCommands()[ 3 * i + 1 ];
+            HAZE_CHECK( wstring( merged.GetText( text ), text.nTextLength ) == labels[ i ] );
+            HAZE_CHECK( polyline.nTextLength == 2 + i && memcmp( merged.GetPoints( polyline ), points + i, ( 2 + i ) * sizeof( PointF ) ) == 0 );
+        }
+        HAZE_CHECK( merged.Hash() == serial.Hash() );
+
+        // the other commands have no arena to point into
+        HAZE_CHECK( merged.GetPoints( merged.GetCommands()[ 0 ] ) == nullptr );
+        HAZE_CHECK( *merged.GetText( merged.GetCommands()[ 1 ] ) == L'\0' );
+    }
+
+    // stands in for a font, recordings only keep its address
+    const int FONT = 0;
+
+    /**
+     * @brief      Record one frame with a text and a polyline
+     */
+    void Record( CCommandList& list, uint32_t color, float x, const wchar_t* label, float point_x, const void* pFont = &FONT )
+    {
+        const PointF points[] = { { 0.f, 0.f }, { point_x, 10.f }, { 20.f, 0.f } };
+        list.FillRect( x, 10.f, 20.f, 20.f, color );
+        list.FillRoundedFrame( x, 40.f, 40.f, 20.f, 4.f, 4.f, 1.f, 3.f, 3.f, color, 0xFF000000 );
+        list.Text( x, 70.f, 100.f, 20.f, label, wcslen( label ), pFont, color );
+        list.Polyline( points, 3, 1.5f, color );
+        list.SetAntialiasMode( AntialiasMode::Aliased );
+    }
+
+    void TestHash( void )
+    {
+        CCommandList a, b;
+        Record( a, 0xFFFFFFFF, 5.f, L"label", 10.f );
+        Record( b, 0xFFFFFFFF, 5.f, L"label", 10.f );
+        HAZE_CHECK( a.Hash() == b.Hash() );
+        HAZE_CHECK( CCommandList().Hash() == CCommandList().Hash() );
+
+        // a list which held another frame before has no stale bytes to hash
+        CCommandList reused;
+        for( int i = 0; i < 64; ++i ) {
+            Record( reused, 0x12345678u * i, -1.f * i, L"previous frame", 0.25f * i );
+        }
+        reused.Reset();
+        Record( reused, 0xFFFFFFFF, 5.f, L"label", 10.f );
+        HAZE_CHECK( reused.Hash() == a.Hash() );
+
+        const auto changed = [ & ]( uint32_t color, float x, const wchar_t* label, float point_x ) {
+            CCommandList list;
+            Record( list, color, x, label, point_x );
+            return list.Hash() != a.Hash();
+        };
+        HAZE_CHECK( changed( 0xFFFFFFFE, 5.f, L"label", 10.f ) );
+        HAZE_CHECK( changed( 0xFFFFFFFF, 5.5f, L"label", 10.f ) );
+        HAZE_CHECK( changed( 0xFFFFFFFF, 5.f, L"lAbel", 10.f ) );
+        // inside the bounds of the polyline, only the point arena differs
+        HAZE_CHECK( changed( 0xFFFFFFFF, 5.f, L"label", 10.5f ) );
+
+        // so do another font, another order and one command more
+        CCommandList font;
+        Record( font, 0xFFFFFFFF, 5.f, L"label", 10.f, &font );
+        HAZE_CHECK( font.Hash() != a.Hash() );
+
+        CCommandList ordered, swapped;
+        ordered.FillRect( 0.f, 0.f, 1.f, 1.f, 0xFFFFFFFF );
+        ordered.FillRect( 1.f, 0.f, 1.f, 1.f, 0xFFFFFFFF );
+        swapped.FillRect( 1.f, 0.f, 1.f, 1.f, 0xFFFFFFFF );
+        swapped.FillRect( 0.f, 0.f, 1.f, 1.f, 0xFFFFFFFF );
+        HAZE_CHECK( ordered.Hash() != swapped.Hash() );
+        CCommandList longer;
+        longer.Append( ordered );
+        longer.FillRect( 0.f, 0.f, 0.f, 0.f, 0 );
+        HAZE_CHECK( ordered.Hash() != longer.Hash() );
+
+        // lists merged with Append hash like the serial recording, empty ones included
+        CCommandList serial, merged, parts[ 3 ];
+        for( int i = 0; i < 3; ++i ) {
+            Record( serial, 0xFF000000u + i, 10.f * i, i % 2 ? L"odd" : L"even", 2.f + 5.f * i );
+            Record( parts[ i ], 0xFF000000u + i, 10.f * i, i % 2 ? L"odd" : L"even", 2.f + 5.f * i );
+            merged.Append( parts[ i ] );
+            merged.Append( CCommandList() );
+        }
+        HAZE_CHECK( merged.Hash() == serial.Hash() );
+    }
+
+    void TestResetKeepsMemory( void )
+    {
+        const PointF points[] = { { 0.f, 0.f }, { 10.f, 10.f }, { 20.f, 0.f } };
+        const wstring label( 200, L'x' );
+        CCommandList list;
+        const auto record = [ & ] {
+            for( int i = 0; i < 1000; ++i ) {
+                list.FillRect( 0.f, 0.f, 1.f, 1.f, 0xFFFFFFFF );
+            }
+            list.Text( 0.f, 0.f, 10.f, 10.f, label.c_str(), label.size(), &list, 0xFFFFFFFF );
+            list.Polyline( points, 3, 1.f, 0xFFFFFFFF );
+        };
+
+        record();
+        const auto* pCommands = list.GetCommands().data();
+        const auto capacity = list.GetCommands().capacity();
+        const auto* pText = list.GetText( list.GetCommands()[ 1000 ] );
+        const auto* pPoints = list.GetPoints( list.GetCommands()[ 1001 ] );
+
+        list.Reset();
+        HAZE_CHECK( list.empty() && list.GetCommands().capacity() == capacity );
+
+        // the same frame again lands in the same memory
+        record();
+        HAZE_CHECK( list.GetCommands().data() == pCommands );
+        HAZE_CHECK( list.GetText( list.GetCommands()[ 1000 ] ) == pText );
+        HAZE_CHECK( list.GetPoints( list.GetCommands()[ 1001 ] ) == pPoints );
+    }
+
+    void TestRejected( void )
+    {
+        CCommandList list;
+        HAZE_CHECK( !list.Text( 0.f, 0.f, 1.f, 1.f, nullptr, 0, &list, 0 ) );
+        HAZE_CHECK( !list.Text( 0.f, 0.f, 1.f, 1.f, L"x", 1, nullptr, 0 ) );
+        const PointF point = { 0.f, 0.f };
+        HAZE_CHECK( !list.Polyline( &point, 1, 1.f, 0 ) && !list.Polyline( nullptr, 2, 1.f, 0 ) );
+        HAZE_CHECK( !list.FillColoredRects( nullptr, 1 ) && !list.Lines( nullptr, 1 ) );
+        HAZE_CHECK( list.empty() );
+    }
+}
+
+int main( void )
+{
+    TestReplayMatchesDirect();
+    TestAppend();
+    TestHash();
+    TestResetKeepsMemory();
+    TestRejected();
+    return test::GetResult();
+}
@@ -0,0 +1,110 @@
+#include "Check.hpp"
+#include "CommandList.hpp"
+#include "DirtyRegion.hpp"
+#include "RenderBackend.hpp"
+#include "SoftwareBackend.hpp"
+#include <cmath>
+#include <cstring>
+#include <string>
+using namespace haze;
+
+namespace {
+    constexpr int32_t WIDTH = 320;
+    constexpr int32_t HEIGHT = 240;
+
+    /**
+     * @brief      Record a frame of which only some parts change
+     */
+    void Record( CCommandList& list, int frame, const void* pFont )
+    {
+        list.Reset();
+        list.FillRect( 0.f, 0.f, 320.f, 40.f, 0xFF303040 );
+        list.FillRoundedRect( 200.f, 60.f, 100.f, 60.f, 8.f, 8.f, 0xC0206080 );
+
+        // a box which moves every frame and one which only moves every fourth
+        list.FillRect( 10.f + static_cast< float >( frame * 7 % 150 ), 60.f, 30.f, 30.f, 0xFFE04020 );
+        list.FillRect( 10.f + static_cast< float >( frame / 4 * 13 % 150 ), 100.f, 20.f, 20.f, 0x8020E040 );
+        list.Line( 0.f, 130.f, 320.f, 150.f, 3.f, 0xFFFFFFFF );
+
+        // a graph whose newest point follows the frame
+        const PointF points[] = { { 20.f, 220.f }, { 60.f, 180.f }, { 100.f, 200.f }, { 140.f, 160.f + static_cast< float >( frame % 5 * 8 ) } };
+        list.Polyline( points, 4, 2.f, 0xFFFFD000 );
+
+        // rotated, so the dirty bounds come from the transformed corners
+        Transform rotation = { 0.8660254f, 0.5f, -0.5f, 0.8660254f, 250.f, 150.f };
+        list.SetTransform( rotation );
+        list.FillRect( 0.f, 0.f, 40.f, 10.f + static_cast< float >( frame % 3 * 5 ), 0xFF8080FF );
+        list.SetTransform( Transform::Identity() );
+
+        // far beyond the target, it never shows
+        list.FillRect( 1e30f, -1e30f, 50.f, 50.f, 0xFFFF00FF );
+
+        const auto label = L"frame " + to_wstring( frame );
+        list.Text( 10.f, 8.f, 200.f, 24.f, label.c_str(), label.size(), pFont, 0xFFFFFFFF );
+    }
+
+    void TestPartialMatchesFull( void )
+    {
+        CSoftwareBackend partial( WIDTH, HEIGHT ), full( WIDTH, HEIGHT );
+        partial.SetClearColor( 0xFF101010 );
+        full.SetClearColor( 0xFF101010 );
+        HAZE_CHECK( partial.LoadFontFile( "DejaVu", HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf" ) );
+        HAZE_CHECK( full.LoadFontFile( "DejaVu", HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf" ) );
+        const auto* pPartialFont = partial.RegisterFont( "label", "DejaVu", 16.f );
+        const auto* pFullFont = full.RegisterFont( "label", "DejaVu", 16.f );
+
+        CDirtyRegion region;
+        CCommandList partialList, fullList;
+        for( int frame = 0; frame < 40; ++frame ) {
+            Record( partialList, frame, pPartialFont );
+            if( !region.Update( partialList, partial ) || !region.Redraw( partialList, partial ) ) {
+                HAZE_CHECK( partial.BeginFrame() );
+                HAZE_CHECK( partialList.Replay( partial ) );
+                HAZE_CHECK( partial.EndFrame() );
+            }
+
+            Record( fullList, frame, pFullFont );
+            HAZE_CHECK( full.BeginFrame() );
+            HAZE_CHECK( fullList.Replay( full ) );
+            HAZE_CHECK( full.EndFrame() );
+
+            HAZE_CHECK( memcmp( partial.GetPixels(), full.GetPixels(), WIDTH * HEIGHT * sizeof( uint32_t ) ) == 0 );
+        }
+
+        // most frames have to be partial, or the comparison proves nothing
+        HAZE_CHECK( region.GetStatistics().nPartialFrames >= 30 );
+    }
+
+    void TestNonFiniteBounds( void )
+    {
+        CCountingRenderBackend backend( WIDTH, HEIGHT );
+        CDirtyRegion region;
+        CCommandList list;
+        list.FillRect( 10.f, 10.f, 20.f, 20.f, 0xFFFFFFFF );
+        HAZE_CHECK( !region.Update( list, backend ) );
+        HAZE_CHECK( region.Update( list, backend ) && region.GetRects().empty() );
+
+        // a rectangle far outside the target is not dirty
+        list.FillRect( 1e30f, 1e30f, 10.f, 10.f, 0xFFFFFFFF );
+        HAZE_CHECK( region.Update( list, backend ) && region.GetRects().empty() );
+
+        // one which spans far beyond both edges covers the whole target
+        list.FillRect( -1e30f, 100.f, 2e30f, 10.f, 0xFFFFFFFF );
+        HAZE_CHECK( region.Update( list, backend ) );
+        HAZE_CHECK( region.GetRects().size() == 1 && region.GetRects()[ 0 ].x == 0.f && region.GetRects()[ 0 ].w == static_cast< float >( WIDTH ) );
+
+        // infinite and NaN bounds may draw anywhere
+        list.FillRect( 0.f, 0.f, HUGE_VALF, 10.f, 0xFFFFFFFF );
+        HAZE_CHECK( !region.Update( list, backend ) );
+        HAZE_CHECK( region.Update( list, backend ) && region.GetRects().empty() );
+        list.FillRect( NAN, 0.f, 10.f, 10.f, 0xFFFFFFFF );
+        HAZE_CHECK( !region.Update( list, backend ) );
+    }
+}
+
+int main( void )
+{
+    TestPartialMatchesFull();
+    TestNonFiniteBounds();
+    return test::GetResult();
+}
@@ -0,0 +1,113 @@
+#include "Check.hpp"
+#include "CommandList.hpp"
+#include "Format.hpp"
+#include "RenderBackend.hpp"
+#include "Surface.hpp"
+#include <cmath>
+#include <cstdint>
+#include <string>
+using namespace haze;
+
+namespace {
+    template< typename TFormat, typename... Args >
+    wstring ToString( TFormat format, const Args&... args )
+    {
+        wstring buffer;
+        CUtf16Writer writer( buffer );
+        Format( writer, format, args... );
+        return wstring( writer.data(), writer.size() );
+    }
+
+    void TestPlaceholders( void )
+    {
+        HAZE_CHECK( ToString( HAZE_FORMAT( "" ) ).empty() );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "no arguments" ) ) == L"no arguments" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}" ), 7 ) == L"7" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{} fps ({:.1} ms)" ), 144, 6.94 ) == L"144 fps (6.9 ms)" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{{}} {{{}}} }}{{" ), 1 ) == L"{} {1} }{" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}{}{}" ), 'a', L'b', "c" ) == L"abc" );
+    }
+
+    void TestIntegers( void )
+    {
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{} {} {}" ), 0, -1, 42u ) == L"0 -1 42" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}" ), INT64_MIN ) == L"-9223372036854775808" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}" ), INT64_MAX ) == L"9223372036854775807" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}" ), UINT64_MAX ) == L"18446744073709551615" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{} {}" ), static_cast< int8_t >( -128 ), static_cast< uint16_t >( 65535 ) ) == L"-128 65535" );
+    }
+
+    void TestFloats( void )
+    {
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}" ), 1.5 ) == L"1.500000" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{:.0}" ), 2.75f ) == L"3" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{:.3}" ), -0.0625 ) == L"-0.063" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{:.9}" ), 0.123456789 ) == L"0.123456789" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{:.2}" ), 1e20 ) == L"100000000000000000000.00" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{:.1} {:.1} {:.1}" ), NAN, HUGE_VAL, -HUGE_VAL ) == L"nan inf -inf" );
+    }
+
+    void TestStrings( void )
+    {
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{} {}" ), true, false ) == L"true false" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "[{}]" ), string( "narrow" ) ) == L"[narrow]" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "[{}]" ), wstring( L"wide" ) ) == L"[wide]" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "[{}]" ), L"wide" ) == L"[wide]" );
+
+        // utf-8 arguments and literals become utf-16, a surrogate pair above U+FFFF
+        HAZE_CHECK( ToString( HAZE_FORMAT( u8"Ziel → {}" ), u8"Über \U0001F3AE" ) == wstring( L"Ziel \x2192 \xDC" ) + L"ber \xD83C\xDFAE" );
+        HAZE_CHECK( ToString( HAZE_FORMAT( "{}" ), "\xFF" ) == L"\xFFFD" );
+    }
+
+    void TestLong( void )
+    {
+        // far beyond the buffer sizes vsprintf used, nothing is cut off
+        const string narrow( 3000, 'n' );
+        const wstring wide( 2000, L'w' );
+        const auto text = ToString( HAZE_FORMAT( "{}|{}|{:.2}" ), narrow, wide, 1.25 );
+        HAZE_CHECK( text.size() == 3000 + 1 + 2000 + 1 + 4 );
+        HAZE_CHECK( text == wstring( 3000, L'n' ) + L"|" + wide + L"|1.25" );
+
+        // the shared buffer of a thread grows and is reused
+        CUtf16Writer writer( GetFormatBuffer() );
+        Format( writer, HAZE_FORMAT( "{}" ), narrow );
+        HAZE_CHECK( writer.size() == 3000 && GetFormatBuffer().size() >= 3000 );
+    }
+
+    void TestSurface( void )
+    {
+        CCountingRenderBackend backend( 256, 256 );
+        backend.RegisterFont( "label" );
+        CRenderSurface surface( &backend );
+
+        // both String overloads reach Text with the whole formatted string
+        const string name( 1500, 'x' );
+        HAZE_CHECK( surface.String( 0.f, 0.f, "label", Color( 255, 255, 255, 255 ), HAZE_FORMAT( "{}: {}" ), name, 60 ) );
+        HAZE_CHECK( surface.String( 0.f, 0.f, surface.GetFontHandle( "label" ), Color( 255, 255, 255, 255 ), HAZE_FORMAT( "{:.1} ms" ), 16.666 ) );
+        HAZE_CHECK( backend.GetCounters().nTexts == 2 );
+        HAZE_CHECK( backend.GetCounters().nCharacters == 1500 + 4 + 7 );
+
+        // an unknown font draws nothing
+        HAZE_CHECK( !surface.String( 0.f, 0.f, "missing", Color( 255, 255, 255, 255 ), HAZE_FORMAT( "{}" ), 1 ) );
+        HAZE_CHECK( backend.GetCounters().nTexts == 2 );
+
+        // the recorded text is the formatted one
+        CCommandList list;
+        surface.SetCommandSink( &list );
+        HAZE_CHECK( surface.String( 0.f, 0.f, "label", Color( 255, 255, 255, 255 ), HAZE_FORMAT( "{} fps" ), 144 ) );
+        HAZE_CHECK( list.size() == 1 );
+        const auto& command = list.GetCommands()[ 0 ];
+        HAZE_CHECK( wstring( list.GetText( command ), command.nTextLength ) == L"144 fps" );
+    }
+}
+
+int main( void )
+{
+    TestPlaceholders();
+    TestIntegers();
+    TestFloats();
+    TestStrings();
+    TestLong();
+    TestSurface();
+    return test::GetResult();
+}
@@ -0,0 +1,79 @@
+#include "Check.hpp"
+#include "FramePacer.hpp"
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Clock which advances a microsecond per read and oversleeps
+     *             by a fixed amount, like a sleep on the default windows timer
+     */
+    class CFakeClock : public IClock
+    {
+    public:
+        explicit CFakeClock( uint64_t overshoot ) :
+            m_nOvershoot( overshoot )
+        {
+        }
+
+        uint64_t Now( void ) const override
+        {
+            return m_nTime += 1000;
+        }
+
+        void Sleep( uint64_t duration ) override
+        {
+            m_nTime += duration + m_nOvershoot;
+        }
+
+    private:
+        mutable uint64_t m_nTime = 1000000000;
+        uint64_t         m_nOvershoot;
+    };
+
+    constexpr uint64_t INTERVAL = 1000000000 / 60;
+
+    void TestSleepOvershoot( void )
+    {
+        CFakeClock clock( 15600000 );
+        CFramePacer pacer( &clock );
+        pacer.SetTargetFramesPerSecond( 60 );
+
+        // the first sleeps overshoot, then the pacer spins the overshoot away
+        for( int i = 0; i < 10; ++i ) {
+            pacer.Wait( true );
+        }
+        pacer.Reset();
+        for( int i = 0; i < 100; ++i ) {
+            pacer.Wait( true );
+        }
+
+        const auto statistics = pacer.GetStatistics();
+        HAZE_CHECK( statistics.nSpinDuration >= 15600000 );
+        HAZE_CHECK( !statistics.nMissed );
+        HAZE_CHECK( statistics.nMaxJitter <= 2000 );
+        HAZE_CHECK( statistics.nLastInterval >= INTERVAL && statistics.nLastInterval <= INTERVAL + 2000 );
+    }
+
+    void TestPreciseSleep( void )
+    {
+        CFakeClock clock( 0 );
+        CFramePacer pacer( &clock );
+        pacer.SetTargetFramesPerSecond( 60 );
+        pacer.SetSpinDuration( 500000 );
+        for( int i = 0; i < 100; ++i ) {
+            pacer.Wait( true );
+        }
+
+        // sleeps which end on time keep the margin which was set
+        const auto statistics = pacer.GetStatistics();
+        HAZE_CHECK( statistics.nSpinDuration == 500000 );
+        HAZE_CHECK( statistics.nMaxJitter <= 2000 );
+    }
+}
+
+int main( void )
+{
+    TestSleepOvershoot();
+    TestPreciseSleep();
+    return test::GetResult();
+}
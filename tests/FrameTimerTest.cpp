@@ -0,0 +1,195 @@
+#include "Check.hpp"
+#include "FrameTimer.hpp"
+#include <algorithm>
+#include <vector>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Clock which only moves when the test advances it
+     */
+    class CManualClock : public IClock
+    {
+    public:
+        uint64_t Now( void ) const override
+        {
+            return m_nTime;
+        }
+
+        void Sleep( uint64_t duration ) override
+        {
+            m_nTime += duration;
+        }
+
+    private:
+        uint64_t m_nTime = 1000000000;
+    };
+
+    constexpr uint64_t INTERVAL = 1000000000 / 60;
+
+    /**
+     * @brief      Does a percentile of the histogram lie inside the bucket of
+     *             the exact one, which is at most 1/8 of its power of two wide?
+     */
+    bool IsClose( uint64_t percentile, uint64_t reference )
+    {
+        return percentile >= reference && percentile - reference <= reference / 8;
+    }
+
+    void TestBuckets( void )
+    {
+        // the larger sample keeps the clamp away from the bucket limit of the smaller one
+        for( auto sample = 0ull; sample < 4096; ++sample ) {
+            CTimingHistogram histogram;
+            histogram.Add( sample );
+            histogram.Add( UINT64_MAX );
+            HAZE_CHECK( IsClose( histogram.GetStatistics().nP50, sample ) );
+        }
+        for( int shift = 12; shift < 64; ++shift ) {
+            for( const auto sample : { 1ull << shift, ( 1ull << shift ) + ( 1ull << ( shift - 3 ) ) - 1, ( 1ull << shift ) + ( 1ull << ( shift - 3 ) ), ( 2ull << shift ) - 1 } ) {
+                CTimingHistogram histogram;
+                histogram.Add( sample );
+                histogram.Add( UINT64_MAX );
+                HAZE_CHECK( IsClose( histogram.GetStatistics().nP50, sample ) );
+            }
+        }
+    }
+
+    void TestPercentiles( void )
+    {
+        uint32_t state = 12345;
+        const auto random = [ & ] {
+            state = state * 1664525u + 1013904223u;
+            return state;
+        };
+
+        for( const auto count : { 1, 2, 7, 100, 256, 1000 } ) {
+            CTimingHistogram histogram;
+            vector< uint64_t > samples;
+            for( int i = 0; i < count; ++i ) {
+                // spread over many powers of two, like frame times with hitches
+                samples.push_back( static_cast< uint64_t >( random() ) >> ( random() % 24 ) );
+                histogram.Add( samples.back() );
+            }
+
+            // only the window counts, sorted it gives the exact percentiles
+            const auto size = samples.size() < CTimingHistogram::WINDOW ? samples.size() : CTimingHistogram::WINDOW;
+            vector< uint64_t > window( samples.end() - static_cast< ptrdiff_t >( size ), samples.end() );
+            sort( window.begin(), window.end() );
+            const auto rank = [ & ]( size_t percent ) {
+                return window[ ( window.size() * percent + 99 ) / 100 - 1 ];
+            };
+
+            uint64_t total = 0;
+            for( const auto sample : window ) {
+                total += sample;
+            }
+
+            const auto statistics = histogram.GetStatistics();
+            HAZE_CHECK( statistics.nSamples == window.size() );
+            HAZE_CHECK( statistics.nMin == window.front() && statistics.nMax == window.back() );
+            HAZE_CHECK( statistics.nAverage == total / window.size() && histogram.GetTotal() == total );
+            HAZE_CHECK( IsClose( statistics.nP50, rank( 50 ) ) );
+            HAZE_CHECK( IsClose( statistics.nP95, rank( 95 ) ) );
+            HAZE_CHECK( IsClose( statistics.nP99, rank( 99 ) ) );
+        }
+    }
+
+    void TestEviction( void )
+    {
+        CTimingHistogram histogram;
+        HAZE_CHECK( !histogram.GetStatistics().nSamples );
+
+        // the hitches leave the window one by one
+        for( size_t i = 0; i < 10; ++i ) {
+            histogram.Add( 100000000 );
+        }
+        for( size_t i = 0; i < CTimingHistogram::WINDOW - 1; ++i ) {
+            histogram.Add( INTERVAL );
+        }
+        HAZE_CHECK( histogram.GetStatistics().nMax == 100000000 );
+
+        histogram.Add( INTERVAL );
+        auto statistics = histogram.GetStatistics();
+        HAZE_CHECK( statistics.nSamples == CTimingHistogram::WINDOW );
+        HAZE_CHECK( statistics.nMax == INTERVAL && statistics.nMin == INTERVAL );
+        HAZE_CHECK( statistics.nP99 == INTERVAL && statistics.nAverage == INTERVAL );
+        HAZE_CHECK( histogram.GetTotal() == INTERVAL * CTimingHistogram::WINDOW );
+
+        histogram.Reset();
+        histogram.Add( 5 );
+        statistics = histogram.GetStatistics();
+        HAZE_CHECK( statistics.nSamples == 1 && statistics.nP50 == 5 && statistics.nMax == 5 );
+    }
+
+    /**
+     * @brief      Run frames of a fixed length, a tenth of it in the
+     *             callbacks and a twentieth in present
+     */
+    void RunFrames( CFrameTimer& timer, CManualClock& clock, int count, uint64_t interval )
+    {
+        for( int i = 0; i < count; ++i ) {
+            timer.BeginFrame();
+            timer.BeginCallbacks();
+            clock.Sleep( interval / 10 );
+            timer.EndCallbacks();
+            timer.BeginPresent();
+            clock.Sleep( interval / 20 );
+            timer.EndPresent();
+            timer.EndFrame();
+            clock.Sleep( interval - interval / 10 - interval / 20 );
+        }
+    }
+
+    void TestFrameTimer( void )
+    {
+        CManualClock clock;
+        CFrameTimer timer( &clock );
+        HAZE_CHECK( !timer.GetTimings().nFrames && !timer.GetFramesPerSecond() );
+
+        RunFrames( timer, clock, 100, INTERVAL );
+        auto timings = timer.GetTimings();
+        HAZE_CHECK( timings.nFrames == 100 && timings.nFramesPerSecond == 60 );
+        HAZE_CHECK( timings.FrameTime.nSamples == 99 && timings.FrameTime.nMax == INTERVAL );
+        HAZE_CHECK( timings.CallbackTime.nSamples == 100 && timings.CallbackTime.nMax == INTERVAL / 10 );
+        HAZE_CHECK( timings.PresentTime.nMin == INTERVAL / 20 );
+
+        // the hidden time between pause and the next frame is not a frame
+        timer.Pause();
+        clock.Sleep( 5000000000ull );
+        RunFrames( timer, clock, 10, INTERVAL );
+        timings = timer.GetTimings();
+        HAZE_CHECK( timings.nFrames == 110 && timings.FrameTime.nSamples == 99 + 9 );
+        HAZE_CHECK( timings.FrameTime.nMax == INTERVAL && timings.nFramesPerSecond == 60 );
+
+        timer.Reset();
+        timings = timer.GetTimings();
+        HAZE_CHECK( !timings.nFrames && !timings.FrameTime.nSamples && !timings.CallbackTime.nSamples );
+    }
+
+    void TestIndependentTimers( void )
+    {
+        CManualClock first_clock, second_clock;
+        CFrameTimer first( &first_clock ), second( &second_clock );
+
+        RunFrames( first, first_clock, 50, INTERVAL );
+        RunFrames( second, second_clock, 20, 1000000000 / 144 );
+        first.Reset();
+        RunFrames( first, first_clock, 30, 1000000000 / 30 );
+
+        const auto a = first.GetTimings(), b = second.GetTimings();
+        HAZE_CHECK( a.nFrames == 30 && a.nFramesPerSecond == 30 && a.FrameTime.nSamples == 29 );
+        HAZE_CHECK( b.nFrames == 20 && b.nFramesPerSecond == 144 && b.FrameTime.nSamples == 19 );
+        HAZE_CHECK( b.FrameTime.nMax == 1000000000 / 144 && b.CallbackTime.nMax == 1000000000 / 1440 );
+    }
+}
+
+int main( void )
+{
+    TestBuckets();
+    TestPercentiles();
+    TestEviction();
+    TestFrameTimer();
+    TestIndependentTimers();
+    return test::GetResult();
+}
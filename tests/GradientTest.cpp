@@ -0,0 +1,108 @@
+#include "Check.hpp"
+#include "Gradient.hpp"
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <vector>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Values which hit the edges of the range, the middles
+     *             between two entries and everything which is not finite
+     */
+    vector< float > MakeValues( const CGradient& gradient, float minimum, float maximum )
+    {
+        const auto range = maximum - minimum;
+        vector< float > values = { NAN, -NAN, HUGE_VALF, -HUGE_VALF, FLT_MAX, -FLT_MAX, 0.f, -0.f, FLT_MIN, -FLT_MIN,
+                                   minimum, maximum, nextafter( minimum, -HUGE_VALF ), nextafter( maximum, HUGE_VALF ), 1e30f, -1e30f };
+        const auto step = range / static_cast< float >( gradient.GetSize() - 1 );
+        for( size_t i = 0; i < gradient.GetSize(); i += 7 ) {
+            const auto middle = minimum + ( static_cast< float >( i ) + 0.5f ) * step;
+            values.insert( values.end(), { middle, nextafter( middle, -HUGE_VALF ), nextafter( middle, HUGE_VALF ) } );
+        }
+
+        uint32_t random = 7;
+        for( int i = 0; i < 100000; ++i ) {
+            random = random * 1664525u + 1013904223u;
+            values.push_back( minimum - range + 3.f * range * static_cast< float >( random >> 8 ) / 16777216.f );
+        }
+        return values;
+    }
+
+    /**
+     * @brief      The batch map has to give the same colors as the single one
+     *             at every length and start around the blocks of four and eight
+     */
+    void CheckBatch( const CGradient& gradient, const vector< float >& values )
+    {
+        vector< Color > result( values.size() );
+        gradient.Map( values.data(), values.size(), result.data() );
+
+        auto matches = true;
+        for( size_t i = 0; i < values.size(); ++i ) {
+            matches = matches && result[ i ] == gradient.Map( values[ i ] );
+        }
+        for( size_t offset = 0; offset < 8; ++offset ) {
+            for( size_t count = 0; count <= 40; ++count ) {
+                vector< Color > span( count, Color( 1, 2, 3, 4 ) );
+                gradient.Map( values.data() + offset, count, span.data() );
+                for( size_t i = 0; i < count; ++i ) {
+                    matches = matches && span[ i ] == gradient.Map( values[ offset + i ] );
+                }
+            }
+        }
+        HAZE_CHECK( matches );
+    }
+
+    void TestMap( void )
+    {
+        const GradientStop stops[] = { { 1.f, Color( 255, 0, 0, 255 ) }, { 0.f, Color( 0, 0, 255, 128 ) }, { 0.4f, Color( 0, 255, 0, 255 ) } };
+        const struct
+        {
+            float minimum;
+            float maximum;
+        } ranges[] = { { 0.f, 1.f }, { -50.f, 150.f }, { 1e-3f, 2e-3f }, { -1e6f, 1e6f } };
+
+        for( const auto space : { GradientSpace::RGB, GradientSpace::HSV } ) {
+            for( const auto size : { CGradient::SMALL_TABLE, CGradient::LARGE_TABLE } ) {
+                CGradient gradient;
+                HAZE_CHECK( gradient.Build( stops, 3, space, size ) );
+                for( const auto& range : ranges ) {
+                    HAZE_CHECK( gradient.SetRange( range.minimum, range.maximum ) );
+
+                    // the ends are clamped and NaN maps to the start
+                    const auto* pTable = gradient.GetTable();
+                    HAZE_CHECK( gradient.Map( range.minimum ) == pTable[ 0 ] );
+                    HAZE_CHECK( gradient.Map( range.maximum ) == pTable[ size - 1 ] );
+                    HAZE_CHECK( gradient.Map( -HUGE_VALF ) == pTable[ 0 ] );
+                    HAZE_CHECK( gradient.Map( HUGE_VALF ) == pTable[ size - 1 ] );
+                    HAZE_CHECK( gradient.Map( NAN ) == pTable[ 0 ] );
+
+                    CheckBatch( gradient, MakeValues( gradient, range.minimum, range.maximum ) );
+                }
+            }
+        }
+    }
+
+    void TestBuild( void )
+    {
+        CGradient gradient;
+        const GradientStop stop = { 0.5f, Color( 10, 20, 30, 40 ) };
+        HAZE_CHECK( !gradient.Build( &stop, 0 ) );
+        HAZE_CHECK( !gradient.Build( &stop, 1, GradientSpace::RGB, 100 ) );
+        HAZE_CHECK( gradient.Build( &stop, 1 ) );
+        HAZE_CHECK( gradient.Map( 0.f ) == stop.color && gradient.Map( 1.f ) == stop.color );
+
+        HAZE_CHECK( !gradient.SetRange( 1.f, 1.f ) );
+        HAZE_CHECK( !gradient.SetRange( 0.f, NAN ) );
+        HAZE_CHECK( !gradient.SetRange( -FLT_MAX, FLT_MAX ) );
+    }
+}
+
+int main( void )
+{
+    TestMap();
+    TestBuild();
+    return test::GetResult();
+}
@@ -0,0 +1,151 @@
+#include "Check.hpp"
+#include "CommandList.hpp"
+#include "Graph.hpp"
+#include "SoftwareBackend.hpp"
+#include "Surface.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+using namespace haze;
+
+namespace {
+    bool IsEqual( const vector< PointF >& a, const vector< PointF >& b )
+    {
+        return a.size() == b.size() && equal( a.begin(), a.end(), b.begin(), []( const PointF& p, const PointF& q ) {
+            return p.x == q.x && p.y == q.y;
+        } );
+    }
+
+    void TestWrapAround( void )
+    {
+        vector< float > samples;
+        for( int i = 0; i < 300; ++i ) {
+            samples.push_back( static_cast< float >( i * 37 % 101 ) );
+        }
+
+        // the same samples rotated into a ring which wraps in the middle
+        for( const auto count : { size_t( 1 ), size_t( 40 ), size_t( 300 ) } ) {
+            for( const auto start : { size_t( 0 ), size_t( 1 ), size_t( 120 ), size_t( 299 ) } ) {
+                vector< float > ring( samples.size() );
+                for( size_t i = 0; i < samples.size(); ++i ) {
+                    ring[ ( start + i ) % ring.size() ] = samples[ i ];
+                }
+
+                for( const auto w : { 500.f, 64.f } ) {
+                    vector< PointF > unrolled, wrapped;
+                    BuildGraph( { samples.data(), samples.size(), 0, count }, { 10.f, 20.f, w, 50.f }, 0.f, 100.f, unrolled );
+                    BuildGraph( { ring.data(), ring.size(), start, count }, { 10.f, 20.f, w, 50.f }, 0.f, 100.f, wrapped );
+                    HAZE_CHECK( !unrolled.empty() && IsEqual( unrolled, wrapped ) );
+                }
+            }
+        }
+    }
+
+    void TestDecimation( void )
+    {
+        // a single spike in either direction inside a flat line of 1000 samples
+        vector< float > samples( 1000, 50.f );
+        samples[ 537 ] = 100.f;
+        samples[ 538 ] = 0.f;
+        samples[ 900 ] = 0.f;
+
+        const RectF bounds = { 0.f, 0.f, 40.f, 100.f };
+        vector< PointF > points;
+        const auto count = BuildGraph( { samples.data(), samples.size(), 0, samples.size() }, bounds, 0.f, 100.f, points );
+        HAZE_CHECK( count == points.size() && count <= 2 * 40 );
+
+        // no column has more than two points, and they stay in sample order
+        const auto step = bounds.w / 999.f;
+        vector< int > columns( 40 );
+        for( size_t i = 0; i < points.size(); ++i ) {
+            const auto column = static_cast< size_t >( lround( points[ i ].x / step ) ) * 40 / 1000;
+            HAZE_CHECK( column < columns.size() && ++columns[ column ] <= 2 );
+            HAZE_CHECK( i == 0 || points[ i - 1 ].x < points[ i ].x );
+        }
+
+        auto top = false, bottom = false, later = false;
+        for( const auto& point : points ) {
+            top = top || ( point.y == 0.f && point.x == 537.f * step );
+            bottom = bottom || ( point.y == 100.f && point.x == 538.f * step );
+            later = later || ( point.y == 100.f && point.x == 900.f * step );
+        }
+        HAZE_CHECK( top && bottom && later );
+    }
+
+    void TestInvalidSamples( void )
+    {
+        const RectF bounds = { 0.f, 10.f, 100.f, 40.f };
+        const float samples[] = { 1.f, NAN, INFINITY, -INFINITY, 3.f };
+        vector< PointF > points;
+
+        // NaN leaves a gap, infinities land on the edges of the box
+        HAZE_CHECK( BuildGraph( { samples, 5, 0, 5 }, bounds, 0.f, 4.f, points ) == 4 );
+        HAZE_CHECK( points[ 0 ].x == 0.f && points[ 0 ].y == 40.f );
+        HAZE_CHECK( points[ 1 ].x == 50.f && points[ 1 ].y == 10.f );
+        HAZE_CHECK( points[ 2 ].x == 75.f && points[ 2 ].y == 50.f );
+        HAZE_CHECK( points[ 3 ].x == 100.f && points[ 3 ].y == 20.f );
+
+        // with more samples than columns a column of NaN is left out
+        vector< float > many( 400, 2.f );
+        for( size_t i = 0; i < 200; ++i ) {
+            many[ i ] = NAN;
+        }
+        many[ 300 ] = INFINITY;
+        many[ 301 ] = -INFINITY;
+        HAZE_CHECK( BuildGraph( { many.data(), many.size(), 0, many.size() }, { 0.f, 0.f, 10.f, 40.f }, 0.f, 4.f, points ) == 6 );
+        for( const auto& point : points ) {
+            HAZE_CHECK( point.x >= 5.f && point.y >= 0.f && point.y <= 40.f );
+        }
+
+        // buffers, boxes and ranges which can't be drawn
+        HAZE_CHECK( !BuildGraph( { nullptr, 5, 0, 5 }, bounds, 0.f, 4.f, points ) && points.empty() );
+        HAZE_CHECK( !BuildGraph( { samples, 5, 5, 5 }, bounds, 0.f, 4.f, points ) );
+        HAZE_CHECK( !BuildGraph( { samples, 5, 0, 6 }, bounds, 0.f, 4.f, points ) );
+        HAZE_CHECK( !BuildGraph( { samples, 5, 0, 5 }, { 0.f, 0.f, 0.f, 40.f }, 0.f, 4.f, points ) );
+        HAZE_CHECK( !BuildGraph( { samples, 5, 0, 5 }, bounds, 4.f, 4.f, points ) );
+        HAZE_CHECK( !BuildGraph( { samples, 5, 0, 5 }, bounds, 0.f, INFINITY, points ) );
+    }
+
+    void TestReplay( void )
+    {
+        vector< float > samples( 600 );
+        for( size_t i = 0; i < samples.size(); ++i ) {
+            samples[ i ] = 50.f + 40.f * sin( static_cast< float >( i ) * 0.05f ) + ( i % 97 == 0 ? 30.f : 0.f );
+        }
+        const SampleBuffer buffer = { samples.data(), samples.size(), 250, samples.size() };
+
+        // a graph drawn directly and one recorded and replayed hit the same pixels
+        CSoftwareBackend backend( 200, 120 );
+        CRenderSurface direct( &backend ), recorded( &backend );
+        CCommandList list;
+        recorded.SetCommandSink( &list );
+        for( const auto mode : { AntialiasMode::PerPrimitive, AntialiasMode::Aliased } ) {
+            for( const auto thickness : { 1.f, 2.5f } ) {
+                backend.BeginFrame();
+                direct.SetAntialiasMode( mode );
+                HAZE_CHECK( direct.Graph( 10.5f, 10.f, 180.f, 100.f, buffer, 0.f, 120.f, thickness, Color( 80, 220, 120, 200 ) ) );
+                backend.EndFrame();
+                const vector< uint32_t > pixels( backend.GetPixels(), backend.GetPixels() + 200 * 120 );
+                HAZE_CHECK( count_if( pixels.begin(), pixels.end(), [ & ]( uint32_t pixel ) { return pixel != pixels[ 0 ]; } ) > 180 );
+
+                list.Reset();
+                recorded.SetAntialiasMode( mode );
+                HAZE_CHECK( recorded.Graph( 10.5f, 10.f, 180.f, 100.f, buffer, 0.f, 120.f, thickness, Color( 80, 220, 120, 200 ) ) );
+                backend.BeginFrame();
+                HAZE_CHECK( list.Replay( backend ) );
+                backend.EndFrame();
+                HAZE_CHECK( memcmp( backend.GetPixels(), pixels.data(), pixels.size() * sizeof( uint32_t ) ) == 0 );
+            }
+        }
+    }
+}
+
+int main( void )
+{
+    TestWrapAround();
+    TestDecimation();
+    TestInvalidSamples();
+    TestReplay();
+    return test::GetResult();
+}
@@ -0,0 +1,115 @@
+#include "Check.hpp"
+#include "SoftwareBackend.hpp"
+#include "Surface.hpp"
+#include <cstdlib>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr int32_t WIDTH = 160;
+    constexpr int32_t HEIGHT = 120;
+
+    /**
+     * @brief      Do two frames differ by at most one in every channel?
+     */
+    bool IsClose( const vector< uint32_t >& a, const uint32_t* b )
+    {
+        for( size_t i = 0; i < a.size(); ++i ) {
+            for( int shift = 0; shift < 32; shift += 8 ) {
+                if( abs( static_cast< int >( a[ i ] >> shift & 0xFF ) - static_cast< int >( b[ i ] >> shift & 0xFF ) ) > 1 ) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void TestOutlinedShapes( void )
+    {
+        CSoftwareBackend backend( WIDTH, HEIGHT );
+        CRenderSurface surface( &backend );
+        backend.SetOverdrawCounter( true );
+
+        const Color fill( 40, 120, 200, 160 ), outline( 250, 200, 20, 200 );
+        for( const auto mode : { AntialiasMode::PerPrimitive, AntialiasMode::Aliased } ) {
+            // every covered pixel is blended once, the outline and the fill only meet
+            for( const auto offset : { 0.f, 0.25f, 0.5f } ) {
+                backend.BeginFrame();
+                backend.SetAntialiasMode( mode );
+                HAZE_CHECK( surface.RoundedRect( 10.f + offset, 12.f + offset, 100.f, 70.f, 12.f, 9.f, 3.f, -1.f, -1.f, fill, outline ) );
+                auto statistics = backend.GetOverdrawStatistics();
+                HAZE_CHECK( statistics.nMaxOverdraw == 1 && statistics.nPixelWrites == statistics.nPixelsWritten );
+                HAZE_CHECK( statistics.nPixelsWritten > 100 * 70 );
+
+                // antialiased rectangles between pixels share the pixel they meet in
+                if( mode == AntialiasMode::PerPrimitive && offset != 0.f ) {
+                    continue;
+                }
+
+                backend.BeginFrame();
+                backend.SetAntialiasMode( mode );
+                HAZE_CHECK( surface.Rect( 20.f + offset, 20.f, 60.f, 40.f, 4.f, fill, outline ) );
+                statistics = backend.GetOverdrawStatistics();
+                HAZE_CHECK( statistics.nMaxOverdraw == 1 && statistics.nPixelWrites == statistics.nPixelsWritten );
+
+                backend.BeginFrame();
+                backend.SetAntialiasMode( mode );
+                HAZE_CHECK( surface.BorderBox( 5.f, 5.f + offset, 120.f, 90.f, 2.f, outline ) );
+                HAZE_CHECK( surface.BorderBox( 30.f + offset, 30.f, 40.f, 30.f, 3.f, 1.f, fill, outline ) );
+                statistics = backend.GetOverdrawStatistics();
+                HAZE_CHECK( statistics.nMaxOverdraw == 1 && statistics.nPixelWrites == statistics.nPixelsWritten );
+                backend.EndFrame();
+            }
+        }
+
+        // overlapping shapes are counted as overdraw
+        backend.BeginFrame();
+        surface.Rect( 0.f, 0.f, 10.f, 10.f, fill );
+        surface.Rect( 5.f, 5.f, 10.f, 10.f, fill );
+        const auto statistics = backend.GetOverdrawStatistics();
+        HAZE_CHECK( statistics.nMaxOverdraw == 2 && statistics.nPixelWrites == 200 && statistics.nPixelsWritten == 175 );
+        HAZE_CHECK( backend.GetOverdraw( 7, 7 ) == 2 && backend.GetOverdraw( 2, 2 ) == 1 && !backend.GetOverdraw( 20, 20 ) );
+        backend.EndFrame();
+
+        backend.SetOverdrawCounter( false );
+        backend.BeginFrame();
+        surface.Rect( 0.f, 0.f, 10.f, 10.f, fill );
+        HAZE_CHECK( !backend.GetOverdrawStatistics().nPixelWrites && !backend.GetOverdraw( 2, 2 ) );
+        backend.EndFrame();
+    }
+
+    void TestFrameMatchesFills( void )
+    {
+        // the ring and an opaque inset in one pass look like the inset filled over the whole shape
+        CSoftwareBackend frame( WIDTH, HEIGHT ), fills( WIDTH, HEIGHT );
+        frame.SetClearColor( 0xFF302010 );
+        fills.SetClearColor( 0xFF302010 );
+        for( const auto mode : { AntialiasMode::PerPrimitive, AntialiasMode::Aliased } ) {
+            for( const auto color : { 0xFFF0C020u, 0x80F0C020u } ) {
+                frame.BeginFrame();
+                frame.SetAntialiasMode( mode );
+                frame.FillRoundedFrame( 10.25f, 8.5f, 120.f, 90.f, 16.f, 12.f, 3.5f, 12.f, 9.f, color, 0xFF2060A0 );
+                frame.FillRoundedFrame( 60.75f, 50.f, 80.f, 60.f, 4.f, 30.f, 6.f, 0.f, 20.f, color, 0xFF80FF80 );
+                frame.EndFrame();
+
+                fills.BeginFrame();
+                fills.SetAntialiasMode( mode );
+                fills.FillRoundedRect( 10.25f, 8.5f, 120.f, 90.f, 16.f, 12.f, color );
+                fills.FillRoundedRect( 13.75f, 12.f, 113.f, 83.f, 12.f, 9.f, 0xFF2060A0 );
+                fills.FillRoundedRect( 60.75f, 50.f, 80.f, 60.f, 4.f, 30.f, color );
+                fills.FillRoundedRect( 66.75f, 56.f, 68.f, 48.f, 0.f, 20.f, 0xFF80FF80 );
+                fills.EndFrame();
+
+                const vector< uint32_t > pixels( frame.GetPixels(), frame.GetPixels() + WIDTH * HEIGHT );
+                HAZE_CHECK( IsClose( pixels, fills.GetPixels() ) );
+            }
+        }
+    }
+}
+
+int main( void )
+{
+    TestOutlinedShapes();
+    TestFrameMatchesFills();
+    return test::GetResult();
+}
@@ -0,0 +1,145 @@
+#include "Check.hpp"
+#include "CallbackRegistry.hpp"
+#include "CommandList.hpp"
+#include "ParallelRecorder.hpp"
+#include "SoftwareBackend.hpp"
+#include "Surface.hpp"
+#include <cstring>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr int32_t WIDTH = 320;
+    constexpr int32_t HEIGHT = 240;
+
+    /**
+     * @brief      Callback which changes every kind of state and leaves some of
+     *             it set for the callbacks after it
+     */
+    void Draw( const CRenderSurface* pSurface, int index )
+    {
+        const auto f = static_cast< float >( index );
+        if( index % 3 == 0 ) {
+            pSurface->SetTransform( { 0.9659258f, 0.2588190f, -0.2588190f, 0.9659258f, f * 5.f, 10.f } );
+        }
+        else if( index % 3 == 1 ) {
+            pSurface->SetTransform( Transform::Identity() );
+        }
+        pSurface->SetAntialiasMode( index % 2 ? AntialiasMode::Aliased : AntialiasMode::PerPrimitive );
+
+        const Color color( 40 * index % 256, 255 - 30 * index % 256, 90, 128 + index % 128 );
+        pSurface->Rect( f * 7.f, f * 5.f, 30.f, 20.f, color );
+        pSurface->RoundedRect( 200.f - f * 3.f, f * 4.f, 50.f, 30.f, 6.f, 6.f, 2.f, 4.f, 4.f, color, Color( 20, 20, 20, 200 ) );
+        pSurface->String( f * 6.f, 200.f - f * 4.f, "label", color, HAZE_FORMAT( "callback {}" ), index );
+
+        const PointF points[] = { { 10.f, 230.f - f }, { 60.f + f, 180.f }, { 110.f, 220.f - f * 2.f }, { 160.f, 150.f + f } };
+        pSurface->Polyline( points, 4, 1.f + static_cast< float >( index % 3 ), color );
+    }
+
+    /**
+     * @brief      Record every callback one after another on one surface, like
+     *             the overlay does without a parallel recorder
+     */
+    void RecordSerial( CCallbackRegistry& registry, IRenderBackend* pRenderBackend, CCommandList& list )
+    {
+        registry.Compact();
+        list.Reset();
+        CRenderSurface surface( pRenderBackend );
+        surface.SetCommandSink( &list );
+        for( size_t i = 0; i < registry.GetEntryCount(); ++i ) {
+            if( registry.IsActive( i ) ) {
+                registry.Invoke( i, &surface );
+            }
+        }
+    }
+
+    /**
+     * @brief      Replay both lists on the backend which owns their fonts and
+     *             compare the pixels
+     */
+    bool ReplaysEqual( const CCommandList& a, const CCommandList& b, CSoftwareBackend& backend )
+    {
+        backend.SetClearColor( 0xFF101820 );
+        backend.BeginFrame();
+        auto replayed = a.Replay( backend );
+        backend.EndFrame();
+        const vector< uint32_t > pixels( backend.GetPixels(), backend.GetPixels() + WIDTH * HEIGHT );
+
+        backend.BeginFrame();
+        replayed = b.Replay( backend ) && replayed;
+        backend.EndFrame();
+        return replayed && memcmp( backend.GetPixels(), pixels.data(), pixels.size() * sizeof( uint32_t ) ) == 0;
+    }
+
+    void TestMatchesSerial( void )
+    {
+        CSoftwareBackend backend( WIDTH, HEIGHT );
+        HAZE_CHECK( backend.LoadFontFile( "DejaVu", HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf" ) );
+        HAZE_CHECK( backend.RegisterFont( "label", "DejaVu", 13.f ) );
+
+        for( const auto workers : { 0, 1, 3, 8 } ) {
+            CParallelRecorder recorder( workers );
+            HAZE_CHECK( recorder.GetPool().GetWorkerCount() == static_cast< size_t >( workers ) );
+
+            for( const auto count : { 1, 3, 40 } ) {
+                // added in reverse, the priorities sort them
+                CCallbackRegistry registry;
+                for( auto index = count; index-- > 0; ) {
+                    registry.Add( [ index ]( const CRenderSurface* pSurface ) { Draw( pSurface, index ); }, index );
+                }
+
+                CCommandList serial, parallel;
+                RecordSerial( registry, &backend, serial );
+                HAZE_CHECK( serial.size() >= static_cast< size_t >( count ) * 5 );
+
+                // the second frame records into the lists of the first one
+                for( int frame = 0; frame < 2; ++frame ) {
+                    registry.Compact();
+                    HAZE_CHECK( recorder.Record( registry, &backend, 60, parallel ) );
+                    HAZE_CHECK( parallel.Hash() == serial.Hash() );
+                    HAZE_CHECK( parallel.size() == serial.size() );
+                }
+                HAZE_CHECK( ReplaysEqual( serial, parallel, backend ) );
+            }
+        }
+    }
+
+    void TestInactive( void )
+    {
+        CSoftwareBackend backend( WIDTH, HEIGHT );
+        HAZE_CHECK( backend.LoadFontFile( "DejaVu", HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf" ) );
+        HAZE_CHECK( backend.RegisterFont( "label", "DejaVu", 13.f ) );
+
+        CCallbackRegistry registry;
+        vector< CallbackHandle > handles;
+        for( int index = 0; index < 12; ++index ) {
+            handles.push_back( registry.Add( [ index ]( const CRenderSurface* pSurface ) { Draw( pSurface, index ); } ) );
+        }
+        registry.Compact();
+
+        CParallelRecorder recorder( 3 );
+        CCommandList serial, parallel;
+        HAZE_CHECK( recorder.Record( registry, &backend, 60, parallel ) );
+
+        // disabled and removed callbacks leave nothing behind in the next
+        // frame, before and after the removed entry is compacted away
+        registry.SetEnabled( handles[ 2 ], false );
+        registry.Remove( handles[ 7 ] );
+        HAZE_CHECK( recorder.Record( registry, &backend, 60, parallel ) );
+        RecordSerial( registry, &backend, serial );
+        HAZE_CHECK( parallel.Hash() == serial.Hash() );
+
+        HAZE_CHECK( recorder.Record( registry, &backend, 60, parallel ) );
+        HAZE_CHECK( parallel.Hash() == serial.Hash() );
+        HAZE_CHECK( ReplaysEqual( serial, parallel, backend ) );
+
+        HAZE_CHECK( !recorder.Record( registry, nullptr, 60, parallel ) && parallel.empty() );
+    }
+}
+
+int main( void )
+{
+    TestMatchesSerial();
+    TestInactive();
+    return test::GetResult();
+}
@@ -0,0 +1,140 @@
+#include "Check.hpp"
+#include "CommandList.hpp"
+#include "RectBatcher.hpp"
+#include "RenderBackend.hpp"
+#include "SoftwareBackend.hpp"
+#include "Surface.hpp"
+#include <cstring>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Replay a list plainly and through the batcher, both have to
+     *             produce the same pixels
+     */
+    bool MatchesPlainReplay( const CCommandList& list )
+    {
+        CSoftwareBackend plain( 256, 256 ), batched( 256, 256 );
+        plain.SetClearColor( 0xFF202020 );
+        batched.SetClearColor( 0xFF202020 );
+
+        CRectBatcher batcher;
+        plain.BeginFrame();
+        batched.BeginFrame();
+        return list.Replay( plain ) && batcher.Submit( list, batched ) &&
+               memcmp( plain.GetPixels(), batched.GetPixels(), 256 * 256 * sizeof( uint32_t ) ) == 0;
+    }
+
+    void TestOutlinedBorderBoxes( void )
+    {
+        // 300 outlined boxes which do not touch each other
+        CCountingRenderBackend backend( 1920, 1080 );
+        CCommandList list;
+        CRenderSurface surface( &backend );
+        surface.SetCommandSink( &list );
+        for( int i = 0; i < 300; ++i ) {
+            surface.BorderBox( 10.f + ( i % 20 ) * 90.f, 10.f + ( i / 20 ) * 70.f, 60.f, 40.f, 2.f, 1.f, Color( 255, 255, 255, 255 ), Color( 0, 0, 0, 255 ) );
+        }
+
+        // every box is three bordered boxes of four rectangles each
+        HAZE_CHECK( list.size() == 3600 );
+        HAZE_CHECK( list.Replay( backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 3600 );
+
+        // one geometry per color
+        backend.Reset();
+        CRectBatcher batcher;
+        HAZE_CHECK( batcher.Submit( list, backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 2 );
+        HAZE_CHECK( backend.GetCounters().nBatches == 2 );
+        HAZE_CHECK( backend.GetCounters().nBatchedRects == 3600 );
+        HAZE_CHECK( batcher.GetCounters().nRects == 3600 );
+        HAZE_CHECK( batcher.GetCounters().nBatches == 2 );
+    }
+
+    void TestOrder( void )
+    {
+        CCountingRenderBackend backend( 256, 256 );
+        CRectBatcher batcher;
+
+        // the third rectangle is drawn over the second one, it must not join the first
+        CCommandList list;
+        list.FillRect( 0.f, 0.f, 50.f, 50.f, 0xFFFF0000 );
+        list.FillRect( 40.f, 40.f, 50.f, 50.f, 0xFF0000FF );
+        list.FillRect( 80.f, 80.f, 50.f, 50.f, 0xFFFF0000 );
+        HAZE_CHECK( batcher.Submit( list, backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 3 );
+        HAZE_CHECK( MatchesPlainReplay( list ) );
+
+        // without the overlap it does
+        backend.Reset();
+        list.Reset();
+        list.FillRect( 0.f, 0.f, 50.f, 50.f, 0xFFFF0000 );
+        list.FillRect( 40.f, 40.f, 50.f, 50.f, 0xFF0000FF );
+        list.FillRect( 100.f, 100.f, 50.f, 50.f, 0xFFFF0000 );
+        HAZE_CHECK( batcher.Submit( list, backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 2 );
+        HAZE_CHECK( MatchesPlainReplay( list ) );
+    }
+
+    void TestTranslucent( void )
+    {
+        CCountingRenderBackend backend( 256, 256 );
+        CRectBatcher batcher;
+
+        // overlapping translucent rectangles blend twice, they stay apart
+        CCommandList list;
+        list.FillRect( 0.f, 0.f, 50.f, 50.f, 0x80FF0000 );
+        list.FillRect( 25.f, 25.f, 50.f, 50.f, 0x80FF0000 );
+        list.FillRect( 100.f, 100.f, 50.f, 50.f, 0x80FF0000 );
+        HAZE_CHECK( batcher.Submit( list, backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 2 );
+        HAZE_CHECK( MatchesPlainReplay( list ) );
+    }
+
+    void TestRandom( void )
+    {
+        // small and large, opaque and translucent rectangles in any order,
+        // the grid has to find every overlap a plain replay draws
+        const uint32_t colors[] = { 0xFFFF0000, 0xFF00FF00, 0x800000FF, 0x40FFFFFF };
+        uint32_t random = 3;
+        const auto next = [ & ]( uint32_t range ) {
+            random = random * 1664525u + 1013904223u;
+            return static_cast< float >( ( random >> 8 ) % range );
+        };
+
+        CCommandList list;
+        for( int i = 0; i < 3000; ++i ) {
+            const auto size = i % 50 ? 24u : 400u;
+            list.FillRect( next( 300 ) - 20.f, next( 300 ) - 20.f, next( size ) - 4.f, next( size ) - 4.f, colors[ static_cast< size_t >( next( 4 ) ) ] );
+        }
+        list.FillRect( 1e7f, 1e7f, 10.f, 10.f, colors[ 0 ] );
+        HAZE_CHECK( MatchesPlainReplay( list ) );
+    }
+
+    void TestOtherCommands( void )
+    {
+        CCountingRenderBackend backend( 256, 256 );
+        CRectBatcher batcher;
+
+        // any other command ends the run, it may overlap the pending rectangles
+        CCommandList list;
+        list.FillRect( 0.f, 0.f, 50.f, 50.f, 0xFFFF0000 );
+        list.Line( 0.f, 0.f, 200.f, 200.f, 3.f, 0xFF00FF00 );
+        list.FillRect( 100.f, 100.f, 50.f, 50.f, 0xFFFF0000 );
+        HAZE_CHECK( batcher.Submit( list, backend ) );
+        HAZE_CHECK( backend.GetDrawCalls() == 3 );
+        HAZE_CHECK( backend.GetCounters().nLines == 1 );
+        HAZE_CHECK( MatchesPlainReplay( list ) );
+    }
+}
+
+int main( void )
+{
+    TestOutlinedBorderBoxes();
+    TestOrder();
+    TestTranslucent();
+    TestRandom();
+    TestOtherCommands();
+    return test::GetResult();
+}
@@ -0,0 +1,80 @@
+#include "Check.hpp"
+#include "RenderBackend.hpp"
+#include "RenderThread.hpp"
+#include <chrono>
+#include <thread>
+using namespace haze;
+
+namespace {
+    /**
+     * @brief      Wait until the render thread picked up every published scene
+     */
+    RenderThreadStatistics WaitForPresents( const CRenderThread& renderThread )
+    {
+        auto statistics = renderThread.GetStatistics();
+        for( int i = 0; i < 5000 && statistics.nPresented + statistics.nDropped < statistics.nPublished; ++i ) {
+            this_thread::sleep_for( chrono::milliseconds( 1 ) );
+            statistics = renderThread.GetStatistics();
+        }
+        return statistics;
+    }
+
+    void CheckConsistent( const RenderThreadStatistics& statistics )
+    {
+        HAZE_CHECK( statistics.nPresented + statistics.nDropped <= statistics.nPublished );
+        if( statistics.nPresented ) {
+            HAZE_CHECK( statistics.nMinLatency <= statistics.nAverageLatency );
+            HAZE_CHECK( statistics.nAverageLatency <= statistics.nMaxLatency );
+            HAZE_CHECK( statistics.nLastLatency <= statistics.nMaxLatency );
+        }
+        else {
+            HAZE_CHECK( !statistics.nMinLatency && !statistics.nAverageLatency );
+        }
+    }
+
+    void TestStatistics( void )
+    {
+        CCountingRenderBackend backend( 256, 256 );
+        CRenderThread renderThread( &backend );
+        HAZE_CHECK( renderThread.Start() );
+
+        // the snapshot has to be consistent while scenes are presented
+        for( int i = 0; i < 2000; ++i ) {
+            auto& list = renderThread.BeginScene();
+            list.FillRect( 0.f, 0.f, 10.f, 10.f, 0xFFFFFFFF );
+            renderThread.PublishScene();
+            CheckConsistent( renderThread.GetStatistics() );
+        }
+
+        const auto statistics = WaitForPresents( renderThread );
+        HAZE_CHECK( statistics.nPublished == 2000 );
+        HAZE_CHECK( statistics.nPresented + statistics.nDropped == 2000 );
+        HAZE_CHECK( statistics.nPresented > 0 );
+        CheckConsistent( statistics );
+
+        // the running render thread resets them itself
+        renderThread.ResetStatistics();
+        auto reset = renderThread.GetStatistics();
+        for( int i = 0; i < 5000 && reset.nPresented; ++i ) {
+            this_thread::sleep_for( chrono::milliseconds( 1 ) );
+            reset = renderThread.GetStatistics();
+        }
+        HAZE_CHECK( !reset.nPublished && !reset.nPresented && !reset.nDropped && !reset.nMaxLatency );
+
+        renderThread.BeginScene();
+        renderThread.PublishScene();
+        const auto next = WaitForPresents( renderThread );
+        HAZE_CHECK( next.nPublished == 1 && next.nPresented + next.nDropped == 1 );
+        CheckConsistent( next );
+
+        renderThread.Stop();
+        renderThread.ResetStatistics();
+        HAZE_CHECK( !renderThread.GetStatistics().nPublished );
+    }
+}
+
+int main( void )
+{
+    TestStatistics();
+    return test::GetResult();
+}
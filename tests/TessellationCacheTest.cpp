@@ -0,0 +1,145 @@
+#include "Check.hpp"
+#include "SoftwareBackend.hpp"
+#include "TessellationCache.hpp"
+#include <cstring>
+#include <vector>
+using namespace haze;
+
+namespace {
+    bool IsInside( const Tessellation& tessellation, float w, float h )
+    {
+        for( const auto& point : tessellation.cPoints ) {
+            if( point.x < -1e-4f || point.y < -1e-4f || point.x > w + 1e-4f || point.y > h + 1e-4f ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestKeys( void )
+    {
+        CTessellationCache cache;
+        const auto* pFrame = cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.f, 4.f, 3.f, 4, 3 );
+        HAZE_CHECK( pFrame && pFrame->nOuter == 4 * 5 && pFrame->cPoints.size() == 4 * 5 + 4 * 4 );
+        HAZE_CHECK( cache.GetStatistics().nMisses == 1 && !cache.GetStatistics().nHits );
+
+        // the same shape is the same entry
+        HAZE_CHECK( cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.f, 4.f, 3.f, 4, 3 ) == pFrame );
+        HAZE_CHECK( cache.GetStatistics().nHits == 1 && cache.GetStatistics().nEntries == 1 );
+
+        // every part of the key tells shapes apart
+        const auto misses = cache.GetStatistics().nMisses;
+        cache.GetRoundedFrame( 41.f, 20.f, 6.f, 5.f, 2.f, 4.f, 3.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 21.f, 6.f, 5.f, 2.f, 4.f, 3.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 7.f, 5.f, 2.f, 4.f, 3.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 6.f, 4.f, 2.f, 4.f, 3.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.5f, 4.f, 3.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.f, 3.f, 3.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.f, 4.f, 2.f, 4, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.f, 4.f, 3.f, 5, 3 );
+        cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 2.f, 4.f, 3.f, 4, 4 );
+        cache.GetRoundedRect( 40.f, 20.f, 6.f, 5.f, 4 );
+        HAZE_CHECK( cache.GetStatistics().nMisses == misses + 10 && cache.GetStatistics().nHits == 1 );
+        HAZE_CHECK( cache.GetStatistics().nEntries == 11 );
+
+        // a frame without thickness or without room for the inset is its outer shape
+        const auto hits = cache.GetStatistics().nHits;
+        const auto* pRect = cache.GetRoundedRect( 40.f, 20.f, 6.f, 5.f, 4 );
+        HAZE_CHECK( cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 0.f, 4.f, 3.f, 4, 3 ) == pRect );
+        HAZE_CHECK( cache.GetRoundedFrame( 40.f, 20.f, 6.f, 5.f, 10.f, 4.f, 3.f, 4, 3 ) == pRect );
+        HAZE_CHECK( pRect->nOuter == pRect->cPoints.size() && cache.GetStatistics().nHits == hits + 3 );
+    }
+
+    void TestClamping( void )
+    {
+        CTessellationCache cache;
+
+        // radii beyond half of the size are the same as half of it, negative ones zero
+        const auto* pRect = cache.GetRoundedRect( 10.f, 20.f, 100.f, -5.f, 4 );
+        HAZE_CHECK( cache.GetRoundedRect( 10.f, 20.f, 5.f, 0.f, 4 ) == pRect );
+        HAZE_CHECK( cache.GetStatistics().nHits == 1 && IsInside( *pRect, 10.f, 20.f ) );
+
+        // the inner radii are limited by the inset, the outer ones by the shape
+        const auto* pFrame = cache.GetRoundedFrame( 30.f, 20.f, 50.f, 50.f, 4.f, 50.f, 50.f, 4, 4 );
+        HAZE_CHECK( cache.GetRoundedFrame( 30.f, 20.f, 15.f, 10.f, 4.f, 11.f, 6.f, 4, 4 ) == pFrame );
+        HAZE_CHECK( IsInside( *pFrame, 30.f, 20.f ) );
+        for( size_t i = pFrame->nOuter; i < pFrame->cPoints.size(); ++i ) {
+            const auto& point = pFrame->cPoints[ i ];
+            HAZE_CHECK( point.x >= 4.f - 1e-4f && point.x <= 26.f + 1e-4f && point.y >= 4.f - 1e-4f && point.y <= 16.f + 1e-4f );
+        }
+
+        // at least one segment per quarter ellipse
+        HAZE_CHECK( cache.GetRoundedRect( 8.f, 8.f, 2.f, 2.f, 0 ) == cache.GetRoundedRect( 8.f, 8.f, 2.f, 2.f, 1 ) );
+        HAZE_CHECK( CTessellationCache::GetArcSegments( 0.f ) == 1 && CTessellationCache::GetArcSegments( 1e6f ) == 64 );
+    }
+
+    void TestEviction( void )
+    {
+        CTessellationCache cache;
+        cache.GetRoundedRect( 10.f, 10.f, 2.f, 2.f, 4 );
+        const auto size = cache.GetStatistics().nBytes;
+
+        // room for two shapes of the same point count
+        cache.Clear();
+        cache.SetBudget( 2 * size );
+        cache.GetRoundedRect( 10.f, 10.f, 2.f, 2.f, 4 );
+        cache.GetRoundedRect( 20.f, 10.f, 2.f, 2.f, 4 );
+        cache.GetRoundedRect( 10.f, 10.f, 2.f, 2.f, 4 );
+        cache.GetRoundedRect( 30.f, 10.f, 2.f, 2.f, 4 );
+        HAZE_CHECK( cache.GetStatistics().nEvictions == 1 && cache.GetStatistics().nEntries == 2 );
+        HAZE_CHECK( cache.GetStatistics().nBytes == 2 * size );
+
+        // the least recently used one left, the one used in between stayed
+        const auto misses = cache.GetStatistics().nMisses;
+        cache.GetRoundedRect( 10.f, 10.f, 2.f, 2.f, 4 );
+        cache.GetRoundedRect( 30.f, 10.f, 2.f, 2.f, 4 );
+        HAZE_CHECK( cache.GetStatistics().nMisses == misses );
+        cache.GetRoundedRect( 20.f, 10.f, 2.f, 2.f, 4 );
+        HAZE_CHECK( cache.GetStatistics().nMisses == misses + 1 );
+
+        // a smaller budget evicts right away, without one the newest shape stays
+        cache.SetBudget( size );
+        HAZE_CHECK( cache.GetStatistics().nEntries == 1 );
+        cache.SetBudget( 0 );
+        HAZE_CHECK( !cache.GetStatistics().nEntries );
+        const auto* pRect = cache.GetRoundedRect( 10.f, 10.f, 2.f, 2.f, 4 );
+        HAZE_CHECK( pRect && pRect->cPoints.size() == 20 && cache.GetStatistics().nEntries == 1 );
+    }
+
+    void TestSoftwareBackend( void )
+    {
+        // a shape drawn from the cache looks like one flattened for the first time
+        CSoftwareBackend cold( 128, 96 ), warm( 128, 96 );
+        for( const auto mode : { AntialiasMode::PerPrimitive, AntialiasMode::Aliased } ) {
+            cold.GetTessellationCache().Clear();
+            cold.BeginFrame();
+            cold.SetAntialiasMode( mode );
+            cold.FillRoundedRect( 60.25f, 40.5f, 50.f, 30.f, 9.f, 7.f, 0xC0FF8020 );
+            cold.FillRoundedFrame( 5.75f, 50.25f, 40.f, 40.f, 10.f, 10.f, 3.f, 7.f, 7.f, 0xFFFFFFFF, 0x80204080 );
+            cold.EndFrame();
+
+            warm.BeginFrame();
+            warm.SetAntialiasMode( mode );
+            warm.FillRoundedRect( 3.f, 2.f, 50.f, 30.f, 9.f, 7.f, 0xFF000000 );
+            warm.FillRoundedFrame( 70.f, 1.f, 40.f, 40.f, 10.f, 10.f, 3.f, 7.f, 7.f, 0xFF000000, 0xFF000000 );
+            warm.BeginFrame();
+            warm.SetAntialiasMode( mode );
+            const auto hits = warm.GetTessellationCache().GetStatistics().nHits;
+            warm.FillRoundedRect( 60.25f, 40.5f, 50.f, 30.f, 9.f, 7.f, 0xC0FF8020 );
+            warm.FillRoundedFrame( 5.75f, 50.25f, 40.f, 40.f, 10.f, 10.f, 3.f, 7.f, 7.f, 0xFFFFFFFF, 0x80204080 );
+            warm.EndFrame();
+
+            HAZE_CHECK( warm.GetTessellationCache().GetStatistics().nHits == hits + 2 );
+            HAZE_CHECK( memcmp( cold.GetPixels(), warm.GetPixels(), 128 * 96 * sizeof( uint32_t ) ) == 0 );
+        }
+    }
+}
+
+int main( void )
+{
+    TestKeys();
+    TestClamping();
+    TestEviction();
+    TestSoftwareBackend();
+    return test::GetResult();
+}
@@ -0,0 +1,73 @@
+#include "Check.hpp"
+#include "SoftwareBackend.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+using namespace haze;
+
+namespace {
+    constexpr int32_t WIDTH = 384;
+    constexpr int32_t HEIGHT = 256;
+
+    /**
+     * @brief      Draw a background which differs from pixel to pixel
+     */
+    void DrawBackground( CSoftwareBackend& backend )
+    {
+        for( int i = 0; i < 24; ++i ) {
+            const auto f = static_cast< float >( i );
+            backend.FillRect( f * 15.3f, 0.f, 9.7f, static_cast< float >( HEIGHT ), 0x40000000u * ( i % 4 ) | ( 0x00102030u * ( i % 7 ) ) );
+            backend.FillRect( 0.f, f * 10.6f + 0.5f, static_cast< float >( WIDTH ), 4.25f, 0x60FFFFFFu - 0x00080402u * i );
+        }
+    }
+
+    /**
+     * @brief      Draw text at every alignment to the groups of four pixels
+     *             the vector paths blend
+     */
+    void DrawStrings( CSoftwareBackend& backend, const void* pSmall, const void* pLarge )
+    {
+        const wstring text = L"The quick brown fox 0123 {}[]";
+        const uint32_t colors[] = { 0xFFFFFFFF, 0xFF000000, 0x80FF4000, 0x2000C0FF };
+        for( int i = 0; i < 16; ++i ) {
+            const auto x = 3.f + static_cast< float >( i % 4 ) + static_cast< float >( i / 4 ) * 0.25f;
+            backend.Text( x, 2.f + static_cast< float >( i ) * 12.f, 380.f, 16.f, text.c_str(), text.size(), pSmall, colors[ i % 4 ] );
+        }
+        backend.Text( 1.f, 196.f, 380.f, 40.f, text.c_str(), text.size(), pLarge, 0xC0FFFF00 );
+
+        // under a rotation the glyphs are filled from their outlines
+        const Transform rotation = { 0.9659258f, 0.2588190f, -0.2588190f, 0.9659258f, 200.f, 150.f };
+        backend.SetTransform( rotation );
+        backend.Text( 0.f, 0.f, 200.f, 40.f, text.c_str(), text.size(), pLarge, 0xE0FF80FF );
+        backend.SetTransform( Transform::Identity() );
+    }
+
+    void TestText( void )
+    {
+        CSoftwareBackend backend( WIDTH, HEIGHT );
+        HAZE_CHECK( backend.LoadFontFile( "DejaVu", HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf" ) );
+        const auto* pSmall = backend.RegisterFont( "small", "DejaVu", 11.f );
+        const auto* pLarge = backend.RegisterFont( "large", "DejaVu", 24.f );
+
+        backend.SetClearColor( 0xFF204060 );
+        HAZE_CHECK( backend.BeginFrame() );
+        DrawBackground( backend );
+        const vector< uint32_t > background( backend.GetPixels(), backend.GetPixels() + WIDTH * HEIGHT );
+        DrawStrings( backend, pSmall, pLarge );
+        HAZE_CHECK( backend.EndFrame() );
+
+        // the text has to show, or the comparison proves nothing
+        size_t changed = 0;
+        for( size_t i = 0; i < background.size(); ++i ) {
+            changed += background[ i ] != backend.GetPixels()[ i ];
+        }
+        HAZE_CHECK( changed > 10000 );
+        HAZE_CHECK( test::MatchesVectorBuild( "TextTest", backend.GetPixels(), WIDTH * HEIGHT * sizeof( uint32_t ) ) );
+    }
+}
+
+int main( void )
+{
+    TestText();
+    return test::GetResult();
+}
@@ -0,0 +1,133 @@
+#include "Check.hpp"
+#include "TrueType.hpp"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+using namespace haze;
+
+namespace {
+    using Bytes = vector< uint8_t >;
+
+    const char* const REQUIRED_TABLES[] = { "cmap", "glyf", "head", "hhea", "hmtx", "loca", "maxp" };
+
+    Bytes ReadFont( void )
+    {
+        ifstream file( HAZE_FONTS_DIRECTORY "/DejaVuSansMono.ttf", ios::binary );
+        return Bytes( istreambuf_iterator< char >( file ), istreambuf_iterator< char >() );
+    }
+
+    uint32_t ReadU32( const Bytes& data, size_t offset )
+    {
+        return static_cast< uint32_t >( data[ offset ] ) << 24 | data[ offset + 1 ] << 16 | data[ offset + 2 ] << 8 | data[ offset + 3 ];
+    }
+
+    void WriteU32( Bytes& data, size_t offset, uint32_t value )
+    {
+        data[ offset ] = static_cast< uint8_t >( value >> 24 );
+        data[ offset + 1 ] = static_cast< uint8_t >( value >> 16 );
+        data[ offset + 2 ] = static_cast< uint8_t >( value >> 8 );
+        data[ offset + 3 ] = static_cast< uint8_t >( value );
+    }
+
+    /**
+     * @brief      Get the offset of the directory record of a table
+     */
+    size_t FindRecord( const Bytes& data, const char* tag )
+    {
+        const size_t count = data[ 4 ] << 8 | data[ 5 ];
+        for( size_t i = 0; i < count; ++i ) {
+            if( memcmp( data.data() + 12 + i * 16, tag, 4 ) == 0 ) {
+                return 12 + i * 16;
+            }
+        }
+        return 0;
+    }
+
+    void TestFont( void )
+    {
+        CTrueTypeFont font;
+        HAZE_CHECK( font.Load( ReadFont() ) );
+        HAZE_CHECK( font.IsLoaded() );
+
+        vector< OutlinePoint > cPoints;
+        vector< size_t > cContours;
+        const auto glyph = font.GetGlyph( 'A' );
+        HAZE_CHECK( glyph != 0 );
+        HAZE_CHECK( font.GetAdvance( glyph ) > 0 );
+        HAZE_CHECK( font.GetOutline( glyph, cPoints, cContours ) );
+    }
+
+    void TestShortTables( void )
+    {
+        const auto data = ReadFont();
+        for( const auto* tag : REQUIRED_TABLES ) {
+            const auto record = FindRecord( data, tag );
+            HAZE_CHECK( record != 0 );
+
+            // one byte less than the directory says, no table or half of it
+            const auto length = ReadU32( data, record + 12 );
+            for( const auto shortened : { length - 1, length / 2, 0u } ) {
+                auto copy = data;
+                WriteU32( copy, record + 12, strcmp( tag, "maxp" ) ? shortened : min( shortened, 5u ) );
+
+                CTrueTypeFont font;
+                HAZE_CHECK( !font.Load( copy ) );
+                HAZE_CHECK( !font.IsLoaded() && !font.GetGlyph( 'A' ) );
+            }
+        }
+    }
+
+    void TestTruncatedFile( void )
+    {
+        // every cut before the end of the last required table
+        const auto data = ReadFont();
+        size_t end = 0;
+        for( const auto* tag : REQUIRED_TABLES ) {
+            const auto record = FindRecord( data, tag );
+            end = max< size_t >( end, ReadU32( data, record + 8 ) + ReadU32( data, record + 12 ) );
+        }
+        HAZE_CHECK( end <= data.size() );
+
+        for( size_t size = 0; size < end; size += size < 64 ? 1 : 997 ) {
+            CTrueTypeFont font;
+            HAZE_CHECK( !font.Load( Bytes( data.begin(), data.begin() + static_cast< ptrdiff_t >( size ) ) ) );
+        }
+        CTrueTypeFont font;
+        HAZE_CHECK( !font.Load( Bytes( data.begin(), data.begin() + static_cast< ptrdiff_t >( end - 1 ) ) ) );
+    }
+
+    void TestCorruptGlyphs( void )
+    {
+        // flipped bytes inside the outlines must only break single glyphs
+        auto data = ReadFont();
+        const auto record = FindRecord( data, "glyf" );
+        const auto offset = ReadU32( data, record + 8 ), length = ReadU32( data, record + 12 );
+        uint32_t random = 12345;
+        for( int i = 0; i < 2000; ++i ) {
+            random = random * 1664525u + 1013904223u;
+            data[ offset + ( random >> 8 ) % length ] ^= static_cast< uint8_t >( random );
+        }
+
+        CTrueTypeFont font;
+        HAZE_CHECK( font.Load( data ) );
+        vector< OutlinePoint > cPoints;
+        vector< size_t > cContours;
+        for( uint32_t glyph = 0; glyph < 4000; ++glyph ) {
+            array< int32_t, 4 > bounds;
+            font.GetBounds( glyph, bounds );
+            if( font.GetOutline( glyph, cPoints, cContours ) ) {
+                HAZE_CHECK( cContours.back() == cPoints.size() );
+            }
+        }
+    }
+}
+
+int main( void )
+{
+    TestFont();
+    TestShortTables();
+    TestTruncatedFile();
+    TestCorruptGlyphs();
+    return test::GetResult();
+}
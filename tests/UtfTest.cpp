@@ -0,0 +1,182 @@
+#include "Check.hpp"
+#include "Utf.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace haze;
+
+namespace {
+    using Units = vector< uint32_t >;
+
+    constexpr uint32_t FFFD = 0xFFFD;
+
+    Units Convert( const string& src, bool* valid = nullptr )
+    {
+        vector< wchar_t > buffer( src.size() + 1 );
+        const auto count = Utf8ToUtf16( src.data(), src.size(), buffer.data(), valid );
+
+        Units units;
+        for( size_t i = 0; i < count; ++i ) {
+            units.push_back( static_cast< uint32_t >( buffer[ i ] ) );
+        }
+        return units;
+    }
+
+    Units Widen( const string& ascii )
+    {
+        return Units( ascii.begin(), ascii.end() );
+    }
+
+    Units Concat( Units a, const Units& b )
+    {
+        a.insert( a.end(), b.begin(), b.end() );
+        return a;
+    }
+
+    /**
+     * @brief      Expect the conversion and its validity
+     */
+    void Expect( const string& src, const Units& expected, bool valid )
+    {
+        bool result = !valid;
+        HAZE_CHECK( Convert( src, &result ) == expected );
+        HAZE_CHECK( result == valid );
+    }
+
+    void TestAscii( void )
+    {
+        // every length around the 16 and 32 byte blocks
+        string text;
+        for( size_t length = 0; length <= 100; ++length ) {
+            Expect( text, Widen( text ), true );
+            text.push_back( static_cast< char >( 0x20 + length % 0x5F ) );
+        }
+        Expect( string( "\0a\x7F", 3 ), { 0x00, 'a', 0x7F }, true );
+    }
+
+    void TestValidSequences( void )
+    {
+        Expect( "\xC2\x80", { 0x80 }, true );
+        Expect( "\xDF\xBF", { 0x7FF }, true );
+        Expect( "\xE0\xA0\x80", { 0x800 }, true );
+        Expect( "\xE2\x82\xAC", { 0x20AC }, true );
+        Expect( "\xED\x9F\xBF", { 0xD7FF }, true );
+        Expect( "\xEE\x80\x80", { 0xE000 }, true );
+        Expect( "\xEF\xBF\xBF", { 0xFFFF }, true );
+
+        // beyond the basic plane utf-16 needs a surrogate pair, even with a 32 bit wchar_t
+        Expect( "\xF0\x90\x80\x80", { 0xD800, 0xDC00 }, true );
+        Expect( "\xF0\x9F\x98\x80", { 0xD83D, 0xDE00 }, true );
+        Expect( "\xF4\x8F\xBF\xBF", { 0xDBFF, 0xDFFF }, true );
+    }
+
+    void TestMaximalSubparts( void )
+    {
+        // example of table 3-8 of the unicode standard
+        Expect( "\x61\xF1\x80\x80\xE1\x80\xC2\x62\x80\x63\x80\xBF\x64", { 0x61, FFFD, FFFD, FFFD, 0x62, FFFD, 0x63, FFFD, FFFD, 0x64 }, false );
+
+        // lone continuation bytes and bytes which never start a sequence
+        Expect( "\x80", { FFFD }, false );
+        Expect( "\xBF\xBF", { FFFD, FFFD }, false );
+        Expect( "\xF5\x80", { FFFD, FFFD }, false );
+        Expect( "\xFF", { FFFD }, false );
+    }
+
+    void TestSurrogates( void )
+    {
+        // encoded surrogates are not scalar values, every byte is replaced
+        Expect( "\xED\xA0\x80", { FFFD, FFFD, FFFD }, false );
+        Expect( "\xED\xBF\xBF", { FFFD, FFFD, FFFD }, false );
+        Expect( "\xED\xA0\xBD\xED\xB8\x80", { FFFD, FFFD, FFFD, FFFD, FFFD, FFFD }, false );
+    }
+
+    void TestOverlongs( void )
+    {
+        Expect( "\xC0\xAF", { FFFD, FFFD }, false );
+        Expect( "\xC1\xBF", { FFFD, FFFD }, false );
+        Expect( "\xE0\x80\xAF", { FFFD, FFFD, FFFD }, false );
+        Expect( "\xE0\x9F\xBF", { FFFD, FFFD, FFFD }, false );
+        Expect( "\xF0\x80\x80\xAF", { FFFD, FFFD, FFFD, FFFD }, false );
+        Expect( "\xF0\x8F\xBF\xBF", { FFFD, FFFD, FFFD, FFFD }, false );
+
+        // above U+10FFFF
+        Expect( "\xF4\x90\x80\x80", { FFFD, FFFD, FFFD, FFFD }, false );
+    }
+
+    void TestTruncated( void )
+    {
+        // an incomplete sequence at the end is one replacement
+        Expect( "a\xC3", { 'a', FFFD }, false );
+        Expect( "a\xE2\x82", { 'a', FFFD }, false );
+        Expect( "a\xF0\x9F\x98", { 'a', FFFD }, false );
+
+        // and so is one cut off by the next character
+        Expect( "\xE2\x82" "a", { FFFD, 'a' }, false );
+        Expect( "\xF0\x9F\x98" "a", { FFFD, 'a' }, false );
+    }
+
+    void TestBlockBoundaries( void )
+    {
+        // the vector paths stop at the first block with a non-ASCII byte,
+        // every sequence has to convert the same at any position of a block
+        const struct
+        {
+            const char* pBytes;
+            Units       expected;
+            bool        valid;
+        } sequences[] = {
+            { "\xC3\xA9", { 0xE9 }, true },
+            { "\xE2\x82\xAC", { 0x20AC }, true },
+            { "\xF0\x9F\x98\x80", { 0xD83D, 0xDE00 }, true },
+            { "\xED\xA0\x80", { FFFD, FFFD, FFFD }, false },
+            { "\xF1\x80\x80\xE1\x80\xC2", { FFFD, FFFD, FFFD }, false },
+        };
+
+        for( const auto& sequence : sequences ) {
+            for( size_t prefix = 0; prefix <= 70; ++prefix ) {
+                const string head( prefix, 'x' ), tail( 40, 'y' );
+
+                // followed by ASCII which is widened by the vector paths again
+                Expect( head + sequence.pBytes + tail, Concat( Concat( Widen( head ), sequence.expected ), Widen( tail ) ), sequence.valid );
+
+                // at the very end of the input
+                Expect( head + sequence.pBytes, Concat( Widen( head ), sequence.expected ), sequence.valid );
+            }
+        }
+
+        // truncated right at the end of a block
+        for( size_t prefix = 0; prefix <= 70; ++prefix ) {
+            const string head( prefix, 'x' );
+            Expect( head + "\xF0\x9F\x98", Concat( Widen( head ), { FFFD } ), false );
+        }
+    }
+
+    void TestBuffer( void )
+    {
+        wstring buffer;
+        HAZE_CHECK( Utf8ToUtf16( "gr\xC3\xBC\xC3\x9F", 6, buffer ) );
+        HAZE_CHECK( buffer == L"gr\u00FC\u00DF" );
+
+        // a warmed up buffer keeps its memory
+        const auto* data = buffer.data();
+        HAZE_CHECK( !Utf8ToUtf16( "\xFF" "ab", 3, buffer ) );
+        HAZE_CHECK( buffer == L"\uFFFDab" );
+        HAZE_CHECK( buffer.data() == data );
+
+        HAZE_CHECK( Utf8ToUtf16( "", 0, buffer ) );
+        HAZE_CHECK( buffer.empty() );
+    }
+}
+
+int main( void )
+{
+    TestAscii();
+    TestValidSequences();
+    TestMaximalSubparts();
+    TestSurrogates();
+    TestOverlongs();
+    TestTruncated();
+    TestBlockBoundaries();
+    TestBuffer();
+    return test::GetResult();
+}